@@ -113,3 +113,68 @@ DEF_BENCH(return new BitmapRectBench(0x80, kLow_SkFilterQuality, false))
 
 DEF_BENCH(return new BitmapRectBench(0xFF, kNone_SkFilterQuality, true))
 DEF_BENCH(return new BitmapRectBench(0xFF, kLow_SkFilterQuality, true))
+
+// Strong non-uniform downscales, which are sampled anisotropically at medium and high quality
+// (only high with perspective).
+class DownscaleBitmapRectBench : public Benchmark {
+    SkBitmap        fBitmap;
+    SkMatrix        fMatrix;
+    SkFilterQuality fFilterQuality;
+    bool            fPerspective;
+    SkString        fName;
+
+    static const int kSize = 1024;
+public:
+    DownscaleBitmapRectBench(SkFilterQuality filterQuality, bool perspective)
+        : fFilterQuality(filterQuality)
+        , fPerspective(perspective) {}
+
+protected:
+    const char* onGetName() override {
+        static const char* kQualityNames[] = { "none", "low", "medium", "high" };
+        fName.printf("bitmaprect_downscale_%s_%s", fPerspective ? "perspective" : "skew",
+                     kQualityNames[fFilterQuality]);
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(kSize, kSize, true);
+        fBitmap.eraseColor(SK_ColorBLACK);
+        draw_into_bitmap(fBitmap);
+
+        if (fPerspective) {
+            // A plane tilted away from the viewer, much narrower at the top than the bottom.
+            const SkPoint src[] = {
+                { 0, 0 }, { kSize, 0 }, { kSize, kSize }, { 0, kSize },
+            };
+            const SkPoint dst[] = {
+                { 112, 0 }, { 144, 0 }, { 256, 128 }, { 0, 128 },
+            };
+            fMatrix.setPolyToPoly(src, dst, 4);
+        } else {
+            fMatrix.setSkew(SK_Scalar1 / 2, 0);
+            fMatrix.preScale(SK_Scalar1 / 8, SK_Scalar1 / 2);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setFilterQuality(fFilterQuality);
+
+        canvas->concat(fMatrix);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawBitmap(fBitmap, 0, 0, &paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new DownscaleBitmapRectBench(kLow_SkFilterQuality, false))
+DEF_BENCH(return new DownscaleBitmapRectBench(kMedium_SkFilterQuality, false))
+DEF_BENCH(return new DownscaleBitmapRectBench(kHigh_SkFilterQuality, false))
+DEF_BENCH(return new DownscaleBitmapRectBench(kLow_SkFilterQuality, true))
+DEF_BENCH(return new DownscaleBitmapRectBench(kMedium_SkFilterQuality, true))
+DEF_BENCH(return new DownscaleBitmapRectBench(kHigh_SkFilterQuality, true))
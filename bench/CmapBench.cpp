@@ -7,8 +7,12 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkFont.h"
+#include "SkFontMgr.h"
 #include "SkPaint.h"
+#include "SkTemplates.h"
 #include "SkTypeface.h"
+#include "SkUTF.h"
 
 enum {
     NGLYPHS = 100
@@ -62,6 +66,38 @@ static void charsToGlyphsNull_proc(int loops, const SkPaint& paint, const void*
     }
 }
 
+// Measures each glyph with its own call, the way layout code measuring word by word does.
+static void glyphWidthsEach_proc(int loops, const SkPaint& paint, const void* text, size_t len,
+                                 int glyphCount) {
+    uint16_t glyphs[NGLYPHS];
+    SkScalar widths[NGLYPHS];
+    SkRect bounds[NGLYPHS];
+    SkASSERT(glyphCount <= NGLYPHS);
+    paint.textToGlyphs(text, len, glyphs);
+
+    SkPaint glyphPaint(paint);
+    glyphPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    for (int i = 0; i < loops; ++i) {
+        for (int j = 0; j < glyphCount; ++j) {
+            glyphPaint.getTextWidths(&glyphs[j], sizeof(uint16_t), &widths[j], &bounds[j]);
+        }
+    }
+}
+
+static void glyphWidthsBatch_proc(int loops, const SkPaint& paint, const void* text, size_t len,
+                                  int glyphCount) {
+    uint16_t glyphs[NGLYPHS];
+    SkScalar widths[NGLYPHS];
+    SkRect bounds[NGLYPHS];
+    SkASSERT(glyphCount <= NGLYPHS);
+    paint.textToGlyphs(text, len, glyphs);
+
+    sk_sp<SkFont> font = SkFont::Testing_CreateFromPaint(paint);
+    for (int i = 0; i < loops; ++i) {
+        font->getWidths(glyphs, glyphCount, widths, bounds);
+    }
+}
+
 class CMAPBench : public Benchmark {
     TypefaceProc fProc;
     SkString     fName;
@@ -100,3 +136,80 @@ DEF_BENCH( return new CMAPBench(containsText_proc, "paint_containsText"); )
 DEF_BENCH( return new CMAPBench(textToGlyphs_proc, "paint_textToGlyphs"); )
 DEF_BENCH( return new CMAPBench(charsToGlyphs_proc, "face_charsToGlyphs"); )
 DEF_BENCH( return new CMAPBench(charsToGlyphsNull_proc, "face_charsToGlyphs_null"); )
+DEF_BENCH( return new CMAPBench(glyphWidthsEach_proc, "paint_glyphWidths_each"); )
+DEF_BENCH( return new CMAPBench(glyphWidthsBatch_proc, "font_glyphWidths_batch"); )
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Maps a large run of text at once, the way shaping a paragraph does. The name includes the size
+// of the text in bytes, so the time per loop gives the throughput.
+class CMAPThroughputBench : public Benchmark {
+    enum {
+        kCharCount = 16384
+    };
+
+    SkString                fName;
+    SkTypeface::Encoding    fEncoding;
+    SkAutoTMalloc<char>     fText;
+    SkAutoTMalloc<uint16_t> fGlyphs;
+    sk_sp<SkTypeface>       fTypeface;
+    bool                    fCJK;
+
+public:
+    CMAPThroughputBench(bool cjk, SkTypeface::Encoding encoding)
+        : fEncoding(encoding), fGlyphs(kCharCount), fCJK(cjk) {
+        SkASSERT(SkTypeface::kUTF32_Encoding != encoding);
+        size_t bytesPerChar = SkTypeface::kUTF8_Encoding == encoding
+                            ? SkUTF::kMaxBytesInUTF8Sequence : sizeof(uint16_t);
+        fText.reset(kCharCount * bytesPerChar);
+        size_t length = 0;
+        for (int i = 0; i < kCharCount; ++i) {
+            // Words of Latin letters, or runs of common CJK ideographs, separated by spaces.
+            SkUnichar uni = ' ';
+            if (i % 8 != 7) {
+                uni = cjk ? 0x4E00 + (i * 37) % 0x1000 : 'a' + (i * 7) % 26;
+            }
+            if (SkTypeface::kUTF8_Encoding == encoding) {
+                length += SkUTF::ToUTF8(uni, fText.get() + length);
+            } else {
+                length += sizeof(uint16_t) *
+                          SkUTF::ToUTF16(uni, reinterpret_cast<uint16_t*>(fText.get() + length));
+            }
+        }
+        fName.printf("cmap_face_charsToGlyphs_%s_%s_%zuB", cjk ? "cjk" : "latin",
+                     SkTypeface::kUTF8_Encoding == encoding ? "utf8" : "utf16", length);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        if (fCJK) {
+            fTypeface.reset(SkFontMgr::RefDefault()->matchFamilyStyleCharacter(
+                    nullptr, SkFontStyle(), nullptr, 0, 0x4E2D));
+        }
+        if (!fTypeface) {
+            fTypeface = SkTypeface::MakeDefault();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            fTypeface->charsToGlyphs(fText.get(), fEncoding, fGlyphs.get(), kCharCount);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new CMAPThroughputBench(false, SkTypeface::kUTF8_Encoding); )
+DEF_BENCH( return new CMAPThroughputBench(false, SkTypeface::kUTF16_Encoding); )
+DEF_BENCH( return new CMAPThroughputBench(true, SkTypeface::kUTF8_Encoding); )
+DEF_BENCH( return new CMAPThroughputBench(true, SkTypeface::kUTF16_Encoding); )
@@ -11,12 +11,19 @@
 #include "SkColorSpaceXform.h"
 #include "SkColorSpaceXformer.h"
 #include "SkColorSpaceXformSteps.h"
+#include "SkConvertPixels.h"
 #include "SkMakeUnique.h"
+#include "SkPixmap.h"
 #include "SkPM4fPriv.h"
 #include "SkRandom.h"
 #include "SkRasterPipeline.h"
+#include "SkTemplates.h"
 
-enum class Mode { xform, steps, pipeA, pipeB, xformer };
+enum class Mode { xform, steps, pipeA, pipeB, xformer, convert, convertBatch };
+
+// The convert modes convert many small images, where setting up each conversion dominates.
+static constexpr int kImages    = 64;
+static constexpr int kImageSize = 4;
 
 struct ColorSpaceXformBench : public Benchmark {
     ColorSpaceXformBench(Mode mode) : fMode(mode) {}
@@ -33,6 +40,11 @@ struct ColorSpaceXformBench : public Benchmark {
 
     std::unique_ptr<SkColorSpaceXformer> fXformer;
 
+    SkAutoTMalloc<uint32_t> fSrcPixels,
+                            fDstPixels;
+    SkPixmap fSrcPixmaps[kImages],
+             fDstPixmaps[kImages];
+
     const char* onGetName() override {
         switch (fMode) {
             case Mode::xform  : return "ColorSpaceXformBench_xform";
@@ -40,6 +52,8 @@ struct ColorSpaceXformBench : public Benchmark {
             case Mode::pipeA  : return "ColorSpaceXformBench_pipeA";
             case Mode::pipeB  : return "ColorSpaceXformBench_pipeB";
             case Mode::xformer: return "ColorSpaceXformBench_xformer";
+            case Mode::convert: return "ColorSpaceXformBench_convert";
+            case Mode::convertBatch: return "ColorSpaceXformBench_convertBatch";
         }
         return "";
     }
@@ -63,9 +77,42 @@ struct ColorSpaceXformBench : public Benchmark {
         fPipeA = p.compile();
 
         fXformer = SkColorSpaceXformer::Make(dst);  // src is implicitly sRGB, what we want anyway
+
+        const int kPixels = kImageSize * kImageSize;
+        fSrcPixels.reset(kImages * kPixels);
+        fDstPixels.reset(kImages * kPixels);
+        SkRandom rand;
+        for (int i = 0; i < kImages * kPixels; i++) {
+            fSrcPixels[i] = rand.nextU() | 0xFF000000;
+        }
+        for (int i = 0; i < kImages; i++) {
+            fSrcPixmaps[i].reset(SkImageInfo::MakeN32(kImageSize, kImageSize, kOpaque_SkAlphaType,
+                                                      src),
+                                 &fSrcPixels[i * kPixels], kImageSize * sizeof(uint32_t));
+            fDstPixmaps[i].reset(SkImageInfo::MakeN32Premul(kImageSize, kImageSize, dst),
+                                 &fDstPixels[i * kPixels], kImageSize * sizeof(uint32_t));
+        }
     }
 
     void onDraw(int n, SkCanvas* canvas) override {
+        if (fMode == Mode::convert) {
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < kImages; j++) {
+                    const SkPixmap& src = fSrcPixmaps[j];
+                    const SkPixmap& dst = fDstPixmaps[j];
+                    SkConvertPixels(dst.info(), dst.writable_addr(), dst.rowBytes(),
+                                    src.info(), src.addr(), src.rowBytes());
+                }
+            }
+            return;
+        }
+        if (fMode == Mode::convertBatch) {
+            for (int i = 0; i < n; i++) {
+                SkConvertPixmaps(fDstPixmaps, fSrcPixmaps, kImages);
+            }
+            return;
+        }
+
         volatile SkColor junk = 0;
         SkRandom rand;
 
@@ -105,6 +152,10 @@ struct ColorSpaceXformBench : public Benchmark {
                 case Mode::xformer: {
                     dst = fXformer->apply(src);
                 } break;
+
+                case Mode::convert:
+                case Mode::convertBatch:
+                    break;
             }
 
             if (false && i == 0) {
@@ -121,3 +172,5 @@ DEF_BENCH(return new ColorSpaceXformBench{Mode::steps  };)
 DEF_BENCH(return new ColorSpaceXformBench{Mode::pipeA  };)
 DEF_BENCH(return new ColorSpaceXformBench{Mode::pipeB  };)
 DEF_BENCH(return new ColorSpaceXformBench{Mode::xformer};)
+DEF_BENCH(return new ColorSpaceXformBench{Mode::convert};)
+DEF_BENCH(return new ColorSpaceXformBench{Mode::convertBatch};)
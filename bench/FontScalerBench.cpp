@@ -7,10 +7,13 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkGlyphCache.h"
 #include "SkGraphics.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
+#include "SkStrikeCache.h"
 #include "SkString.h"
+#include "SkTaskGroup.h"
 
 class FontScalerBench : public Benchmark {
     SkString fName;
@@ -50,3 +53,52 @@ private:
 
 DEF_BENCH(return new FontScalerBench(false);)
 DEF_BENCH(return new FontScalerBench(true);)
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Creates scaler contexts and rasterizes glyphs with them on several threads at once. Each thread
+// works on its own text sizes so that the threads never share a strike and the time is spent in
+// the font host.
+class FontScalerThreadedBench : public Benchmark {
+    SkString fName;
+    SkString fText;
+    int      fThreads;
+public:
+    FontScalerThreadedBench(int threads) : fThreads(threads) {
+        fName.printf("fontscaler_aa_threads%d", threads);
+        fText.set("abcdefghijklmnopqrstuvwxyz01234567890");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkGraphics::PurgeFontCache();
+
+            SkTaskGroup().batch(fThreads, [&](int thread) {
+                SkPaint paint;
+                paint.setAntiAlias(true);
+                for (int ps = 9; ps <= 24; ps += 2) {
+                    paint.setTextSize(ps + thread / SkIntToScalar(fThreads));
+                    auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(paint);
+                    for (size_t c = 0; c < fText.size(); c++) {
+                        const SkGlyph& glyph =
+                                cache->getGlyphIDMetrics(cache->unicharToGlyph(fText[c]));
+                        cache->findImage(glyph);
+                    }
+                }
+            });
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new FontScalerThreadedBench(1);)
+DEF_BENCH(return new FontScalerThreadedBench(4);)
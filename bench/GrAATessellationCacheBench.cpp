@@ -0,0 +1,96 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrDefaultGeoProcFactory.h"
+#include "GrPathUtils.h"
+#include "GrShape.h"
+#include "GrStyle.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "ops/GrAATessellationCache.h"
+
+// Produces the AA vertices for a set of concave paths that scroll a little every frame, the way
+// GrTessellatingPathRenderer does: either by tessellating every frame or by translating the
+// tessellations found in a GrAATessellationCache.
+class GrAATessellationCacheBench : public Benchmark {
+public:
+    GrAATessellationCacheBench(bool useCache) : fUseCache(useCache) {
+        fName.printf("gr_aa_tessellation_cache_%s", useCache ? "scroll" : "none");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom random;
+        for (int i = 0; i < kNumPaths; ++i) {
+            SkScalar x = random.nextRangeScalar(0, 1024);
+            SkScalar y = random.nextRangeScalar(0, 1024);
+            SkScalar r = random.nextRangeScalar(20, 200);
+            // A concave "flower". The AA tessellator only takes paths with few verbs.
+            SkPath& path = fPaths.push_back();
+            path.moveTo(x + r, y);
+            path.quadTo(x, y, x, y + r);
+            path.quadTo(x, y, x - r, y);
+            path.quadTo(x, y, x, y - r);
+            path.quadTo(x, y, x + r, y);
+            path.close();
+        }
+        fVertices.reset(kMaxVertices);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        GrAATessellationCache cache;
+        GrStyle fill(SkStrokeRec::kFill_InitStyle);
+        for (int i = 0; i < loops; ++i) {
+            SkMatrix viewMatrix = SkMatrix::MakeTrans(0.5f, 0.5f - 3 * (i % 100));
+            for (const SkPath& path : fPaths) {
+                GrAATessellationCache::Key key;
+                SkAssertResult(key.set(GrShape(path, fill), viewMatrix));
+                sk_sp<const GrAATessellationCache::Tessellation> tessellation;
+                if (fUseCache) {
+                    tessellation = cache.find(key);
+                }
+                if (!tessellation) {
+                    SkPath devPath;
+                    path.transform(key.tessellationMatrix(), &devPath);
+                    tessellation = GrAATessellationCache::Tessellation::Make(
+                            devPath, GrPathUtils::kDefaultTolerance);
+                    if (fUseCache) {
+                        cache.add(key, tessellation);
+                    }
+                }
+                if (tessellation && tessellation->count() <= kMaxVertices) {
+                    GrAATessellationCache::WriteVertices(*tessellation, key.translate(), 0xFF000000,
+                                                         true, fVertices.get());
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr int kNumPaths = 100;
+    static constexpr int kMaxVertices = 1 << 16;
+
+    bool                                                            fUseCache;
+    SkString                                                        fName;
+    SkTArray<SkPath>                                                fPaths;
+    SkAutoTMalloc<GrDefaultGeoProcFactory::PositionColorCoverageAttr> fVertices;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new GrAATessellationCacheBench(false);)
+DEF_BENCH(return new GrAATessellationCacheBench(true);)
+
+#endif
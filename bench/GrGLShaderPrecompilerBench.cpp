@@ -0,0 +1,105 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#include "SkExecutor.h"
+#include "SkSLUtil.h"
+#include "SkTaskGroup.h"
+#include "gl/builders/GrGLShaderPrecompiler.h"
+
+#include <memory>
+
+// Measures how long it takes GrGLShaderPrecompiler to translate a captured set of programs from
+// SkSL to GLSL, either serially or spread across a thread pool.
+class GrGLShaderPrecompilerBench : public Benchmark {
+public:
+    GrGLShaderPrecompilerBench(bool threaded)
+        : fThreaded(threaded)
+        , fName(threaded ? "gl_shader_precompile_threaded" : "gl_shader_precompile_serial") {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName; }
+
+    void onDelayedSetup() override {
+        fCaps = SkSL::ShaderCapsFactory::Default();
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+        // Stand-ins for the programs a real run stores in its persistent cache: one vertex shader
+        // shared by everything, and a variety of fragment shaders.
+        SkSL::Program::Settings settings;
+        SkSL::String sksl[GrGLShaderPrecompiler::kShaderTypeCount];
+        sksl[GrGLShaderPrecompiler::kVertex_ShaderType] =
+                "in float2 position; in half4 inColor; out half4 vcolor; out float2 vlocal;"
+                "uniform float4 sk_RTAdjust;"
+                "void main() {"
+                "    vcolor = inColor;"
+                "    vlocal = position;"
+                "    sk_Position = float4(position * sk_RTAdjust.xz + sk_RTAdjust.yw, 0, 1);"
+                "}";
+        for (int i = 0; i < kProgramCount; ++i) {
+            SkSL::String& fs = sksl[GrGLShaderPrecompiler::kFragment_ShaderType];
+            fs = "in half4 vcolor; in float2 vlocal; uniform half4 tint;"
+                 "uniform float4 circle; uniform half4 colors[4];"
+                 "void main() {"
+                 "    half4 color = vcolor;";
+            if (i & 1) {
+                fs += "    half d = half(length(vlocal - circle.xy) - circle.z);"
+                      "    color *= saturate(0.5 - d);";
+            }
+            if (i & 2) {
+                fs += "    half t = fract(half(vlocal.x * circle.w));"
+                      "    half4 g = mix(colors[0], colors[1], t);"
+                      "    color = t < 0.5 ? g * color : mix(colors[2], colors[3], t) * color;";
+            }
+            if (i & 4) {
+                fs += "    for (int j = 0; j < 4; ++j) {"
+                      "        color.rgb = color.rgb * tint.a + tint.rgb * half(j);"
+                      "    }";
+            }
+            fs.appendf("    sk_FragColor = color * %d.0;"
+                       "}", i + 1);
+            fKeys[i] = SkData::MakeWithCopy(&i, sizeof(i));
+            fData[i] = GrGLShaderPrecompiler::Encode(settings, sksl);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        std::unique_ptr<SkTaskGroup> taskGroup;
+        if (fExecutor) {
+            taskGroup.reset(new SkTaskGroup(*fExecutor));
+        }
+        for (int i = 0; i < loops; ++i) {
+            sk_sp<GrGLShaderPrecompiler> precompiler(new GrGLShaderPrecompiler(fCaps));
+            for (int j = 0; j < kProgramCount; ++j) {
+                precompiler->add(*fKeys[j], *fData[j]);
+            }
+            precompiler->compile(taskGroup.get());
+            for (int j = 0; j < kProgramCount; ++j) {
+                SkAssertResult(precompiler->find(&j, sizeof(j)));
+            }
+        }
+    }
+
+private:
+    static constexpr int kProgramCount = 64;
+
+    bool                        fThreaded;
+    const char*                 fName;
+    sk_sp<GrShaderCaps>         fCaps;
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkData>               fKeys[kProgramCount];
+    sk_sp<SkData>               fData[kProgramCount];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new GrGLShaderPrecompilerBench(false);)
+DEF_BENCH(return new GrGLShaderPrecompilerBench(true);)
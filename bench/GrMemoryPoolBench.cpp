@@ -9,7 +9,9 @@
 
 #include "Benchmark.h"
 #include "GrMemoryPool.h"
+#include "SkExecutor.h"
 #include "SkRandom.h"
+#include "SkTaskGroup.h"
 #include "SkTDArray.h"
 #include "SkTemplates.h"
 #include <new>
@@ -169,8 +171,70 @@ private:
     typedef Benchmark INHERITED;
 };
 
+/**
+ * This benchmark simulates DDL recording on many threads: each loop every thread creates an op
+ * pool, allocates op sized objects from it, releases them, and destroys the pool. With a
+ * GrMemoryPoolBlockCache the pools' blocks are recycled instead of going back to malloc.
+ */
+class GrMemoryPoolBenchDDL : public Benchmark {
+public:
+    GrMemoryPoolBenchDDL(bool useBlockCache) : fUseBlockCache(useBlockCache) {
+        fName.printf("grmemorypool_ddl_%d_threads_%s", kThreads,
+                     useBlockCache ? "recycled" : "malloc");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(kThreads);
+        if (fUseBlockCache) {
+            fBlockCache.reset(new GrMemoryPoolBlockCache(GrMemoryPoolBlockCache::kOpPoolBlockSize,
+                                                         kThreads));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        constexpr size_t kBlockSize = GrMemoryPoolBlockCache::kOpPoolBlockSize;
+        SkTaskGroup taskGroup(*fExecutor);
+        for (int i = 0; i < loops; i++) {
+            taskGroup.batch(kThreads, [this](int threadIndex) {
+                GrMemoryPool pool(kBlockSize, kBlockSize, fBlockCache.get());
+                SkRandom r(threadIndex);
+                void* ops[kOpsPerRecording];
+                for (int j = 0; j < kOpsPerRecording; ++j) {
+                    ops[j] = pool.allocate(r.nextRangeU(64, 512));
+                }
+                for (int j = 0; j < kOpsPerRecording; ++j) {
+                    pool.release(ops[j]);
+                }
+            });
+            taskGroup.wait();
+        }
+    }
+
+private:
+    static constexpr int kThreads = 16;
+    static constexpr int kOpsPerRecording = 1000;
+
+    bool                                    fUseBlockCache;
+    SkString                                fName;
+    std::unique_ptr<SkExecutor>             fExecutor;
+    std::unique_ptr<GrMemoryPoolBlockCache> fBlockCache;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new GrMemoryPoolBenchStack(); )
 DEF_BENCH( return new GrMemoryPoolBenchRandom(); )
 DEF_BENCH( return new GrMemoryPoolBenchQueue(); )
+DEF_BENCH( return new GrMemoryPoolBenchDDL(false); )
+DEF_BENCH( return new GrMemoryPoolBenchDDL(true); )
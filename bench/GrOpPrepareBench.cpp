@@ -0,0 +1,104 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#include "GrContext.h"
+#include "GrContextOptions.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkSurface.h"
+
+// Draws antialiased concave fills (tessellated) and convex strokes (linearized) with the mock GPU
+// backend and flushes. With threads the ops' vertex generation is done on the context's executor.
+class GrOpPrepareBench : public Benchmark {
+public:
+    GrOpPrepareBench(int threads) : fThreads(threads) {
+        fName.printf("gr_op_prepare_paths_%d_threads", threads);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        GrContextOptions options;
+        options.fExecutor = fExecutor.get();
+#if GR_TEST_UTILS
+        options.fGpuPathRenderers = GpuPathRenderers::kTessellating |
+                                    GpuPathRenderers::kAALinearizing;
+#endif
+        fContext = GrContext::MakeMock(nullptr, options);
+        if (!fContext) {
+            return;
+        }
+        fSurface = SkSurface::MakeRenderTarget(fContext.get(), SkBudgeted::kNo,
+                                               SkImageInfo::MakeN32Premul(kSize, kSize));
+
+        SkRandom random;
+        for (int i = 0; i < kNumPaths; ++i) {
+            SkScalar x = random.nextRangeScalar(0, kSize);
+            SkScalar y = random.nextRangeScalar(0, kSize);
+            SkScalar r = random.nextRangeScalar(20, 200);
+            SkPath& path = fPaths.push_back();
+            if (i & 1) {
+                // A concave "flower". The AA tessellator only takes paths with few verbs.
+                path.moveTo(x + r, y);
+                path.quadTo(x, y, x, y + r);
+                path.quadTo(x, y, x - r, y);
+                path.quadTo(x, y, x, y - r);
+                path.quadTo(x, y, x + r, y);
+                path.close();
+            } else {
+                path.addCircle(x, y, r);
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fSurface) {
+            return;
+        }
+        SkCanvas* canvas = fSurface->getCanvas();
+        SkPaint fill;
+        fill.setAntiAlias(true);
+        SkPaint stroke(fill);
+        stroke.setStyle(SkPaint::kStroke_Style);
+        stroke.setStrokeWidth(3);
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < fPaths.count(); ++j) {
+                SkPaint& paint = (j & 1) ? fill : stroke;
+                paint.setColor(0xFF000000 | (j * 0x10101));
+                canvas->drawPath(fPaths[j], paint);
+            }
+            fSurface->flush();
+        }
+    }
+
+private:
+    static constexpr int kSize = 1024;
+    static constexpr int kNumPaths = 200;
+
+    int                          fThreads;
+    SkString                     fName;
+    std::unique_ptr<SkExecutor>  fExecutor;
+    sk_sp<GrContext>             fContext;
+    sk_sp<SkSurface>             fSurface;
+    SkTArray<SkPath>             fPaths;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new GrOpPrepareBench(0);)
+DEF_BENCH(return new GrOpPrepareBench(4);)
@@ -21,8 +21,9 @@ enum {
 
 class BenchResource : public GrGpuResource {
 public:
-    BenchResource (GrGpu* gpu)
-        : INHERITED(gpu) {
+    BenchResource (GrGpu* gpu, int scratchType = -1)
+        : INHERITED(gpu)
+        , fScratchType(scratchType) {
         this->registerWithCache(SkBudgeted::kYes);
     }
 
@@ -34,9 +35,26 @@ public:
         }
     }
 
+    static void ComputeScratchKey(int scratchType, GrScratchKey* key) {
+        static GrScratchKey::ResourceType kType = GrScratchKey::GenerateResourceType();
+        GrScratchKey::Builder builder(key, kType, 1);
+        builder[0] = scratchType;
+    }
+
+    static constexpr size_t kSize = 100;
+
 private:
-    size_t onGpuMemorySize() const override { return 100; }
+    void computeScratchKey(GrScratchKey* key) const override {
+        if (fScratchType >= 0) {
+            ComputeScratchKey(fScratchType, key);
+        }
+    }
+
+    size_t onGpuMemorySize() const override { return kSize; }
     const char* getResourceType() const override { return "bench"; }
+
+    int fScratchType;
+
     typedef GrGpuResource INHERITED;
 };
 
@@ -156,6 +174,105 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Purges the oldest scratch resources from a cache that also holds many older uniquely keyed
+// resources, the way GrContext::purgeUnlockedResources(bytes, true) does.
+class GrResourceCacheBenchPurgeScratch : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+protected:
+    const char* onGetName() override {
+        return "grresourcecache_purge_scratch_100k";
+    }
+
+    void onDelayedSetup() override {
+        fContext = GrContext::MakeMock(nullptr);
+        if (!fContext) {
+            return;
+        }
+        fContext->setResourceCacheLimits(2 * kResourceCount, 1 << 30);
+        populate_cache(fContext->contextPriv().getGpu(), kResourceCount, 1);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        if (!fContext) {
+            return;
+        }
+        GrResourceCache* cache = fContext->contextPriv().getResourceCache();
+        GrGpu* gpu = fContext->contextPriv().getGpu();
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < kScratchCount; ++j) {
+                (new BenchResource(gpu, j))->unref();
+            }
+            cache->purgeUnlockedResources(kScratchCount * BenchResource::kSize, true);
+            SkASSERT(kResourceCount == cache->getResourceCount());
+        }
+    }
+
+private:
+    static constexpr int kResourceCount = 100000;
+    static constexpr int kScratchCount = 100;
+
+    sk_sp<GrContext> fContext;
+    typedef Benchmark INHERITED;
+};
+
+// Looks up scratch resources whose keys are shared by many resources that are still in use.
+class GrResourceCacheBenchFindScratch : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+protected:
+    const char* onGetName() override {
+        return "grresourcecache_find_scratch_100k";
+    }
+
+    void onDelayedSetup() override {
+        fContext = GrContext::MakeMock(nullptr);
+        if (!fContext) {
+            return;
+        }
+        fContext->setResourceCacheLimits(2 * kResourceCount, 1 << 30);
+        GrGpu* gpu = fContext->contextPriv().getGpu();
+        // The first resources made for each key are freed and the rest stay in use.
+        for (int i = 0; i < kResourceCount; ++i) {
+            GrGpuResource* resource = new BenchResource(gpu, i % kScratchTypeCount);
+            if (i < kResourceCount / 10) {
+                resource->unref();
+            } else {
+                fInUse.push_back(sk_sp<GrGpuResource>(resource));
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        if (!fContext) {
+            return;
+        }
+        GrResourceCache* cache = fContext->contextPriv().getResourceCache();
+        for (int i = 0; i < loops; ++i) {
+            for (int type = 0; type < kScratchTypeCount; ++type) {
+                GrScratchKey key;
+                BenchResource::ComputeScratchKey(type, &key);
+                sk_sp<GrGpuResource> resource(
+                        cache->findAndRefScratchResource(key, BenchResource::kSize, 0));
+                SkASSERT(resource);
+            }
+        }
+    }
+
+private:
+    static constexpr int kResourceCount = 100000;
+    static constexpr int kScratchTypeCount = 16;
+
+    sk_sp<GrContext>                fContext;
+    // Declared after fContext so that these are released first.
+    SkTArray<sk_sp<GrGpuResource>>  fInUse;
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH( return new GrResourceCacheBenchAdd(1); )
 #ifdef SK_RELEASE
 // Only on release because on debug the SkTDynamicHash validation is too slow.
@@ -182,3 +299,6 @@ DEF_BENCH( return new GrResourceCacheBenchFind(54); )
 DEF_BENCH( return new GrResourceCacheBenchFind(55); )
 DEF_BENCH( return new GrResourceCacheBenchFind(56); )
 #endif
+
+DEF_BENCH( return new GrResourceCacheBenchPurgeScratch(); )
+DEF_BENCH( return new GrResourceCacheBenchFindScratch(); )
@@ -124,6 +124,31 @@ static sk_sp<SkShader> MakeConicalOutsideZeroRad(const SkPoint pts[2], const Gra
                                                  data.fCount, tm);
 }
 
+/// Ignores scale
+static sk_sp<SkShader> MakeConicalConcentric(const SkPoint pts[2], const GradData& data,
+                                             SkShader::TileMode tm, float scale) {
+    SkPoint center;
+    center.set(SkScalarAve(pts[0].fX, pts[1].fX),
+               SkScalarAve(pts[0].fY, pts[1].fY));
+    return SkGradientShader::MakeTwoPointConical(center, (pts[1].fX - pts[0].fX) / 10,
+                                                 center, (pts[1].fX - pts[0].fX) / 2,
+                                                 data.fColors, data.fPos, data.fCount, tm);
+}
+
+/// Ignores scale
+static sk_sp<SkShader> MakeConicalFocalOnCircle(const SkPoint pts[2], const GradData& data,
+                                                SkShader::TileMode tm, float scale) {
+    // The start point lies on the end circle.
+    SkPoint center0, center1;
+    SkScalar radius1 = (pts[1].fX - pts[0].fX) / 4;
+    center0.set(SkScalarAve(pts[0].fX, pts[1].fX),
+                SkScalarAve(pts[0].fY, pts[1].fY));
+    center1.set(center0.fX - radius1, center0.fY);
+    return SkGradientShader::MakeTwoPointConical(center0, 0.0,
+                                                 center1, radius1,
+                                                 data.fColors, data.fPos, data.fCount, tm);
+}
+
 typedef sk_sp<SkShader> (*GradMaker)(const SkPoint pts[2], const GradData& data,
                                      SkShader::TileMode tm, float scale);
 
@@ -138,6 +163,8 @@ static const struct {
     { MakeConicalZeroRad,         "conicalZero" },
     { MakeConicalOutside,         "conicalOut" },
     { MakeConicalOutsideZeroRad,  "conicalOutZero" },
+    { MakeConicalConcentric,      "conicalConcentric" },
+    { MakeConicalFocalOnCircle,   "conicalFocalOnCircle" },
 };
 
 enum GradType { // these must match the order in gGrads
@@ -147,7 +174,9 @@ enum GradType { // these must match the order in gGrads
     kConical_GradType,
     kConicalZero_GradType,
     kConicalOut_GradType,
-    kConicalOutZero_GradType
+    kConicalOutZero_GradType,
+    kConicalConcentric_GradType,
+    kConicalFocalOnCircle_GradType
 };
 
 enum GeomType {
@@ -190,7 +219,8 @@ public:
                   SkShader::TileMode tm = SkShader::kClamp_TileMode,
                   GeomType geomType = kRect_GeomType,
                   float scale = 1.0f)
-        : fGeomType(geomType) {
+        : fGeomType(geomType)
+        , fSize(SkISize::Make(kSize, kSize)) {
 
         fName.printf("gradient_%s_%s", gGrads[gradType].fName,
                      tilemodename(tm));
@@ -209,7 +239,8 @@ public:
     }
 
     GradientBench(GradType gradType, GradData data, bool dither)
-        : fGeomType(kRect_GeomType) {
+        : fGeomType(kRect_GeomType)
+        , fSize(SkISize::Make(kSize, kSize)) {
 
         const char *tmname = tilemodename(SkShader::kClamp_TileMode);
         fName.printf("gradient_%s_%s", gGrads[gradType].fName, tmname);
@@ -224,17 +255,31 @@ public:
         fPaint.setDither(dither);
     }
 
+    // Large fills, where the per-pixel cost of the gradient dominates.
+    GradientBench(GradType gradType, GradData data, SkISize size)
+        : fGeomType(kRect_GeomType)
+        , fSize(size) {
+
+        fName.printf("gradient_%s_%s", gGrads[gradType].fName,
+                     tilemodename(SkShader::kClamp_TileMode));
+        fName.append(data.fName);
+        fName.appendf("_%dx%d", size.width(), size.height());
+
+        this->setupPaint(&fPaint);
+        fPaint.setShader(MakeShader(gradType, data, SkShader::kClamp_TileMode, 1.0f));
+    }
+
 protected:
     const char* onGetName() override {
         return fName.c_str();
     }
 
     SkIPoint onGetSize() override {
-        return SkIPoint::Make(kSize, kSize);
+        return SkIPoint::Make(fSize.width(), fSize.height());
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
-        const SkRect r = SkRect::MakeIWH(kSize, kSize);
+        const SkRect r = SkRect::Make(fSize);
 
         for (int i = 0; i < loops; i++) {
             switch (fGeomType) {
@@ -255,7 +300,7 @@ private:
                                SkShader::TileMode tm, float scale) {
         const SkPoint pts[2] = {
             { 0, 0 },
-            { SkIntToScalar(kSize), SkIntToScalar(kSize) }
+            { SkIntToScalar(fSize.width()), SkIntToScalar(fSize.height()) }
         };
 
         return gGrads[gradType].fMaker(pts, data, tm, scale);
@@ -266,6 +311,7 @@ private:
     SkString       fName;
     SkPaint        fPaint;
     const GeomType fGeomType;
+    const SkISize  fSize;
 };
 
 DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[0]); )
@@ -307,6 +353,20 @@ DEF_BENCH( return new GradientBench(kConicalOut_GradType, gGradData[2]); )
 DEF_BENCH( return new GradientBench(kConicalOutZero_GradType); )
 DEF_BENCH( return new GradientBench(kConicalOutZero_GradType, gGradData[1]); )
 DEF_BENCH( return new GradientBench(kConicalOutZero_GradType, gGradData[2]); )
+DEF_BENCH( return new GradientBench(kConicalConcentric_GradType); )
+DEF_BENCH( return new GradientBench(kConicalConcentric_GradType, gGradData[1]); )
+DEF_BENCH( return new GradientBench(kConicalFocalOnCircle_GradType); )
+DEF_BENCH( return new GradientBench(kConicalFocalOnCircle_GradType, gGradData[1]); )
+
+// 4K UHD fills
+DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[0], SkISize::Make(3840, 2160)); )
+DEF_BENCH( return new GradientBench(kSweep_GradType, gGradData[0], SkISize::Make(3840, 2160)); )
+DEF_BENCH( return new GradientBench(kSweep_GradType, gGradData[2], SkISize::Make(3840, 2160)); )
+DEF_BENCH( return new GradientBench(kConical_GradType, gGradData[0], SkISize::Make(3840, 2160)); )
+DEF_BENCH( return new GradientBench(kConicalConcentric_GradType, gGradData[0],
+                                    SkISize::Make(3840, 2160)); )
+DEF_BENCH( return new GradientBench(kConicalFocalOnCircle_GradType, gGradData[0],
+                                    SkISize::Make(3840, 2160)); )
 
 // Dithering
 DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[3], true); )
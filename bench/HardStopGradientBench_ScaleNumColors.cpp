@@ -30,11 +30,23 @@ static const char* get_tilemode_name(SkShader::TileMode tilemode) {
 
 class HardStopGradientBench_ScaleNumColors : public Benchmark {
 public:
-    HardStopGradientBench_ScaleNumColors(SkShader::TileMode tilemode, int count) {
-        fName.printf("hardstop_scale_num_colors_%s_%03d_colors", get_tilemode_name(tilemode), count);
+    enum Stops {
+        kHardStopAtStart_Stops,
+        kHardStopInMiddle_Stops,
+        kNoHardStop_Stops,
+    };
+
+    HardStopGradientBench_ScaleNumColors(SkShader::TileMode tilemode, int count,
+                                         Stops stops = kHardStopAtStart_Stops,
+                                         bool radial = false) {
+        static const char* kStopsNames[] = { "hardstop_", "hardstop_middle_", "uneven_stops_" };
+        fName.printf("%s%sscale_num_colors_%s_%03d_colors", radial ? "radial_" : "",
+                     kStopsNames[stops], get_tilemode_name(tilemode), count);
 
         fTileMode   = tilemode;
         fColorCount = count;
+        fStops      = stops;
+        fRadial     = radial;
     }
 
     const char* onGetName() override {
@@ -51,6 +63,13 @@ public:
      * different colors. The positions are evenly spaced,
      * with the exception of the first two; these create a
      * hard stop in order to trigger the hard stop code.
+     * kHardStopInMiddle_Stops moves the hard stop to the
+     * middle instead, and kNoHardStop_Stops spaces the
+     * positions unevenly without any hard stop.
+     *
+     * Linear gradients with more than two colors are drawn
+     * by a burst context in raster. Radial gradients are
+     * drawn by the raster pipeline's gradient stages.
      */
     void onPreDraw(SkCanvas* canvas) override {
         // Left to right
@@ -73,22 +92,47 @@ public:
             colors[i] = color_choices[i % kNumColorChoices];
         }
 
-        // Create a hard stop
         SkScalar positions[100];
-        positions[0] = 0.0f;
-        positions[1] = 0.0f;
-        for (int i = 2; i < fColorCount; i++) {
-            // Evenly spaced afterwards
-            positions[i] = i / (fColorCount - 1.0f);
+        switch (fStops) {
+            case kHardStopAtStart_Stops:
+                // Create a hard stop
+                positions[0] = 0.0f;
+                positions[1] = 0.0f;
+                for (int i = 2; i < fColorCount; i++) {
+                    // Evenly spaced afterwards
+                    positions[i] = i / (fColorCount - 1.0f);
+                }
+                break;
+            case kHardStopInMiddle_Stops:
+                for (int i = 0; i < fColorCount; i++) {
+                    positions[i] = i / (fColorCount - 1.0f);
+                }
+                positions[fColorCount / 2] = positions[fColorCount / 2 - 1];
+                break;
+            case kNoHardStop_Stops:
+                for (int i = 0; i < fColorCount; i++) {
+                    float t = i / (fColorCount - 1.0f);
+                    positions[i] = t * t;
+                }
+                break;
         }
 
-        fPaint.setShader(SkGradientShader::MakeLinear(points,
-                                                      colors,
-                                                      positions,
-                                                      fColorCount,
-                                                      fTileMode,
-                                                      0,
-                                                      nullptr));
+        if (fRadial) {
+            fPaint.setShader(SkGradientShader::MakeRadial(SkPoint::Make(kSize/2, kSize/2),
+                                                          kSize/2,
+                                                          colors,
+                                                          positions,
+                                                          fColorCount,
+                                                          fTileMode));
+        } else {
+            fPaint.setShader(SkGradientShader::MakeLinear(points,
+                                                          colors,
+                                                          positions,
+                                                          fColorCount,
+                                                          fTileMode,
+                                                          0,
+                                                          nullptr));
+        }
     }
 
     /*
@@ -106,6 +150,8 @@ private:
     SkShader::TileMode  fTileMode;
     SkString            fName;
     int                 fColorCount;
+    Stops               fStops;
+    bool                fRadial;
     SkPaint             fPaint;
 
     typedef Benchmark INHERITED;
@@ -137,3 +183,36 @@ DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kMirror_Tile
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kMirror_TileMode,  25);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kMirror_TileMode,  50);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kMirror_TileMode, 100);)
+
+// Radial, which reaches the raster pipeline's gradient stages. From 64 stops without hard stops
+// they are looked up in a table.
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  63,
+        HardStopGradientBench_ScaleNumColors::kHardStopAtStart_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  64,
+        HardStopGradientBench_ScaleNumColors::kHardStopAtStart_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode, 100,
+        HardStopGradientBench_ScaleNumColors::kHardStopAtStart_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  63,
+        HardStopGradientBench_ScaleNumColors::kHardStopInMiddle_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  64,
+        HardStopGradientBench_ScaleNumColors::kHardStopInMiddle_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode, 100,
+        HardStopGradientBench_ScaleNumColors::kHardStopInMiddle_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  16,
+        HardStopGradientBench_ScaleNumColors::kNoHardStop_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  50,
+        HardStopGradientBench_ScaleNumColors::kNoHardStop_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  63,
+        HardStopGradientBench_ScaleNumColors::kNoHardStop_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  64,
+        HardStopGradientBench_ScaleNumColors::kNoHardStop_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode, 100,
+        HardStopGradientBench_ScaleNumColors::kNoHardStop_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kRepeat_TileMode,  16,
+        HardStopGradientBench_ScaleNumColors::kNoHardStop_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kRepeat_TileMode,  63,
+        HardStopGradientBench_ScaleNumColors::kNoHardStop_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kRepeat_TileMode,  64,
+        HardStopGradientBench_ScaleNumColors::kNoHardStop_Stops, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kRepeat_TileMode, 100,
+        HardStopGradientBench_ScaleNumColors::kNoHardStop_Stops, true);)
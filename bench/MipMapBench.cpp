@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "SkBitmap.h"
+#include "SkExecutor.h"
 #include "SkMipMap.h"
 
 class MipMapBench: public Benchmark {
@@ -14,15 +15,22 @@ class MipMapBench: public Benchmark {
     SkString fName;
     const int fW, fH;
     bool fHalfFoat;
+    // Large levels are built on the default executor. Unless fThreads is 0, it is replaced by a
+    // thread pool with this many threads while drawing; 1 builds them on the calling thread.
+    const int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MipMapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipMapBench(int w, int h, bool halfFloat = false, int threads = 0)
+        : fW(w), fH(h), fHalfFoat(halfFloat), fThreads(threads)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
         if (halfFloat) {
             fName.append("_f16");
         }
+        if (threads) {
+            fName.appendf("_%dthread%s", threads, threads > 1 ? "s" : "");
+        }
     }
 
 protected:
@@ -38,12 +46,20 @@ protected:
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+        if (fThreads > 1) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
+        SkExecutor* defaultExecutor = &SkExecutor::GetDefault();
+        if (fThreads) {
+            SkExecutor::SetDefault(fExecutor.get());
+        }
         for (int i = 0; i < loops * 4; i++) {
             SkMipMap::Build(fBitmap, nullptr)->unref();
         }
+        SkExecutor::SetDefault(defaultExecutor);
     }
 
 private:
@@ -65,3 +81,11 @@ DEF_BENCH( return new MipMapBench(2048, 2048); )
 DEF_BENCH( return new MipMapBench(2047, 2047); )
 DEF_BENCH( return new MipMapBench(2048, 2047); )
 DEF_BENCH( return new MipMapBench(2047, 2048); )
+
+// 8K sources, which are large enough for their upper levels to be built on multiple threads.
+DEF_BENCH( return new MipMapBench(8192, 8192, false, 1); )
+DEF_BENCH( return new MipMapBench(8192, 8192, false, 4); )
+DEF_BENCH( return new MipMapBench(7680, 4320, false, 1); )
+DEF_BENCH( return new MipMapBench(7680, 4320, false, 4); )
+DEF_BENCH( return new MipMapBench(7680, 4320, true, 1); )
+DEF_BENCH( return new MipMapBench(7680, 4320, true, 4); )
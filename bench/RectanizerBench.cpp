@@ -12,16 +12,19 @@
 
 #include "GrRectanizer_pow2.h"
 #include "GrRectanizer_skyline.h"
+#include "GrRectanizer_wastemap.h"
 
 /**
  * This bench exercises Ganesh' GrRectanizer classes. It exercises the following
  * rectanizers:
  *      Pow2 Rectanizer
  *      Skyline Rectanizer
+ *      Waste Map Rectanizer
  * in the following cases:
  *      random rects (e.g., pull-save-layers forward use case)
  *      random power of two rects
  *      small constant sized power of 2 rects (e.g., glyph cache use case)
+ *      small random rects (e.g., glyph and CCPR atlas use case)
  */
 class RectanizerBench : public Benchmark {
 public:
@@ -31,12 +34,14 @@ public:
     enum RectanizerType {
         kPow2_RectanizerType,
         kSkyline_RectanizerType,
+        kWasteMap_RectanizerType,
     };
 
     enum RectType {
         kRand_RectType,
         kRandPow2_RectType,
-        kSmallPow2_RectType
+        kSmallPow2_RectType,
+        kSmallRand_RectType
     };
 
     RectanizerBench(RectanizerType rectanizerType, RectType rectType)
@@ -46,18 +51,22 @@ public:
 
         if (kPow2_RectanizerType == fRectanizerType) {
             fName.append("pow2_");
-        } else {
-            SkASSERT(kSkyline_RectanizerType == fRectanizerType);
+        } else if (kSkyline_RectanizerType == fRectanizerType) {
             fName.append("skyline_");
+        } else {
+            SkASSERT(kWasteMap_RectanizerType == fRectanizerType);
+            fName.append("wastemap_");
         }
 
         if (kRand_RectType == fRectType) {
             fName.append("rand");
         } else if (kRandPow2_RectType == fRectType) {
             fName.append("rand2");
-        } else {
-            SkASSERT(kSmallPow2_RectType == fRectType);
+        } else if (kSmallPow2_RectType == fRectType) {
             fName.append("sm2");
+        } else {
+            SkASSERT(kSmallRand_RectType == fRectType);
+            fName.append("smrand");
         }
     }
 
@@ -75,9 +84,11 @@ protected:
 
         if (kPow2_RectanizerType == fRectanizerType) {
             fRectanizer.reset(new GrRectanizerPow2(kWidth, kHeight));
-        } else {
-            SkASSERT(kSkyline_RectanizerType == fRectanizerType);
+        } else if (kSkyline_RectanizerType == fRectanizerType) {
             fRectanizer.reset(new GrRectanizerSkyline(kWidth, kHeight));
+        } else {
+            SkASSERT(kWasteMap_RectanizerType == fRectanizerType);
+            fRectanizer.reset(new GrRectanizerWasteMap(kWidth, kHeight));
         }
     }
 
@@ -93,9 +104,11 @@ protected:
             } else if (kRandPow2_RectType == fRectType) {
                 size = SkISize::Make(GrNextPow2(rand.nextRangeU(1, kWidth / 2)),
                                      GrNextPow2(rand.nextRangeU(1, kHeight / 2)));
-            } else {
-                SkASSERT(kSmallPow2_RectType == fRectType);
+            } else if (kSmallPow2_RectType == fRectType) {
                 size = SkISize::Make(128, 128);
+            } else {
+                SkASSERT(kSmallRand_RectType == fRectType);
+                size = SkISize::Make(rand.nextRangeU(4, 32), rand.nextRangeU(4, 32));
             }
 
             if (!fRectanizer->addRect(size.fWidth, size.fHeight, &loc)) {
@@ -132,3 +145,13 @@ DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
                                      RectanizerBench::kRandPow2_RectType);)
 DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
                                      RectanizerBench::kSmallPow2_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
+                                     RectanizerBench::kSmallRand_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kWasteMap_RectanizerType,
+                                     RectanizerBench::kRand_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kWasteMap_RectanizerType,
+                                     RectanizerBench::kRandPow2_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kWasteMap_RectanizerType,
+                                     RectanizerBench::kSmallPow2_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kWasteMap_RectanizerType,
+                                     RectanizerBench::kSmallRand_RectType);)
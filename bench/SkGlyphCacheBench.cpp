@@ -109,7 +109,53 @@ private:
     SkString fName;
 };
 
+// Rasterizes every subpixel position of each glyph into a new strike, which is where subpixel
+// images are compared so that identical ones can be shared.
+class SkGlyphCacheSubpixelImages : public Benchmark {
+public:
+    explicit SkGlyphCacheSubpixelImages(SkPaint::Hinting hinting) : fHinting(hinting) { }
+
+protected:
+    const char* onGetName() override {
+        fName.printf("SkGlyphCacheSubpixelImages_%s",
+                     fHinting == SkPaint::kFull_Hinting ? "full" : "slight");
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setSubpixelText(true);
+        paint.setHinting(fHinting);
+        paint.setTextSize(18);
+        paint.setTypeface(sk_tool_utils::create_portable_typeface("serif", SkFontStyle()));
+
+        for (int work = 0; work < loops; work++) {
+            SkGraphics::PurgeFontCache();
+            auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(
+                    paint, nullptr, SkScalerContextFlags::kNone, nullptr);
+            for (int c = ' '; c < 'z'; c++) {
+                SkGlyphID glyph = cache->unicharToGlyph(c);
+                for (SkFixed x = 0; x < SK_Fixed1; x += SK_Fixed1 / 4) {
+                    cache->findImage(cache->getGlyphIDMetrics(glyph, x, 0));
+                }
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+    const SkPaint::Hinting fHinting;
+    SkString fName;
+};
+
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheSubpixelImages(SkPaint::kSlight_Hinting); )
+DEF_BENCH( return new SkGlyphCacheSubpixelImages(SkPaint::kFull_Hinting); )
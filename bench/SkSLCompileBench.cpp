@@ -0,0 +1,108 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkSLCompiler.h"
+#include "SkSLUtil.h"
+
+// Measures the SkSL front end: creating a Compiler, and converting typical fragment shaders and
+// fragment processors with a Compiler which is reused from one program to the next.
+
+class SkSLCompileBench : public Benchmark {
+public:
+    enum class Mode {
+        kCreateCompiler,
+        kFragment,
+        kFragmentProcessor,
+    };
+
+    SkSLCompileBench(Mode mode) : fMode(mode) {
+        switch (mode) {
+            case Mode::kCreateCompiler:    fName = "sksl_compile_create_compiler"; break;
+            case Mode::kFragment:          fName = "sksl_compile_fragment";        break;
+            case Mode::kFragmentProcessor: fName = "sksl_compile_fp";              break;
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName; }
+
+    void onDelayedSetup() override {
+        fCaps = SkSL::ShaderCapsFactory::Default();
+        fSettings.fCaps = fCaps.get();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        switch (fMode) {
+            case Mode::kCreateCompiler:
+                for (int i = 0; i < loops; ++i) {
+                    SkSL::Compiler compiler;
+                }
+                break;
+            case Mode::kFragment:
+                for (int i = 0; i < loops; ++i) {
+                    std::unique_ptr<SkSL::Program> program = fCompiler.convertProgram(
+                            SkSL::Program::kFragment_Kind,
+                            SkSL::String("in float2 vlocal; uniform half4 tint;"
+                                         "uniform float4 circle; uniform half4 colors[2];"
+                                         "struct Ramp { half4 start; half4 end; };"
+                                         "half4 ramp(Ramp r, half t) {"
+                                         "    return mix(r.start, r.end, t);"
+                                         "}"
+                                         "void main() {"
+                                         "    half d = half(length(vlocal - circle.xy) - circle.z);"
+                                         "    Ramp r;"
+                                         "    r.start = colors[0];"
+                                         "    r.end = colors[1];"
+                                         "    half4 color = ramp(r, fract(half(vlocal.x)));"
+                                         "    for (int j = 0; j < 4; ++j) {"
+                                         "        color.rgb = color.rgb * tint.a + tint.rgb;"
+                                         "    }"
+                                         "    sk_FragColor = color * saturate(0.5 - d);"
+                                         "}"),
+                            fSettings);
+                    SkSL::String glsl;
+                    SkAssertResult(program && fCompiler.toGLSL(*program, &glsl));
+                }
+                break;
+            case Mode::kFragmentProcessor:
+                for (int i = 0; i < loops; ++i) {
+                    std::unique_ptr<SkSL::Program> program = fCompiler.convertProgram(
+                            SkSL::Program::kFragmentProcessor_Kind,
+                            SkSL::String("layout(key) in GrClipEdgeType edgeType;"
+                                         "in float4 circle;"
+                                         "void main() {"
+                                         "    half d = half(length(sk_FragCoord.xy - circle.xy) -"
+                                         "                  circle.z);"
+                                         "    if (edgeType == GrClipEdgeType::kInverseFillAA) {"
+                                         "        d = -d;"
+                                         "    }"
+                                         "    sk_OutColor = sk_InColor * saturate(0.5 - d);"
+                                         "}"),
+                            fSettings);
+                    SkSL::StringStream cpp;
+                    SkAssertResult(program && fCompiler.toCPP(*program, "Circle", cpp));
+                }
+                break;
+        }
+    }
+
+private:
+    Mode                    fMode;
+    const char*             fName;
+    sk_sp<GrShaderCaps>     fCaps;
+    SkSL::Program::Settings fSettings;
+    SkSL::Compiler          fCompiler;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new SkSLCompileBench(SkSLCompileBench::Mode::kCreateCompiler);)
+DEF_BENCH(return new SkSLCompileBench(SkSLCompileBench::Mode::kFragment);)
+DEF_BENCH(return new SkSLCompileBench(SkSLCompileBench::Mode::kFragmentProcessor);)
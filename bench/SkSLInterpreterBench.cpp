@@ -0,0 +1,134 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkArenaAlloc.h"
+#include "SkRasterPipeline.h"
+#include "SkSLByteCode.h"
+#include "SkSLCompiler.h"
+#include "SkSLInterpreter.h"
+#include "../src/jumper/SkJumper.h"
+
+// Runs the same simple color shader (swap red and blue, then halve red, green and blue, leaving
+// alpha alone) over a row of F32 pixels, either as a native SkRasterPipeline stage, as SkSL
+// ByteCode, or through the SkSL tree walking Interpreter. The tree interpreter only sees r, g and
+// b, so the shader never touches alpha.
+
+class SkSLInterpreterBench : public Benchmark {
+public:
+    enum class Mode {
+        kNative,
+        kByteCode,
+        kTree,
+    };
+
+    SkSLInterpreterBench(Mode mode) : fMode(mode) {
+        switch (mode) {
+            case Mode::kNative:   fName = "SkSLInterpreter_native";   break;
+            case Mode::kByteCode: fName = "SkSLInterpreter_bytecode"; break;
+            case Mode::kTree:     fName = "SkSLInterpreter_tree";     break;
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName; }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < kWidth; ++i) {
+            fPixels[i * 4 + 0] = i / (float) kWidth;
+            fPixels[i * 4 + 1] = 0.5f;
+            fPixels[i * 4 + 2] = 1 - i / (float) kWidth;
+            fPixels[i * 4 + 3] = 1;
+        }
+        fCtx = { fPixels, 0 };
+        fPipeline.append(SkRasterPipeline::load_f32, &fCtx);
+        switch (fMode) {
+            case Mode::kNative:
+                fPipeline.append(SkRasterPipeline::matrix_3x4, fSwapAndHalve);
+                break;
+            case Mode::kByteCode: {
+                std::unique_ptr<SkSL::Program> program = fCompiler.convertProgram(
+                        SkSL::Program::kPipelineStage_Kind,
+                        SkSL::String("void main(int x, int y, inout half4 color) {"
+                                     "    color = half4(color.bgr * 0.5, color.a);"
+                                     "}"),
+                        SkSL::Program::Settings());
+                if (!program) {
+                    SkDebugf("%s\n", fCompiler.errorText().c_str());
+                    return;
+                }
+                fByteCode = fCompiler.toByteCode(*program);
+                if (!fByteCode) {
+                    SkDebugf("%s\n", fCompiler.errorText().c_str());
+                    return;
+                }
+                SkSL::ByteCode::AppendStage(*fByteCode->getFunction("main"), &fPipeline,
+                                            &fAlloc);
+                break;
+            }
+            case Mode::kTree: {
+                // The tree interpreter only sees r, g and b, and has no swizzles, so swap by hand.
+                std::unique_ptr<SkSL::Program> program = fCompiler.convertProgram(
+                        SkSL::Program::kPipelineStage_Kind,
+                        SkSL::String("void process(inout float r, inout float g, inout float b) {"
+                                     "    r = r + b;"
+                                     "    b = r - b;"
+                                     "    r = r - b;"
+                                     "    r *= 0.5;"
+                                     "    g *= 0.5;"
+                                     "    b *= 0.5;"
+                                     "}"
+                                     "void appendStages(SkRasterPipeline p) {"
+                                     "    append(p, process);"
+                                     "}"),
+                        SkSL::Program::Settings());
+                if (!program) {
+                    SkDebugf("%s\n", fCompiler.errorText().c_str());
+                    return;
+                }
+                fInterpreter.reset(new SkSL::Interpreter(std::move(program), &fPipeline,
+                                                         &fStack));
+                fInterpreter->run();
+                break;
+            }
+        }
+        fPipeline.append(SkRasterPipeline::store_f32, &fCtx);
+        fReady = true;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fReady) {
+            return;
+        }
+        while (loops --> 0) {
+            fPipeline.run(0, 0, kWidth, 1);
+        }
+    }
+
+private:
+    static constexpr int kWidth = 1024;
+
+    Mode                                  fMode;
+    const char*                           fName;
+    float                                 fPixels[4 * kWidth];
+    // matrix_3x4 is column major: r' = 0.5 * b, g' = 0.5 * g, b' = 0.5 * r.
+    const float                           fSwapAndHalve[12] = { 0,0,0.5f,  0,0.5f,0,  0.5f,0,0,
+                                                                0,0,0 };
+    bool                                  fReady = false;
+    SkJumper_MemoryCtx                    fCtx;
+    SkSTArenaAlloc<4096>                  fAlloc;
+    SkRasterPipeline                      fPipeline{&fAlloc};
+    SkSL::Compiler                        fCompiler;
+    std::unique_ptr<SkSL::ByteCode>       fByteCode;
+    std::vector<SkSL::Interpreter::Value> fStack;
+    std::unique_ptr<SkSL::Interpreter>    fInterpreter;
+};
+
+DEF_BENCH(return new SkSLInterpreterBench(SkSLInterpreterBench::Mode::kNative);)
+DEF_BENCH(return new SkSLInterpreterBench(SkSLInterpreterBench::Mode::kByteCode);)
+DEF_BENCH(return new SkSLInterpreterBench(SkSLInterpreterBench::Mode::kTree);)
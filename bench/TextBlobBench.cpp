@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "Resources.h"
 #include "SkCanvas.h"
+#include "SkGlyphRun.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkStream.h"
@@ -46,6 +47,16 @@ public:
         return fBuilder.make();
     }
 
+    // A blob which is positioned by its glyphs' advances, like most blobs made from strings.
+    sk_sp<SkTextBlob> makeDefaultPositionedBlob() {
+        for (int line = 0; line < 4; line++) {
+            const SkTextBlobBuilder::RunBuffer& run =
+                fBuilder.allocRun(fPaint, fGlyphs.count(), 10, 20 * (line + 1));
+            memcpy(run.glyphs, fGlyphs.begin(), fGlyphs.count() * sizeof(uint16_t));
+        }
+        return fBuilder.make();
+    }
+
 private:
     SkTextBlobBuilder    fBuilder;
     SkPaint              fPaint;
@@ -84,5 +95,44 @@ class TextBlobFirstTimeBench : public SkTextBlobBench {
     }
 };
 
+class TextBlobRepeatedBench : public SkTextBlobBench {
+    const char* onGetName() override {
+        return "TextBlobRepeatedBench";
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+
+        auto blob = this->makeDefaultPositionedBlob();
+        for (int i = 0; i < loops; i++) {
+            canvas->drawTextBlob(blob, 0, 0, paint);
+        }
+    }
+};
+
+// Only builds the glyph runs which every draw of a blob starts with. The default positioned runs
+// are resolved by the first draw, so later draws don't look up any advances.
+class TextBlobGlyphRunsBench : public SkTextBlobBench {
+    const char* onGetName() override {
+        return "TextBlobGlyphRunsBench";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+
+        auto blob = this->makeDefaultPositionedBlob();
+        SkGlyphRunBuilder builder;
+        for (int i = 0; i < loops; i++) {
+            builder.drawTextBlob(paint, *blob, SkPoint::Make(0, 0));
+        }
+    }
+};
+
 DEF_BENCH( return new TextBlobCachedBench(); )
 DEF_BENCH( return new TextBlobFirstTimeBench(); )
+DEF_BENCH( return new TextBlobRepeatedBench(); )
+DEF_BENCH( return new TextBlobGlyphRunsBench(); )
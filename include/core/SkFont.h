@@ -12,6 +12,7 @@
 #include "SkScalar.h"
 
 class SkPaint;
+struct SkRect;
 class SkTypeface;
 
 enum SkTextEncoding {
@@ -99,7 +100,30 @@ public:
 
         kVertical_Flag              = 1 << 4,
 
+        /**
+         *  Hint the outlines lightly, as SkPaint's kSlight_Hinting does.
+         */
+        kEnableSlightHints_Flag     = 1 << 5,
+
         kEmbolden_Flag              = 1 << 6,
+
+        /**
+         *  Hint the outlines, as SkPaint's kNormal_Hinting does. kEnableByteCodeHints_Flag is
+         *  SkPaint's kFull_Hinting. If several hinting flags are set the strongest is used; if none
+         *  are, the outlines are not hinted.
+         */
+        kEnableNormalHints_Flag     = 1 << 7,
+
+        /**
+         *  Position glyphs at fractional offsets, as SkPaint's kSubpixelText_Flag does.
+         */
+        kSubpixel_Flag              = 1 << 8,
+
+        /**
+         *  Use unrounded, unhinted advances, as SkPaint's kLinearText_Flag does. This is set
+         *  independently of kSubpixel_Flag; kUseNonlinearMetrics_Flag is set when neither is.
+         */
+        kLinearMetrics_Flag         = 1 << 9,
     };
 
     enum MaskType {
@@ -134,6 +158,8 @@ public:
     bool isEnableAutoHints() const { return SkToBool(fFlags & kEnableAutoHints_Flag); }
     bool isEnableByteCodeHints() const { return SkToBool(fFlags & kEnableByteCodeHints_Flag); }
     bool isUseNonLinearMetrics() const { return SkToBool(fFlags & kUseNonlinearMetrics_Flag); }
+    bool isSubpixel() const { return SkToBool(fFlags & kSubpixel_Flag); }
+    bool isLinearMetrics() const { return SkToBool(fFlags & kLinearMetrics_Flag); }
 
     int textToGlyphs(const void* text, size_t byteLength, SkTextEncoding,
                      SkGlyphID glyphs[], int maxGlyphCount) const;
@@ -144,10 +170,18 @@ public:
 
     SkScalar measureText(const void* text, size_t byteLength, SkTextEncoding) const;
 
+    /**
+     *  Returns the advance and the bounds (relative to the glyph's origin) of each glyph. All of
+     *  the glyphs are looked up with a single checkout of the glyph cache, so this is cheaper than
+     *  measuring them one at a time. widths and bounds may be nullptr.
+     */
+    void getWidths(const SkGlyphID glyphs[], int count, SkScalar widths[],
+                   SkRect bounds[] = nullptr) const;
+
     static sk_sp<SkFont> Testing_CreateFromPaint(const SkPaint&);
 
 private:
-    static constexpr int kAllFlags = 0xFF;
+    static constexpr int kAllFlags = 0x3FF;
 
     SkFont(sk_sp<SkTypeface>, SkScalar size, SkScalar scaleX, SkScalar skewX, MaskType,
            uint32_t flags);
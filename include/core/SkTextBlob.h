@@ -26,6 +26,7 @@
 
 struct SkSerialProcs;
 struct SkDeserialProcs;
+struct SkTextBlobResolvedRuns;
 
 /** \class SkTextBlob
     SkTextBlob combines multiple text runs into an immutable container. Each text
@@ -167,6 +168,9 @@ private:
     const uint32_t                fUniqueID;
     mutable std::atomic<uint32_t> fCacheID;
 
+    // Set by the first draw of the blob, see SkTextBlobPriv::SetResolvedRuns().
+    mutable std::atomic<SkTextBlobResolvedRuns*> fResolvedRuns;
+
     SkDEBUGCODE(size_t fStorageSize;)
 
     // The actual payload resides in externally-managed storage, following the object.
@@ -51,6 +51,7 @@ class GrTextureProxy;
 class GrVertexBuffer;
 struct GrVkBackendContext;
 
+class SkExecutor;
 class SkImage;
 class SkSurfaceCharacterization;
 class SkSurfaceProps;
@@ -275,6 +276,15 @@ public:
     GrSemaphoresSubmitted flushAndSignalSemaphores(int numSemaphores,
                                                    GrBackendSemaphore signalSemaphores[]);
 
+    /**
+     * Warms up the shader cache from a previous run. keys are keys which the GrContextOptions'
+     * PersistentCache was asked to store(); the corresponding data is load()ed again and any
+     * shaders it describes are compiled ahead of their first use. If the context has an executor
+     * the work is spread across its threads and this returns without waiting for it. Returns the
+     * number of programs that will be precompiled; keys which don't describe one are ignored.
+     */
+    int precompileShaders(const sk_sp<SkData> keys[], int count);
+
     /**
      * An ID associated with this context, guaranteed to be unique.
      */
@@ -326,6 +336,7 @@ private:
     // GrRenderTargetContexts.  It is also passed to the GrResourceProvider and SkGpuDevice.
     mutable GrSingleOwner                   fSingleOwner;
 
+    SkExecutor*                             fExecutor = nullptr;
     std::unique_ptr<SkTaskGroup>            fTaskGroup;
 
     const uint32_t                          fUniqueID;
@@ -171,6 +171,16 @@ struct GrContextOptions {
      */
     Enable fSortRenderTargets = Enable::kDefault;
 
+    /**
+     * Bounds how many previously recorded ops are examined when looking for an op to combine a new
+     * op with, and how many following ops are examined when combining ops as a render target's
+     * op list is closed. Larger values allow more combining of interleaved draws at the cost of
+     * more time spent recording. Negative values select Ganesh's defaults and zero disables the
+     * respective search.
+     */
+    int fMaxOpCombineLookback = -1;
+    int fMaxOpCombineLookahead = -1;
+
     /**
      * Some ES3 contexts report the ES2 external image extension, but not the ES3 version.
      * If support for external images is critical, enabling this option will cause Ganesh to limit
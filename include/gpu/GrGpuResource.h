@@ -10,6 +10,7 @@
 
 #include "../private/GrTypesPriv.h"
 #include "../private/SkNoncopyable.h"
+#include "../private/SkTInternalLList.h"
 #include "GrResourceKey.h"
 
 class GrContext;
@@ -337,6 +338,14 @@ private:
     uint32_t fTimestamp;
     uint32_t fExternalFlushCntWhenBecamePurgeable;
     GrStdSteadyClock::time_point fTimeWhenBecamePurgeable;
+    // Links in the cache's list of purgeable resources, which is kept in the order they became
+    // purgeable. This is maintained by the cache.
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(GrGpuResource);
+    // Links in the cache's list of scratch resources with this resource's scratch key. This is
+    // maintained by the cache. Together with the links above they add four pointers to each
+    // resource, in exchange for constant time updates of both lists.
+    GrGpuResource* fScratchPrev = nullptr;
+    GrGpuResource* fScratchNext = nullptr;
 
     static const size_t kInvalidGpuMemorySize = ~static_cast<size_t>(0);
     GrScratchKey fScratchKey;
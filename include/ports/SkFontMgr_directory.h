@@ -18,4 +18,11 @@ class SkFontMgr;
  */
 SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir);
 
+/** Like SkFontMgr_New_Custom_Directory, but the results of scanning the font files are saved to
+ *  scanCachePath and reused by later font managers for files whose size and modification time
+ *  have not changed. Files which are not in the cache are scanned in parallel with SkTaskGroup.
+ *  If scanCachePath is null no cache is used.
+ */
+SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir, const char* scanCachePath);
+
 #endif // SkFontMgr_directory_DEFINED
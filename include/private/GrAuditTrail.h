@@ -117,6 +117,17 @@ public:
     void getBoundsByClientID(SkTArray<OpInfo>* outInfo, int clientID);
     void getBoundsByOpListID(OpInfo* outInfo, int opListID);
 
+    // Summarizes how effective op combining was, per op name, for all of the ops collected since
+    // the last reset. fRecorded counts every op that was added and fCombined counts the ops left
+    // once combining consumed some of them.
+    struct OpCount {
+        SkString fName;
+        int      fRecorded;
+        int      fCombined;
+    };
+
+    void getOpCounts(SkTArray<OpCount>* outCounts) const;
+
     void fullReset();
 
     static const int kGrAuditTrailInvalidID;
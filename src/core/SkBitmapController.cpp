@@ -19,12 +19,133 @@
 SkBitmapController::State* SkBitmapController::RequestBitmap(const SkBitmapProvider& provider,
                                                              const SkMatrix& inv,
                                                              SkFilterQuality quality,
-                                                             SkArenaAlloc* alloc) {
-    auto* state = alloc->make<SkBitmapController::State>(provider, inv, quality);
+                                                             SkArenaAlloc* alloc,
+                                                             bool allowAnisotropic) {
+    auto* state = alloc->make<SkBitmapController::State>(provider, inv, quality,
+                                                         allowAnisotropic);
 
     return state->pixmap().addr() ? state : nullptr;
 }
 
+// Footprints whose major axis is at least this many times longer than their minor axis are
+// sampled anisotropically, with up to kMaxAnisotropicTaps taps. Affine draws make up for fewer
+// taps with a smaller mip level. Perspective draws sample the full image, so each tap there costs
+// about as much as another bilinear draw of it.
+static constexpr SkScalar kMinAnisotropy = 2;
+static constexpr int kMaxAnisotropicTaps = 4;
+
+// Measures the sides of a destination pixel's footprint in the source, from the derivatives of
+// the inverse matrix. With perspective the footprint varies, so this measures it where each
+// corner of the source is drawn, and returns the one with the longest major axis.
+static bool footprint_axes(const SkMatrix& inv, int width, int height,
+                           SkScalar* minor, SkScalar* major) {
+    if (!inv.hasPerspective()) {
+        SkSize scale;
+        if (!inv.decomposeScale(&scale)) {
+            return false;
+        }
+        *minor = SkTMin(scale.width(), scale.height());
+        *major = SkTMax(scale.width(), scale.height());
+        return true;
+    }
+
+    SkMatrix matrix;
+    if (!inv.invert(&matrix)) {
+        return false;
+    }
+    const SkPoint corners[] = {
+        {0, 0}, {SkIntToScalar(width), 0}, {0, SkIntToScalar(height)},
+        {SkIntToScalar(width), SkIntToScalar(height)},
+    };
+    *minor = *major = 0;
+    for (SkPoint corner : corners) {
+        SkPoint device = matrix.mapXY(corner.fX, corner.fY);
+        SkScalar w = inv[SkMatrix::kMPersp0] * device.fX + inv[SkMatrix::kMPersp1] * device.fY +
+                     inv[SkMatrix::kMPersp2];
+        if (!(w > 0)) {
+            return false;
+        }
+        SkVector dx = {(inv[SkMatrix::kMScaleX] - corner.fX * inv[SkMatrix::kMPersp0]) / w,
+                       (inv[SkMatrix::kMSkewY]  - corner.fY * inv[SkMatrix::kMPersp0]) / w},
+                 dy = {(inv[SkMatrix::kMSkewX]  - corner.fX * inv[SkMatrix::kMPersp1]) / w,
+                       (inv[SkMatrix::kMScaleY] - corner.fY * inv[SkMatrix::kMPersp1]) / w};
+        SkScalar lx = dx.length(),
+                 ly = dy.length();
+        if (SkTMax(lx, ly) > *major) {
+            *minor = SkTMin(lx, ly);
+            *major = SkTMax(lx, ly);
+        }
+    }
+    return SkScalarIsFinite(*major) && *minor > 0;
+}
+
+/*
+ *  Strong non-uniform downscales are sampled with several bilinear taps along the major axis of
+ *  each pixel's footprint. Affine draws use the mip level which matches the minor axis (or the
+ *  major axis split between the taps), so that neither axis aliases or overblurs. Perspective
+ *  draws have no mip level to use, which makes them several times slower than medium quality,
+ *  so they are only sampled this way at high quality.
+ */
+bool SkBitmapController::State::processAnisotropicRequest(const SkBitmapProvider& provider) {
+    if (fQuality < kMedium_SkFilterQuality ||
+        (fInvMatrix.hasPerspective() && fQuality < kHigh_SkFilterQuality)) {
+        return false;
+    }
+
+    SkScalar minor, major;
+    if (!footprint_axes(fInvMatrix, provider.width(), provider.height(), &minor, &major) ||
+        major <= 1 || major < minor * kMinAnisotropy) {
+        return false;
+    }
+
+    const SkScalar levelScale = SkTMax(minor, major / kMaxAnisotropicTaps);
+    if (fInvMatrix.hasPerspective() || levelScale <= 1 ||
+        !this->extractMipLevel(provider, SkSize::Make(SkScalarInvert(levelScale),
+                                                      SkScalarInvert(levelScale)))) {
+        if (!provider.asBitmap(&fResultBitmap)) {
+            return false;
+        }
+    }
+    // The taps are spaced by the footprint in the pixels of the chosen level.
+    (void)footprint_axes(fInvMatrix, fResultBitmap.width(), fResultBitmap.height(),
+                         &minor, &major);
+
+    fQuality = kLow_SkFilterQuality;
+    fAnisotropicTaps = SkTPin(SkScalarCeilToInt(major), 2, kMaxAnisotropicTaps);
+    return true;
+}
+
+bool SkBitmapController::State::extractMipLevel(const SkBitmapProvider& provider,
+                                                const SkSize& scale) {
+    fCurrMip.reset(SkMipMapCache::FindAndRef(provider.makeCacheDesc()));
+    if (nullptr == fCurrMip.get()) {
+        SkBitmap orig;
+        if (!provider.asBitmap(&orig)) {
+            return false;
+        }
+        fCurrMip.reset(SkMipMapCache::AddAndRef(orig));
+        if (nullptr == fCurrMip.get()) {
+            return false;
+        }
+    }
+    // diagnostic for a crasher...
+    SkASSERT_RELEASE(fCurrMip->data());
+
+    SkMipMap::Level level;
+    if (fCurrMip->extractLevel(scale, &level)) {
+        const SkSize& invScaleFixup = level.fScale;
+        fInvMatrix.postScale(invScaleFixup.width(), invScaleFixup.height());
+
+        // todo: if we could wrap the fCurrMip in a pixelref, then we could just install
+        //       that here, and not need to explicitly track it ourselves.
+        return fResultBitmap.installPixels(level.fPixmap);
+    } else {
+        // failed to extract, so release the mipmap
+        fCurrMip.reset(nullptr);
+    }
+    return false;
+}
+
 bool SkBitmapController::State::processHighRequest(const SkBitmapProvider& provider) {
     if (fQuality != kHigh_SkFilterQuality) {
         return false;
@@ -76,45 +197,21 @@ bool SkBitmapController::State::processMediumRequest(const SkBitmapProvider& pro
     }
 
     if (invScaleSize.width() > SK_Scalar1 || invScaleSize.height() > SK_Scalar1) {
-        fCurrMip.reset(SkMipMapCache::FindAndRef(provider.makeCacheDesc()));
-        if (nullptr == fCurrMip.get()) {
-            SkBitmap orig;
-            if (!provider.asBitmap(&orig)) {
-                return false;
-            }
-            fCurrMip.reset(SkMipMapCache::AddAndRef(orig));
-            if (nullptr == fCurrMip.get()) {
-                return false;
-            }
-        }
-        // diagnostic for a crasher...
-        SkASSERT_RELEASE(fCurrMip->data());
-
-        const SkSize scale = SkSize::Make(SkScalarInvert(invScaleSize.width()),
-                                          SkScalarInvert(invScaleSize.height()));
-        SkMipMap::Level level;
-        if (fCurrMip->extractLevel(scale, &level)) {
-            const SkSize& invScaleFixup = level.fScale;
-            fInvMatrix.postScale(invScaleFixup.width(), invScaleFixup.height());
-
-            // todo: if we could wrap the fCurrMip in a pixelref, then we could just install
-            //       that here, and not need to explicitly track it ourselves.
-            return fResultBitmap.installPixels(level.fPixmap);
-        } else {
-            // failed to extract, so release the mipmap
-            fCurrMip.reset(nullptr);
-        }
+        return this->extractMipLevel(provider, SkSize::Make(SkScalarInvert(invScaleSize.width()),
+                                                            SkScalarInvert(invScaleSize.height())));
     }
     return false;
 }
 
 SkBitmapController::State::State(const SkBitmapProvider& provider,
                                  const SkMatrix& inv,
-                                 SkFilterQuality qual) {
+                                 SkFilterQuality qual,
+                                 bool allowAnisotropic) {
     fInvMatrix = inv;
     fQuality = qual;
 
-    if (this->processHighRequest(provider) || this->processMediumRequest(provider)) {
+    if ((allowAnisotropic && this->processAnisotropicRequest(provider)) ||
+        this->processHighRequest(provider) || this->processMediumRequest(provider)) {
         SkASSERT(fResultBitmap.getPixels());
     } else {
         (void)provider.asBitmap(&fResultBitmap);
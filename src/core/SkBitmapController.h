@@ -23,19 +23,29 @@ class SkBitmapController : ::SkNoncopyable {
 public:
     class State : ::SkNoncopyable {
     public:
-        State(const SkBitmapProvider&, const SkMatrix& inv, SkFilterQuality);
+        State(const SkBitmapProvider&, const SkMatrix& inv, SkFilterQuality,
+              bool allowAnisotropic = false);
 
         const SkPixmap& pixmap() const { return fPixmap; }
         const SkMatrix& invMatrix() const { return fInvMatrix; }
         SkFilterQuality quality() const { return fQuality; }
 
+        /**
+         *  If non-zero, the pixmap should be sampled with this many bilinear taps spread along
+         *  the major axis of each pixel's footprint, as computed from invMatrix().
+         */
+        int anisotropicTaps() const { return fAnisotropicTaps; }
+
     private:
+        bool processAnisotropicRequest(const SkBitmapProvider&);
         bool processHighRequest(const SkBitmapProvider&);
         bool processMediumRequest(const SkBitmapProvider&);
+        bool extractMipLevel(const SkBitmapProvider&, const SkSize& scale);
 
         SkPixmap              fPixmap;
         SkMatrix              fInvMatrix;
         SkFilterQuality       fQuality;
+        int                   fAnisotropicTaps = 0;
 
         // Pixmap storage.
         SkBitmap              fResultBitmap;
@@ -43,8 +53,12 @@ public:
 
     };
 
+    /**
+     *  allowAnisotropic should only be set by callers which can sample the result with
+     *  State::anisotropicTaps().
+     */
     static State* RequestBitmap(const SkBitmapProvider&, const SkMatrix& inverse, SkFilterQuality,
-                                SkArenaAlloc*);
+                                SkArenaAlloc*, bool allowAnisotropic = false);
 
 private:
     SkBitmapController() = delete;
@@ -6,12 +6,17 @@
  */
 
 #include "SkColorSpacePriv.h"
+#include "SkColorSpaceXformSteps.h"
 #include "SkConvertPixels.h"
 #include "SkHalf.h"
 #include "SkImageInfoPriv.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 #include "SkOpts.h"
 #include "SkPM4fPriv.h"
+#include "SkPixmap.h"
 #include "SkRasterPipeline.h"
+#include "SkTLazy.h"
 #include "SkUnPreMultiply.h"
 #include "SkUnPreMultiplyPriv.h"
 #include "../jumper/SkJumper.h"
@@ -172,113 +177,194 @@ static void convert_to_alpha8(uint8_t* dst, size_t dstRB, const SkImageInfo& src
 }
 
 // Default: Use the pipeline.
-static void convert_with_pipeline(const SkImageInfo& dstInfo, void* dstRow, size_t dstRB,
-                                  const SkImageInfo& srcInfo, const void* srcRow, size_t srcRB) {
+namespace {
 
-    SkJumper_MemoryCtx src = { (void*)srcRow, (int)(srcRB / srcInfo.bytesPerPixel()) },
-                       dst = { (void*)dstRow, (int)(dstRB / dstInfo.bytesPerPixel()) };
+// Everything SkColorSpaceXformSteps is derived from. Like SkColorSpaceXformSteps, we trust the
+// gamut hashes to tell gamuts apart.
+struct StepsKey {
+    SkColorSpaceTransferFn srcTF,
+                           dstTF;
+    uint32_t               srcGamutHash,
+                           dstGamutHash;
+    uint32_t               gammaFlags;
+    SkAlphaType            srcAT,
+                           dstAT;
 
-    SkRasterPipeline_<256> pipeline;
+    bool operator==(const StepsKey& that) const {
+        return 0 == memcmp(this, &that, sizeof(*this));
+    }
+};
+
+}  // namespace
+
+// Deriving the steps inverts transfer functions and concatenates gamut matrices, which is a good
+// part of the cost of converting a small image. Conversions tend to repeat a handful of color
+// space pairs, so we keep the steps for the most recent ones.
+static constexpr int kMaxCachedSteps = 32;
+
+SK_DECLARE_STATIC_MUTEX(gStepsCacheMutex);
+
+static SkLRUCache<StepsKey, SkColorSpaceXformSteps>& steps_cache() {
+    static auto* cache = new SkLRUCache<StepsKey, SkColorSpaceXformSteps>(kMaxCachedSteps);
+    return *cache;
+}
+
+// Returns false for color spaces without an XYZ gamut, whose steps we don't cache.
+static bool make_steps_key(const SkImageInfo& srcInfo, const SkImageInfo& dstInfo,
+                           StepsKey* key) {
+    // Resolve null color spaces the same way SkColorSpaceXformSteps does.
+    SkColorSpace* src = srcInfo.colorSpace() ? srcInfo.colorSpace() : sk_srgb_singleton();
+    SkColorSpace* dst = dstInfo.colorSpace() ? dstInfo.colorSpace() : src;
+    if (!src->toXYZD50() || !dst->toXYZD50() ||
+        !src->isNumericalTransferFn(&key->srcTF) ||
+        !dst->isNumericalTransferFn(&key->dstTF)) {
+        return false;
+    }
+    key->srcGamutHash = src->toXYZD50Hash();
+    key->dstGamutHash = dst->toXYZD50Hash();
+    key->gammaFlags   = (src->gammaIsLinear()     ? 1 : 0)
+                      | (dst->gammaIsLinear()     ? 2 : 0)
+                      | (src->gammaCloseToSRGB()  ? 4 : 0)
+                      | (dst->gammaCloseToSRGB()  ? 8 : 0);
+    key->srcAT        = srcInfo.alphaType();
+    key->dstAT        = dstInfo.alphaType();
+    return true;
+}
+
+static SkColorSpaceXformSteps find_steps(const SkImageInfo& srcInfo, const SkImageInfo& dstInfo) {
+    StepsKey key;
+    if (!make_steps_key(srcInfo, dstInfo, &key)) {
+        return SkColorSpaceXformSteps(srcInfo.colorSpace(), srcInfo.alphaType(),
+                                      dstInfo.colorSpace(), dstInfo.alphaType());
+    }
+
+    SkAutoMutexAcquire lock(gStepsCacheMutex);
+    if (const SkColorSpaceXformSteps* steps = steps_cache().find(key)) {
+        return *steps;
+    }
+    SkColorSpaceXformSteps steps(srcInfo.colorSpace(), srcInfo.alphaType(),
+                                 dstInfo.colorSpace(), dstInfo.alphaType());
+    steps_cache().insert(key, steps);
+    return steps;
+}
+
+// We'll dither if we're decreasing precision below 32-bit.
+static float dither_rate(const SkImageInfo& dstInfo, const SkImageInfo& srcInfo) {
+    if (srcInfo.bytesPerPixel() > dstInfo.bytesPerPixel()) {
+        switch (dstInfo.colorType()) {
+            case   kRGB_565_SkColorType: return 1/63.0f;
+            case kARGB_4444_SkColorType: return 1/15.0f;
+            default:                     return    0.0f;
+        }
+    }
+    return 0.0f;
+}
+
+// steps and ditherRate are used by the pipeline, so they must outlive it.
+static void append_conversion(SkRasterPipeline* pipeline,
+                              const SkImageInfo& dstInfo, SkJumper_MemoryCtx* dst,
+                              const SkImageInfo& srcInfo, SkJumper_MemoryCtx* src,
+                              const SkColorSpaceXformSteps& steps, const float* ditherRate) {
     switch (srcInfo.colorType()) {
         case kRGBA_8888_SkColorType:
-            pipeline.append(SkRasterPipeline::load_8888, &src);
+            pipeline->append(SkRasterPipeline::load_8888, src);
             break;
         case kRGB_888x_SkColorType:
-            pipeline.append(SkRasterPipeline::load_8888, &src);
-            pipeline.append(SkRasterPipeline::force_opaque);
+            pipeline->append(SkRasterPipeline::load_8888, src);
+            pipeline->append(SkRasterPipeline::force_opaque);
             break;
         case kBGRA_8888_SkColorType:
-            pipeline.append(SkRasterPipeline::load_bgra, &src);
+            pipeline->append(SkRasterPipeline::load_bgra, src);
             break;
         case kRGBA_1010102_SkColorType:
-            pipeline.append(SkRasterPipeline::load_1010102, &src);
+            pipeline->append(SkRasterPipeline::load_1010102, src);
             break;
         case kRGB_101010x_SkColorType:
-            pipeline.append(SkRasterPipeline::load_1010102, &src);
-            pipeline.append(SkRasterPipeline::force_opaque);
+            pipeline->append(SkRasterPipeline::load_1010102, src);
+            pipeline->append(SkRasterPipeline::force_opaque);
             break;
         case kRGB_565_SkColorType:
-            pipeline.append(SkRasterPipeline::load_565, &src);
+            pipeline->append(SkRasterPipeline::load_565, src);
             break;
         case kRGBA_F16_SkColorType:
-            pipeline.append(SkRasterPipeline::load_f16, &src);
+            pipeline->append(SkRasterPipeline::load_f16, src);
             break;
         case kRGBA_F32_SkColorType:
-            pipeline.append(SkRasterPipeline::load_f32, &src);
+            pipeline->append(SkRasterPipeline::load_f32, src);
             break;
         case kGray_8_SkColorType:
-            pipeline.append(SkRasterPipeline::load_g8, &src);
+            pipeline->append(SkRasterPipeline::load_g8, src);
             break;
         case kAlpha_8_SkColorType:
-            pipeline.append(SkRasterPipeline::load_a8, &src);
+            pipeline->append(SkRasterPipeline::load_a8, src);
             break;
         case kARGB_4444_SkColorType:
-            pipeline.append(SkRasterPipeline::load_4444, &src);
+            pipeline->append(SkRasterPipeline::load_4444, src);
             break;
         case kUnknown_SkColorType:
             SkASSERT(false);
             break;
     }
 
-    SkColorSpaceXformSteps steps{srcInfo.colorSpace(), srcInfo.alphaType(),
-                                 dstInfo.colorSpace(), dstInfo.alphaType()};
-    steps.apply(&pipeline);
+    steps.apply(pipeline);
 
-    // We'll dither if we're decreasing precision below 32-bit.
-    float dither_rate = 0.0f;
-    if (srcInfo.bytesPerPixel() > dstInfo.bytesPerPixel()) {
-        switch (dstInfo.colorType()) {
-            case   kRGB_565_SkColorType: dither_rate = 1/63.0f; break;
-            case kARGB_4444_SkColorType: dither_rate = 1/15.0f; break;
-            default:                     dither_rate =    0.0f; break;
-        }
-    }
-    if (dither_rate > 0) {
-        pipeline.append(SkRasterPipeline::dither, &dither_rate);
+    if (*ditherRate > 0) {
+        pipeline->append(SkRasterPipeline::dither, ditherRate);
     }
 
     switch (dstInfo.colorType()) {
         case kRGBA_8888_SkColorType:
-            pipeline.append(SkRasterPipeline::store_8888, &dst);
+            pipeline->append(SkRasterPipeline::store_8888, dst);
             break;
         case kRGB_888x_SkColorType:
-            pipeline.append(SkRasterPipeline::force_opaque);
-            pipeline.append(SkRasterPipeline::store_8888, &dst);
+            pipeline->append(SkRasterPipeline::force_opaque);
+            pipeline->append(SkRasterPipeline::store_8888, dst);
             break;
         case kBGRA_8888_SkColorType:
-            pipeline.append(SkRasterPipeline::store_bgra, &dst);
+            pipeline->append(SkRasterPipeline::store_bgra, dst);
             break;
         case kRGBA_1010102_SkColorType:
-            pipeline.append(SkRasterPipeline::store_1010102, &dst);
+            pipeline->append(SkRasterPipeline::store_1010102, dst);
             break;
         case kRGB_101010x_SkColorType:
-            pipeline.append(SkRasterPipeline::force_opaque);
-            pipeline.append(SkRasterPipeline::store_1010102, &dst);
+            pipeline->append(SkRasterPipeline::force_opaque);
+            pipeline->append(SkRasterPipeline::store_1010102, dst);
             break;
         case kRGB_565_SkColorType:
-            pipeline.append(SkRasterPipeline::store_565, &dst);
+            pipeline->append(SkRasterPipeline::store_565, dst);
             break;
         case kRGBA_F16_SkColorType:
-            pipeline.append(SkRasterPipeline::store_f16, &dst);
+            pipeline->append(SkRasterPipeline::store_f16, dst);
             break;
         case kRGBA_F32_SkColorType:
-            pipeline.append(SkRasterPipeline::store_f32, &dst);
+            pipeline->append(SkRasterPipeline::store_f32, dst);
             break;
         case kARGB_4444_SkColorType:
-            pipeline.append(SkRasterPipeline::store_4444, &dst);
+            pipeline->append(SkRasterPipeline::store_4444, dst);
             break;
         case kAlpha_8_SkColorType:
-            pipeline.append(SkRasterPipeline::store_a8, &dst);
+            pipeline->append(SkRasterPipeline::store_a8, dst);
             break;
         case kGray_8_SkColorType:
-            pipeline.append(SkRasterPipeline::luminance_to_alpha);
-            pipeline.append(SkRasterPipeline::store_a8, &dst);
+            pipeline->append(SkRasterPipeline::luminance_to_alpha);
+            pipeline->append(SkRasterPipeline::store_a8, dst);
             break;
         case kUnknown_SkColorType:
             SkASSERT(false);
             break;
     }
+}
+
+static void convert_with_pipeline(const SkImageInfo& dstInfo, void* dstRow, size_t dstRB,
+                                  const SkImageInfo& srcInfo, const void* srcRow, size_t srcRB) {
+    SkJumper_MemoryCtx src = { (void*)srcRow, (int)(srcRB / srcInfo.bytesPerPixel()) },
+                       dst = { (void*)dstRow, (int)(dstRB / dstInfo.bytesPerPixel()) };
+
+    SkColorSpaceXformSteps steps = find_steps(srcInfo, dstInfo);
+    float ditherRate = dither_rate(dstInfo, srcInfo);
 
+    SkRasterPipeline_<256> pipeline;
+    append_conversion(&pipeline, dstInfo, &dst, srcInfo, &src, steps, &ditherRate);
     pipeline.run(0,0, srcInfo.width(), srcInfo.height());
 }
 
@@ -292,30 +378,92 @@ static bool swizzle_and_multiply_color_type(SkColorType ct) {
     }
 }
 
-void SkConvertPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRB,
-                     const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB) {
-    SkASSERT(dstInfo.dimensions() == srcInfo.dimensions());
-    SkASSERT(SkImageInfoValidConversion(dstInfo, srcInfo));
-
+// Returns false if none of the fast paths apply, and the pipeline is needed.
+static bool convert_with_fast_path(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRB,
+                                   const SkImageInfo& srcInfo, const void* srcPixels,
+                                   size_t srcRB) {
     // Fast Path 1: The memcpy() case.
     if (can_memcpy(dstInfo, srcInfo)) {
         SkRectMemcpy(dstPixels, dstRB, srcPixels, srcRB, dstInfo.minRowBytes(), dstInfo.height());
-        return;
+        return true;
     }
 
     // Fast Path 2: Simple swizzles and premuls.
     if (swizzle_and_multiply_color_type(srcInfo.colorType()) &&
         swizzle_and_multiply_color_type(dstInfo.colorType()) && !dstInfo.colorSpace()) {
         swizzle_and_multiply(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB);
-        return;
+        return true;
     }
 
     // Fast Path 3: Alpha 8 dsts.
     if (kAlpha_8_SkColorType == dstInfo.colorType()) {
         convert_to_alpha8((uint8_t*) dstPixels, dstRB, srcInfo, srcPixels, srcRB);
+        return true;
+    }
+
+    return false;
+}
+
+void SkConvertPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRB,
+                     const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB) {
+    SkASSERT(dstInfo.dimensions() == srcInfo.dimensions());
+    SkASSERT(SkImageInfoValidConversion(dstInfo, srcInfo));
+
+    if (convert_with_fast_path(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB)) {
         return;
     }
 
     // Default: Use the pipeline.
     convert_with_pipeline(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB);
 }
+
+static bool same_format(const SkImageInfo& a, const SkImageInfo& b) {
+    return a.colorType() == b.colorType() &&
+           a.alphaType() == b.alphaType() &&
+           SkColorSpace::Equals(a.colorSpace(), b.colorSpace());
+}
+
+void SkConvertPixmaps(const SkPixmap dst[], const SkPixmap src[], int count) {
+    // The compiled pipeline reads and writes through these, so each pair just repoints them.
+    SkJumper_MemoryCtx srcCtx = { nullptr, 0 },
+                       dstCtx = { nullptr, 0 };
+
+    SkSTArenaAlloc<1024> alloc;
+    std::function<void(size_t, size_t, size_t, size_t)> run;
+    const SkImageInfo* compiledDstInfo = nullptr;
+    const SkImageInfo* compiledSrcInfo = nullptr;
+    SkTLazy<SkColorSpaceXformSteps> steps;
+    float ditherRate = 0;
+
+    for (int i = 0; i < count; i++) {
+        const SkImageInfo& dstInfo = dst[i].info();
+        const SkImageInfo& srcInfo = src[i].info();
+        SkASSERT(dstInfo.dimensions() == srcInfo.dimensions());
+        SkASSERT(SkImageInfoValidConversion(dstInfo, srcInfo));
+
+        if (convert_with_fast_path(dstInfo, dst[i].writable_addr(), dst[i].rowBytes(),
+                                   srcInfo, src[i].addr(), src[i].rowBytes())) {
+            continue;
+        }
+
+        // Compile a pipeline for each run of pixmaps with the same formats.
+        if (!compiledDstInfo ||
+            !same_format(*compiledDstInfo, dstInfo) ||
+            !same_format(*compiledSrcInfo, srcInfo)) {
+            alloc.reset();
+            steps.set(find_steps(srcInfo, dstInfo));
+            ditherRate = dither_rate(dstInfo, srcInfo);
+
+            SkRasterPipeline pipeline(&alloc);
+            append_conversion(&pipeline, dstInfo, &dstCtx, srcInfo, &srcCtx, *steps.get(),
+                              &ditherRate);
+            run = pipeline.compile();
+            compiledDstInfo = &dstInfo;
+            compiledSrcInfo = &srcInfo;
+        }
+
+        srcCtx = { src[i].writable_addr(), (int)(src[i].rowBytes() / srcInfo.bytesPerPixel()) };
+        dstCtx = { dst[i].writable_addr(), (int)(dst[i].rowBytes() / dstInfo.bytesPerPixel()) };
+        run(0,0, srcInfo.width(), srcInfo.height());
+    }
+}
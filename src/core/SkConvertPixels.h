@@ -12,10 +12,16 @@
 #include "SkTemplates.h"
 
 class SkColorTable;
+class SkPixmap;
 
 void SkConvertPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
                      const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRowBytes);
 
+// Converts each src[i] into dst[i], which must have the same dimensions. Consecutive pairs with the
+// same formats share one compiled pipeline, so this is much cheaper than calling SkConvertPixels()
+// for each pair when converting many small images.
+void SkConvertPixmaps(const SkPixmap dst[], const SkPixmap src[], int count);
+
 static inline void SkRectMemcpy(void* dst, size_t dstRB, const void* src, size_t srcRB,
                                 size_t bytesPerRow, int rowCount) {
     SkASSERT(bytesPerRow <= dstRB);
@@ -25,6 +25,23 @@
 #define SK_DistanceFieldMultiplier   "7.96875"
 #define SK_DistanceFieldThreshold    "0.50196078431"
 
+// Distance field text is generated at a few fixed sizes, which are scaled to draw every text size
+// in their range. For example, above kSmallDFFontLimit the medium size is used. The large size is
+// used up until the size at which text is drawn as paths instead, kDefaultMaxDistanceFieldFontSize
+// unless the GPU backend's options say otherwise.
+static const int kSmallDFFontSize = 32;
+static const int kSmallDFFontLimit = 32;
+static const int kMediumDFFontSize = 72;
+static const int kMediumDFFontLimit = 72;
+static const int kLargeDFFontSize = 162;
+
+static const int kDefaultMinDistanceFieldFontSize = 18;
+#ifdef SK_BUILD_FOR_ANDROID
+static const int kDefaultMaxDistanceFieldFontSize = 384;
+#else
+static const int kDefaultMaxDistanceFieldFontSize = 2 * kLargeDFFontSize;
+#endif
+
 /** Given 8-bit mask data, generate the associated distance field
 
  *  @param distanceField     The distance field to be generated. Should already be allocated
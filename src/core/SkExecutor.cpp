@@ -11,6 +11,7 @@
 #include "SkSemaphore.h"
 #include "SkSpinlock.h"
 #include "SkTArray.h"
+#include "SkTaskGroup.h"
 #include <deque>
 #include <thread>
 
@@ -47,6 +48,10 @@ void SkExecutor::SetDefault(SkExecutor* executor) {
     gDefaultExecutor = executor ? executor : &gTrivial;
 }
 
+bool SkTaskGroup::HasDefaultExecutor() {
+    return gDefaultExecutor != &gTrivial;
+}
+
 // We'll always push_back() new work, but pop from the front of deques or the back of SkTArray.
 static inline std::function<void(void)> pop(std::deque<std::function<void(void)>>* list) {
     std::function<void(void)> fn = std::move(list->front());
@@ -115,6 +115,41 @@ SkScalar SkFont::measureText(const void* text, size_t byteLength, SkTextEncoding
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SkPaint.h"
+#include "SkPaintPriv.h"
+
+// The inverse of Testing_CreateFromPaint, used to find the font's glyph cache.
+static void apply_to_paint(const SkFont& font, SkPaint* paint) {
+    paint->setTypeface(sk_ref_sp(font.getTypeface()));
+    paint->setTextSize(font.getSize());
+    paint->setTextScaleX(font.getScaleX());
+    paint->setTextSkewX(font.getSkewX());
+
+    paint->setVerticalText(font.isVertical());
+    paint->setEmbeddedBitmapText(SkToBool(font.getFlags() & SkFont::kEmbeddedBitmaps_Flag));
+    paint->setFakeBoldText(font.isEmbolden());
+    paint->setAutohinted(font.isEnableAutoHints());
+    if (font.isEnableByteCodeHints()) {
+        paint->setHinting(SkPaint::kFull_Hinting);
+    } else if (font.getFlags() & SkFont::kEnableNormalHints_Flag) {
+        paint->setHinting(SkPaint::kNormal_Hinting);
+    } else if (font.getFlags() & SkFont::kEnableSlightHints_Flag) {
+        paint->setHinting(SkPaint::kSlight_Hinting);
+    } else {
+        paint->setHinting(SkPaint::kNo_Hinting);
+    }
+    paint->setSubpixelText(font.isSubpixel());
+    paint->setLinearText(font.isLinearMetrics());
+
+    paint->setAntiAlias(font.getMaskType() != SkFont::kBW_MaskType);
+    paint->setLCDRenderText(font.getMaskType() == SkFont::kLCD_MaskType);
+}
+
+void SkFont::getWidths(const SkGlyphID glyphs[], int count, SkScalar widths[],
+                       SkRect bounds[]) const {
+    SkPaint paint;
+    apply_to_paint(*this, &paint);
+    SkPaintPriv::GetGlyphWidths(paint, glyphs, count, widths, bounds);
+}
 
 sk_sp<SkFont> SkFont::Testing_CreateFromPaint(const SkPaint& paint) {
     uint32_t flags = 0;
@@ -128,15 +163,29 @@ sk_sp<SkFont> SkFont::Testing_CreateFromPaint(const SkPaint& paint) {
         flags |= kEmbolden_Flag;
     }
 
-    if (SkPaint::kFull_Hinting == paint.getHinting()) {
-        flags |= kEnableByteCodeHints_Flag;
+    switch (paint.getHinting()) {
+        case SkPaint::kNo_Hinting:
+            break;
+        case SkPaint::kSlight_Hinting:
+            flags |= kEnableSlightHints_Flag;
+            break;
+        case SkPaint::kNormal_Hinting:
+            flags |= kEnableNormalHints_Flag;
+            break;
+        case SkPaint::kFull_Hinting:
+            flags |= kEnableByteCodeHints_Flag;
+            break;
     }
     if (paint.isAutohinted()) {
         flags |= kEnableAutoHints_Flag;
     }
-    if (paint.isSubpixelText() || paint.isLinearText()) {
-        // this is our default
-    } else {
+    if (paint.isSubpixelText()) {
+        flags |= kSubpixel_Flag;
+    }
+    if (paint.isLinearText()) {
+        flags |= kLinearMetrics_Flag;
+    }
+    if (!paint.isSubpixelText() && !paint.isLinearText()) {
         flags |= kUseNonlinearMetrics_Flag;
     }
 
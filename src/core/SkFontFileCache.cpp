@@ -0,0 +1,136 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkFontFileCache.h"
+#include "SkMakeUnique.h"
+#include "SkMutex.h"
+#include "SkOSFile.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTHash.h"
+#include "SkTraceMemoryDump.h"
+
+namespace {
+
+struct FontFile {
+    size_t        fSize;     // The file's size and modification time when it was read.
+    int64_t       fModTime;
+    sk_sp<SkData> fData;
+    bool          fMapped;
+};
+
+}  // namespace
+
+SK_DECLARE_STATIC_MUTEX(gFontFileMutex);
+static size_t gMappedBytes;
+static size_t gHeapBytes;
+
+static SkTHashMap<SkString, FontFile>& font_files() {
+    static auto* files = new SkTHashMap<SkString, FontFile>;
+    return *files;
+}
+
+// Caller must lock gFontFileMutex before calling this function.
+static void remove_file(const SkString& path) {
+    gFontFileMutex.assertHeld();
+    FontFile* file = font_files().find(path);
+    SkASSERT(file);
+    (file->fMapped ? gMappedBytes : gHeapBytes) -= file->fData->size();
+    font_files().remove(path);
+}
+
+// Caller must lock gFontFileMutex before calling this function.
+static void purge_unused_files() {
+    gFontFileMutex.assertHeld();
+    // Only the cache hands out refs to the files, and it only does so with the mutex held, so a
+    // file which is unique here can't be referenced by anything else.
+    SkTArray<SkString> unused;
+    font_files().foreach([&unused](const SkString& path, FontFile* file) {
+        if (file->fData->unique()) {
+            unused.push_back(path);
+        }
+    });
+    for (const SkString& path : unused) {
+        remove_file(path);
+    }
+}
+
+sk_sp<SkData> SkFontFileCache::Find(const char path[]) {
+    size_t size;
+    int64_t modTime;
+    if (!sk_stat(path, &size, &modTime)) {
+        return nullptr;
+    }
+    SkString key(path);
+    {
+        SkAutoMutexAcquire ama(gFontFileMutex);
+        if (FontFile* file = font_files().find(key)) {
+            if (file->fSize == size && file->fModTime == modTime) {
+                return file->fData;
+            }
+        }
+    }
+
+    // Read the file without the lock, since it may be slow.
+    bool mapped = true;
+    sk_sp<SkData> data = SkData::MakeFromFileName(path);
+    if (!data) {
+        mapped = false;
+        SkFILEStream stream(path);
+        if (!stream.isValid()) {
+            return nullptr;
+        }
+        data = SkData::MakeFromStream(&stream, stream.getLength());
+        if (!data) {
+            return nullptr;
+        }
+    }
+
+    SkAutoMutexAcquire ama(gFontFileMutex);
+    if (FontFile* file = font_files().find(key)) {
+        if (file->fSize == size && file->fModTime == modTime) {
+            // Another thread read the file first.
+            return file->fData;
+        }
+        remove_file(key);
+    }
+    purge_unused_files();
+    (mapped ? gMappedBytes : gHeapBytes) += data->size();
+    font_files().set(std::move(key), FontFile{size, modTime, data, mapped});
+    return data;
+}
+
+std::unique_ptr<SkStreamAsset> SkFontFileCache::OpenStream(const char path[]) {
+    sk_sp<SkData> data = Find(path);
+    if (!data) {
+        return nullptr;
+    }
+    return skstd::make_unique<SkMemoryStream>(std::move(data));
+}
+
+void SkFontFileCache::Purge() {
+    SkAutoMutexAcquire ama(gFontFileMutex);
+    purge_unused_files();
+}
+
+size_t SkFontFileCache::GetMappedBytes() {
+    SkAutoMutexAcquire ama(gFontFileMutex);
+    return gMappedBytes;
+}
+
+size_t SkFontFileCache::GetHeapBytes() {
+    SkAutoMutexAcquire ama(gFontFileMutex);
+    return gHeapBytes;
+}
+
+void SkFontFileCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    static const char kDumpName[] = "skia/sk_font_files";
+    SkAutoMutexAcquire ama(gFontFileMutex);
+    dump->dumpNumericValue(kDumpName, "mapped_size", "bytes", gMappedBytes);
+    dump->dumpNumericValue(kDumpName, "heap_size", "bytes", gHeapBytes);
+    dump->dumpNumericValue(kDumpName, "file_count", "objects", font_files().count());
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFontFileCache_DEFINED
+#define SkFontFileCache_DEFINED
+
+#include "SkData.h"
+#include "SkRefCnt.h"
+
+class SkStreamAsset;
+class SkTraceMemoryDump;
+
+/**
+ *  Shares the contents of font files between all of the typefaces, streams and scaler contexts
+ *  which use them. Each file is mapped read only once, so its pages are shared rather than copied
+ *  to the heap for every user. If a file can't be mapped it is read into the heap, also once.
+ *
+ *  Files are found by path, and a file is read again if its size or modification time changed.
+ *  The cache holds a ref on the contents of every file it has read. Contents which are only
+ *  referenced by the cache are released when new files are added, or by Purge().
+ */
+class SkFontFileCache {
+public:
+    /** Returns the contents of the file at path, or nullptr if it can't be read. */
+    static sk_sp<SkData> Find(const char path[]);
+
+    /** Returns a stream over the contents of the file at path, or nullptr if it can't be read. */
+    static std::unique_ptr<SkStreamAsset> OpenStream(const char path[]);
+
+    /** Releases the files which are not in use outside of the cache. */
+    static void Purge();
+
+    /** The bytes of font files which are mapped, and which had to be copied to the heap. */
+    static size_t GetMappedBytes();
+    static size_t GetHeapBytes();
+
+    static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
+};
+
+#endif
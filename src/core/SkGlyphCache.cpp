@@ -19,6 +19,15 @@ namespace {
 size_t compute_path_size(const SkPath& path) {
     return sizeof(SkPath) + path.countPoints() * sizeof(SkPoint);
 }
+
+// Subpixel positions of an outline usually rasterize to different images, so comparing them is
+// only worth it where they are likely to match: embedded bitmaps ignore the subpixel offset, and
+// full hinting snaps outlines to the pixel grid. Color glyphs are compared in any strike, since
+// they are almost always bitmaps.
+bool shares_subpixel_images(const SkScalerContextRec& rec) {
+    return SkToBool(rec.fFlags & SkScalerContext::kEmbeddedBitmapText_Flag) ||
+           rec.getHinting() == SkPaint::kFull_Hinting;
+}
 }  // namespace
 
 SkGlyphCache::SkGlyphCache(
@@ -30,9 +39,12 @@ SkGlyphCache::SkGlyphCache(
     , fFontMetrics{fontMetrics}
     , fIsSubpixel{fScalerContext->isSubpixel()}
     , fAxisAlignment{fScalerContext->computeAxisAlignmentForHText()}
+    , fSharesSubpixelImages{fIsSubpixel && shares_subpixel_images(fScalerContext->getRec())}
 {
     SkASSERT(fScalerContext != nullptr);
     fMemoryUsed = sizeof(*this);
+    fSharedImageMemory = 0;
+    fScratchImageSize = 0;
 }
 
 SkGlyphCache::~SkGlyphCache() {
@@ -187,7 +199,10 @@ SkGlyph* SkGlyphCache::allocateNewGlyph(SkPackedGlyphID packedGlyphID, MetricsTy
 
 const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
     if (glyph.fWidth > 0 && glyph.fWidth < kMaxGlyphWidth) {
-        if (nullptr == glyph.fImage) {
+        if (nullptr == glyph.fImage && fIsSubpixel &&
+            (fSharesSubpixelImages || glyph.fMaskFormat == SkMask::kARGB32_Format)) {
+            this->generateSubpixelImage(const_cast<SkGlyph*>(&glyph));
+        } else if (nullptr == glyph.fImage) {
             size_t  size = const_cast<SkGlyph&>(glyph).allocImage(&fAlloc);
             // check that alloc() actually succeeded
             if (glyph.fImage) {
@@ -203,6 +218,61 @@ const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
     return glyph.fImage;
 }
 
+// The subpixel positions of a glyph may rasterize to the same image, for instance when the glyph
+// comes from an embedded bitmap (CJK and emoji fonts) or hinting snaps it to the pixel grid. If
+// another position already has an image of the same size, the image is generated into scratch
+// memory, and only copied to the strike if it differs from theirs. Otherwise there is nothing to
+// compare it with, so it is generated straight into the strike.
+void SkGlyphCache::generateSubpixelImage(SkGlyph* glyph) {
+    const int xCount = fAxisAlignment != kY_SkAxisAlignment ? 1 << SkPackedID::kSubBits : 1;
+    const int yCount = fAxisAlignment != kX_SkAxisAlignment ? 1 << SkPackedID::kSubBits : 1;
+    const SkGlyph* candidates[(1 << SkPackedID::kSubBits) * (1 << SkPackedID::kSubBits)];
+    int candidateCount = 0;
+    for (int y = 0; y < yCount; y++) {
+        for (int x = 0; x < xCount; x++) {
+            SkPackedGlyphID id(glyph->getGlyphID(),
+                               x << (16 - SkPackedID::kSubBits), y << (16 - SkPackedID::kSubBits));
+            const SkGlyph* other = fGlyphMap.find(id);
+            if (other != nullptr && other != glyph && other->fImage != nullptr &&
+                other->fMaskFormat == glyph->fMaskFormat &&
+                other->fWidth == glyph->fWidth && other->fHeight == glyph->fHeight &&
+                other->fLeft == glyph->fLeft && other->fTop == glyph->fTop)
+            {
+                candidates[candidateCount++] = other;
+            }
+        }
+    }
+
+    if (candidateCount == 0) {
+        fMemoryUsed += glyph->allocImage(&fAlloc);
+        fScalerContext->getImage(*glyph);
+        return;
+    }
+
+    size_t size = glyph->computeImageSize();
+
+    glyph->fImage = fScratchImage.reset(size, SkAutoMalloc::kReuse_OnShrink);
+    if (size > fScratchImageSize) {
+        // The scratch memory is kept for the life of the strike.
+        fMemoryUsed += size - fScratchImageSize;
+        fScratchImageSize = size;
+    }
+    fScalerContext->getImage(*glyph);
+
+    for (int i = 0; i < candidateCount; i++) {
+        if (0 == memcmp(candidates[i]->fImage, glyph->fImage, size)) {
+            glyph->fImage = candidates[i]->fImage;
+            fSharedImageMemory += size;
+            return;
+        }
+    }
+
+    void* image = fAlloc.makeBytesAlignedTo(size, glyph->formatAlignment());
+    memcpy(image, glyph->fImage, size);
+    glyph->fImage = image;
+    fMemoryUsed += size;
+}
+
 void SkGlyphCache::initializeImage(const volatile void* data, size_t size, SkGlyph* glyph) {
     // Don't overwrite the image if we already have one. We could have used a fallback if the
     // glyph was missing earlier.
@@ -484,17 +554,25 @@ void SkGlyphCache::dump() const {
 
 #ifdef SK_DEBUG
 void SkGlyphCache::forceValidate() const {
-    size_t memoryUsed = sizeof(*this);
-    fGlyphMap.foreach ([&memoryUsed](const SkGlyph& glyph) {
+    size_t memoryUsed = sizeof(*this) + fScratchImageSize;
+    size_t sharedImageMemory = 0;
+    SkTHashSet<const void*> images;
+    fGlyphMap.foreach ([&](const SkGlyph& glyph) {
         memoryUsed += sizeof(SkGlyph);
         if (glyph.fImage) {
-            memoryUsed += glyph.computeImageSize();
+            if (images.contains(glyph.fImage)) {
+                sharedImageMemory += glyph.computeImageSize();
+            } else {
+                images.add(glyph.fImage);
+                memoryUsed += glyph.computeImageSize();
+            }
         }
         if (glyph.fPathData && glyph.fPathData->fPath) {
             memoryUsed += compute_path_size(*glyph.fPathData->fPath);
         }
     });
     SkASSERT(fMemoryUsed == memoryUsed);
+    SkASSERT(fSharedImageMemory == sharedImageMemory);
 }
 
 void SkGlyphCache::validate() const {
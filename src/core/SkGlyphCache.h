@@ -8,6 +8,7 @@
 #define SkGlyphCache_DEFINED
 
 #include "SkArenaAlloc.h"
+#include "SkAutoMalloc.h"
 #include "SkDescriptor.h"
 #include "SkGlyph.h"
 #include "SkGlyphRun.h"
@@ -142,6 +143,9 @@ public:
     /** Return the approx RAM usage for this cache. */
     size_t getMemoryUsed() const { return fMemoryUsed; }
 
+    /** Return the RAM saved by glyphs which share the image of another subpixel position. */
+    size_t getSharedImageMemory() const { return fSharedImageMemory; }
+
     void dump() const;
 
     SkScalerContext* getScalerContext() const { return fScalerContext.get(); }
@@ -205,6 +209,10 @@ private:
     // The id arg is a combined id generated by MakeID.
     CharGlyphRec* getCharGlyphRec(SkPackedUnicharID id);
 
+    // Generate the image of a subpixel positioned glyph, sharing an identical image of one of the
+    // glyph's other subpixel positions if there is one.
+    void generateSubpixelImage(SkGlyph* glyph);
+
     static void OffsetResults(const SkGlyph::Intercept* intercept, SkScalar scale,
                               SkScalar xPos, SkScalar* array, int* count);
     static void AddInterval(SkScalar val, SkGlyph::Intercept* intercept);
@@ -237,9 +245,17 @@ private:
 
     // used to track (approx) how much ram is tied-up in this cache
     size_t                  fMemoryUsed;
+    // images which were not stored because another subpixel position has the same image
+    size_t                  fSharedImageMemory;
+
+    // where subpixel images are generated before looking for an identical one
+    SkAutoMalloc            fScratchImage;
+    size_t                  fScratchImageSize;
 
     const bool              fIsSubpixel;
     const SkAxisAlignment   fAxisAlignment;
+    // whether the images of a glyph's subpixel positions are compared to share identical ones
+    const bool              fSharesSubpixelImages;
 };
 
 #endif  // SkGlyphCache_DEFINED
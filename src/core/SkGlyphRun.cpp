@@ -8,6 +8,7 @@
 #include "SkGlyphRun.h"
 
 #include "SkGlyphCache.h"
+#include "SkMakeUnique.h"
 #include "SkPaint.h"
 #include "SkPaintPriv.h"
 #include "SkStrikeCache.h"
@@ -234,6 +235,21 @@ void SkGlyphRunBuilder::drawPosText(const SkPaint& paint, const void* bytes,
 void SkGlyphRunBuilder::drawTextBlob(const SkPaint& paint, const SkTextBlob& blob, SkPoint origin) {
     SkPaint runPaint = paint;
 
+    // Default positioned runs are positioned by their glyphs' advances, which only depend on the
+    // runs' fonts. They are resolved by the blob's first draw, and reused by the later ones.
+    const SkTextBlobResolvedRuns* resolved = SkTextBlobPriv::GetResolvedRuns(blob);
+    const SkPoint* resolvedPositions = nullptr;
+    const uint16_t* resolvedDenseIndices = nullptr;
+    const SkGlyphID* resolvedUniqueGlyphIDs = nullptr;
+    const size_t* resolvedUniqueGlyphCounts = nullptr;
+    if (resolved != nullptr) {
+        resolvedPositions = resolved->fPositions.get();
+        resolvedDenseIndices = resolved->fDenseIndices.get();
+        resolvedUniqueGlyphIDs = resolved->fUniqueGlyphIDs.get();
+        resolvedUniqueGlyphCounts = resolved->fUniqueGlyphCounts.get();
+    }
+    fScratchDefaultRuns.clear();
+
     // Figure out all the storage needed to pre-size everything below.
     size_t totalGlyphs = 0;
     for (SkTextBlobRunIterator it(&blob); !it.done(); it.next()) {
@@ -264,10 +280,32 @@ void SkGlyphRunBuilder::drawTextBlob(const SkPaint& paint, const SkTextBlob& blo
         size_t uniqueGlyphIDsSize = 0;
         switch (it.positioning()) {
             case SkTextBlobRunIterator::kDefault_Positioning: {
+                if (resolved != nullptr) {
+                    size_t resolvedUniqueSize = *resolvedUniqueGlyphCounts++;
+                    if (resolvedUniqueSize > 0) {
+                        this->makeGlyphRun(
+                                runPaint,
+                                glyphIDs,
+                                SkSpan<const SkPoint>{resolvedPositions, runSize},
+                                SkSpan<const uint16_t>{resolvedDenseIndices, runSize},
+                                SkSpan<const SkGlyphID>{resolvedUniqueGlyphIDs,
+                                                        resolvedUniqueSize},
+                                text,
+                                clusters);
+                    }
+                    resolvedPositions += runSize;
+                    resolvedDenseIndices += runSize;
+                    resolvedUniqueGlyphIDs += resolvedUniqueSize;
+                    break;
+                }
                 uniqueGlyphIDsSize = this->simplifyDrawText(
                         runPaint, glyphIDs, offset,
                         currentDenseIndices, currentUniqueGlyphIDs, currentPositions,
                         text, clusters);
+                fScratchDefaultRuns.push_back({
+                        SkTo<size_t>(currentPositions - fPositions.get()), runSize,
+                        SkTo<size_t>(currentUniqueGlyphIDs - fUniqueGlyphIDs.get()),
+                        uniqueGlyphIDsSize});
             }
                 break;
             case SkTextBlobRunIterator::kHorizontal_Positioning: {
@@ -291,9 +329,45 @@ void SkGlyphRunBuilder::drawTextBlob(const SkPaint& paint, const SkTextBlob& blo
         currentUniqueGlyphIDs += uniqueGlyphIDsSize;
     }
 
+    if (!fScratchDefaultRuns.empty()) {
+        this->resolveDefaultRuns(blob);
+    }
+
     this->makeGlyphRunList(paint, &blob, origin);
 }
 
+void SkGlyphRunBuilder::resolveDefaultRuns(const SkTextBlob& blob) {
+    size_t glyphCount = 0,
+           uniqueGlyphCount = 0;
+    for (const DefaultRun& run : fScratchDefaultRuns) {
+        glyphCount += run.fGlyphCount;
+        uniqueGlyphCount += run.fUniqueGlyphCount;
+    }
+
+    auto resolved = skstd::make_unique<SkTextBlobResolvedRuns>(
+            glyphCount, uniqueGlyphCount, fScratchDefaultRuns.size());
+    SkPoint* positions = resolved->fPositions.get();
+    uint16_t* denseIndices = resolved->fDenseIndices.get();
+    SkGlyphID* uniqueGlyphIDs = resolved->fUniqueGlyphIDs.get();
+    size_t* uniqueGlyphCounts = resolved->fUniqueGlyphCounts.get();
+    for (const DefaultRun& run : fScratchDefaultRuns) {
+        *uniqueGlyphCounts++ = run.fUniqueGlyphCount;
+        // A run without unique glyphs was not made, and its buffers were not filled in.
+        if (run.fUniqueGlyphCount > 0) {
+            memcpy(positions, fPositions.get() + run.fGlyphStart,
+                   run.fGlyphCount * sizeof(SkPoint));
+            memcpy(denseIndices, fUniqueGlyphIDIndices.get() + run.fGlyphStart,
+                   run.fGlyphCount * sizeof(uint16_t));
+            memcpy(uniqueGlyphIDs, fUniqueGlyphIDs.get() + run.fUniqueGlyphStart,
+                   run.fUniqueGlyphCount * sizeof(SkGlyphID));
+        }
+        positions += run.fGlyphCount;
+        denseIndices += run.fGlyphCount;
+        uniqueGlyphIDs += run.fUniqueGlyphCount;
+    }
+    SkTextBlobPriv::SetResolvedRuns(blob, std::move(resolved));
+}
+
 void SkGlyphRunBuilder::drawGlyphPos(
         const SkPaint& paint, SkSpan<const SkGlyphID> glyphIDs, const SkPoint* pos) {
     if (!glyphIDs.empty()) {
@@ -222,6 +222,9 @@ private:
 
     void makeGlyphRunList(const SkPaint& paint, const SkTextBlob* blob, SkPoint origin);
 
+    // Copies the default positioned runs drawn from blob into its resolved runs.
+    void resolveDefaultRuns(const SkTextBlob& blob);
+
     size_t simplifyDrawText(
             const SkPaint& paint, SkSpan<const SkGlyphID> glyphIDs, SkPoint origin,
             uint16_t* uniqueGlyphIDIndices, SkGlyphID* uniqueGlyphIDs, SkPoint* positions,
@@ -257,6 +260,15 @@ private:
 
     // Used for collecting the set of unique glyphs.
     SkGlyphIDSet fGlyphIDSet;
+
+    // Where drawTextBlob put the default positioned runs of a blob which was not resolved yet.
+    struct DefaultRun {
+        size_t fGlyphStart;
+        size_t fGlyphCount;
+        size_t fUniqueGlyphStart;
+        size_t fUniqueGlyphCount;
+    };
+    std::vector<DefaultRun> fScratchDefaultRuns;
 };
 
 template <typename PerGlyphPos>
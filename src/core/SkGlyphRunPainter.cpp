@@ -25,7 +25,10 @@
 #include "SkPaintPriv.h"
 #include "SkPathEffect.h"
 #include "SkRasterClip.h"
+#include "SkRasterPipeline.h"
+#include "SkSDFMaskFilter.h"
 #include "SkStrikeCache.h"
+#include "../jumper/SkJumper.h"
 
 // -- SkGlyphRunListPainter ------------------------------------------------------------------------
 SkGlyphRunListPainter::SkGlyphRunListPainter(
@@ -75,6 +78,42 @@ bool SkGlyphRunListPainter::ShouldDrawAsPath(const SkPaint& paint, const SkMatri
     return SkPaint::TooBigToUseCache(matrix, textM, 1024);
 }
 
+bool SkGlyphRunListPainter::shouldDrawAsSDF(const SkPaint& paint, const SkMatrix& matrix) const {
+    if (!fDeviceProps.isUseDeviceIndependentFonts()) {
+        return false;
+    }
+
+    // mask filters modify alpha, which doesn't translate well to distance
+    if (paint.getMaskFilter() || paint.getStyle() != SkPaint::kFill_Style) {
+        return false;
+    }
+
+    SkASSERT(!matrix.hasPerspective());
+    SkScalar scaledTextSize = matrix.getMaxScale() * paint.getTextSize();
+    // Raster distance field text uses GrTextContext's default size range, see SkDistanceFieldGen.h.
+    return kDefaultMinDistanceFieldFontSize <= scaledTextSize &&
+           scaledTextSize <= kDefaultMaxDistanceFieldFontSize;
+}
+
+static SkPaint make_sdf_paint(const SkPaint& paint, const SkMatrix& matrix, SkScalar* textRatio) {
+    SkScalar textSize = paint.getTextSize();
+    SkScalar scaledTextSize = matrix.getMaxScale() * textSize;
+    int sdfTextSize = scaledTextSize <= kSmallDFFontLimit  ? kSmallDFFontSize
+                    : scaledTextSize <= kMediumDFFontLimit ? kMediumDFFontSize
+                                                           : kLargeDFFontSize;
+    *textRatio = textSize / sdfTextSize;
+
+    SkPaint sdfPaint{paint};
+    sdfPaint.setTextSize(SkIntToScalar(sdfTextSize));
+    sdfPaint.setAntiAlias(true);
+    sdfPaint.setLCDRenderText(false);
+    sdfPaint.setAutohinted(false);
+    sdfPaint.setHinting(SkPaint::kNormal_Hinting);
+    sdfPaint.setSubpixelText(true);
+    sdfPaint.setMaskFilter(SkSDFMaskFilter::Make());
+    return sdfPaint;
+}
+
 bool SkGlyphRunListPainter::ensureBitmapBuffers(size_t runSize) {
     if (runSize > fMaxRunSize) {
         fPositions.reset(runSize);
@@ -233,6 +272,32 @@ void SkGlyphRunListPainter::drawForBitmapDevice(
 
             auto perPath = perPathCreator(paint, matrixScale, &alloc);
             this->drawUsingPaths(glyphRun, origin, pathCache.get(), perPath);
+        } else if (this->shouldDrawAsSDF(paint, deviceMatrix)) {
+            SkScalar textRatio;
+            SkPaint sdfPaint = make_sdf_paint(paint, deviceMatrix, &textRatio);
+            auto sdfCache = SkStrikeCache::FindOrCreateStrikeExclusive(
+                    sdfPaint, &fBitmapFallbackProps, SkScalerContextFlags::kNone, nullptr);
+            auto perMask = perMaskCreator(paint, &alloc);
+
+            // Glyphs without outlines, like color emoji, are drawn from the usual strike.
+            SkExclusiveStrikePtr fallbackCache;
+            auto perFallback = [&](SkGlyphID glyphID, SkPoint position) {
+                if (!fallbackCache) {
+                    fallbackCache = SkStrikeCache::FindOrCreateStrikeExclusive(
+                            paint, &props, fScalerContextFlags, &deviceMatrix);
+                }
+                SkPoint mapped = deviceMatrix.mapXY(position.x(), position.y());
+                mapped += {SK_ScalarHalf, SK_ScalarHalf};
+                if (SkScalarsAreFinite(mapped.fX, mapped.fY)) {
+                    const SkGlyph& glyph = fallbackCache->getGlyphIDMetrics(glyphID);
+                    SkMask mask;
+                    if (prepare_mask(fallbackCache.get(), glyph, mapped, &mask)) {
+                        perMask(mask, glyph, mapped);
+                    }
+                }
+            };
+            this->drawGlyphRunAsSDF(sdfCache.get(), glyphRun, origin, deviceMatrix, textRatio,
+                                    perMask, perFallback);
         } else {
             auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(
                     paint, &props, fScalerContextFlags, &deviceMatrix);
@@ -242,6 +307,95 @@ void SkGlyphRunListPainter::drawForBitmapDevice(
     }
 }
 
+void SkGlyphRunListPainter::drawGlyphRunAsSDF(
+        SkGlyphCache* cache, const SkGlyphRun& glyphRun,
+        SkPoint origin, const SkMatrix& deviceMatrix, SkScalar textRatio,
+        PerMask perMask, PerFallback perFallback) {
+    // Samples a glyph's distance field at each pixel of its device bounds, and stores the
+    // coverage. The contexts are updated for each glyph.
+    SkSTArenaAlloc<512> alloc;
+    float* deviceToTexel = alloc.makeArrayDefault<float>(6);
+    auto sdf = alloc.make<SkJumper_SDFCtx>();
+    auto coverage = alloc.make<SkJumper_MemoryCtx>();
+    SkRasterPipeline pipeline(&alloc);
+    pipeline.append(SkRasterPipeline::seed_shader);
+    pipeline.append(SkRasterPipeline::matrix_2x3, deviceToTexel);
+    pipeline.append(SkRasterPipeline::bilerp_sdf, sdf);
+    pipeline.append(SkRasterPipeline::store_a8, coverage);
+    auto run = pipeline.compile();
+
+    // The distance field's values are distances in texels, biased so that the edge is at 128/255,
+    // and spanning SK_DistanceFieldMagnitude texels either side of it. Scaling the distance to
+    // device pixels and adding a half gives an antialiased edge one pixel wide.
+    SkMatrix runToDevice = deviceMatrix;
+    runToDevice.preScale(textRatio, textRatio);
+    SkScalar pixelsPerTexel = SkScalarSqrt(SkScalarAbs(
+            runToDevice.getScaleX() * runToDevice.getScaleY() -
+            runToDevice.getSkewX()  * runToDevice.getSkewY()));
+    const float distanceMultiplier = SK_DistanceFieldMagnitude * 255.0f / 128.0f;
+    const float distanceThreshold = 128.0f / 255.0f;
+    sdf->scale = distanceMultiplier * pixelsPerTexel;
+    sdf->bias = 0.5f - distanceThreshold * sdf->scale;
+
+    // Keep far away glyphs from overflowing the device bounds.
+    const SkRect deviceLimits = SkRect::MakeLTRB(-(1 << 24), -(1 << 24), 1 << 24, 1 << 24);
+
+    const SkPoint* positionCursor = glyphRun.positions().data();
+    for (auto glyphID : glyphRun.shuntGlyphsIDs()) {
+        SkPoint position = origin + *positionCursor++;
+        const SkGlyph& glyph = cache->getGlyphIDMetrics(glyphID);
+        if (glyph.fWidth == 0) {
+            continue;
+        }
+        if (glyph.fMaskFormat != SkMask::kSDF_Format) {
+            perFallback(glyphID, position);
+            continue;
+        }
+
+        SkMatrix texelToDevice = deviceMatrix;
+        texelToDevice.preTranslate(position.x(), position.y());
+        texelToDevice.preScale(textRatio, textRatio);
+        texelToDevice.preTranslate(glyph.fLeft, glyph.fTop);
+        SkRect deviceRect = texelToDevice.mapRect(SkRect::MakeIWH(glyph.fWidth, glyph.fHeight));
+        if (!deviceLimits.contains(deviceRect)) {
+            continue;
+        }
+        SkIRect bounds = deviceRect.roundOut();
+        SkMatrix inverse;
+        if (bounds.isEmpty() || !texelToDevice.invert(&inverse)) {
+            continue;
+        }
+        const void* image = cache->findImage(glyph);
+        if (image == nullptr) {
+            continue;
+        }
+
+        // The pipeline runs over the mask, so its pixels are offset from the device's.
+        inverse.preTranslate(bounds.fLeft, bounds.fTop);
+        SkAssertResult(inverse.asAffine(deviceToTexel));
+        sdf->gather.pixels = image;
+        sdf->gather.stride = glyph.rowBytes();
+        sdf->gather.width  = glyph.fWidth;
+        sdf->gather.height = glyph.fHeight;
+
+        size_t maskSize = SkToSizeT(bounds.width()) * bounds.height();
+        if (maskSize > fMaxSDFCoverageSize) {
+            fSDFCoverage.reset(maskSize);
+            fMaxSDFCoverageSize = maskSize;
+        }
+        coverage->pixels = fSDFCoverage.get();
+        coverage->stride = bounds.width();
+        run(0, 0, bounds.width(), bounds.height());
+
+        SkMask mask;
+        mask.fImage    = fSDFCoverage.get();
+        mask.fBounds   = bounds;
+        mask.fRowBytes = bounds.width();
+        mask.fFormat   = SkMask::kA8_Format;
+        perMask(mask, glyph, position);
+    }
+}
+
 void SkGlyphRunListPainter::drawUsingMasks(
         SkGlyphCache* cache, const SkGlyphRun& glyphRun,
         SkPoint origin, const SkMatrix& deviceMatrix, PerMask perMask) {
@@ -55,6 +55,7 @@ public:
 
 private:
     static bool ShouldDrawAsPath(const SkPaint& paint, const SkMatrix& matrix);
+    bool shouldDrawAsSDF(const SkPaint& paint, const SkMatrix& matrix) const;
     bool ensureBitmapBuffers(size_t runSize);
 
 
@@ -73,6 +74,14 @@ private:
             SkPoint origin, const SkMatrix& deviceMatrix,
             PerMask perMask);
 
+    // Draws the glyphs of an SDF strike scaled by textRatio, turning each distance field into a
+    // coverage mask in device space. Glyphs which aren't distance fields go to perFallback.
+    using PerFallback = std::function<void(SkGlyphID, SkPoint)>;
+    void drawGlyphRunAsSDF(
+            SkGlyphCache* cache, const SkGlyphRun& glyphRun,
+            SkPoint origin, const SkMatrix& deviceMatrix, SkScalar textRatio,
+            PerMask perMask, PerFallback perFallback);
+
     // The props as on the actual device.
     const SkSurfaceProps fDeviceProps;
     // The props for when the bitmap device can't draw LCD text.
@@ -81,6 +90,9 @@ private:
     const SkScalerContextFlags fScalerContextFlags;
     size_t fMaxRunSize{0};
     SkAutoTMalloc<SkPoint> fPositions;
+
+    size_t fMaxSDFCoverageSize{0};
+    SkAutoTMalloc<uint8_t> fSDFCoverage;
 };
 
 inline static bool glyph_too_big_for_atlas(const SkGlyph& glyph) {
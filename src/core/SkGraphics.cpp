@@ -10,6 +10,7 @@
 #include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkCpu.h"
+#include "SkFontFileCache.h"
 #include "SkGeometry.h"
 #include "SkImageFilter.h"
 #include "SkMath.h"
@@ -54,12 +55,14 @@ void SkGraphics::Init() {
 void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkResourceCache::DumpMemoryStatistics(dump);
   SkStrikeCache::DumpMemoryStatistics(dump);
+  SkFontFileCache::DumpMemoryStatistics(dump);
 }
 
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter::PurgeCache();
+    SkFontFileCache::Purge();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -69,6 +69,17 @@ public:
         return fMap.count();
     }
 
+    /** Returns the least recently used value, or null if the cache is empty. */
+    V* oldest() {
+        return fLRU.tail() ? &fLRU.tail()->fValue : nullptr;
+    }
+
+    /** Removes the least recently used entry. The cache must not be empty. */
+    void removeOldest() {
+        SkASSERT(fLRU.tail());
+        this->remove(fLRU.tail()->fKey);
+    }
+
     template <typename Fn>  // f(V*)
     void foreach(Fn&& fn) {
         typename SkTInternalLList<Entry>::Iter iter;
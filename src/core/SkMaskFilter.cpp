@@ -17,13 +17,13 @@
 #include "SkRRect.h"
 #include "SkRasterClip.h"
 #include "SkReadBuffer.h"
+#include "SkSDFMaskFilter.h"
 #include "SkWriteBuffer.h"
 
 #if SK_SUPPORT_GPU
 #include "GrTextureProxy.h"
 #include "GrFragmentProcessor.h"
 #include "effects/GrXfermodeFragmentProcessor.h"
-#include "text/GrSDFMaskFilter.h"
 #endif
 
 SkMaskFilterBase::NinePatch::~NinePatch() {
@@ -710,7 +710,5 @@ void SkMaskFilter::InitializeFlattenables() {
     SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkComposeMF)
     SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkCombineMF)
     sk_register_blur_maskfilter_createproc();
-#if SK_SUPPORT_GPU
-    gr_register_sdf_maskfilter_createproc();
-#endif
+    sk_register_sdf_maskfilter_createproc();
 }
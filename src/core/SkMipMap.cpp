@@ -14,6 +14,7 @@
 #include "SkMathPriv.h"
 #include "SkNx.h"
 #include "SkPM4fPriv.h"
+#include "SkTaskGroup.h"
 #include "SkTo.h"
 #include "SkTypes.h"
 #include <new>
@@ -301,6 +302,9 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Levels with at least this many pixels are built on multiple threads.
+static constexpr int kMinPixelsPerBand = 256 * 256;
+
 size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     if (levelCount < 0) {
         return 0;
@@ -470,14 +474,31 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
                                          SkIntToScalar(height) / src.height());
 
         const SkPixmap& dstPM = levels[i].fPixmap;
-        const void* srcBasePtr = srcPM.addr();
-        void* dstBasePtr = dstPM.writable_addr();
+        const char* srcBasePtr = (const char*)srcPM.addr();
+        char* dstBasePtr = (char*)dstPM.writable_addr();
 
         const size_t srcRB = srcPM.rowBytes();
-        for (int y = 0; y < height; y++) {
-            proc(dstBasePtr, srcBasePtr, srcRB, width);
-            srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-            dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+        const size_t dstRB = dstPM.rowBytes();
+        auto downsampleRows = [=](int top, int bottom) {
+            const char* srcRow = srcBasePtr + srcRB * 2 * top;
+            char* dstRow = dstBasePtr + dstRB * top;
+            for (int y = top; y < bottom; y++) {
+                proc(dstRow, srcRow, srcRB, width);
+                srcRow += srcRB * 2; // jump two rows
+                dstRow += dstRB;
+            }
+        };
+
+        // Large levels are split into bands of rows, which only read the level above. Without a
+        // default executor the bands would all run here, one after another.
+        const int bands = SkTMin(height, width * height / kMinPixelsPerBand);
+        if (bands > 1 && SkTaskGroup::HasDefaultExecutor()) {
+            SkTaskGroup().batch(bands, [&](int band) {
+                downsampleRows(SkToInt(sk_64_mul(height, band) / bands),
+                               SkToInt(sk_64_mul(height, band + 1) / bands));
+            });
+        } else {
+            downsampleRows(0, height);
         }
         srcPM = dstPM;
         addr += height * rowBytes;
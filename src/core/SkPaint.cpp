@@ -17,6 +17,7 @@
 #include "SkMaskFilter.h"
 #include "SkMaskGamma.h"
 #include "SkMutex.h"
+#include "SkNx.h"
 #include "SkOpts.h"
 #include "SkPaintDefaults.h"
 #include "SkPaintPriv.h"
@@ -866,6 +867,59 @@ static void set_bounds(const SkGlyph& g, SkRect* bounds, SkScalar scale) {
                 (g.fTop + g.fHeight) * scale);
 }
 
+static void scale_widths_and_bounds(SkScalar widths[], SkRect bounds[], int count,
+                                    SkScalar scale) {
+    if (widths) {
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            (Sk4f::Load(widths + i) * scale).store(widths + i);
+        }
+        for (; i < count; ++i) {
+            widths[i] *= scale;
+        }
+    }
+    if (bounds) {
+        static_assert(sizeof(SkRect) == sizeof(Sk4f), "SkRect is four floats");
+        for (int i = 0; i < count; ++i) {
+            (Sk4f::Load(&bounds[i]) * scale).store(&bounds[i]);
+        }
+    }
+}
+
+void SkPaintPriv::GetGlyphWidths(const SkPaint& origPaint, const SkGlyphID glyphs[], int count,
+                                 SkScalar widths[], SkRect bounds[]) {
+    if (count <= 0 || (nullptr == widths && nullptr == bounds)) {
+        return;
+    }
+    SkASSERT(glyphs);
+
+    SkCanonicalizePaint canon(origPaint);
+    const SkPaint& paint = canon.getPaint();
+    SkScalar scale = canon.getScale();
+
+    auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(paint);
+    const int xyIndex = paint.isVerticalText() ? 1 : 0;
+
+    if (bounds) {
+        for (int i = 0; i < count; ++i) {
+            const SkGlyph& g = cache->getGlyphIDMetrics(glyphs[i]);
+            if (widths) {
+                widths[i] = advance(g, xyIndex);
+            }
+            set_bounds(g, &bounds[i]);
+        }
+    } else {
+        // Only the advances are needed, which may be cheaper to compute than the full metrics.
+        for (int i = 0; i < count; ++i) {
+            widths[i] = advance(cache->getGlyphIDAdvance(glyphs[i]), xyIndex);
+        }
+    }
+
+    if (scale) {
+        scale_widths_and_bounds(widths, bounds, count, scale);
+    }
+}
+
 int SkPaint::getTextWidths(const void* textData, size_t byteLength,
                            SkScalar widths[], SkRect bounds[]) const {
     if (0 == byteLength) {
@@ -878,6 +932,13 @@ int SkPaint::getTextWidths(const void* textData, size_t byteLength,
         return this->countText(textData, byteLength);
     }
 
+    if (kGlyphID_TextEncoding == this->getTextEncoding()) {
+        int count = SkToInt(byteLength >> 1);
+        SkPaintPriv::GetGlyphWidths(*this, static_cast<const SkGlyphID*>(textData), count,
+                                    widths, bounds);
+        return count;
+    }
+
     SkCanonicalizePaint canon(*this);
     const SkPaint& paint = canon.getPaint();
     SkScalar scale = canon.getScale();
@@ -52,6 +52,14 @@ public:
 
     static void ScaleFontMetrics(SkPaint::FontMetrics*, SkScalar);
 
+    /**
+     *  Like SkPaint::getTextWidths for glyph IDs, ignoring the paint's text encoding. All of the
+     *  glyphs are looked up with a single checkout of the glyph cache. widths and bounds may be
+     *  nullptr.
+     */
+    static void GetGlyphWidths(const SkPaint&, const SkGlyphID glyphs[], int count,
+                               SkScalar widths[], SkRect bounds[]);
+
     /**
      *  Return a matrix that applies the paint's text values: size, scale, skew
      */
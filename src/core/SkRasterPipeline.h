@@ -35,7 +35,7 @@
  */
 
 #define SK_RASTER_PIPELINE_STAGES(M)                               \
-    M(callback)                                                    \
+    M(callback) M(interpreter)                                     \
     M(move_src_dst) M(move_dst_src)                                \
     M(clamp_0) M(clamp_1) M(clamp_a) M(clamp_a_dst)                \
     M(unpremul) M(premul) M(premul_dst)                            \
@@ -53,7 +53,7 @@
     M(load_8888) M(load_8888_dst) M(store_8888) M(gather_8888)     \
     M(load_bgra) M(load_bgra_dst) M(store_bgra) M(gather_bgra)     \
     M(load_1010102) M(load_1010102_dst) M(store_1010102) M(gather_1010102) \
-    M(bilerp_clamp_8888)                                           \
+    M(bilerp_clamp_8888) M(bilerp_sdf) M(aniso_clamp_8888)         \
     M(store_u16_be)                                                \
     M(load_rgba) M(store_rgba)                                     \
     M(scale_u8) M(scale_565) M(scale_1_float)                      \
@@ -81,10 +81,11 @@
     M(save_xy) M(accumulate)                                       \
     M(clamp_x_1) M(mirror_x_1) M(repeat_x_1)                       \
     M(evenly_spaced_gradient)                                      \
-    M(gradient)                                                    \
+    M(gradient) M(gradient_lut)                                    \
     M(evenly_spaced_2_stop_gradient)                               \
     M(xy_to_unit_angle)                                            \
     M(xy_to_radius)                                                \
+    M(xy_to_2pt_conical_concentric)                                \
     M(xy_to_2pt_conical_strip)                                     \
     M(xy_to_2pt_conical_focal_on_circle)                           \
     M(xy_to_2pt_conical_well_behaved)                              \
@@ -5,20 +5,20 @@
  * found in the LICENSE file.
  */
 
-#ifndef GrSDFMaskFilter_DEFINED
-#define GrSDFMaskFilter_DEFINED
+#ifndef SkSDFMaskFilter_DEFINED
+#define SkSDFMaskFilter_DEFINED
 
 #include "SkMaskFilter.h"
 
-/** \class GrSDFMaskFilter
+/** \class SkSDFMaskFilter
 
     This mask filter converts an alpha mask to a signed distance field representation
 */
-class SK_API GrSDFMaskFilter : public SkMaskFilter {
+class SK_API SkSDFMaskFilter : public SkMaskFilter {
 public:
     static sk_sp<SkMaskFilter> Make();
 };
 
-extern void gr_register_sdf_maskfilter_createproc();
+extern void sk_register_sdf_maskfilter_createproc();
 
 #endif
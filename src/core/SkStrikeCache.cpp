@@ -228,6 +228,8 @@ void SkStrikeCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 
         dump->dumpNumericValue(dumpName.c_str(),
                                "size", "bytes", cache.getMemoryUsed());
+        dump->dumpNumericValue(dumpName.c_str(),
+                               "shared_image_size", "bytes", cache.getSharedImageMemory());
         dump->dumpNumericValue(dumpName.c_str(),
                                "glyph_count", "objects", cache.countCachedGlyphs());
         dump->setMemoryBacking(dumpName.c_str(), "malloc", nullptr);
@@ -33,6 +33,10 @@ public:
     // Block until done().
     void wait();
 
+    // Returns true if SkExecutor::SetDefault() has installed an executor. Until one is, a
+    // default-constructed SkTaskGroup runs each task inline as it is added.
+    static bool HasDefaultExecutor();
+
     // A convenience for testing tools.
     // Creates and owns a thread pool, and passes it to SkExecutor::SetDefault().
     struct Enabler {
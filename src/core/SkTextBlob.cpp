@@ -311,7 +311,8 @@ static int32_t next_id() {
 SkTextBlob::SkTextBlob(const SkRect& bounds)
     : fBounds(bounds)
     , fUniqueID(next_id())
-    , fCacheID(SK_InvalidUniqueID) {}
+    , fCacheID(SK_InvalidUniqueID)
+    , fResolvedRuns(nullptr) {}
 
 SkTextBlob::~SkTextBlob() {
 #if SK_SUPPORT_GPU
@@ -319,6 +320,7 @@ SkTextBlob::~SkTextBlob() {
         GrTextBlobCache::PostPurgeBlobMessage(fUniqueID, fCacheID);
     }
 #endif
+    delete fResolvedRuns.load();
 
     const auto* run = RunRecord::First(this);
     do {
@@ -10,9 +10,31 @@
 
 #include "SkTextBlob.h"
 
+#include <memory>
+
 class SkReadBuffer;
 class SkWriteBuffer;
 
+/**
+ *  The positions, dense indices and unique glyph IDs SkGlyphRunBuilder resolves from the advances
+ *  of a blob's default positioned runs. The runs' fonts determine them, so they are resolved by
+ *  the blob's first draw and shared by every later draw, on any thread.
+ */
+struct SkTextBlobResolvedRuns {
+    SkTextBlobResolvedRuns(size_t glyphCount, size_t uniqueGlyphCount, size_t runCount)
+        : fPositions(glyphCount)
+        , fDenseIndices(glyphCount)
+        , fUniqueGlyphIDs(uniqueGlyphCount)
+        , fUniqueGlyphCounts(runCount) {}
+
+    // Each default positioned run's glyphs follow the previous run's, in blob order.
+    SkAutoTMalloc<SkPoint>   fPositions;
+    SkAutoTMalloc<uint16_t>  fDenseIndices;
+    SkAutoTMalloc<SkGlyphID> fUniqueGlyphIDs;
+    // A run without unique glyphs was not drawn.
+    SkAutoTMalloc<size_t>    fUniqueGlyphCounts;
+};
+
 class SkTextBlobPriv {
 public:
     /**
@@ -28,6 +50,25 @@ public:
      *          invalid.
      */
     static sk_sp<SkTextBlob> MakeFromBuffer(SkReadBuffer&);
+
+    /**
+     *  Returns the blob's resolved runs, or nullptr if it has not been drawn yet.
+     */
+    static const SkTextBlobResolvedRuns* GetResolvedRuns(const SkTextBlob& blob) {
+        return blob.fResolvedRuns.load(std::memory_order_acquire);
+    }
+
+    /**
+     *  Gives the blob its resolved runs, unless another thread drawing it got there first.
+     */
+    static void SetResolvedRuns(const SkTextBlob& blob,
+                                std::unique_ptr<SkTextBlobResolvedRuns> resolved) {
+        SkTextBlobResolvedRuns* expected = nullptr;
+        if (blob.fResolvedRuns.compare_exchange_strong(expected, resolved.get(),
+                                                       std::memory_order_acq_rel)) {
+            resolved.release();
+        }
+    }
 };
 
 class SkTextBlobBuilderPriv {
@@ -125,6 +125,30 @@ void GrAuditTrail::getBoundsByOpListID(OpInfo* outInfo, int opListID) {
     this->copyOutFromOpList(outInfo, opListID);
 }
 
+void GrAuditTrail::getOpCounts(SkTArray<OpCount>* outCounts) const {
+    SkTHashMap<SkString, int> nameToIndex;
+    auto countFor = [&](const SkString& name) -> OpCount& {
+        int* index = nameToIndex.find(name);
+        if (!index) {
+            index = nameToIndex.set(name, outCounts->count());
+            outCounts->push_back(OpCount{name, 0, 0});
+        }
+        return (*outCounts)[*index];
+    };
+    outCounts->reset();
+    for (int i = 0; i < fOpPool.count(); ++i) {
+        countFor(fOpPool[i]->fName).fRecorded++;
+    }
+    // Consumed nodes are left as null sentinels in fOpList. Only ops of the same class combine so
+    // the first child names the whole node.
+    for (int i = 0; i < fOpList.count(); ++i) {
+        if (fOpList[i]) {
+            SkASSERT(!fOpList[i]->fChildren.empty());
+            countFor(fOpList[i]->fChildren[0]->fName).fCombined++;
+        }
+    }
+}
+
 void GrAuditTrail::fullReset() {
     SkASSERT(fEnabled);
     fOpList.reset();
@@ -135,7 +135,9 @@ bool GrContext::initCommon(const GrContextOptions& options) {
                                             : false;
     fDrawingManager.reset(new GrDrawingManager(this, prcOptions, textContextOptions,
                                                &fSingleOwner, explicitlyAllocatingResources,
-                                               options.fSortRenderTargets));
+                                               options.fSortRenderTargets,
+                                               options.fMaxOpCombineLookback,
+                                               options.fMaxOpCombineLookahead));
 
     fGlyphCache = new GrGlyphCache(fCaps.get(), options.fGlyphCacheTextureMaximumBytes);
 
@@ -144,6 +146,7 @@ bool GrContext::initCommon(const GrContextOptions& options) {
 
     // DDL TODO: we need to think through how the task group & persistent cache
     // get passed on to/shared between all the DDLRecorders created with this context.
+    fExecutor = options.fExecutor;
     if (options.fExecutor) {
         fTaskGroup = skstd::make_unique<SkTaskGroup>(*options.fExecutor);
     }
@@ -163,6 +166,13 @@ GrContext::~GrContext() {
     delete fResourceCache;
     delete fProxyProvider;
     delete fGlyphCache;
+
+    // DDL recorders come and go all the time, so only a direct context's destruction gives back
+    // the op pool blocks cached for reuse.
+    if (fGpu) {
+        fOpMemoryPool.reset();
+        GrMemoryPoolBlockCache::Global()->purge();
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -293,6 +303,8 @@ void GrContext::freeGpuResources() {
     fDrawingManager->freeGpuResources();
 
     fResourceCache->purgeAllUnlocked();
+
+    GrMemoryPoolBlockCache::Global()->purge();
 }
 
 void GrContext::purgeUnlockedResources(bool scratchResourcesOnly) {
@@ -308,6 +320,8 @@ void GrContext::performDeferredCleanup(std::chrono::milliseconds msNotUsed) {
     fResourceCache->purgeResourcesNotUsedSince(GrStdSteadyClock::now() - msNotUsed);
 
     fTextBlobCache->purgeStaleBlobs();
+
+    GrMemoryPoolBlockCache::Global()->purge();
 }
 
 void GrContext::purgeUnlockedResources(size_t bytesToPurge, bool preferScratchResources) {
@@ -376,6 +390,15 @@ GrSemaphoresSubmitted GrContext::flushAndSignalSemaphores(int numSemaphores,
     return fDrawingManager->flush(nullptr, numSemaphores, signalSemaphores);
 }
 
+int GrContext::precompileShaders(const sk_sp<SkData> keys[], int count) {
+    ASSERT_SINGLE_OWNER
+    if (fDrawingManager->wasAbandoned() || !fGpu || !fPersistentCache) {
+        return 0;
+    }
+
+    return fGpu->precompileShaders(keys, count);
+}
+
 void GrContextPriv::flush(GrSurfaceProxy* proxy) {
     ASSERT_SINGLE_OWNER_PRIV
     RETURN_IF_ABANDONED_PRIV
@@ -827,7 +850,11 @@ sk_sp<GrOpMemoryPool> GrContextPriv::refOpMemoryPool() {
         // DDL TODO: should the size of the memory pool be decreased in DDL mode? CPU-side memory
         // consumed in DDL mode vs. normal mode for a single skp might be a good metric of wasted
         // memory.
-        fContext->fOpMemoryPool = sk_sp<GrOpMemoryPool>(new GrOpMemoryPool(16384, 16384));
+        // The blocks are recycled through a process wide cache since DDL recorders each create
+        // (and destroy) their own context and pool, often on many threads at once.
+        constexpr size_t kBlockSize = GrMemoryPoolBlockCache::kOpPoolBlockSize;
+        fContext->fOpMemoryPool = sk_sp<GrOpMemoryPool>(
+                new GrOpMemoryPool(kBlockSize, kBlockSize, GrMemoryPoolBlockCache::Global()));
     }
 
     SkASSERT(fContext->fOpMemoryPool);
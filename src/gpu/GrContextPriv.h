@@ -179,6 +179,7 @@ public:
 
     GrBackend getBackend() const { return fContext->fBackend; }
 
+    SkExecutor* getExecutor() { return fContext->fExecutor; }
     SkTaskGroup* getTaskGroup() { return fContext->fTaskGroup.get(); }
 
     GrProxyProvider* proxyProvider() { return fContext->fProxyProvider; }
@@ -37,7 +37,9 @@ GrDrawingManager::GrDrawingManager(GrContext* context,
                                    const GrTextContext::Options& optionsForTextContext,
                                    GrSingleOwner* singleOwner,
                                    bool explicitlyAllocating,
-                                   GrContextOptions::Enable sortRenderTargets)
+                                   GrContextOptions::Enable sortRenderTargets,
+                                   int maxOpCombineLookback,
+                                   int maxOpCombineLookahead)
         : fContext(context)
         , fOptionsForPathRendererChain(optionsForPathRendererChain)
         , fOptionsForTextContext(optionsForTextContext)
@@ -46,7 +48,9 @@ GrDrawingManager::GrDrawingManager(GrContext* context,
         , fTextContext(nullptr)
         , fPathRendererChain(nullptr)
         , fSoftwarePathRenderer(nullptr)
-        , fFlushing(false) {
+        , fFlushing(false)
+        , fMaxOpCombineLookback(maxOpCombineLookback)
+        , fMaxOpCombineLookahead(maxOpCombineLookahead) {
 
     if (GrContextOptions::Enable::kNo == sortRenderTargets) {
         fSortRenderTargets = false;
@@ -157,7 +161,7 @@ GrSemaphoresSubmitted GrDrawingManager::internalFlush(GrSurfaceProxy*,
 #endif
 
     GrOpFlushState flushState(gpu, fContext->contextPriv().resourceProvider(),
-                              &fTokenTracker);
+                              &fTokenTracker, fContext->contextPriv().getExecutor());
 
     GrOnFlushResourceProvider onFlushProvider(this);
     // TODO: AFAICT the only reason fFlushState is on GrDrawingManager rather than on the
@@ -443,7 +447,9 @@ sk_sp<GrRenderTargetOpList> GrDrawingManager::newRTOpList(GrRenderTargetProxy* r
                                                         resourceProvider,
                                                         fContext->contextPriv().refOpMemoryPool(),
                                                         rtp,
-                                                        fContext->contextPriv().getAuditTrail()));
+                                                        fContext->contextPriv().getAuditTrail(),
+                                                        fMaxOpCombineLookback,
+                                                        fMaxOpCombineLookahead));
     SkASSERT(rtp->getLastOpList() == opList.get());
 
     if (managedOpList) {
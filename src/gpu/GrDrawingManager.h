@@ -83,7 +83,8 @@ public:
 private:
     GrDrawingManager(GrContext*, const GrPathRendererChain::Options&,
                      const GrTextContext::Options&, GrSingleOwner*,
-                     bool explicitlyAllocating, GrContextOptions::Enable sortRenderTargets);
+                     bool explicitlyAllocating, GrContextOptions::Enable sortRenderTargets,
+                     int maxOpCombineLookback, int maxOpCombineLookahead);
 
     void abandon();
     void cleanup();
@@ -131,6 +132,8 @@ private:
     GrTokenTracker                    fTokenTracker;
     bool                              fFlushing;
     bool                              fSortRenderTargets;
+    int                               fMaxOpCombineLookback;
+    int                               fMaxOpCombineLookahead;
 
     SkTArray<GrOnFlushCallbackObject*> fOnFlushCBObjects;
 };
@@ -39,6 +39,7 @@ class GrStencilAttachment;
 class GrStencilSettings;
 class GrSurface;
 class GrTexture;
+class SkData;
 class SkJSONWriter;
 
 class GrGpu : public SkRefCnt {
@@ -276,6 +277,13 @@ public:
      */
     virtual sk_sp<GrSemaphore> prepareTextureForCrossContextUsage(GrTexture*) = 0;
 
+    /**
+     * Starts translating the shaders stored in the context's persistent cache under the given keys,
+     * ahead of the first draw which needs them. Returns the number of programs that will be
+     * precompiled. Backends which have nothing to precompile return 0.
+     */
+    virtual int precompileShaders(const sk_sp<SkData> keys[], int count) { return 0; }
+
     ///////////////////////////////////////////////////////////////////////////
     // Debugging and Stats
 
@@ -86,6 +86,10 @@ private:
 
     int* accessCacheIndex() const { return &fResource->fCacheArrayIndex; }
 
+    /** The links in the cache's list of scratch resources with the same scratch key. */
+    GrGpuResource*& scratchPrev() const { return fResource->fScratchPrev; }
+    GrGpuResource*& scratchNext() const { return fResource->fScratchNext; }
+
     CacheAccess(GrGpuResource* resource) : fResource(resource) {}
     CacheAccess(const CacheAccess& that) : fResource(that.fResource) {}
     CacheAccess& operator=(const CacheAccess&); // unimpl
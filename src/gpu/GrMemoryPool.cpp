@@ -6,7 +6,10 @@
  */
 
 #include "GrMemoryPool.h"
+#include "SkChecksum.h"
 #include "SkMalloc.h"
+#include "SkOnce.h"
+#include "SkThreadID.h"
 #ifdef SK_DEBUG
 #include "SkAtomics.h"
 #endif
@@ -25,9 +28,115 @@ void GrOpMemoryPool::release(std::unique_ptr<GrOp> op) {
     fMemoryPool.release(tmp);
 }
 
+constexpr size_t GrMemoryPoolBlockCache::kOpPoolBlockSize;
+
+GrMemoryPoolBlockCache::GrMemoryPoolBlockCache(size_t blockSize, int maxBlocksPerShard)
+        : fBlockSize(blockSize)
+        , fMaxBlocksPerShard(maxBlocksPerShard) {
+    SkASSERT(blockSize >= sizeof(FreeBlock));
+}
+
+GrMemoryPoolBlockCache::~GrMemoryPoolBlockCache() {
+    this->purge();
+}
+
+GrMemoryPoolBlockCache* GrMemoryPoolBlockCache::Global() {
+    // Enough for 8 threads to each have 256K of op memory waiting to be reused.
+    static constexpr int kMaxBlocksPerShard = 16;
+    static GrMemoryPoolBlockCache* gCache;
+    static SkOnce once;
+    once([] { gCache = new GrMemoryPoolBlockCache(kOpPoolBlockSize, kMaxBlocksPerShard); });
+    return gCache;
+}
+
+int GrMemoryPoolBlockCache::shardIndex() const {
+    return SkChecksum::Mix(static_cast<uint32_t>(SkGetThreadID())) % kShardCount;
+}
+
+GrMemoryPoolBlockCache::FreeBlock* GrMemoryPoolBlockCache::Pop(Shard* shard) {
+    FreeBlock* block = shard->fHead;
+    if (block) {
+        shard->fHead = block->fNext;
+        --shard->fCount;
+    }
+    return block;
+}
+
+void* GrMemoryPoolBlockCache::acquire(size_t size) {
+    if (size == fBlockSize) {
+        int start = this->shardIndex();
+        Shard* shard = &fShards[start];
+        shard->fLock.acquire();
+        FreeBlock* block = Pop(shard);
+        shard->fLock.release();
+        // Blocks are often recycled on a different thread than the one that records the next
+        // DDL. Look in the other shards but don't wait on them.
+        for (int i = 1; !block && i < kShardCount; ++i) {
+            shard = &fShards[(start + i) % kShardCount];
+            if (shard->fLock.tryAcquire()) {
+                block = Pop(shard);
+                shard->fLock.release();
+            }
+        }
+        if (block) {
+            fRecycledBlocks.fetch_add(1, std::memory_order_relaxed);
+            return block;
+        }
+    }
+    fAllocatedBlocks.fetch_add(1, std::memory_order_relaxed);
+    return sk_malloc_throw(size);
+}
+
+void GrMemoryPoolBlockCache::recycle(void* block, size_t size) {
+    if (size == fBlockSize) {
+        Shard* shard = &fShards[this->shardIndex()];
+        shard->fLock.acquire();
+        bool cached = shard->fCount < fMaxBlocksPerShard;
+        if (cached) {
+            FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+            freeBlock->fNext = shard->fHead;
+            shard->fHead = freeBlock;
+            ++shard->fCount;
+        }
+        shard->fLock.release();
+        if (cached) {
+            fCachedBlocks.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    fFreedBlocks.fetch_add(1, std::memory_order_relaxed);
+    sk_free(block);
+}
+
+void GrMemoryPoolBlockCache::purge() {
+    for (Shard& shard : fShards) {
+        shard.fLock.acquire();
+        FreeBlock* block = shard.fHead;
+        shard.fHead = nullptr;
+        shard.fCount = 0;
+        shard.fLock.release();
+        while (block) {
+            FreeBlock* next = block->fNext;
+            sk_free(block);
+            block = next;
+        }
+    }
+}
+
+void GrMemoryPoolBlockCache::getStats(Stats* stats) const {
+    stats->fRecycledBlocks = fRecycledBlocks.load(std::memory_order_relaxed);
+    stats->fAllocatedBlocks = fAllocatedBlocks.load(std::memory_order_relaxed);
+    stats->fCachedBlocks = fCachedBlocks.load(std::memory_order_relaxed);
+    stats->fFreedBlocks = fFreedBlocks.load(std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 constexpr size_t GrMemoryPool::kSmallestMinAllocSize;
 
-GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize) {
+GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize,
+                           GrMemoryPoolBlockCache* blockCache)
+        : fBlockCache(blockCache) {
     SkDEBUGCODE(fAllocationCnt = 0);
     SkDEBUGCODE(fAllocBlockCnt = 0);
 
@@ -37,7 +146,7 @@ GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize) {
     fMinAllocSize = minAllocSize;
     fSize = 0;
 
-    fHead = CreateBlock(preallocSize);
+    fHead = this->createBlock(preallocSize);
     fTail = fHead;
     fHead->fNext = nullptr;
     fHead->fPrev = nullptr;
@@ -62,7 +171,7 @@ GrMemoryPool::~GrMemoryPool() {
     SkASSERT(0 == fAllocationCnt);
     SkASSERT(fHead == fTail);
     SkASSERT(0 == fHead->fLiveCount);
-    DeleteBlock(fHead);
+    this->deleteBlock(fHead);
 };
 
 void* GrMemoryPool::allocate(size_t size) {
@@ -72,7 +181,7 @@ void* GrMemoryPool::allocate(size_t size) {
     if (fTail->fFreeSize < size) {
         size_t blockSize = size + kHeaderSize;
         blockSize = SkTMax<size_t>(blockSize, fMinAllocSize);
-        BlockHeader* block = CreateBlock(blockSize);
+        BlockHeader* block = this->createBlock(blockSize);
 
         block->fPrev = fTail;
         block->fNext = nullptr;
@@ -130,7 +239,7 @@ void GrMemoryPool::release(void* p) {
                 fTail = prev;
             }
             fSize -= block->fSize;
-            DeleteBlock(block);
+            this->deleteBlock(block);
             SkDEBUGCODE(fAllocBlockCnt--);
         }
     } else {
@@ -145,10 +254,10 @@ void GrMemoryPool::release(void* p) {
     VALIDATE;
 }
 
-GrMemoryPool::BlockHeader* GrMemoryPool::CreateBlock(size_t blockSize) {
+GrMemoryPool::BlockHeader* GrMemoryPool::createBlock(size_t blockSize) {
     blockSize = SkTMax<size_t>(blockSize, kHeaderSize);
-    BlockHeader* block =
-        reinterpret_cast<BlockHeader*>(sk_malloc_throw(blockSize));
+    void* memory = fBlockCache ? fBlockCache->acquire(blockSize) : sk_malloc_throw(blockSize);
+    BlockHeader* block = reinterpret_cast<BlockHeader*>(memory);
     // we assume malloc gives us aligned memory
     SkASSERT(!(reinterpret_cast<intptr_t>(block) % kAlignment));
     SkDEBUGCODE(block->fBlockSentinal = kAssignedMarker);
@@ -160,10 +269,14 @@ GrMemoryPool::BlockHeader* GrMemoryPool::CreateBlock(size_t blockSize) {
     return block;
 }
 
-void GrMemoryPool::DeleteBlock(BlockHeader* block) {
+void GrMemoryPool::deleteBlock(BlockHeader* block) {
     SkASSERT(kAssignedMarker == block->fBlockSentinal);
     SkDEBUGCODE(block->fBlockSentinal = kFreedMarker); // FWIW
-    sk_free(block);
+    if (fBlockCache) {
+        fBlockCache->recycle(block, block->fSize);
+    } else {
+        sk_free(block);
+    }
 }
 
 void GrMemoryPool::validate() {
@@ -11,11 +11,83 @@
 #include "GrTypes.h"
 
 #include "SkRefCnt.h"
+#include "SkSpinlock.h"
+
+#include <atomic>
 
 #ifdef SK_DEBUG
 #include "SkTHash.h"
 #endif
 
+/**
+ * Recycles the blocks of GrMemoryPools so that pools which are created and destroyed frequently,
+ * e.g. the op pools of DDL recorders, don't have to go back to malloc for their memory. Only
+ * blocks of exactly blockSize are recycled. The cache may be shared by pools on any number of
+ * threads. It is split into shards, each with its own lock, and a thread prefers the shard
+ * picked by its thread ID so that concurrent recorders rarely contend. Other shards are only
+ * tried when the lock can be taken without waiting.
+ */
+class GrMemoryPoolBlockCache {
+public:
+    GrMemoryPoolBlockCache(size_t blockSize, int maxBlocksPerShard);
+
+    ~GrMemoryPoolBlockCache();
+
+    /**
+     * The cache used for the GrContext op pools. Its block size is kOpPoolBlockSize. It is purged
+     * by GrContext::freeGpuResources(), GrContext::performDeferredCleanup() and the destruction of
+     * a direct (non-DDL) context.
+     */
+    static GrMemoryPoolBlockCache* Global();
+
+    static constexpr size_t kOpPoolBlockSize = 16384;
+
+    size_t blockSize() const { return fBlockSize; }
+
+    /** Returns a block of 'size' bytes, recycled if size is blockSize() and one is available. */
+    void* acquire(size_t size);
+
+    /** Takes back a block from acquire(). It is freed if its shard is full. */
+    void recycle(void* block, size_t size);
+
+    /** Frees all of the cached blocks. */
+    void purge();
+
+    struct Stats {
+        int fRecycledBlocks;    ///< acquire()s that were satisfied by a cached block
+        int fAllocatedBlocks;   ///< acquire()s that had to call malloc
+        int fCachedBlocks;      ///< recycle()s that kept the block
+        int fFreedBlocks;       ///< recycle()s that freed the block
+    };
+
+    void getStats(Stats*) const;
+
+private:
+    static constexpr int kShardCount = 8;
+
+    struct FreeBlock {
+        FreeBlock* fNext;
+    };
+
+    struct Shard {
+        SkSpinlock fLock;
+        FreeBlock* fHead = nullptr;
+        int        fCount = 0;
+    };
+
+    int shardIndex() const;
+
+    static FreeBlock* Pop(Shard*);
+
+    const size_t     fBlockSize;
+    const int        fMaxBlocksPerShard;
+    Shard            fShards[kShardCount];
+    std::atomic<int> fRecycledBlocks{0};
+    std::atomic<int> fAllocatedBlocks{0};
+    std::atomic<int> fCachedBlocks{0};
+    std::atomic<int> fFreedBlocks{0};
+};
+
 /**
  * Allocates memory in blocks and parcels out space in the blocks for allocation
  * requests. It is optimized for allocate / release speed over memory
@@ -36,8 +108,12 @@ public:
      *
      * Both sizes is what the pool will end up allocating from the system, and
      * portions of the allocated memory is used for internal bookkeeping.
+     *
+     * If blockCache is not null blocks are acquired from and returned to it rather than the
+     * system. It must outlive the pool.
      */
-    GrMemoryPool(size_t preallocSize, size_t minAllocSize);
+    GrMemoryPool(size_t preallocSize, size_t minAllocSize,
+                 GrMemoryPoolBlockCache* blockCache = nullptr);
 
     ~GrMemoryPool();
 
@@ -74,9 +150,9 @@ public:
 private:
     struct BlockHeader;
 
-    static BlockHeader* CreateBlock(size_t size);
+    BlockHeader* createBlock(size_t size);
 
-    static void DeleteBlock(BlockHeader* block);
+    void deleteBlock(BlockHeader* block);
 
     void validate();
 
@@ -107,6 +183,7 @@ private:
 
     size_t                            fSize;
     size_t                            fMinAllocSize;
+    GrMemoryPoolBlockCache*           fBlockCache;
     BlockHeader*                      fHead;
     BlockHeader*                      fTail;
 #ifdef SK_DEBUG
@@ -130,8 +207,9 @@ class GrOp;
 // ref counting
 class GrOpMemoryPool : public SkRefCnt {
 public:
-    GrOpMemoryPool(size_t preallocSize, size_t minAllocSize)
-            : fMemoryPool(preallocSize, minAllocSize) {
+    GrOpMemoryPool(size_t preallocSize, size_t minAllocSize,
+                   GrMemoryPoolBlockCache* blockCache = nullptr)
+            : fMemoryPool(preallocSize, minAllocSize, blockCache) {
     }
 
     template <typename Op, typename... OpArgs>
@@ -148,6 +226,12 @@ public:
 
     bool isEmpty() const { return fMemoryPool.isEmpty(); }
 
+    /**
+     * Returns the number of bytes the pool has allocated for ops, including its preallocated
+     * block.
+     */
+    size_t size() const { return fMemoryPool.preallocSize() + fMemoryPool.size(); }
+
 private:
     GrMemoryPool fMemoryPool;
 };
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrOpBoundsIndex.h"
+#include "GrRect.h"
+
+GrOpBoundsIndex::GrOpBoundsIndex(int width, int height)
+        : fCellsPerX(SkIntToScalar(kGridSize) / SkTMax(width, 1))
+        , fCellsPerY(SkIntToScalar(kGridSize) / SkTMax(height, 1)) {}
+
+// The cell mapping only has to be monotonic for two overlapping rects to share a cell. Anything
+// outside of the render target is clamped to the edge cells.
+int GrOpBoundsIndex::cellX(SkScalar x) const {
+    SkScalar c = x * fCellsPerX;
+    if (!(c > 0)) {
+        return 0;
+    }
+    return c >= kGridSize - 1 ? kGridSize - 1 : static_cast<int>(c);
+}
+
+int GrOpBoundsIndex::cellY(SkScalar y) const {
+    SkScalar c = y * fCellsPerY;
+    if (!(c > 0)) {
+        return 0;
+    }
+    return c >= kGridSize - 1 ? kGridSize - 1 : static_cast<int>(c);
+}
+
+bool GrOpBoundsIndex::cellRange(const SkRect& rect, SkIRect* cells) const {
+    // GrRectsOverlap is always false if any of the edges is NaN.
+    if (SkScalarIsNaN(rect.fLeft) || SkScalarIsNaN(rect.fTop) ||
+        SkScalarIsNaN(rect.fRight) || SkScalarIsNaN(rect.fBottom)) {
+        return false;
+    }
+    cells->setLTRB(this->cellX(rect.fLeft), this->cellY(rect.fTop),
+                   this->cellX(rect.fRight), this->cellY(rect.fBottom));
+    return cells->fLeft <= cells->fRight && cells->fTop <= cells->fBottom;
+}
+
+void GrOpBoundsIndex::insert(int index, const SkRect& bounds) {
+    SkASSERT(index >= 0);
+    if (!fCells) {
+        fCells.reset(new SkTDArray<int>[kGridSize * kGridSize]);
+    }
+    while (fBounds.count() <= index) {
+        fBounds.push_back(SkRect::MakeEmpty());
+    }
+    // Merging only ever grows an op's bounds so the new bounds contain the old ones.
+    fBounds[index] = bounds;
+
+    SkIRect cells;
+    if (!this->cellRange(bounds, &cells)) {
+        return;
+    }
+    for (int y = cells.fTop; y <= cells.fBottom; ++y) {
+        for (int x = cells.fLeft; x <= cells.fRight; ++x) {
+            SkTDArray<int>& cell = fCells[y * kGridSize + x];
+            if (cell.isEmpty() || cell.top() < index) {
+                cell.push_back(index);
+                continue;
+            }
+            // Growing an older entry. Keep the cell sorted and free of duplicates.
+            int i = cell.count() - 1;
+            while (i >= 0 && cell[i] > index) {
+                --i;
+            }
+            if (i < 0 || cell[i] != index) {
+                *cell.insert(i + 1) = index;
+            }
+        }
+    }
+}
+
+int GrOpBoundsIndex::findLastOverlap(const SkRect& bounds, int minIndex) const {
+    SkIRect cells;
+    if (!fCells || !this->cellRange(bounds, &cells)) {
+        return -1;
+    }
+    int result = -1;
+    int floor = SkTMax(minIndex, 0);
+    for (int y = cells.fTop; y <= cells.fBottom; ++y) {
+        for (int x = cells.fLeft; x <= cells.fRight; ++x) {
+            const SkTDArray<int>& cell = fCells[y * kGridSize + x];
+            for (int i = cell.count() - 1; i >= 0; --i) {
+                int index = cell[i];
+                if (index < floor || index <= result) {
+                    break;
+                }
+                if (GrRectsOverlap(fBounds[index], bounds)) {
+                    result = index;
+                    break;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+void GrOpBoundsIndex::reset() {
+    fCells.reset();
+    fBounds.reset();
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrOpBoundsIndex_DEFINED
+#define GrOpBoundsIndex_DEFINED
+
+#include "SkRect.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+
+#include <memory>
+
+/**
+ * A coarse spatial index over the bounds of the ops recorded in a GrRenderTargetOpList. The
+ * render target is divided into a uniform grid and each cell keeps the (sorted) indices of the
+ * ops whose bounds touch it. This lets the opList find the last op that a new op would have to
+ * draw after without visiting every op in between, which in turn lets it search much further
+ * back for an op to combine with.
+ *
+ * Indices are opaque to the index but must be inserted in increasing order, except that an
+ * already inserted index may be reinserted with larger bounds (e.g. after another op was merged
+ * into it).
+ */
+class GrOpBoundsIndex {
+public:
+    GrOpBoundsIndex(int width, int height);
+
+    /** Adds the op at 'index' with the given bounds, or grows the bounds of an existing entry. */
+    void insert(int index, const SkRect& bounds);
+
+    /**
+     * Returns the largest index >= minIndex whose bounds overlap 'bounds' (as determined by
+     * GrRectsOverlap), or -1 if there is no such index.
+     */
+    int findLastOverlap(const SkRect& bounds, int minIndex) const;
+
+    void reset();
+
+    static constexpr int kGridSize = 8;
+
+private:
+    // Returns false if the rect does not touch any cell.
+    bool cellRange(const SkRect&, SkIRect* cells) const;
+    int cellX(SkScalar x) const;
+    int cellY(SkScalar y) const;
+
+    SkScalar                         fCellsPerX;
+    SkScalar                         fCellsPerY;
+    std::unique_ptr<SkTDArray<int>[]> fCells;
+    // Bounds of each inserted index. Indices that were never inserted have empty bounds.
+    SkTArray<SkRect, true>           fBounds;
+};
+
+#endif
@@ -17,12 +17,14 @@
 
 GrOpFlushState::GrOpFlushState(GrGpu* gpu,
                                GrResourceProvider* resourceProvider,
-                               GrTokenTracker* tokenTracker)
+                               GrTokenTracker* tokenTracker,
+                               SkExecutor* executor)
         : fVertexPool(gpu)
         , fIndexPool(gpu)
         , fGpu(gpu)
         , fResourceProvider(resourceProvider)
-        , fTokenTracker(tokenTracker) {
+        , fTokenTracker(tokenTracker)
+        , fExecutor(executor) {
 }
 
 const GrCaps& GrOpFlushState::caps() const {
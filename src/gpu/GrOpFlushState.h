@@ -21,11 +21,13 @@ class GrGpu;
 class GrGpuCommandBuffer;
 class GrGpuRTCommandBuffer;
 class GrResourceProvider;
+class SkExecutor;
 
 /** Tracks the state across all the GrOps (really just the GrDrawOps) in a GrOpList flush. */
 class GrOpFlushState final : public GrDeferredUploadTarget, public GrMeshDrawOp::Target {
 public:
-    GrOpFlushState(GrGpu*, GrResourceProvider*, GrTokenTracker*);
+    /** If an executor is provided ops may do part of their preparation on its threads. */
+    GrOpFlushState(GrGpu*, GrResourceProvider*, GrTokenTracker*, SkExecutor* = nullptr);
 
     ~GrOpFlushState() final { this->reset(); }
 
@@ -45,6 +47,8 @@ public:
 
     GrGpu* gpu() { return fGpu; }
 
+    SkExecutor* executor() { return fExecutor; }
+
     void reset();
 
     /** Additional data required on a per-op basis when executing GrOps. */
@@ -157,6 +161,7 @@ private:
     GrGpu* fGpu;
     GrResourceProvider* fResourceProvider;
     GrTokenTracker* fTokenTracker;
+    SkExecutor* fExecutor;
     GrGpuCommandBuffer* fCommandBuffer = nullptr;
 
     // Variables that are used to track where we are in lists as ops are executed
@@ -71,6 +71,14 @@ bool GrRectanizerSkyline::rectangleFits(int skylineIndex, int width, int height,
 }
 
 void GrRectanizerSkyline::addSkylineLevel(int skylineIndex, int x, int y, int width, int height) {
+    for (int i = skylineIndex; i < fSkyline.count() && fSkyline[i].fX < x + width; ++i) {
+        if (fSkyline[i].fY < y) {
+            int left = SkMax32(fSkyline[i].fX, x);
+            int right = SkMin32(fSkyline[i].fX + fSkyline[i].fWidth, x + width);
+            this->onWaste(left, fSkyline[i].fY, right - left, y - fSkyline[i].fY);
+        }
+    }
+
     SkylineSegment newSegment;
     newSegment.fX = x;
     newSegment.fY = y + height;
@@ -113,9 +121,3 @@ void GrRectanizerSkyline::addSkylineLevel(int skylineIndex, int x, int y, int wi
         }
     }
 }
-
-///////////////////////////////////////////////////////////////////////////////
-
-GrRectanizer* GrRectanizer::Factory(int width, int height) {
-    return new GrRectanizerSkyline(width, height);
-}
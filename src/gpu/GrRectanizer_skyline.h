@@ -36,6 +36,13 @@ public:
         return fAreaSoFar / ((float)this->width() * this->height());
     }
 
+protected:
+    // Called for each area that a newly added rect leaves empty below it. Such areas can't be
+    // reached by later rects placed on the skyline.
+    virtual void onWaste(int x, int y, int width, int height) {}
+
+    int32_t fAreaSoFar;
+
 private:
     struct SkylineSegment {
         int  fX;
@@ -45,8 +52,6 @@ private:
 
     SkTDArray<SkylineSegment> fSkyline;
 
-    int32_t fAreaSoFar;
-
     // Can a width x height rectangle fit in the free space represented by
     // the skyline segments >= 'skylineIndex'? If so, return true and fill in
     // 'y' with the y-location at which it fits (the x location is pulled from
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrRectanizer_wastemap.h"
+#include "SkIPoint16.h"
+#include "SkMathPriv.h"
+#include "SkTSort.h"
+
+#include <algorithm>
+
+GrRectanizerWasteMap::GrRectanizerWasteMap(int w, int h)
+        : INHERITED(w, h)
+        // Free rects always lie below a placed rect so they are shorter than the rectanizer.
+        , fLeafCount(GrNextPow2(SkTMax(h, 1))) {
+    SkASSERT(w <= SK_MaxS16 && h <= SK_MaxS16);
+    fMaxWidths.reset(2 * fLeafCount);
+    this->reset();
+}
+
+void GrRectanizerWasteMap::reset() {
+    INHERITED::reset();
+    fFreeRects.reset();
+    fFreeRectsChanged = false;
+    sk_bzero(fMaxWidths.get(), 2 * fLeafCount * sizeof(uint16_t));
+}
+
+bool GrRectanizerWasteMap::addRect(int width, int height, SkIPoint16* loc) {
+    if ((unsigned)width > (unsigned)this->width() ||
+        (unsigned)height > (unsigned)this->height()) {
+        return false;
+    }
+
+    int index = this->findFreeRect(width, height);
+    if (index < 0) {
+        if (this->INHERITED::addRect(width, height, loc)) {
+            return true;
+        }
+        if (!this->mergeFreeRects() || (index = this->findFreeRect(width, height)) < 0) {
+            return false;
+        }
+    }
+
+    FreeRect rect = fFreeRects[index];
+    this->removeFreeRect(index);
+    fFreeRectsChanged = true;
+
+    // Split the rest of the free rect along the shorter leftover axis so that the larger of the
+    // two new free rects is as large as possible.
+    int rightWidth = rect.fWidth - width;
+    int bottomHeight = rect.fHeight - height;
+    if (rightWidth < bottomHeight) {
+        this->insertFreeRect(rect.fX + width, rect.fY, rightWidth, height);
+        this->insertFreeRect(rect.fX, rect.fY + height, rect.fWidth, bottomHeight);
+    } else {
+        this->insertFreeRect(rect.fX + width, rect.fY, rightWidth, rect.fHeight);
+        this->insertFreeRect(rect.fX, rect.fY + height, width, bottomHeight);
+    }
+
+    loc->fX = rect.fX;
+    loc->fY = rect.fY;
+    fAreaSoFar += width*height;
+    return true;
+}
+
+void GrRectanizerWasteMap::onWaste(int x, int y, int width, int height) {
+    this->insertFreeRect(x, y, width, height);
+}
+
+int GrRectanizerWasteMap::lowerBound(uint64_t key) const {
+    const FreeRect* rect = std::lower_bound(fFreeRects.begin(), fFreeRects.end(), key,
+                                            [](const FreeRect& r, uint64_t k) {
+                                                return r.key() < k;
+                                            });
+    return SkToInt(rect - fFreeRects.begin());
+}
+
+int GrRectanizerWasteMap::findFreeRect(int width, int height) const {
+    // Free rects are shorter than fLeafCount, which also keeps the leaf below in bounds.
+    if (height >= fLeafCount || fMaxWidths[1] < width) {
+        return -1;
+    }
+    // Find the shortest height >= 'height' with a wide enough free rect. Walk up from the leaf
+    // until there is a wide enough subtree to the right, then down into its leftmost such leaf.
+    int node = fLeafCount + height;
+    if (fMaxWidths[node] < width) {
+        while (true) {
+            // A node with a right sibling is a left child.
+            if (!(node & 1) && fMaxWidths[node + 1] >= width) {
+                node = node + 1;
+                break;
+            }
+            node >>= 1;
+            if (node <= 1) {
+                return -1;
+            }
+        }
+        while (node < fLeafCount) {
+            node = fMaxWidths[2 * node] >= width ? 2 * node : 2 * node + 1;
+        }
+    }
+    // Within that height the first free rect at least 'width' wide is the narrowest that fits.
+    int index = this->lowerBound(FreeRect::Key(0, 0, width, node - fLeafCount));
+    SkASSERT(index < fFreeRects.count() && fFreeRects[index].fWidth >= width &&
+             fFreeRects[index].fHeight >= height);
+    return index;
+}
+
+void GrRectanizerWasteMap::insertFreeRect(int x, int y, int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    SkASSERT(height < fLeafCount);
+    FreeRect* rect = fFreeRects.insert(this->lowerBound(FreeRect::Key(x, y, width, height)));
+    rect->fX = x;
+    rect->fY = y;
+    rect->fWidth = width;
+    rect->fHeight = height;
+    if (fMaxWidths[fLeafCount + height] < width) {
+        this->updateMaxWidth(height);
+    }
+}
+
+void GrRectanizerWasteMap::removeFreeRect(int index) {
+    int height = fFreeRects[index].fHeight;
+    fFreeRects.remove(index);
+    this->updateMaxWidth(height);
+}
+
+void GrRectanizerWasteMap::updateMaxWidth(int height) {
+    // The widest free rect of this height is the last one before the next height.
+    int next = this->lowerBound(FreeRect::Key(0, 0, 0, height + 1));
+    int node = fLeafCount + height;
+    fMaxWidths[node] = next > 0 && fFreeRects[next - 1].fHeight == height
+                               ? fFreeRects[next - 1].fWidth : 0;
+    for (node >>= 1; node; node >>= 1) {
+        fMaxWidths[node] = SkTMax(fMaxWidths[2 * node], fMaxWidths[2 * node + 1]);
+    }
+}
+
+void GrRectanizerWasteMap::rebuildMaxWidths() {
+    sk_bzero(fMaxWidths.get(), 2 * fLeafCount * sizeof(uint16_t));
+    for (const FreeRect& rect : fFreeRects) {
+        // The rects are sorted so the last one of each height is the widest.
+        fMaxWidths[fLeafCount + rect.fHeight] = rect.fWidth;
+    }
+    for (int node = fLeafCount - 1; node > 0; --node) {
+        fMaxWidths[node] = SkTMax(fMaxWidths[2 * node], fMaxWidths[2 * node + 1]);
+    }
+}
+
+// Merges runs of free rects that are adjacent along one axis and match along the other. The rects
+// are sorted so that mergeable neighbors are next to each other.
+template <bool kHorizontal>
+static bool merge_runs(SkTDArray<GrRectanizerWasteMap::FreeRect>* rects) {
+    using FreeRect = GrRectanizerWasteMap::FreeRect;
+    SkTQSort(rects->begin(), rects->end() - 1, [](const FreeRect& a, const FreeRect& b) {
+        if (kHorizontal) {
+            return a.fY != b.fY ? a.fY < b.fY : a.fHeight != b.fHeight ? a.fHeight < b.fHeight
+                                                                       : a.fX < b.fX;
+        }
+        return a.fX != b.fX ? a.fX < b.fX : a.fWidth != b.fWidth ? a.fWidth < b.fWidth
+                                                                 : a.fY < b.fY;
+    });
+
+    int count = 0;
+    for (const FreeRect& rect : *rects) {
+        if (count) {
+            FreeRect& last = (*rects)[count - 1];
+            if (kHorizontal && last.fY == rect.fY && last.fHeight == rect.fHeight &&
+                last.fX + last.fWidth == rect.fX) {
+                last.fWidth += rect.fWidth;
+                continue;
+            }
+            if (!kHorizontal && last.fX == rect.fX && last.fWidth == rect.fWidth &&
+                last.fY + last.fHeight == rect.fY) {
+                last.fHeight += rect.fHeight;
+                continue;
+            }
+        }
+        (*rects)[count++] = rect;
+    }
+    bool merged = count < rects->count();
+    rects->setCount(count);
+    return merged;
+}
+
+bool GrRectanizerWasteMap::mergeFreeRects() {
+    if (!fFreeRectsChanged || fFreeRects.count() < 2) {
+        return false;
+    }
+    fFreeRectsChanged = false;
+    bool merged = false;
+    for (bool mergedThisPass = true; mergedThisPass;) {
+        mergedThisPass = merge_runs<true>(&fFreeRects);
+        mergedThisPass |= merge_runs<false>(&fFreeRects);
+        merged |= mergedThisPass;
+    }
+    SkTQSort(fFreeRects.begin(), fFreeRects.end() - 1,
+             [](const FreeRect& a, const FreeRect& b) { return a.key() < b.key(); });
+    this->rebuildMaxWidths();
+    return merged;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+GrRectanizer* GrRectanizer::Factory(int width, int height) {
+    return new GrRectanizerWasteMap(width, height);
+}
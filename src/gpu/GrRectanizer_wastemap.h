@@ -0,0 +1,77 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrRectanizer_wastemap_DEFINED
+#define GrRectanizer_wastemap_DEFINED
+
+#include "GrRectanizer_skyline.h"
+#include "SkTemplates.h"
+
+// A skyline rectanizer that also reuses the space it leaves behind. Whenever a rect is placed
+// above the skyline the gaps below it are kept as free rects (the "waste map", after Jukka
+// Jylanki's work) and later rects are placed into them first, using a guillotine split. This
+// packs small entries such as glyphs noticeably tighter, so atlases fill up later.
+//
+// The free rects are kept sorted by height and then width, along with a tree of the widest free
+// rect for each height, so the tightest fitting free rect is found in O(log n). The skyline is
+// still searched linearly when no free rect fits. When nothing fits at all adjacent free rects
+// are merged and the search is retried once.
+class GrRectanizerWasteMap : public GrRectanizerSkyline {
+public:
+    GrRectanizerWasteMap(int w, int h);
+
+    ~GrRectanizerWasteMap() override { }
+
+    void reset() override;
+
+    bool addRect(int w, int h, SkIPoint16* loc) override;
+
+    struct FreeRect {
+        // The sort key. The position is included so that the order is total.
+        static uint64_t Key(int x, int y, int width, int height) {
+            return (uint64_t)height << 48 | (uint64_t)width << 32 | (uint64_t)y << 16 | x;
+        }
+        uint64_t key() const { return Key(fX, fY, fWidth, fHeight); }
+
+        uint16_t fX;
+        uint16_t fY;
+        uint16_t fWidth;
+        uint16_t fHeight;
+    };
+
+private:
+    void onWaste(int x, int y, int width, int height) override;
+
+    // Returns the index of the shortest (and then narrowest) free rect that can hold a
+    // width x height rect, or -1.
+    int findFreeRect(int width, int height) const;
+
+    void insertFreeRect(int x, int y, int width, int height);
+    void removeFreeRect(int index);
+
+    // Returns the index of the first free rect that isn't ordered before key.
+    int lowerBound(uint64_t key) const;
+
+    // Updates fMaxWidths after the free rects of the given height changed.
+    void updateMaxWidth(int height);
+    void rebuildMaxWidths();
+
+    // Merges free rects that share a whole edge. Returns true if any were merged. This only does
+    // work if a free rect was used since the last merge so that a full atlas fails quickly.
+    bool mergeFreeRects();
+
+    SkTDArray<FreeRect>     fFreeRects;       // sorted by key()
+    // A max tree over the free rect heights: leaf fLeafCount + h is the width of the widest free
+    // rect of height h and every other node is the max of its two children.
+    SkAutoTMalloc<uint16_t> fMaxWidths;
+    int                     fLeafCount;
+    bool                    fFreeRectsChanged;
+
+    typedef GrRectanizerSkyline INHERITED;
+};
+
+#endif
@@ -16,21 +16,29 @@
 #include "GrResourceAllocator.h"
 #include "ops/GrClearOp.h"
 #include "ops/GrCopySurfaceOp.h"
+#include "SkTaskGroup.h"
 #include "SkTraceEvent.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
 
-// Experimentally we have found that most combining occurs within the first 10 comparisons.
-static const int kMaxOpLookback = 10;
-static const int kMaxOpLookahead = 10;
+// Experimentally we have found that most combining occurs within the first 10 comparisons. The
+// backward search only visits ops of the same class that don't lie behind an op we intersect
+// (see GrOpBoundsIndex) so it can afford to look much further back than the forward search.
+static const int kDefaultMaxOpLookback = 64;
+static const int kDefaultMaxOpLookahead = 10;
 
 GrRenderTargetOpList::GrRenderTargetOpList(GrResourceProvider* resourceProvider,
                                            sk_sp<GrOpMemoryPool> opMemoryPool,
                                            GrRenderTargetProxy* proxy,
-                                           GrAuditTrail* auditTrail)
+                                           GrAuditTrail* auditTrail,
+                                           int maxOpLookback,
+                                           int maxOpLookahead)
         : INHERITED(resourceProvider, std::move(opMemoryPool), proxy, auditTrail)
         , fLastClipStackGenID(SK_InvalidUniqueID)
+        , fMaxOpLookback(maxOpLookback >= 0 ? maxOpLookback : kDefaultMaxOpLookback)
+        , fMaxOpLookahead(maxOpLookahead >= 0 ? maxOpLookahead : kDefaultMaxOpLookahead)
+        , fBoundsIndex(proxy->worstCaseWidth(), proxy->worstCaseHeight())
         SkDEBUGCODE(, fNumClips(0)) {
 }
 
@@ -45,6 +53,13 @@ void GrRenderTargetOpList::deleteOps() {
         }
     }
     fRecordedOps.reset();
+    this->resetCombiningState();
+}
+
+void GrRenderTargetOpList::resetCombiningState() {
+    fBoundsIndex.reset();
+    fPrevOpOfSameClass.reset();
+    fLastOpOfClass.reset();
 }
 
 GrRenderTargetOpList::~GrRenderTargetOpList() {
@@ -87,6 +102,38 @@ void GrRenderTargetOpList::onPrepare(GrOpFlushState* flushState) {
     TRACE_EVENT0("skia", TRACE_FUNC);
 #endif
 
+    // Ops that can do some of their CPU work (e.g. tessellation) without touching shared state
+    // do it on the executor's threads first. Everything that touches the flush state, such as
+    // allocating vertex space, uploads, and recording draws, still happens below in op order.
+    if (SkExecutor* executor = flushState->executor()) {
+        SkSTArray<16, GrOp*, true> parallelOps;
+        for (int i = 0; i < fRecordedOps.count(); ++i) {
+            if (fRecordedOps[i].fOp && fRecordedOps[i].fOp->isChainHead()) {
+                GrOpFlushState::OpArgs opArgs = {
+                    fRecordedOps[i].fOp.get(),
+                    fTarget.get()->asRenderTargetProxy(),
+                    fRecordedOps[i].fAppliedClip,
+                    fRecordedOps[i].fDstProxy
+                };
+
+                flushState->setOpArgs(&opArgs);
+                if (fRecordedOps[i].fOp->wantsParallelPrepare(flushState)) {
+                    parallelOps.push_back(fRecordedOps[i].fOp.get());
+                }
+                flushState->setOpArgs(nullptr);
+            }
+        }
+        if (!parallelOps.empty()) {
+            // Use our own task group so that we only wait for these ops, not for other work that
+            // has been queued on the context's task group.
+            SkTaskGroup taskGroup(*executor);
+            taskGroup.batch(parallelOps.count(), [&parallelOps](int i) {
+                parallelOps[i]->parallelPrepare();
+            });
+            taskGroup.wait();
+        }
+    }
+
     // Loop over the ops that haven't yet been prepared.
     for (int i = 0; i < fRecordedOps.count(); ++i) {
         if (fRecordedOps[i].fOp && fRecordedOps[i].fOp->isChainHead()) {
@@ -353,19 +400,34 @@ uint32_t GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
                op->bounds().fRight, op->bounds().fBottom);
     GrOP_INFO(SkTabString(op->dumpInfo(), 1).c_str());
     GrOP_INFO("\tOutcome:\n");
-    int maxCandidates = SkTMin(kMaxOpLookback, fRecordedOps.count());
+    int maxCandidates = SkTMin(fMaxOpLookback, fRecordedOps.count());
     int firstChainableIdx = -1;
     if (maxCandidates) {
-        int i = 0;
-        while (true) {
-            const RecordedOp& candidate = fRecordedOps.fromBack(i);
+        // Only ops of the same class can combine or chain, and we can't search back past a chain
+        // head that we intersect. Rather than testing every op in the lookback window we ask the
+        // bounds index for the last chain head that we intersect and then only visit the ops of
+        // our class from there on. This visits the same candidates, in the same order, as a linear
+        // search would, which is what allows a much larger lookback.
+        int count = fRecordedOps.count();
+        int minIdx = count - maxCandidates;
+        int intersectIdx = fBoundsIndex.findLastOverlap(op->bounds(), minIdx);
+        if (intersectIdx >= 0) {
+            GrOP_INFO("\t\tBackward: Intersects with (%s, opID: %u)\n",
+                      fRecordedOps[intersectIdx].fOp->name(),
+                      fRecordedOps[intersectIdx].fOp->uniqueID());
+            minIdx = intersectIdx;
+        }
+        uint32_t classID = op->classID();
+        int idx = classID < SkToU32(fLastOpOfClass.count()) ? fLastOpOfClass[classID] : -1;
+        for (; idx >= minIdx; idx = fPrevOpOfSameClass[idx]) {
+            const RecordedOp& candidate = fRecordedOps[idx];
             auto combineResult = this->combineIfPossible(candidate, op.get(), clip, dstProxy, caps);
             switch (combineResult) {
                 case GrOp::CombineResult::kMayChain:
                     if (candidate.fOp->isChainTail() && firstChainableIdx < 0) {
                         GrOP_INFO("\t\tBackward: Can chain with (%s, opID: %u)\n",
                                   candidate.fOp->name(), candidate.fOp->uniqueID());
-                        firstChainableIdx = i;
+                        firstChainableIdx = count - 1 - idx;
                     }
                     break;
                 case GrOp::CombineResult::kMerged:
@@ -374,25 +436,17 @@ uint32_t GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
                     GrOP_INFO("\t\t\tBackward: Combined op info:\n");
                     GrOP_INFO(SkTabString(candidate.fOp->dumpInfo(), 4).c_str());
                     GR_AUDIT_TRAIL_OPS_RESULT_COMBINED(fAuditTrail, candidate.fOp.get(), op.get());
+                    if (candidate.fOp->isChainHead()) {
+                        fBoundsIndex.insert(idx, candidate.fOp->bounds());
+                    }
                     fOpMemoryPool->release(std::move(op));
                     return SK_InvalidUniqueID;
                 case GrOp::CombineResult::kCannotCombine:
                     break;
             }
-            // Stop going backwards if we would cause a painter's order violation. We only need to
-            // test against chain heads as elements of a chain always draw in their chain head's
-            // slot.
-            if (candidate.fOp->isChainHead() &&
-                !can_reorder(candidate.fOp->bounds(), op->bounds())) {
-                GrOP_INFO("\t\tBackward: Intersects with (%s, opID: %u)\n", candidate.fOp->name(),
-                          candidate.fOp->uniqueID());
-                break;
-            }
-            ++i;
-            if (i == maxCandidates) {
-                GrOP_INFO("\t\tBackward: Reached max lookback or beginning of op array %d\n", i);
-                break;
-            }
+        }
+        if (minIdx > 0 && intersectIdx < 0) {
+            GrOP_INFO("\t\tBackward: Reached max lookback %d\n", maxCandidates);
         }
     } else {
         GrOP_INFO("\t\tBackward: FirstOp\n");
@@ -429,8 +483,20 @@ uint32_t GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
             GrOP_INFO("\t\t\tBackward: Chained to (%s, opID: %u)\n", prevOp->name(),
                       prevOp->uniqueID());
             prevOp->setNextInChain(op.get());
+            // Chaining grows the bounds of the chain head, which is at 'idx'.
+            fBoundsIndex.insert(fRecordedOps.count() - 1 - idx, chainHead->bounds());
         }
     }
+    int newIdx = fRecordedOps.count();
+    if (op->isChainHead()) {
+        fBoundsIndex.insert(newIdx, op->bounds());
+    }
+    uint32_t classID = op->classID();
+    while (SkToU32(fLastOpOfClass.count()) <= classID) {
+        fLastOpOfClass.push_back(-1);
+    }
+    fPrevOpOfSameClass.push_back(fLastOpOfClass[classID]);
+    fLastOpOfClass[classID] = newIdx;
     fRecordedOps.emplace_back(std::move(op), clip, dstProxy);
     return this->uniqueID();
 }
@@ -440,10 +506,18 @@ void GrRenderTargetOpList::forwardCombine(const GrCaps& caps) {
 
     GrOP_INFO("opList: %d ForwardCombine %d ops:\n", this->uniqueID(), fRecordedOps.count());
 
+    // No more ops will be recorded so the backward search state is no longer needed. It would
+    // also be invalidated by the forward search moving ops between slots.
+    this->resetCombiningState();
+
+    if (!fMaxOpLookahead) {
+        return;
+    }
+
     for (int i = 0; i < fRecordedOps.count() - 1; ++i) {
         GrOp* op = fRecordedOps[i].fOp.get();
 
-        int maxCandidateIdx = SkTMin(i + kMaxOpLookahead, fRecordedOps.count() - 1);
+        int maxCandidateIdx = SkTMin(i + fMaxOpLookahead, fRecordedOps.count() - 1);
         int j = i + 1;
         int firstChainableIdx = -1;
         while (true) {
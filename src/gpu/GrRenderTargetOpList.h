@@ -9,6 +9,7 @@
 #define GrRenderTargetOpList_DEFINED
 
 #include "GrAppliedClip.h"
+#include "GrOpBoundsIndex.h"
 #include "GrOpList.h"
 #include "GrPathRendering.h"
 #include "GrPrimitiveProcessor.h"
@@ -32,8 +33,14 @@ private:
     using DstProxy = GrXferProcessor::DstProxy;
 
 public:
+    /**
+     * maxOpLookback and maxOpLookahead bound how many recorded ops are considered when searching
+     * for an op to combine a new op with, and when combining forward as the opList is closed. A
+     * negative value selects the default.
+     */
     GrRenderTargetOpList(GrResourceProvider*, sk_sp<GrOpMemoryPool>,
-                         GrRenderTargetProxy*, GrAuditTrail*);
+                         GrRenderTargetProxy*, GrAuditTrail*,
+                         int maxOpLookback = -1, int maxOpLookahead = -1);
 
     ~GrRenderTargetOpList() override;
 
@@ -127,6 +134,7 @@ private:
     friend class GrRenderTargetContextPriv; // for stencil clip state. TODO: this is invasive
 
     void deleteOps();
+    void resetCombiningState();
 
     struct RecordedOp {
         RecordedOp(std::unique_ptr<GrOp> op, GrAppliedClip* appliedClip, const DstProxy* dstProxy)
@@ -178,9 +186,19 @@ private:
     SkIRect                        fLastDevClipBounds;
     int                            fLastClipNumAnalyticFPs;
 
+    int                            fMaxOpLookback;
+    int                            fMaxOpLookahead;
+
     // For ops/opList we have mean: 5 stdDev: 28
     SkSTArray<5, RecordedOp, true> fRecordedOps;
 
+    // State for the backward combining search in recordOp. The bounds index holds the chain heads
+    // of fRecordedOps. fPrevOpOfSameClass parallels fRecordedOps and links each op to the previous
+    // op with the same class ID, and fLastOpOfClass is indexed by class ID (-1 for none).
+    GrOpBoundsIndex                fBoundsIndex;
+    SkTArray<int, true>            fPrevOpOfSameClass;
+    SkTArray<int, true>            fLastOpOfClass;
+
     // MDB TODO: 4096 for the first allocation of the clip space will be huge overkill.
     // Gather statistics to determine the correct size.
     SkArenaAlloc                   fClipAllocator{4096};
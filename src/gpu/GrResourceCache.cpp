@@ -133,7 +133,7 @@ void GrResourceCache::insertResource(GrGpuResource* resource) {
     if (resource->resourcePriv().getScratchKey().isValid() &&
         !resource->getUniqueKey().isValid()) {
         SkASSERT(!resource->resourcePriv().refsWrappedObjects());
-        fScratchMap.insert(resource->resourcePriv().getScratchKey(), resource);
+        fScratchMap.insert(resource);
     }
 
     this->purgeAsNeeded();
@@ -146,6 +146,7 @@ void GrResourceCache::removeResource(GrGpuResource* resource) {
     size_t size = resource->gpuMemorySize();
     if (resource->isPurgeable()) {
         fPurgeableQueue.remove(resource);
+        this->ageList(resource)->remove(resource);
         fPurgeableBytes -= size;
     } else {
         this->removeFromNonpurgeableArray(resource);
@@ -162,7 +163,7 @@ void GrResourceCache::removeResource(GrGpuResource* resource) {
 
     if (resource->resourcePriv().getScratchKey().isValid() &&
         !resource->getUniqueKey().isValid()) {
-        fScratchMap.remove(resource->resourcePriv().getScratchKey(), resource);
+        fScratchMap.remove(resource);
     }
     if (resource->getUniqueKey().isValid()) {
         fUniqueHash.remove(resource->getUniqueKey());
@@ -233,6 +234,113 @@ void GrResourceCache::releaseAll() {
     SkASSERT(!fPurgeableBytes);
 }
 
+GrResourceCache::ScratchMap::~ScratchMap() {
+    SkTDynamicHash<List, GrScratchKey>::Iter iter(&fLists);
+    for (; !iter.done(); ++iter) {
+        delete &(*iter);
+    }
+}
+
+void GrResourceCache::ScratchMap::insert(GrGpuResource* resource) {
+    const GrScratchKey& key = resource->resourcePriv().getScratchKey();
+    SkASSERT(key.isValid());
+    SkASSERT(!resource->cacheAccess().scratchPrev() && !resource->cacheAccess().scratchNext());
+    if (List* list = fLists.find(key)) {
+        resource->cacheAccess().scratchPrev() = list->fTail;
+        list->fTail->cacheAccess().scratchNext() = resource;
+        list->fTail = resource;
+    } else {
+        fLists.add(new List{resource, resource});
+    }
+    ++fCount;
+}
+
+void GrResourceCache::ScratchMap::unlink(List* list, const GrGpuResource* resource) {
+    GrGpuResource*& prev = resource->cacheAccess().scratchPrev();
+    GrGpuResource*& next = resource->cacheAccess().scratchNext();
+    (prev ? prev->cacheAccess().scratchNext() : list->fHead) = next;
+    (next ? next->cacheAccess().scratchPrev() : list->fTail) = prev;
+    prev = next = nullptr;
+}
+
+void GrResourceCache::ScratchMap::remove(const GrGpuResource* resource) {
+    const GrScratchKey& key = resource->resourcePriv().getScratchKey();
+    List* list = fLists.find(key);
+    SkASSERT(list && this->has(resource));
+    if (list->fHead == list->fTail) {
+        // The list's key comes from its head so remove it from the hash while it has one.
+        fLists.remove(key);
+        delete list;
+    } else {
+        this->unlink(list, resource);
+    }
+    --fCount;
+}
+
+void GrResourceCache::ScratchMap::moveToFront(GrGpuResource* resource) {
+    List* list = fLists.find(resource->resourcePriv().getScratchKey());
+    SkASSERT(list && this->has(resource));
+    if (list->fHead != resource) {
+        this->unlink(list, resource);
+        resource->cacheAccess().scratchNext() = list->fHead;
+        list->fHead->cacheAccess().scratchPrev() = resource;
+        list->fHead = resource;
+    }
+}
+
+void GrResourceCache::ScratchMap::moveToBack(GrGpuResource* resource) {
+    List* list = fLists.find(resource->resourcePriv().getScratchKey());
+    SkASSERT(list && this->has(resource));
+    if (list->fTail != resource) {
+        this->unlink(list, resource);
+        resource->cacheAccess().scratchPrev() = list->fTail;
+        list->fTail->cacheAccess().scratchNext() = resource;
+        list->fTail = resource;
+    }
+}
+
+template <typename Predicate>
+GrGpuResource* GrResourceCache::ScratchMap::find(const GrScratchKey& key,
+                                                 const Predicate& predicate) const {
+    List* list = fLists.find(key);
+    for (GrGpuResource* resource = list ? list->fHead : nullptr; resource;
+         resource = resource->cacheAccess().scratchNext()) {
+        if (predicate(resource)) {
+            return resource;
+        }
+    }
+    return nullptr;
+}
+
+#ifdef SK_DEBUG
+bool GrResourceCache::ScratchMap::has(const GrGpuResource* resource) const {
+    const GrScratchKey& key = resource->resourcePriv().getScratchKey();
+    return key.isValid() && this->find(key, [resource](const GrGpuResource* r) {
+        return r == resource;
+    });
+}
+
+int GrResourceCache::ScratchMap::countForKey(const GrScratchKey& key) const {
+    int count = 0;
+    this->find(key, [&count](const GrGpuResource*) {
+        ++count;
+        return false;
+    });
+    return count;
+}
+
+template <typename Fn>
+void GrResourceCache::ScratchMap::foreach(Fn&& fn) const {
+    SkTDynamicHash<List, GrScratchKey>::ConstIter iter(&fLists);
+    for (; !iter.done(); ++iter) {
+        for (const GrGpuResource* resource = (*iter).fHead; resource;
+             resource = resource->cacheAccess().scratchNext()) {
+            fn(resource);
+        }
+    }
+}
+#endif
+
 class GrResourceCache::AvailableForScratchUse {
 public:
     AvailableForScratchUse(bool rejectPendingIO) : fRejectPendingIO(rejectPendingIO) { }
@@ -259,6 +367,7 @@ GrGpuResource* GrResourceCache::findAndRefScratchResource(const GrScratchKey& sc
     if (flags & (kPreferNoPendingIO_ScratchFlag | kRequireNoPendingIO_ScratchFlag)) {
         resource = fScratchMap.find(scratchKey, AvailableForScratchUse(true));
         if (resource) {
+            fScratchMap.moveToBack(resource);
             this->refAndMakeResourceMRU(resource);
             this->validate();
             return resource;
@@ -276,6 +385,7 @@ GrGpuResource* GrResourceCache::findAndRefScratchResource(const GrScratchKey& sc
     }
     resource = fScratchMap.find(scratchKey, AvailableForScratchUse(false));
     if (resource) {
+        fScratchMap.moveToBack(resource);
         this->refAndMakeResourceMRU(resource);
         this->validate();
     }
@@ -285,7 +395,7 @@ GrGpuResource* GrResourceCache::findAndRefScratchResource(const GrScratchKey& sc
 void GrResourceCache::willRemoveScratchKey(const GrGpuResource* resource) {
     SkASSERT(resource->resourcePriv().getScratchKey().isValid());
     if (!resource->getUniqueKey().isValid()) {
-        fScratchMap.remove(resource->resourcePriv().getScratchKey(), resource);
+        fScratchMap.remove(resource);
     }
 }
 
@@ -296,10 +406,21 @@ void GrResourceCache::removeUniqueKey(GrGpuResource* resource) {
         SkASSERT(resource == fUniqueHash.find(resource->getUniqueKey()));
         fUniqueHash.remove(resource->getUniqueKey());
     }
+    // Without its unique key a purgeable resource becomes a scratch resource. This happens to the
+    // previous owner of a key in changeUniqueKey().
+    if (resource->isPurgeable()) {
+        this->ageList(resource)->remove(resource);
+    }
     resource->cacheAccess().removeUniqueKey();
+    if (resource->isPurgeable()) {
+        this->insertIntoAgeList(resource);
+    }
 
     if (resource->resourcePriv().getScratchKey().isValid()) {
-        fScratchMap.insert(resource->resourcePriv().getScratchKey(), resource);
+        fScratchMap.insert(resource);
+        if (resource->isPurgeable()) {
+            fScratchMap.moveToFront(resource);
+        }
     }
 
     this->validate();
@@ -330,11 +451,17 @@ void GrResourceCache::changeUniqueKey(GrGpuResource* resource, const GrUniqueKey
             // 'resource' didn't have a valid unique key before so it is switching sides. Remove it
             // from the ScratchMap
             if (resource->resourcePriv().getScratchKey().isValid()) {
-                fScratchMap.remove(resource->resourcePriv().getScratchKey(), resource);
+                fScratchMap.remove(resource);
             }
         }
 
+        if (resource->isPurgeable()) {
+            this->ageList(resource)->remove(resource);
+        }
         resource->cacheAccess().setUniqueKey(newKey);
+        if (resource->isPurgeable()) {
+            this->insertIntoAgeList(resource);
+        }
         fUniqueHash.add(resource);
     } else {
         this->removeUniqueKey(resource);
@@ -351,6 +478,7 @@ void GrResourceCache::refAndMakeResourceMRU(GrGpuResource* resource) {
         // It's about to become unpurgeable.
         fPurgeableBytes -= resource->gpuMemorySize();
         fPurgeableQueue.remove(resource);
+        this->ageList(resource)->remove(resource);
         this->addToNonpurgeableArray(resource);
     }
     resource->ref();
@@ -379,6 +507,14 @@ void GrResourceCache::notifyCntReachedZero(GrGpuResource* resource, uint32_t fla
 #endif
         resource->cacheAccess().setTimestamp(this->getNextTimestamp());
         SkDEBUGCODE(fNewlyPurgeableResourceForValidation = nullptr);
+
+        // Prefer the most recently freed resource for scratch reuse. It is more likely to still
+        // be resident and this lets the ones that stay unused age out. Resources that are reused
+        // move to the back of the list so lookups don't have to skip past them while in use.
+        if (resource->resourcePriv().getScratchKey().isValid() &&
+            !resource->getUniqueKey().isValid()) {
+            fScratchMap.moveToFront(resource);
+        }
     }
 
     if (!SkToBool(ResourceAccess::kAllCntsReachedZero_RefNotificationFlag & flags)) {
@@ -391,6 +527,7 @@ void GrResourceCache::notifyCntReachedZero(GrGpuResource* resource, uint32_t fla
     fPurgeableQueue.insert(resource);
     resource->cacheAccess().setFlushCntWhenResourceBecamePurgeable(fExternalFlushCnt);
     resource->cacheAccess().setTimeWhenResourceBecomePurgeable();
+    this->ageList(resource)->addToTail(resource);
     fPurgeableBytes += resource->gpuMemorySize();
 
     if (SkBudgeted::kNo == resource->resourcePriv().isBudgeted()) {
@@ -507,21 +644,15 @@ void GrResourceCache::purgeUnlockedResources(bool scratchResourcesOnly) {
             resource->cacheAccess().release();
         }
     } else {
-        // Sort the queue
-        fPurgeableQueue.sort();
-
-        // Make a list of the scratch resources to delete
+        // Make a list of the scratch resources to delete, oldest first.
         SkTDArray<GrGpuResource*> scratchResources;
-        for (int i = 0; i < fPurgeableQueue.count(); i++) {
-            GrGpuResource* resource = fPurgeableQueue.at(i);
+        for (GrGpuResource* resource : fPurgeableScratchAgeList) {
             SkASSERT(resource->isPurgeable());
-            if (!resource->getUniqueKey().isValid()) {
-                *scratchResources.append() = resource;
-            }
+            *scratchResources.append() = resource;
         }
 
         // Delete the scratch resources. This must be done as a separate pass
-        // to avoid messing up the sorted order of the queue
+        // since releasing a resource removes it from the list.
         for (int i = 0; i < scratchResources.count(); i++) {
             scratchResources.getAt(i)->cacheAccess().release();
         }
@@ -531,19 +662,13 @@ void GrResourceCache::purgeUnlockedResources(bool scratchResourcesOnly) {
 }
 
 void GrResourceCache::purgeResourcesNotUsedSince(GrStdSteadyClock::time_point purgeTime) {
-    while (fPurgeableQueue.count()) {
-        const GrStdSteadyClock::time_point resourceTime =
-                fPurgeableQueue.peek()->cacheAccess().timeWhenResourceBecamePurgeable();
-        if (resourceTime >= purgeTime) {
-            // Resources were given both LRU timestamps and tagged with a frame number when
-            // they first became purgeable. The LRU timestamp won't change again until the
-            // resource is made non-purgeable again. So, at this point all the remaining
-            // resources in the timestamp-sorted queue will have a frame number >= to this
-            // one.
+    // The age lists are ordered by the time each resource became purgeable, so this only visits
+    // the resources it purges.
+    while (GrGpuResource* resource = this->oldestPurgeableResource()) {
+        SkASSERT(resource->isPurgeable());
+        if (resource->cacheAccess().timeWhenResourceBecamePurgeable() >= purgeTime) {
             break;
         }
-        GrGpuResource* resource = fPurgeableQueue.peek();
-        SkASSERT(resource->isPurgeable());
         resource->cacheAccess().release();
     }
 }
@@ -554,24 +679,21 @@ void GrResourceCache::purgeUnlockedResources(size_t bytesToPurge, bool preferScr
     bool stillOverbudget = tmpByteBudget < fBytes;
 
     if (preferScratchResources && bytesToPurge < fPurgeableBytes) {
-        // Sort the queue
-        fPurgeableQueue.sort();
-
-        // Make a list of the scratch resources to delete
+        // Make a list of the oldest scratch resources to delete
         SkTDArray<GrGpuResource*> scratchResources;
         size_t scratchByteCount = 0;
-        for (int i = 0; i < fPurgeableQueue.count() && stillOverbudget; i++) {
-            GrGpuResource* resource = fPurgeableQueue.at(i);
+        AgeList::Iter iter;
+        GrGpuResource* resource = iter.init(fPurgeableScratchAgeList,
+                                            AgeList::Iter::kHead_IterStart);
+        for (; resource && stillOverbudget; resource = iter.next()) {
             SkASSERT(resource->isPurgeable());
-            if (!resource->getUniqueKey().isValid()) {
-                *scratchResources.append() = resource;
-                scratchByteCount += resource->gpuMemorySize();
-                stillOverbudget = tmpByteBudget < fBytes - scratchByteCount;
-            }
+            *scratchResources.append() = resource;
+            scratchByteCount += resource->gpuMemorySize();
+            stillOverbudget = tmpByteBudget < fBytes - scratchByteCount;
         }
 
         // Delete the scratch resources. This must be done as a separate pass
-        // to avoid messing up the sorted order of the queue
+        // since releasing a resource removes it from the list.
         for (int i = 0; i < scratchResources.count(); i++) {
             scratchResources.getAt(i)->cacheAccess().release();
         }
@@ -622,6 +744,33 @@ void GrResourceCache::processFreedGpuResources() {
     }
 }
 
+void GrResourceCache::insertIntoAgeList(GrGpuResource* resource) {
+    SkASSERT(resource->isPurgeable());
+    AgeList* list = this->ageList(resource);
+    // Resources normally join the list as they become purgeable so this rarely walks.
+    AgeList::Iter iter;
+    GrGpuResource* older = iter.init(*list, AgeList::Iter::kTail_IterStart);
+    while (older && older->cacheAccess().timeWhenResourceBecamePurgeable() >
+                    resource->cacheAccess().timeWhenResourceBecamePurgeable()) {
+        older = iter.prev();
+    }
+    if (older) {
+        list->addAfter(resource, older);
+    } else {
+        list->addToHead(resource);
+    }
+}
+
+GrGpuResource* GrResourceCache::oldestPurgeableResource() {
+    GrGpuResource* scratch = fPurgeableScratchAgeList.head();
+    GrGpuResource* unique = fPurgeableUniqueAgeList.head();
+    if (!scratch || !unique) {
+        return scratch ? scratch : unique;
+    }
+    return scratch->cacheAccess().timeWhenResourceBecamePurgeable() <=
+           unique->cacheAccess().timeWhenResourceBecamePurgeable() ? scratch : unique;
+}
+
 void GrResourceCache::addToNonpurgeableArray(GrGpuResource* resource) {
     int index = fNonpurgeableResources.count();
     *fNonpurgeableResources.append() = resource;
@@ -787,7 +936,7 @@ void GrResourceCache::validate() const {
                          resource->resourcePriv().refsWrappedObjects());
 
                 if (scratchKey.isValid()) {
-                    SkASSERT(!fScratchMap->has(resource, scratchKey));
+                    SkASSERT(!fScratchMap->has(resource));
                 }
             }
 
@@ -799,15 +948,12 @@ void GrResourceCache::validate() const {
     };
 
     {
-        ScratchMap::ConstIter iter(&fScratchMap);
-
         int count = 0;
-        for ( ; !iter.done(); ++iter) {
-            const GrGpuResource* resource = *iter;
+        fScratchMap.foreach([&count](const GrGpuResource* resource) {
             SkASSERT(resource->resourcePriv().getScratchKey().isValid());
             SkASSERT(!resource->getUniqueKey().isValid());
             count++;
-        }
+        });
         SkASSERT(count == fScratchMap.count()); // ensure the iterator is working correctly
     }
 
@@ -821,6 +967,18 @@ void GrResourceCache::validate() const {
         SkASSERT(!fNonpurgeableResources[i]->wasDestroyed());
         stats.update(fNonpurgeableResources[i]);
     }
+    SkASSERT(fPurgeableScratchAgeList.countEntries() + fPurgeableUniqueAgeList.countEntries() ==
+             fPurgeableQueue.count());
+    for (const AgeList* list : {&fPurgeableScratchAgeList, &fPurgeableUniqueAgeList}) {
+        GrGpuResource* older = nullptr;
+        for (GrGpuResource* resource : *list) {
+            SkASSERT(resource->isPurgeable());
+            SkASSERT(list == this->ageList(resource));
+            SkASSERT(!older || older->cacheAccess().timeWhenResourceBecamePurgeable() <=
+                               resource->cacheAccess().timeWhenResourceBecamePurgeable());
+            older = resource;
+        }
+    }
     for (int i = 0; i < fPurgeableQueue.count(); ++i) {
         SkASSERT(fPurgeableQueue.at(i)->isPurgeable());
         SkASSERT(*fPurgeableQueue.at(i)->cacheAccess().accessCacheIndex() == i);
@@ -16,8 +16,8 @@
 #include "SkRefCnt.h"
 #include "SkTArray.h"
 #include "SkTDPQueue.h"
+#include "SkTDynamicHash.h"
 #include "SkTInternalLList.h"
-#include "SkTMultiMap.h"
 
 class GrCaps;
 class GrProxyProvider;
@@ -281,6 +281,9 @@ private:
 
     void processInvalidUniqueKeys(const SkTArray<GrUniqueKeyInvalidatedMessage>&);
     void processFreedGpuResources();
+    // Inserts a purgeable resource into its age list, keeping the list ordered.
+    void insertIntoAgeList(GrGpuResource*);
+    GrGpuResource* oldestPurgeableResource();
     void addToNonpurgeableArray(GrGpuResource*);
     void removeFromNonpurgeableArray(GrGpuResource*);
 
@@ -301,15 +304,53 @@ private:
 
     class AvailableForScratchUse;
 
-    struct ScratchMapTraits {
-        static const GrScratchKey& GetKey(const GrGpuResource& r) {
-            return r.resourcePriv().getScratchKey();
-        }
+    /**
+     * The resources that can be used as scratch resources, grouped by scratch key. Each key's
+     * resources are kept in a doubly linked list threaded through the resources themselves, so
+     * a resource can be moved to either end of its list in constant time.
+     */
+    class ScratchMap {
+    public:
+        ~ScratchMap();
+
+        /** Adds the resource at the back of its key's list. */
+        void insert(GrGpuResource*);
+        void remove(const GrGpuResource*);
+
+        /** Moves the resource to the front of its key's list, where find() looks first. */
+        void moveToFront(GrGpuResource*);
+        void moveToBack(GrGpuResource*);
 
-        static uint32_t Hash(const GrScratchKey& key) { return key.hash(); }
-        static void OnFree(GrGpuResource*) { }
+        /** Returns the first resource in the key's list that satisfies the predicate. */
+        template <typename Predicate>
+        GrGpuResource* find(const GrScratchKey&, const Predicate&) const;
+
+        int count() const { return fCount; }
+
+#ifdef SK_DEBUG
+        bool has(const GrGpuResource*) const;
+        // This walks the key's list so it is only used for validation.
+        int countForKey(const GrScratchKey&) const;
+        template <typename Fn>  // fn(const GrGpuResource*)
+        void foreach(Fn&& fn) const;
+#endif
+
+    private:
+        struct List {
+            GrGpuResource* fHead;
+            GrGpuResource* fTail;
+
+            static const GrScratchKey& GetKey(const List& list) {
+                return list.fHead->resourcePriv().getScratchKey();
+            }
+            static uint32_t Hash(const GrScratchKey& key) { return key.hash(); }
+        };
+
+        void unlink(List*, const GrGpuResource*);
+
+        SkTDynamicHash<List, GrScratchKey> fLists;
+        int                                fCount = 0;
     };
-    typedef SkTMultiMap<GrGpuResource, GrScratchKey, ScratchMapTraits> ScratchMap;
 
     struct UniqueHashTraits {
         static const GrUniqueKey& GetKey(const GrGpuResource& r) { return r.getUniqueKey(); }
@@ -330,6 +371,16 @@ private:
     typedef SkMessageBus<GrGpuResourceFreedMessage>::Inbox FreedGpuResourceInbox;
     typedef SkTDPQueue<GrGpuResource*, CompareTimestamp, AccessResourceIndex> PurgeableQueue;
     typedef SkTDArray<GrGpuResource*> ResourceArray;
+    typedef SkTInternalLList<GrGpuResource> AgeList;
+
+    // The age list that a purgeable resource belongs in.
+    AgeList* ageList(const GrGpuResource* resource) {
+        return resource->getUniqueKey().isValid() ? &fPurgeableUniqueAgeList
+                                                  : &fPurgeableScratchAgeList;
+    }
+    const AgeList* ageList(const GrGpuResource* resource) const {
+        return const_cast<GrResourceCache*>(this)->ageList(resource);
+    }
 
     GrProxyProvider*                    fProxyProvider;
     // Whenever a resource is added to the cache or the result of a cache lookup, fTimestamp is
@@ -337,6 +388,11 @@ private:
     // purgeable resources by this value, and thus is used to purge resources in LRU order.
     uint32_t                            fTimestamp;
     PurgeableQueue                      fPurgeableQueue;
+    // The purgeable resources without and with unique keys, each in the order they became
+    // purgeable, oldest first. Time based and scratch only purges walk these rather than sorting
+    // fPurgeableQueue so they only visit the resources they purge.
+    AgeList                             fPurgeableScratchAgeList;
+    AgeList                             fPurgeableUniqueAgeList;
     ResourceArray                       fNonpurgeableResources;
 
     // This map holds all resources that can be used as scratch resources.
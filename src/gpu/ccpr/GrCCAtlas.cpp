@@ -10,7 +10,7 @@
 #include "GrCaps.h"
 #include "GrOnFlushResourceProvider.h"
 #include "GrProxyProvider.h"
-#include "GrRectanizer_skyline.h"
+#include "GrRectanizer_wastemap.h"
 #include "GrRenderTargetContext.h"
 #include "GrTexture.h"
 #include "GrTextureProxy.h"
@@ -43,7 +43,7 @@ public:
 private:
     const std::unique_ptr<Node> fPrevious;
     const int fX, fY;
-    GrRectanizerSkyline fRectanizer;
+    GrRectanizerWasteMap fRectanizer;
 };
 
 GrCCAtlas::GrCCAtlas(GrPixelConfig pixelConfig, const Specs& specs, const GrCaps& caps)
@@ -35,6 +35,7 @@
 #include "SkTo.h"
 #include "SkTraceEvent.h"
 #include "SkTypes.h"
+#include "builders/GrGLShaderPrecompiler.h"
 #include "builders/GrGLShaderStringBuilder.h"
 
 #include <cmath>
@@ -27,6 +27,7 @@
 class GrGLBuffer;
 class GrGLGpuRTCommandBuffer;
 class GrGLGpuTextureCommandBuffer;
+class GrGLShaderPrecompiler;
 class GrPipeline;
 class GrSwizzle;
 
@@ -131,6 +132,11 @@ public:
         fHWBoundRenderTargetUniqueID.makeInvalid();
     }
 
+    int precompileShaders(const sk_sp<SkData> keys[], int count) override;
+
+    // Null until precompileShaders() has been called.
+    GrGLShaderPrecompiler* shaderPrecompiler() const { return fShaderPrecompiler.get(); }
+
     GrStencilAttachment* createStencilAttachmentForRenderTarget(const GrRenderTarget* rt,
                                                                 int width,
                                                                 int height) override;
@@ -406,6 +412,7 @@ private:
 
     // GL program-related state
     ProgramCache*               fProgramCache;
+    sk_sp<GrGLShaderPrecompiler> fShaderPrecompiler;
 
     ///////////////////////////////////////////////////////////////////////////
     ///@name Caching of GL State
@@ -8,6 +8,9 @@
 #include "GrGLGpu.h"
 
 #include "builders/GrGLProgramBuilder.h"
+#include "builders/GrGLShaderPrecompiler.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
 #include "GrProcessor.h"
 #include "GrProgramDesc.h"
 #include "GrGLPathRendering.h"
@@ -105,3 +108,24 @@ GrGLProgram* GrGLGpu::ProgramCache::refProgram(const GrGLGpu* gpu,
 
     return SkRef((*entry)->fProgram.get());
 }
+
+int GrGLGpu::precompileShaders(const sk_sp<SkData> keys[], int count) {
+    // With program binaries there is no SkSL left to compile on a cache hit.
+    auto persistentCache = this->getContext()->contextPriv().getPersistentCache();
+    if (!persistentCache || this->glCaps().programBinarySupport()) {
+        return 0;
+    }
+    if (!fShaderPrecompiler) {
+        fShaderPrecompiler.reset(
+                new GrGLShaderPrecompiler(sk_ref_sp(this->caps()->shaderCaps())));
+    }
+    int added = 0;
+    for (int i = 0; i < count; ++i) {
+        sk_sp<SkData> data = persistentCache->load(*keys[i]);
+        if (data && fShaderPrecompiler->add(*keys[i], *data)) {
+            ++added;
+        }
+    }
+    fShaderPrecompiler->compile(this->getContext()->contextPriv().getTaskGroup());
+    return added;
+}
@@ -29,6 +29,37 @@
 #define GL_CALL(X) GR_GL_CALL(this->gpu()->glInterface(), X)
 #define GL_CALL_RET(R, X) GR_GL_CALL_RET(this->gpu()->glInterface(), R, X)
 
+static GrGLShaderPrecompiler::ShaderType precompiled_shader_type(GrGLenum type) {
+    switch (type) {
+        case GR_GL_VERTEX_SHADER:   return GrGLShaderPrecompiler::kVertex_ShaderType;
+        case GR_GL_GEOMETRY_SHADER: return GrGLShaderPrecompiler::kGeometry_ShaderType;
+        case GR_GL_FRAGMENT_SHADER: return GrGLShaderPrecompiler::kFragment_ShaderType;
+    }
+    SK_ABORT("unsupported shader kind");
+    return GrGLShaderPrecompiler::kFragment_ShaderType;
+}
+
+// Compares every setting which affects the GLSL SkSL::Compiler generates.
+static bool same_settings(const SkSL::Program::Settings& a, const SkSL::Program::Settings& b) {
+    if (a.fCaps != b.fCaps ||
+        a.fFlipY != b.fFlipY ||
+        a.fFragColorIsInOut != b.fFragColorIsInOut ||
+        a.fReplaceSettings != b.fReplaceSettings ||
+        a.fForceHighPrecision != b.fForceHighPrecision ||
+        a.fSharpenTextures != b.fSharpenTextures ||
+        a.fArgs.size() != b.fArgs.size()) {
+        return false;
+    }
+    for (const auto& arg : a.fArgs) {
+        auto found = b.fArgs.find(arg.first);
+        if (found == b.fArgs.end() || found->second.fKind != arg.second.fKind ||
+            found->second.fValue != arg.second.fValue) {
+            return false;
+        }
+    }
+    return true;
+}
+
 GrGLProgram* GrGLProgramBuilder::CreateProgram(const GrPrimitiveProcessor& primProc,
                                                const GrPipeline& pipeline,
                                                GrProgramDesc* desc,
@@ -50,6 +81,10 @@ GrGLProgram* GrGLProgramBuilder::CreateProgram(const GrPrimitiveProcessor& primP
         // doing necessary setup in addition to generating the SkSL code. Currently we are only able
         // to skip the SkSL->GLSL step on a cache hit.
     }
+    GrGLShaderPrecompiler* precompiler = gpu->shaderPrecompiler();
+    if (precompiler && !gpu->glCaps().programBinarySupport()) {
+        builder.fPrecompiled = precompiler->find(desc->asKey(), desc->keyLength());
+    }
     if (!builder.emitAndInstallProcs()) {
         return nullptr;
     }
@@ -128,6 +163,37 @@ bool GrGLProgramBuilder::compileAndAttachShaders(GrGLSLShaderBuilder& shader,
                                          *outInputs);
 }
 
+bool GrGLProgramBuilder::translateShader(GrGLSLShaderBuilder& shader,
+                                         GrGLenum type,
+                                         const SkSL::Program::Settings& settings,
+                                         SkSL::String* glsl,
+                                         SkSL::Program::Inputs* outInputs) {
+    if (fPrecompiled) {
+        const SkSL::String& precompiled = fPrecompiled->fGLSL[precompiled_shader_type(type)];
+        if (!precompiled.empty()) {
+            *glsl = precompiled;
+            if (outInputs) {
+                *outInputs = fPrecompiled->fInputs;
+            }
+            return true;
+        }
+    }
+    std::unique_ptr<SkSL::Program> program = GrSkSLtoGLSL(gpu()->glContext(),
+                                                          type,
+                                                          shader.fCompilerStrings.begin(),
+                                                          shader.fCompilerStringLengths.begin(),
+                                                          shader.fCompilerStrings.count(),
+                                                          settings,
+                                                          glsl);
+    if (!program) {
+        return false;
+    }
+    if (outInputs) {
+        *outInputs = program->fInputs;
+    }
+    return true;
+}
+
 void GrGLProgramBuilder::computeCountsAndStrides(GrGLuint programID,
                                                  const GrPrimitiveProcessor& primProc,
                                                  bool bindAttribLocations) {
@@ -225,19 +291,14 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
         if (fFS.fForceHighPrecision) {
             settings.fForceHighPrecision = true;
         }
+        if (fPrecompiled && !same_settings(fPrecompiled->fSettings, settings)) {
+            fPrecompiled = nullptr;
+        }
         SkSL::String glsl;
-        std::unique_ptr<SkSL::Program> fs = GrSkSLtoGLSL(gpu()->glContext(),
-                                                         GR_GL_FRAGMENT_SHADER,
-                                                         fFS.fCompilerStrings.begin(),
-                                                         fFS.fCompilerStringLengths.begin(),
-                                                         fFS.fCompilerStrings.count(),
-                                                         settings,
-                                                         &glsl);
-        if (!fs) {
+        if (!this->translateShader(fFS, GR_GL_FRAGMENT_SHADER, settings, &glsl, &inputs)) {
             this->cleanupProgram(programID, shadersToDelete);
             return nullptr;
         }
-        inputs = fs->fInputs;
         this->addInputVars(inputs);
         if (!this->compileAndAttachShaders(glsl.c_str(), glsl.size(), programID,
                                            GR_GL_FRAGMENT_SHADER, &shadersToDelete, settings,
@@ -246,16 +307,10 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
             return nullptr;
         }
 
-        std::unique_ptr<SkSL::Program> vs = GrSkSLtoGLSL(gpu()->glContext(),
-                                                         GR_GL_VERTEX_SHADER,
-                                                         fVS.fCompilerStrings.begin(),
-                                                         fVS.fCompilerStringLengths.begin(),
-                                                         fVS.fCompilerStrings.count(),
-                                                         settings,
-                                                         &glsl);
-        if (!vs || !this->compileAndAttachShaders(glsl.c_str(), glsl.size(), programID,
-                                                  GR_GL_VERTEX_SHADER, &shadersToDelete, settings,
-                                                  inputs)) {
+        if (!this->translateShader(fVS, GR_GL_VERTEX_SHADER, settings, &glsl, nullptr) ||
+            !this->compileAndAttachShaders(glsl.c_str(), glsl.size(), programID,
+                                           GR_GL_VERTEX_SHADER, &shadersToDelete, settings,
+                                           inputs)) {
             this->cleanupProgram(programID, shadersToDelete);
             return nullptr;
         }
@@ -267,17 +322,10 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
         }
 
         if (primProc.willUseGeoShader()) {
-            std::unique_ptr<SkSL::Program> gs;
-            gs = GrSkSLtoGLSL(gpu()->glContext(),
-                              GR_GL_GEOMETRY_SHADER,
-                              fGS.fCompilerStrings.begin(),
-                              fGS.fCompilerStringLengths.begin(),
-                              fGS.fCompilerStrings.count(),
-                              settings,
-                              &glsl);
-            if (!gs || !this->compileAndAttachShaders(glsl.c_str(), glsl.size(), programID,
-                                                      GR_GL_GEOMETRY_SHADER, &shadersToDelete,
-                                                      settings, inputs)) {
+            if (!this->translateShader(fGS, GR_GL_GEOMETRY_SHADER, settings, &glsl, nullptr) ||
+                !this->compileAndAttachShaders(glsl.c_str(), glsl.size(), programID,
+                                               GR_GL_GEOMETRY_SHADER, &shadersToDelete,
+                                               settings, inputs)) {
                 this->cleanupProgram(programID, shadersToDelete);
                 return nullptr;
             }
@@ -335,6 +383,27 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
                                             *key, *SkData::MakeWithoutCopy(data.get(), dataLength));
         }
     }
+    if (!fPrecompiled && this->gpu()->getContext()->contextPriv().getPersistentCache() &&
+        !fGpu->glCaps().programBinarySupport()) {
+        // Without binaries, store the SkSL so the next run can precompile it. See
+        // GrContext::precompileShaders.
+        auto skslSource = [](const GrGLSLShaderBuilder& shader) {
+            SkSL::String sksl;
+            for (int i = 0; i < shader.fCompilerStrings.count(); ++i) {
+                sksl.append(shader.fCompilerStrings[i], shader.fCompilerStringLengths[i]);
+            }
+            return sksl;
+        };
+        SkSL::String sksl[GrGLShaderPrecompiler::kShaderTypeCount];
+        sksl[GrGLShaderPrecompiler::kVertex_ShaderType] = skslSource(fVS);
+        if (primProc.willUseGeoShader()) {
+            sksl[GrGLShaderPrecompiler::kGeometry_ShaderType] = skslSource(fGS);
+        }
+        sksl[GrGLShaderPrecompiler::kFragment_ShaderType] = skslSource(fFS);
+        sk_sp<SkData> key = SkData::MakeWithoutCopy(desc()->asKey(), desc()->keyLength());
+        this->gpu()->getContext()->contextPriv().getPersistentCache()->store(
+                *key, *GrGLShaderPrecompiler::Encode(settings, sksl));
+    }
     return this->createProgram(programID);
 }
 
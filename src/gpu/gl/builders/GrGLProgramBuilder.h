@@ -13,6 +13,7 @@
 #include "gl/GrGLProgramDataManager.h"
 #include "gl/GrGLUniformHandler.h"
 #include "gl/GrGLVaryingHandler.h"
+#include "gl/builders/GrGLShaderPrecompiler.h"
 #include "glsl/GrGLSLProgramBuilder.h"
 #include "glsl/GrGLSLProgramDataManager.h"
 #include "ir/SkSLProgram.h"
@@ -63,6 +64,13 @@ private:
                                  SkTDArray<GrGLuint>* shaderIds,
                                  const SkSL::Program::Settings& settings,
                                  SkSL::Program::Inputs* outInputs);
+    // Produces the shader's GLSL, taking it from fPrecompiled when possible and otherwise
+    // compiling the shader's SkSL. outInputs may be null.
+    bool translateShader(GrGLSLShaderBuilder& shader,
+                         GrGLenum type,
+                         const SkSL::Program::Settings& settings,
+                         SkSL::String* glsl,
+                         SkSL::Program::Inputs* outInputs);
     void computeCountsAndStrides(GrGLuint programID, const GrPrimitiveProcessor& primProc,
                                  bool bindAttribLocations);
     GrGLProgram* finalize();
@@ -95,6 +103,9 @@ private:
     // (all remaining bytes) char[] binary
     sk_sp<SkData> fCached;
 
+    // GLSL translated ahead of time by the GPU's GrGLShaderPrecompiler, if any.
+    const GrGLShaderPrecompiler::Entry* fPrecompiled = nullptr;
+
     typedef GrGLSLProgramBuilder INHERITED;
 };
 #endif
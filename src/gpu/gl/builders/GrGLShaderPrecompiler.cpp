@@ -0,0 +1,256 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrGLShaderPrecompiler.h"
+
+#include "GrShaderCaps.h"
+#include "SkBuffer.h"
+#include "SkSLCompiler.h"
+#include "SkTaskGroup.h"
+#include "SkTraceEvent.h"
+
+#include <vector>
+
+// Entries are laid out as:
+//   uint32_t magic
+//   uint32_t version
+//   uint32_t settings flags
+//   uint32_t arg count
+//   arg count x { uint32_t length, char[length] name, padding to 4 bytes, uint32_t kind,
+//                 int32_t value }
+//   kShaderTypeCount x { uint32_t length, char[length] SkSL, padding to 4 bytes }
+static const uint32_t kMagic = SkSetFourByteTag('s', 'k', 's', 'l');
+static const uint32_t kVersion = 2;
+
+enum SettingsFlags {
+    kFlipY_SettingsFlag              = 1 << 0,
+    kFragColorIsInOut_SettingsFlag   = 1 << 1,
+    kForceHighPrecision_SettingsFlag = 1 << 2,
+    kSharpenTextures_SettingsFlag    = 1 << 3,
+    kReplaceSettings_SettingsFlag    = 1 << 4,
+};
+
+static const SkSL::Program::Kind kProgramKinds[] = {
+    SkSL::Program::kVertex_Kind,
+    SkSL::Program::kGeometry_Kind,
+    SkSL::Program::kFragment_Kind,
+};
+static_assert(SK_ARRAY_COUNT(kProgramKinds) == GrGLShaderPrecompiler::kShaderTypeCount, "");
+
+static size_t string_size(const SkSL::String& string) {
+    return sizeof(uint32_t) + SkAlign4(string.size());
+}
+
+static void write_string(SkWBuffer* buffer, const SkSL::String& string) {
+    buffer->write32(SkToU32(string.size()));
+    buffer->write(string.c_str(), string.size());
+    buffer->padToAlign4();
+}
+
+static bool read_string(SkRBuffer* buffer, SkSL::String* string) {
+    uint32_t length;
+    if (!buffer->readU32(&length)) {
+        return false;
+    }
+    const char* chars = (const char*) buffer->skip(length);
+    if (!chars || !buffer->skipToAlign4()) {
+        return false;
+    }
+    *string = SkSL::String(chars, length);
+    return true;
+}
+
+GrGLShaderPrecompiler::GrGLShaderPrecompiler(sk_sp<const GrShaderCaps> caps)
+        : fCaps(std::move(caps)) {}
+
+GrGLShaderPrecompiler::~GrGLShaderPrecompiler() {
+#ifdef SK_DEBUG
+    // Compile tasks hold a ref until they finish, so no entry can still be compiling.
+    fEntries.foreach([](const SkString&, std::unique_ptr<Entry>* entry) {
+        SkASSERT(Entry::kCompiling_State != (*entry)->fState.load());
+    });
+#endif
+    fNewEntries.reset();
+    fEntries.reset();
+}
+
+sk_sp<SkData> GrGLShaderPrecompiler::Encode(const SkSL::Program::Settings& settings,
+                                            const SkSL::String sksl[kShaderTypeCount]) {
+    size_t size = 4 * sizeof(uint32_t);
+    for (const auto& arg : settings.fArgs) {
+        size += string_size(arg.first) + 2 * sizeof(uint32_t);
+    }
+    for (int i = 0; i < kShaderTypeCount; ++i) {
+        size += string_size(sksl[i]);
+    }
+    uint32_t flags = 0;
+    if (settings.fFlipY) {
+        flags |= kFlipY_SettingsFlag;
+    }
+    if (settings.fFragColorIsInOut) {
+        flags |= kFragColorIsInOut_SettingsFlag;
+    }
+    if (settings.fForceHighPrecision) {
+        flags |= kForceHighPrecision_SettingsFlag;
+    }
+    if (settings.fSharpenTextures) {
+        flags |= kSharpenTextures_SettingsFlag;
+    }
+    if (settings.fReplaceSettings) {
+        flags |= kReplaceSettings_SettingsFlag;
+    }
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(size);
+    SkWBuffer buffer(data->writable_data(), size);
+    buffer.write32(kMagic);
+    buffer.write32(kVersion);
+    buffer.write32(flags);
+    buffer.write32(SkToU32(settings.fArgs.size()));
+    for (const auto& arg : settings.fArgs) {
+        write_string(&buffer, arg.first);
+        buffer.write32(arg.second.fKind);
+        buffer.write32(arg.second.fValue);
+    }
+    for (int i = 0; i < kShaderTypeCount; ++i) {
+        write_string(&buffer, sksl[i]);
+    }
+    SkASSERT(buffer.pos() == size);
+    return data;
+}
+
+bool GrGLShaderPrecompiler::Decode(const SkData& data, Entry* entry) {
+    SkRBuffer buffer(data.data(), data.size());
+    uint32_t magic, version, flags, argCount;
+    if (!buffer.readU32(&magic) || kMagic != magic ||
+        !buffer.readU32(&version) || kVersion != version ||
+        !buffer.readU32(&flags) || !buffer.readU32(&argCount)) {
+        return false;
+    }
+    entry->fSettings.fFlipY = SkToBool(flags & kFlipY_SettingsFlag);
+    entry->fSettings.fFragColorIsInOut = SkToBool(flags & kFragColorIsInOut_SettingsFlag);
+    entry->fSettings.fForceHighPrecision = SkToBool(flags & kForceHighPrecision_SettingsFlag);
+    entry->fSettings.fSharpenTextures = SkToBool(flags & kSharpenTextures_SettingsFlag);
+    entry->fSettings.fReplaceSettings = SkToBool(flags & kReplaceSettings_SettingsFlag);
+    entry->fSettings.fArgs.clear();
+    for (uint32_t i = 0; i < argCount; ++i) {
+        SkSL::String name;
+        uint32_t kind;
+        int32_t value;
+        if (!read_string(&buffer, &name) || !buffer.readU32(&kind) || !buffer.readS32(&value)) {
+            return false;
+        }
+        switch (kind) {
+            case SkSL::Program::Settings::Value::kBool_Kind:
+                entry->fSettings.fArgs.insert(std::make_pair(name, SkToBool(value)));
+                break;
+            case SkSL::Program::Settings::Value::kInt_Kind:
+                entry->fSettings.fArgs.insert(std::make_pair(name, (int) value));
+                break;
+            default:
+                return false;
+        }
+    }
+    for (int i = 0; i < kShaderTypeCount; ++i) {
+        if (!read_string(&buffer, &entry->fSkSL[i])) {
+            return false;
+        }
+    }
+    // Vertex and fragment shaders are always present.
+    return buffer.eof() && !entry->fSkSL[kVertex_ShaderType].empty() &&
+           !entry->fSkSL[kFragment_ShaderType].empty();
+}
+
+bool GrGLShaderPrecompiler::add(const SkData& key, const SkData& data) {
+    SkString keyString((const char*) key.data(), key.size());
+    if (fEntries.find(keyString)) {
+        return false;
+    }
+    std::unique_ptr<Entry> entry(new Entry());
+    if (!Decode(data, entry.get())) {
+        return false;
+    }
+    entry->fSettings.fCaps = fCaps.get();
+    fNewEntries.push_back(entry.get());
+    fEntries.set(std::move(keyString), std::move(entry));
+    return true;
+}
+
+bool GrGLShaderPrecompiler::claimAndCompile(Entry* entry,
+                                            std::unique_ptr<SkSL::Compiler>* compiler) const {
+    int queued = Entry::kQueued_State;
+    if (!entry->fState.compare_exchange_strong(queued, Entry::kCompiling_State)) {
+        return false;
+    }
+    TRACE_EVENT0("skia.gpu", TRACE_FUNC);
+    if (!*compiler) {
+        compiler->reset(new SkSL::Compiler());
+    }
+    entry->fCompiled = true;
+    entry->fInputs.reset();
+    for (int type = 0; type < kShaderTypeCount && entry->fCompiled; ++type) {
+        if (entry->fSkSL[type].empty()) {
+            continue;
+        }
+        std::unique_ptr<SkSL::Program> program = (*compiler)->convertProgram(
+                kProgramKinds[type], entry->fSkSL[type], entry->fSettings);
+        // Failures are left for GrGLProgramBuilder to report when the program is built.
+        if (!program || !(*compiler)->toGLSL(*program, &entry->fGLSL[type])) {
+            entry->fCompiled = false;
+        } else if (kFragment_ShaderType == type) {
+            entry->fInputs = program->fInputs;
+        }
+    }
+    entry->fState.store(Entry::kDone_State, std::memory_order_release);
+    return true;
+}
+
+void GrGLShaderPrecompiler::compile(SkTaskGroup* taskGroup) {
+    if (fNewEntries.empty()) {
+        return;
+    }
+    if (!taskGroup) {
+        std::unique_ptr<SkSL::Compiler> compiler;
+        for (Entry* entry : fNewEntries) {
+            this->claimAndCompile(entry, &compiler);
+        }
+        fNewEntries.reset();
+        return;
+    }
+    for (int start = 0; start < fNewEntries.count(); start += kProgramsPerTask) {
+        int count = SkTMin(kProgramsPerTask, fNewEntries.count() - start);
+        std::vector<Entry*> batch(fNewEntries.begin() + start,
+                                  fNewEntries.begin() + start + count);
+        sk_sp<GrGLShaderPrecompiler> self = sk_ref_sp(this);
+        taskGroup->add([self, batch] {
+            // The compiler is only made if find() hasn't already claimed every entry.
+            std::unique_ptr<SkSL::Compiler> compiler;
+            for (Entry* entry : batch) {
+                if (self->claimAndCompile(entry, &compiler)) {
+                    entry->fDone.signal();
+                }
+            }
+        });
+    }
+    fNewEntries.reset();
+}
+
+const GrGLShaderPrecompiler::Entry* GrGLShaderPrecompiler::find(const void* key,
+                                                                size_t keyLength) {
+    std::unique_ptr<Entry>* found = fEntries.find(SkString((const char*) key, keyLength));
+    if (!found) {
+        return nullptr;
+    }
+    Entry* entry = found->get();
+    std::unique_ptr<SkSL::Compiler> compiler;
+    if (!this->claimAndCompile(entry, &compiler) &&
+        Entry::kDone_State != entry->fState.load(std::memory_order_acquire)) {
+        // A task is compiling this entry. Its signal is only consumed here, and after this wait
+        // the entry is done, so we never wait for it again.
+        entry->fDone.wait();
+    }
+    return entry->fCompiled ? entry : nullptr;
+}
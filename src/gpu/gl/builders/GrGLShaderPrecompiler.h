@@ -0,0 +1,126 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrGLShaderPrecompiler_DEFINED
+#define GrGLShaderPrecompiler_DEFINED
+
+#include "SkData.h"
+#include "SkRefCnt.h"
+#include "SkSemaphore.h"
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+#include "SkSLString.h"
+#include "ir/SkSLProgram.h"
+
+#include <atomic>
+
+class GrShaderCaps;
+class SkTaskGroup;
+namespace SkSL { class Compiler; }
+
+/**
+ * Translates the SkSL of previously seen programs to GLSL ahead of their first use, so that the
+ * first frame which needs them only pays for the driver compile and link.
+ *
+ * When the GPU has a persistent cache but cannot store program binaries, GrGLProgramBuilder
+ * stores each program's SkSL in the cache, encoded with Encode(). The client passes the keys it
+ * was given back to GrContext::precompileShaders(), which loads the entries and add()s them here.
+ * compile() then runs SkSL::Compiler over every new entry, spread across the threads of a task
+ * group when one is available. Each task owns its own SkSL::Compiler, since a Compiler may only be
+ * used by one thread at a time.
+ *
+ * The precompiler itself is only accessed from the thread that owns the GPU. The compile tasks
+ * only ever touch the entries they were handed, and hold a ref on the precompiler until done.
+ * Each entry is compiled by whichever thread claims it first: find() compiles an entry no task has
+ * started on inline, and only waits for the requested entry if a task is compiling it.
+ */
+class GrGLShaderPrecompiler : public SkRefCnt {
+public:
+    enum ShaderType {
+        kVertex_ShaderType,
+        kGeometry_ShaderType,
+        kFragment_ShaderType,
+
+        kLast_ShaderType = kFragment_ShaderType
+    };
+    static constexpr int kShaderTypeCount = kLast_ShaderType + 1;
+
+    struct Entry {
+        // fCaps is not encoded; it is always the precompiler's caps.
+        SkSL::Program::Settings fSettings;
+        // The geometry shader's SkSL is empty if the program does not use one.
+        SkSL::String            fSkSL[kShaderTypeCount];
+
+        // Results, only valid once find() has returned the entry.
+        bool                    fCompiled = false;
+        SkSL::String            fGLSL[kShaderTypeCount];
+        SkSL::Program::Inputs   fInputs;
+
+    private:
+        friend class GrGLShaderPrecompiler;
+
+        enum State {
+            kQueued_State,
+            kCompiling_State,
+            kDone_State,
+        };
+        std::atomic<int>        fState{kQueued_State};
+        // Signaled when a compile task finishes this entry.
+        SkSemaphore             fDone;
+    };
+
+    GrGLShaderPrecompiler(sk_sp<const GrShaderCaps> caps);
+    ~GrGLShaderPrecompiler() override;
+
+    /**
+     * Encodes a program's settings and SkSL in the format read by add().
+     */
+    static sk_sp<SkData> Encode(const SkSL::Program::Settings& settings,
+                                const SkSL::String sksl[kShaderTypeCount]);
+
+    /**
+     * Decodes data produced by Encode(). Returns false if the data is not a valid entry, e.g. if
+     * it is a program binary stored by a driver which supports them.
+     */
+    static bool Decode(const SkData& data, Entry* entry);
+
+    /**
+     * Queues the encoded program for the next call to compile(). Returns false, and does nothing,
+     * if the data cannot be decoded or the key has already been added.
+     */
+    bool add(const SkData& key, const SkData& data);
+
+    /**
+     * Compiles every entry added since the last call. If taskGroup is non-null the compiles run
+     * on its threads and this returns immediately; otherwise they are done before returning.
+     */
+    void compile(SkTaskGroup* taskGroup);
+
+    /**
+     * Returns the entry for the key, or null if there isn't one or it failed to compile. If no task
+     * has started on the entry it is compiled here; if one is compiling it, waits for that task.
+     */
+    const Entry* find(const void* key, size_t keyLength);
+
+    int count() const { return fEntries.count(); }
+
+private:
+    // Number of programs compiled by each task. Constructing an SkSL::Compiler is costly, so
+    // each task reuses one for several programs.
+    static constexpr int kProgramsPerTask = 8;
+
+    // Compiles the entry if no other thread has claimed it. Returns false if one has.
+    bool claimAndCompile(Entry* entry, std::unique_ptr<SkSL::Compiler>* compiler) const;
+
+    sk_sp<const GrShaderCaps>                    fCaps;
+    SkTHashMap<SkString, std::unique_ptr<Entry>> fEntries;
+    // Entries added since the last call to compile().
+    SkTArray<Entry*>                             fNewEntries;
+};
+
+#endif
@@ -241,31 +241,47 @@ private:
         target->draw(std::move(gp), pipeline, fixedDynamicState, mesh);
     }
 
-    void onPrepareDraws(Target* target) override {
-        auto pipe = fHelper.makePipeline(target);
-        // Setup GrGeometryProcessor
-        sk_sp<GrGeometryProcessor> gp(create_lines_only_gp(target->caps().shaderCaps(),
-                                                           fHelper.compatibleWithAlphaAsCoverage(),
-                                                           this->viewMatrix(),
-                                                           fHelper.usesLocalCoords()));
-        if (!gp) {
-            SkDebugf("Couldn't create a GrGeometryProcessor\n");
-            return;
-        }
+    size_t vertexStride() const {
+        return fHelper.compatibleWithAlphaAsCoverage()
+                       ? sizeof(GrDefaultGeoProcFactory::PositionColorAttr)
+                       : sizeof(GrDefaultGeoProcFactory::PositionColorCoverageAttr);
+    }
 
-        size_t vertexStride = fHelper.compatibleWithAlphaAsCoverage()
-                                      ? sizeof(GrDefaultGeoProcFactory::PositionColorAttr)
-                                      : sizeof(GrDefaultGeoProcFactory::PositionColorCoverageAttr);
-        SkASSERT(vertexStride == gp->debugOnly_vertexStride());
+    // Vertex and index data for the op's paths, split into draws whose indices fit in 16 bits.
+    // Each draw has its own buffers, so no buffer holds more than one draw's worth of data.
+    struct Geometry {
+        struct Draw {
+            SkAutoTMalloc<uint8_t>  fVertices;
+            SkAutoTMalloc<uint16_t> fIndices;
+            int                     fVertexCount;
+            int                     fIndexCount;
+        };
+        SkSTArray<1, Draw> fDraws;
+    };
 
+    // Tessellates the op's paths into CPU memory. This only reads the op's own data so it may be
+    // called off of the flush thread. If a draw grows too large, it and the paths after it are
+    // dropped; the draws finished before it are kept.
+    void makeGeometry(Geometry* geometry) const {
+        size_t vertexStride = this->vertexStride();
         int instanceCount = fPaths.count();
 
         int64_t vertexCount = 0;
         int64_t indexCount = 0;
         int64_t maxVertices = DEFAULT_BUFFER_SIZE;
         int64_t maxIndices = DEFAULT_BUFFER_SIZE;
-        uint8_t* vertices = (uint8_t*) sk_malloc_throw(maxVertices * vertexStride);
-        uint16_t* indices = (uint16_t*) sk_malloc_throw(maxIndices * sizeof(uint16_t));
+        SkAutoTMalloc<uint8_t> vertices(maxVertices * vertexStride);
+        SkAutoTMalloc<uint16_t> indices(maxIndices);
+        auto finishDraw = [&]() {
+            if (vertexCount > 0 && indexCount > 0) {
+                geometry->fDraws.push_back({std::move(vertices), std::move(indices),
+                                            SkToInt(vertexCount), SkToInt(indexCount)});
+                vertices.reset(maxVertices * vertexStride);
+                indices.reset(maxIndices);
+            }
+            vertexCount = 0;
+            indexCount = 0;
+        };
         for (int i = 0; i < instanceCount; i++) {
             const PathData& args = fPaths[i];
             GrAAConvexTessellator tess(args.fStyle, args.fStrokeWidth,
@@ -278,44 +294,69 @@ private:
             int currentVertices = tess.numPts();
             if (vertexCount + currentVertices > static_cast<int>(UINT16_MAX)) {
                 // if we added the current instance, we would overflow the indices we can store in a
-                // uint16_t. Draw what we've got so far and reset.
-                this->draw(target, gp, pipe.fPipeline, pipe.fFixedDynamicState, vertexCount,
-                           vertexStride, vertices, indexCount, indices);
-                vertexCount = 0;
-                indexCount = 0;
+                // uint16_t. Finish what we've got so far and start a new draw.
+                finishDraw();
             }
             if (vertexCount + currentVertices > maxVertices) {
                 maxVertices = SkTMax(vertexCount + currentVertices, maxVertices * 2);
                 if (maxVertices * vertexStride > SK_MaxS32) {
-                    sk_free(vertices);
-                    sk_free(indices);
                     return;
                 }
-                vertices = (uint8_t*) sk_realloc_throw(vertices, maxVertices * vertexStride);
+                vertices.realloc(maxVertices * vertexStride);
             }
             int currentIndices = tess.numIndices();
             if (indexCount + currentIndices > maxIndices) {
                 maxIndices = SkTMax(indexCount + currentIndices, maxIndices * 2);
                 if (maxIndices * sizeof(uint16_t) > SK_MaxS32) {
-                    sk_free(vertices);
-                    sk_free(indices);
                     return;
                 }
-                indices = (uint16_t*) sk_realloc_throw(indices, maxIndices * sizeof(uint16_t));
+                indices.realloc(maxIndices);
             }
 
-            extract_verts(tess, vertices + vertexStride * vertexCount, vertexStride, args.fColor,
-                          vertexCount, indices + indexCount,
+            extract_verts(tess, vertices.get() + vertexStride * vertexCount, vertexStride,
+                          args.fColor, vertexCount, indices.get() + indexCount,
                           fHelper.compatibleWithAlphaAsCoverage());
             vertexCount += currentVertices;
             indexCount += currentIndices;
         }
-        if (vertexCount <= SK_MaxS32 && indexCount <= SK_MaxS32) {
-            this->draw(target, std::move(gp), pipe.fPipeline, pipe.fFixedDynamicState, vertexCount,
-                       vertexStride, vertices, indexCount, indices);
+        finishDraw();
+    }
+
+    bool onWantsParallelPrepareDraws(Target*) override { return true; }
+
+    void onParallelPrepareDraws() override {
+        fParallelGeometry.reset(new Geometry);
+        this->makeGeometry(fParallelGeometry.get());
+    }
+
+    void onPrepareDraws(Target* target) override {
+        std::unique_ptr<Geometry> geometry = std::move(fParallelGeometry);
+        if (!geometry) {
+            geometry.reset(new Geometry);
+            this->makeGeometry(geometry.get());
+        }
+        if (geometry->fDraws.empty()) {
+            return;
+        }
+
+        auto pipe = fHelper.makePipeline(target);
+        // Setup GrGeometryProcessor
+        sk_sp<GrGeometryProcessor> gp(create_lines_only_gp(target->caps().shaderCaps(),
+                                                           fHelper.compatibleWithAlphaAsCoverage(),
+                                                           this->viewMatrix(),
+                                                           fHelper.usesLocalCoords()));
+        if (!gp) {
+            SkDebugf("Couldn't create a GrGeometryProcessor\n");
+            return;
+        }
+
+        size_t vertexStride = this->vertexStride();
+        SkASSERT(vertexStride == gp->debugOnly_vertexStride());
+
+        for (Geometry::Draw& draw : geometry->fDraws) {
+            this->draw(target, gp, pipe.fPipeline, pipe.fFixedDynamicState, draw.fVertexCount,
+                       vertexStride, draw.fVertices.get(), draw.fIndexCount, draw.fIndices.get());
         }
-        sk_free(vertices);
-        sk_free(indices);
     }
 
     CombineResult onCombineIfPossible(GrOp* t, const GrCaps& caps) override {
@@ -343,6 +384,7 @@ private:
 
     SkSTArray<1, PathData, true> fPaths;
     Helper fHelper;
+    std::unique_ptr<Geometry> fParallelGeometry;
 
     typedef GrMeshDrawOp INHERITED;
 };
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrAATessellationCache.h"
+#include "GrDefaultGeoProcFactory.h"
+#include "GrShape.h"
+#include "GrTessellator.h"
+#include "SkColorData.h"
+#include "SkFloatBits.h"
+#include "SkOpts.h"
+
+// Larger tessellations are cheap relative to their size to regenerate and would quickly use up the
+// cache's memory.
+static constexpr int kMaxCachedVertices = 4096;
+
+// Beyond this the translation can't be split at quarter pixels without losing precision.
+static constexpr SkScalar kMaxTranslate = 1 << 20;
+
+// The subpixel part of the translation is keyed at this resolution.
+static constexpr SkScalar kSubpixelSteps = 64;
+
+namespace {
+
+class TessellationAllocator : public GrTessellator::VertexAllocator {
+public:
+    TessellationAllocator()
+            : VertexAllocator(sizeof(GrDefaultGeoProcFactory::PositionColorCoverageAttr)) {}
+    void* lock(int vertexCount) override {
+        fVertices.reset(vertexCount);
+        return fVertices.get();
+    }
+    void unlock(int actualCount) override { fCount = actualCount; }
+
+    const GrDefaultGeoProcFactory::PositionColorCoverageAttr* vertices() const {
+        return fVertices.get();
+    }
+    int count() const { return fCount; }
+
+private:
+    SkAutoTMalloc<GrDefaultGeoProcFactory::PositionColorCoverageAttr> fVertices;
+    int fCount = 0;
+};
+
+}  // anonymous namespace
+
+sk_sp<GrAATessellationCache::Tessellation> GrAATessellationCache::Tessellation::Make(
+        const SkPath& devPath, SkScalar tolerance) {
+    // The clip bounds are only used for inverse fills, which aren't cached.
+    SkASSERT(!devPath.isInverseFillType());
+    TessellationAllocator allocator;
+    bool isLinear;
+    int count = GrTessellator::PathToTriangles(devPath, tolerance, SkRect::MakeEmpty(), &allocator,
+                                               true, 0, false, &isLinear);
+    if (!count) {
+        return nullptr;
+    }
+    SkAutoTMalloc<Vertex> vertices(count);
+    for (int i = 0; i < count; ++i) {
+        vertices[i].fPosition = allocator.vertices()[i].fPosition;
+        vertices[i].fCoverage = allocator.vertices()[i].fCoverage;
+    }
+    return sk_sp<Tessellation>(new Tessellation(std::move(vertices), count));
+}
+
+bool GrAATessellationCache::Key::set(const GrShape& shape, const SkMatrix& viewMatrix) {
+    if (shape.inverseFilled() || viewMatrix.hasPerspective()) {
+        return false;
+    }
+    int shapeKeySize = shape.unstyledKeySize();
+    if (shapeKeySize < 0) {
+        return false;
+    }
+    SkScalar tx = viewMatrix.getTranslateX();
+    SkScalar ty = viewMatrix.getTranslateY();
+    if (!(SkScalarAbs(tx) < kMaxTranslate && SkScalarAbs(ty) < kMaxTranslate)) {
+        return false;
+    }
+    fTranslate.set(SkScalarFloorToScalar(tx * 4) * 0.25f, SkScalarFloorToScalar(ty * 4) * 0.25f);
+    // The remainder is snapped so that translations which only differ by float error (e.g. an
+    // offset that was scrolled) share a key. This moves the path by at most 1/128 of a pixel
+    // before the tessellator snaps it to the quarter pixel grid.
+    fTessellationMatrix = viewMatrix;
+    fTessellationMatrix.setTranslateX(
+            SkScalarRoundToScalar((tx - fTranslate.fX) * kSubpixelSteps) / kSubpixelSteps);
+    fTessellationMatrix.setTranslateY(
+            SkScalarRoundToScalar((ty - fTranslate.fY) * kSubpixelSteps) / kSubpixelSteps);
+
+    static constexpr int kMatrixKeySize = 6;
+    fData.reset(shapeKeySize + kMatrixKeySize);
+    shape.writeUnstyledKey(fData.begin());
+    uint32_t* matrixKey = fData.begin() + shapeKeySize;
+    matrixKey[0] = SkFloat2Bits(fTessellationMatrix.getScaleX());
+    matrixKey[1] = SkFloat2Bits(fTessellationMatrix.getSkewX());
+    matrixKey[2] = SkFloat2Bits(fTessellationMatrix.getSkewY());
+    matrixKey[3] = SkFloat2Bits(fTessellationMatrix.getScaleY());
+    matrixKey[4] = SkFloat2Bits(fTessellationMatrix.getTranslateX());
+    matrixKey[5] = SkFloat2Bits(fTessellationMatrix.getTranslateY());
+    return true;
+}
+
+uint32_t GrAATessellationCache::Key::Hash::operator()(const Key& key) const {
+    return SkOpts::hash(key.fData.begin(), key.fData.count() * sizeof(uint32_t));
+}
+
+// Entries are limited by the byte budget rather than by count.
+GrAATessellationCache::GrAATessellationCache(size_t maxBytes)
+        : fCache(SK_MaxS32)
+        , fMaxBytes(maxBytes) {}
+
+sk_sp<const GrAATessellationCache::Tessellation> GrAATessellationCache::find(const Key& key) {
+    sk_sp<const Tessellation>* tessellation = fCache.find(key);
+    if (!tessellation) {
+        ++fMissCount;
+        return nullptr;
+    }
+    ++fHitCount;
+    return *tessellation;
+}
+
+void GrAATessellationCache::add(const Key& key, sk_sp<const Tessellation> tessellation) {
+    if (!tessellation || tessellation->count() > kMaxCachedVertices) {
+        return;
+    }
+    fBytes += tessellation->bytes();
+    // SkLRUCache requires that keys are unique.
+    if (sk_sp<const Tessellation>* existing = fCache.find(key)) {
+        fBytes -= (*existing)->bytes();
+        *existing = std::move(tessellation);
+    } else {
+        fCache.insert(key, std::move(tessellation));
+    }
+    this->purgeAsNeeded();
+}
+
+void GrAATessellationCache::setMaxBytes(size_t maxBytes) {
+    fMaxBytes = maxBytes;
+    this->purgeAsNeeded();
+}
+
+void GrAATessellationCache::purgeAll() {
+    fCache.reset();
+    fBytes = 0;
+}
+
+void GrAATessellationCache::purgeAsNeeded() {
+    while (fBytes > fMaxBytes) {
+        fBytes -= (*fCache.oldest())->bytes();
+        fCache.removeOldest();
+    }
+}
+
+void GrAATessellationCache::WriteVertices(const Tessellation& tessellation,
+                                          const SkVector& translate, uint32_t color,
+                                          bool tweakAlphaForCoverage, void* vertices) {
+    const Vertex* src = tessellation.vertices();
+    int count = tessellation.count();
+    if (tweakAlphaForCoverage) {
+        auto* dst = static_cast<GrDefaultGeoProcFactory::PositionColorAttr*>(vertices);
+        for (int i = 0; i < count; ++i) {
+            // The tessellator produced the coverage from an 8 bit alpha so this recovers it exactly.
+            unsigned alpha = SkScalarRoundToInt(src[i].fCoverage * 255);
+            dst[i].fPosition = src[i].fPosition + translate;
+            dst[i].fColor = SkAlphaMulQ(color, SkAlpha255To256(alpha));
+        }
+    } else {
+        auto* dst = static_cast<GrDefaultGeoProcFactory::PositionColorCoverageAttr*>(vertices);
+        for (int i = 0; i < count; ++i) {
+            dst[i].fPosition = src[i].fPosition + translate;
+            dst[i].fColor = color;
+            dst[i].fCoverage = src[i].fCoverage;
+        }
+    }
+}
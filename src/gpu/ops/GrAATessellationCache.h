@@ -0,0 +1,135 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrAATessellationCache_DEFINED
+#define GrAATessellationCache_DEFINED
+
+#include "SkLRUCache.h"
+#include "SkMatrix.h"
+#include "SkRefCnt.h"
+#include "SkTArray.h"
+#include "SkTemplates.h"
+
+class GrShape;
+class SkPath;
+
+/**
+ * A CPU-side cache of the antialiased tessellations made by GrTessellatingPathRenderer. AA paths
+ * are tessellated in device space so, unlike non-AA tessellations, they can't be reused under a
+ * different view matrix. They can however be reused under a different translation, which is
+ * what happens when content scrolls or animates position. Tessellations are keyed on the path's
+ * key (which includes its gen ID), the exact linear part of the view matrix, and the
+ * translation's offset from a quarter pixel boundary (the tessellator snaps AA geometry to a
+ * quarter pixel grid) rounded to 1/64 of a pixel. They are stored without the
+ * quarter-pixel-aligned part of the translation which is added back as the vertices are written.
+ * Because of that rounding a cached tessellation can differ from a direct one by a small fraction
+ * of a pixel.
+ *
+ * The cache's memory is limited to a byte budget, which GrTessellatingPathRenderer derives from
+ * the resource cache's budget. The cache is not thread safe. It is only used by direct contexts,
+ * whose ops are recorded and executed on the thread that owns the GrContext. DDL recording
+ * contexts don't use it, since their ops are executed by another context on another thread.
+ */
+class GrAATessellationCache : public SkNVRefCnt<GrAATessellationCache> {
+public:
+    struct Vertex {
+        SkPoint fPosition;
+        float   fCoverage;
+    };
+
+    class Tessellation : public SkNVRefCnt<Tessellation> {
+    public:
+        /**
+         * Tessellates a device space path. Returns null if the path doesn't produce any
+         * triangles.
+         */
+        static sk_sp<Tessellation> Make(const SkPath& devPath, SkScalar tolerance);
+
+        int count() const { return fCount; }
+        const Vertex* vertices() const { return fVertices.get(); }
+
+        size_t bytes() const { return sizeof(Tessellation) + fCount * sizeof(Vertex); }
+
+    private:
+        Tessellation(SkAutoTMalloc<Vertex> vertices, int count)
+                : fVertices(std::move(vertices)), fCount(count) {}
+
+        SkAutoTMalloc<Vertex> fVertices;
+        int                   fCount;
+    };
+
+    class Key {
+    public:
+        /**
+         * Sets the key for a filled shape drawn with viewMatrix. Returns false if the draw can't
+         * be cached, e.g. because the shape is inverse filled or has no key.
+         */
+        bool set(const GrShape&, const SkMatrix& viewMatrix);
+
+        /**
+         * The matrix to tessellate with. This is the view matrix minus translate(), with the
+         * remaining subpixel translation rounded to the key's resolution.
+         */
+        const SkMatrix& tessellationMatrix() const { return fTessellationMatrix; }
+
+        /** The translation to add to the cached vertices. This is a multiple of a quarter pixel. */
+        const SkVector& translate() const { return fTranslate; }
+
+        bool operator==(const Key& that) const {
+            return fData.count() == that.fData.count() &&
+                   !memcmp(fData.begin(), that.fData.begin(), fData.count() * sizeof(uint32_t));
+        }
+
+        struct Hash {
+            uint32_t operator()(const Key& key) const;
+        };
+
+    private:
+        SkSTArray<16, uint32_t, true> fData;
+        SkMatrix                      fTessellationMatrix;
+        SkVector                      fTranslate;
+    };
+
+    static constexpr size_t kDefaultMaxBytes = 4 * 1024 * 1024;
+
+    explicit GrAATessellationCache(size_t maxBytes = kDefaultMaxBytes);
+
+    /** Returns the cached tessellation for the key, or null. Updates the hit and miss counts. */
+    sk_sp<const Tessellation> find(const Key&);
+
+    /** Adds or replaces the key's tessellation. Null and very large tessellations are ignored. */
+    void add(const Key&, sk_sp<const Tessellation>);
+
+    /** Sets the byte budget, purging the least recently used tessellations to fit it. */
+    void setMaxBytes(size_t maxBytes);
+
+    /** Drops every tessellation. */
+    void purgeAll();
+
+    size_t maxBytes() const { return fMaxBytes; }
+    size_t bytes() const { return fBytes; }
+    int hitCount() const { return fHitCount; }
+    int missCount() const { return fMissCount; }
+
+    /**
+     * Writes the tessellation translated by 'translate' as PositionColorAttr vertices if
+     * tweakAlphaForCoverage is true, and PositionColorCoverageAttr vertices otherwise.
+     */
+    static void WriteVertices(const Tessellation&, const SkVector& translate, uint32_t color,
+                              bool tweakAlphaForCoverage, void* vertices);
+
+private:
+    void purgeAsNeeded();
+
+    SkLRUCache<Key, sk_sp<const Tessellation>, Key::Hash> fCache;
+    size_t                                                fMaxBytes;
+    size_t                                                fBytes = 0;
+    int                                                   fHitCount = 0;
+    int                                                   fMissCount = 0;
+};
+
+#endif
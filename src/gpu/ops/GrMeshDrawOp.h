@@ -70,8 +70,15 @@ protected:
 
 private:
     void onPrepare(GrOpFlushState* state) final;
+    bool onWantsParallelPrepare(GrOpFlushState* state) final;
+    void onParallelPrepare() final { this->onParallelPrepareDraws(); }
     void onExecute(GrOpFlushState* state) final;
     virtual void onPrepareDraws(Target*) = 0;
+    // See GrOp::wantsParallelPrepare(). onParallelPrepareDraws() is typically used to generate
+    // vertex data into CPU memory owned by the op which onPrepareDraws() then copies into the
+    // space it gets from the Target.
+    virtual bool onWantsParallelPrepareDraws(Target*) { return false; }
+    virtual void onParallelPrepareDraws() {}
     typedef GrDrawOp INHERITED;
 };
 
@@ -157,6 +157,19 @@ public:
      */
     void prepare(GrOpFlushState* state) { this->onPrepare(state); }
 
+    /**
+     * Ops may move CPU work that doesn't depend on any state outside of the op, such as
+     * tessellation, off of the flush thread. Before an opList prepares its ops it may call
+     * wantsParallelPrepare() on the flush thread. If that returns true then parallelPrepare() may
+     * be called on another thread, concurrently with other ops' parallelPrepare(), and will have
+     * returned before prepare() is called. parallelPrepare() must only touch the op's own data.
+     * Ops must still prepare correctly when parallelPrepare() is never called.
+     */
+    bool wantsParallelPrepare(GrOpFlushState* state) {
+        return this->onWantsParallelPrepare(state);
+    }
+    void parallelPrepare() { this->onParallelPrepare(); }
+
     /** Issues the op's commands to GrGpu. */
     void execute(GrOpFlushState* state) {
         TRACE_EVENT0("skia", name());
@@ -268,6 +281,8 @@ private:
     }
 
     virtual void onPrepare(GrOpFlushState*) = 0;
+    virtual bool onWantsParallelPrepare(GrOpFlushState*) { return false; }
+    virtual void onParallelPrepare() {}
     virtual void onExecute(GrOpFlushState*) = 0;
 
     static uint32_t GenID(int32_t* idCounter) {
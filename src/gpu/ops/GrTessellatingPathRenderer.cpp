@@ -7,8 +7,10 @@
 
 #include "GrTessellatingPathRenderer.h"
 #include <stdio.h>
+#include "GrAATessellationCache.h"
 #include "GrAuditTrail.h"
 #include "GrClip.h"
+#include "GrContextPriv.h"
 #include "GrDefaultGeoProcFactory.h"
 #include "GrDrawOpTest.h"
 #include "GrMesh.h"
@@ -27,6 +29,9 @@
 #define GR_AA_TESSELLATOR_MAX_VERB_COUNT 10
 #endif
 
+// The AA tessellation cache may use this fraction of the resource cache's budget.
+static constexpr size_t kAACacheBudgetDivisor = 16;
+
 /*
  * This path renderer tessellates the path into triangles using GrTessellator, uploads the
  * triangles to a vertex buffer, and renders them with a single draw call. It can do screenspace
@@ -132,9 +137,32 @@ private:
     void* fVertices;
 };
 
+// Tessellates into CPU memory. Used when tessellating off of the flush thread.
+class CpuVertexAllocator : public GrTessellator::VertexAllocator {
+public:
+    CpuVertexAllocator(size_t stride) : VertexAllocator(stride), fCount(0) {}
+    void* lock(int vertexCount) override {
+        fVertices.reset(vertexCount * stride());
+        return fVertices.get();
+    }
+    void unlock(int actualCount) override { fCount = actualCount; }
+    const void* vertices() const { return fVertices.get(); }
+    int count() const { return fCount; }
+private:
+    SkAutoTMalloc<char> fVertices;
+    int fCount;
+};
+
 }  // namespace
 
-GrTessellatingPathRenderer::GrTessellatingPathRenderer() {
+GrTessellatingPathRenderer::GrTessellatingPathRenderer()
+        : fAACache(sk_make_sp<GrAATessellationCache>()) {
+}
+
+GrTessellatingPathRenderer::~GrTessellatingPathRenderer() {
+    // Ops that haven't executed yet may still hold the cache. Free its memory now, since this is
+    // how GrContext::freeGpuResources() releases it.
+    fAACache->purgeAll();
 }
 
 GrPathRenderer::CanDrawPath
@@ -144,8 +172,8 @@ GrTessellatingPathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
     // ones to simpler algorithms. We pass on paths that have styles, though they may come back
     // around after applying the styling information to the geometry to create a filled path. In
     // the non-AA case, We skip paths that don't have a key since the real advantage of this path
-    // renderer comes from caching the tessellated geometry. In the AA case, we do not cache, so we
-    // accept paths without keys.
+    // renderer comes from caching the tessellated geometry. In the AA case, tessellations are only
+    // cached on the CPU when the path has a key, so we accept paths without keys.
     if (!args.fShape->style().isSimpleFill() || args.fShape->knownToBeConvex()) {
         return CanDrawPath::kNo;
     }
@@ -176,10 +204,11 @@ public:
                                           const SkMatrix& viewMatrix,
                                           SkIRect devClipBounds,
                                           GrAAType aaType,
-                                          const GrUserStencilSettings* stencilSettings) {
+                                          const GrUserStencilSettings* stencilSettings,
+                                          GrAATessellationCache* aaCache = nullptr) {
         return Helper::FactoryHelper<TessellatingPathOp>(context, std::move(paint), shape,
                                                          viewMatrix, devClipBounds,
-                                                         aaType, stencilSettings);
+                                                         aaType, stencilSettings, aaCache);
     }
 
     const char* name() const override { return "TessellatingPathOp"; }
@@ -202,7 +231,8 @@ public:
                        const SkMatrix& viewMatrix,
                        const SkIRect& devClipBounds,
                        GrAAType aaType,
-                       const GrUserStencilSettings* stencilSettings)
+                       const GrUserStencilSettings* stencilSettings,
+                       GrAATessellationCache* aaCache)
             : INHERITED(ClassID())
             , fHelper(helperArgs, aaType, stencilSettings)
             , fColor(color)
@@ -218,6 +248,10 @@ public:
             devBounds.join(SkRect::Make(fDevClipBounds));
         }
         this->setBounds(devBounds, HasAABloat::kNo, IsZeroArea::kNo);
+        // The op holds a ref since the path renderer may be destroyed before the op is flushed.
+        if (fAntiAlias && aaCache && fAACacheKey.set(shape, viewMatrix)) {
+            fAACache = sk_ref_sp(aaCache);
+        }
     }
 
     FixedFunctionFlags fixedFunctionFlags() const override { return fHelper.fixedFunctionFlags(); }
@@ -237,17 +271,14 @@ private:
         return path;
     }
 
-    void draw(Target* target, sk_sp<const GrGeometryProcessor> gp, size_t vertexStride) {
-        SkASSERT(!fAntiAlias);
-        GrResourceProvider* rp = target->resourceProvider();
+    void makeKey(GrUniqueKey* key) const {
         bool inverseFill = fShape.inverseFilled();
         // construct a cache key from the path's genID and the view matrix
         static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
-        GrUniqueKey key;
         static constexpr int kClipBoundsCnt = sizeof(fDevClipBounds) / sizeof(uint32_t);
         int shapeKeyDataCnt = fShape.unstyledKeySize();
         SkASSERT(shapeKeyDataCnt >= 0);
-        GrUniqueKey::Builder builder(&key, kDomain, shapeKeyDataCnt + kClipBoundsCnt, "Path");
+        GrUniqueKey::Builder builder(key, kDomain, shapeKeyDataCnt + kClipBoundsCnt, "Path");
         fShape.writeUnstyledKey(&builder[0]);
         // For inverse fills, the tessellation is dependent on clip bounds.
         if (inverseFill) {
@@ -256,27 +287,130 @@ private:
             memset(&builder[shapeKeyDataCnt], 0, sizeof(fDevClipBounds));
         }
         builder.finish();
-        sk_sp<GrBuffer> cachedVertexBuffer(rp->findByUniqueKey<GrBuffer>(key));
-        int actualCount;
-        SkScalar tol = GrPathUtils::kDefaultTolerance;
-        tol = GrPathUtils::scaleToleranceToSrc(tol, fViewMatrix, fShape.bounds());
-        if (cache_match(cachedVertexBuffer.get(), tol, &actualCount)) {
-            this->drawVertices(target, std::move(gp), cachedVertexBuffer.get(), 0, actualCount);
-            return;
+    }
+
+    SkScalar tolerance() const {
+        if (fAntiAlias) {
+            return GrPathUtils::kDefaultTolerance;
         }
+        return GrPathUtils::scaleToleranceToSrc(GrPathUtils::kDefaultTolerance, fViewMatrix,
+                                                fShape.bounds());
+    }
 
-        SkRect clipBounds = SkRect::Make(fDevClipBounds);
+    size_t vertexStride() const {
+        size_t vertexStride = sizeof(SkPoint);  // position
+        if (fAntiAlias) {
+            vertexStride += sizeof(uint32_t);
+            if (!fHelper.compatibleWithAlphaAsCoverage()) {
+                vertexStride += 4;
+            }
+        }
+        return vertexStride;
+    }
 
+    // Returns the number of vertices written to the allocator. This only reads the op's own data
+    // so it may be called off of the flush thread.
+    int tessellate(GrTessellator::VertexAllocator* allocator, bool* isLinear) const {
+        SkPath path = getPath();
+        SkRect clipBounds = SkRect::Make(fDevClipBounds);
+        if (fAntiAlias) {
+            if (path.isEmpty()) {
+                return 0;
+            }
+            path.transform(fViewMatrix);
+            return GrTessellator::PathToTriangles(path, this->tolerance(), clipBounds, allocator,
+                                                  true, fColor,
+                                                  fHelper.compatibleWithAlphaAsCoverage(),
+                                                  isLinear);
+        }
         SkMatrix vmi;
         if (!fViewMatrix.invert(&vmi)) {
-            return;
+            return 0;
         }
         vmi.mapRect(&clipBounds);
+        return GrTessellator::PathToTriangles(path, this->tolerance(), clipBounds, allocator,
+                                              false, GrColor(), false, isLinear);
+    }
+
+    // Writes the tessellation to the allocator, either by copying the one made by
+    // onParallelPrepareDraws() or by tessellating now.
+    int writeTessellation(GrTessellator::VertexAllocator* allocator, bool* isLinear) {
+        if (!fParallelTessellation) {
+            return this->tessellate(allocator, isLinear);
+        }
+        std::unique_ptr<CpuVertexAllocator> tessellation = std::move(fParallelTessellation);
+        *isLinear = fParallelTessellationIsLinear;
+        int count = tessellation->count();
+        if (count == 0) {
+            return 0;
+        }
+        SkASSERT(allocator->stride() == tessellation->stride());
+        void* vertices = allocator->lock(count);
+        if (!vertices) {
+            return 0;
+        }
+        memcpy(vertices, tessellation->vertices(), count * allocator->stride());
+        allocator->unlock(count);
+        return count;
+    }
+
+    sk_sp<const GrAATessellationCache::Tessellation> makeAATessellation() const {
+        SkASSERT(fAACache);
+        SkPath path = getPath();
+        if (path.isEmpty()) {
+            return nullptr;
+        }
+        path.transform(fAACacheKey.tessellationMatrix());
+        return GrAATessellationCache::Tessellation::Make(path, this->tolerance());
+    }
+
+    bool onWantsParallelPrepareDraws(Target* target) override {
+        if (fAACache) {
+            // The lookup is done here, on the flush thread, so that only misses are tessellated
+            // ahead.
+            fAATessellation = fAACache->find(fAACacheKey);
+            fHasAATessellation = SkToBool(fAATessellation);
+            return !fHasAATessellation;
+        }
+        if (fAntiAlias) {
+            return true;
+        }
+        // Non-AA tessellations are cached so it is only worth tessellating ahead on a cache miss.
+        GrUniqueKey key;
+        this->makeKey(&key);
+        sk_sp<GrBuffer> cachedVertexBuffer(
+                target->resourceProvider()->findByUniqueKey<GrBuffer>(key));
+        int actualCount;
+        return !cache_match(cachedVertexBuffer.get(), this->tolerance(), &actualCount);
+    }
+
+    void onParallelPrepareDraws() override {
+        if (fAACache) {
+            fAATessellation = this->makeAATessellation();
+            fHasAATessellation = true;
+            return;
+        }
+        fParallelTessellation.reset(new CpuVertexAllocator(this->vertexStride()));
+        this->tessellate(fParallelTessellation.get(), &fParallelTessellationIsLinear);
+    }
+
+    void draw(Target* target, sk_sp<const GrGeometryProcessor> gp, size_t vertexStride) {
+        SkASSERT(!fAntiAlias);
+        GrResourceProvider* rp = target->resourceProvider();
+        GrUniqueKey key;
+        this->makeKey(&key);
+        sk_sp<GrBuffer> cachedVertexBuffer(rp->findByUniqueKey<GrBuffer>(key));
+        int actualCount;
+        SkScalar tol = this->tolerance();
+        if (cache_match(cachedVertexBuffer.get(), tol, &actualCount)) {
+            this->drawVertices(target, std::move(gp), cachedVertexBuffer.get(), 0, actualCount);
+            return;
+        }
+
         bool isLinear;
         bool canMapVB = GrCaps::kNone_MapFlags != target->caps().mapBufferFlags();
         StaticVertexAllocator allocator(vertexStride, rp, canMapVB);
-        int count = GrTessellator::PathToTriangles(getPath(), tol, clipBounds, &allocator,
-                                                   false, GrColor(), false, &isLinear);
+        int count = this->writeTessellation(&allocator, &isLinear);
         if (count == 0) {
             return;
         }
@@ -289,20 +423,42 @@ private:
         fShape.addGenIDChangeListener(sk_make_sp<PathInvalidator>(key, target->contextUniqueID()));
     }
 
+    void drawCachedAA(Target* target, sk_sp<const GrGeometryProcessor> gp, size_t vertexStride) {
+        SkASSERT(fAACache);
+        if (!fHasAATessellation) {
+            fAATessellation = fAACache->find(fAACacheKey);
+            if (!fAATessellation) {
+                fAATessellation = this->makeAATessellation();
+            }
+        }
+        sk_sp<const GrAATessellationCache::Tessellation> tessellation = std::move(fAATessellation);
+        fAACache->add(fAACacheKey, tessellation);
+        if (!tessellation) {
+            return;
+        }
+        const GrBuffer* vertexBuffer;
+        int firstVertex;
+        void* vertices = target->makeVertexSpace(vertexStride, tessellation->count(),
+                                                 &vertexBuffer, &firstVertex);
+        if (!vertices) {
+            SkDebugf("Could not allocate vertices\n");
+            return;
+        }
+        GrAATessellationCache::WriteVertices(*tessellation, fAACacheKey.translate(), fColor,
+                                             fHelper.compatibleWithAlphaAsCoverage(), vertices);
+        this->drawVertices(target, std::move(gp), vertexBuffer, firstVertex,
+                           tessellation->count());
+    }
+
     void drawAA(Target* target, sk_sp<const GrGeometryProcessor> gp, size_t vertexStride) {
         SkASSERT(fAntiAlias);
-        SkPath path = getPath();
-        if (path.isEmpty()) {
+        if (fAACache) {
+            this->drawCachedAA(target, std::move(gp), vertexStride);
             return;
         }
-        SkRect clipBounds = SkRect::Make(fDevClipBounds);
-        path.transform(fViewMatrix);
-        SkScalar tol = GrPathUtils::kDefaultTolerance;
         bool isLinear;
         DynamicVertexAllocator allocator(vertexStride, target);
-        int count =
-                GrTessellator::PathToTriangles(path, tol, clipBounds, &allocator, true, fColor,
-                                               fHelper.compatibleWithAlphaAsCoverage(), &isLinear);
+        int count = this->writeTessellation(&allocator, &isLinear);
         if (count == 0) {
             return;
         }
@@ -312,12 +468,10 @@ private:
 
     void onPrepareDraws(Target* target) override {
         sk_sp<GrGeometryProcessor> gp;
-        size_t vertexStride;
+        size_t vertexStride = this->vertexStride();
         {
             using namespace GrDefaultGeoProcFactory;
 
-            vertexStride = sizeof(SkPoint);  // position
-
             Color color(fColor);
             LocalCoords::Type localCoordsType = fHelper.usesLocalCoords()
                                                         ? LocalCoords::kUsePosition_Type
@@ -325,12 +479,10 @@ private:
             Coverage::Type coverageType;
             if (fAntiAlias) {
                 color = Color(Color::kPremulGrColorAttribute_Type);
-                vertexStride += sizeof(uint32_t);
                 if (fHelper.compatibleWithAlphaAsCoverage()) {
                     coverageType = Coverage::kSolid_Type;
                 } else {
                     coverageType = Coverage::kAttribute_Type;
-                    vertexStride += 4;
                 }
             } else {
                 coverageType = Coverage::kSolid_Type;
@@ -372,6 +524,13 @@ private:
     SkMatrix                fViewMatrix;
     SkIRect                 fDevClipBounds;
     bool                    fAntiAlias;
+    std::unique_ptr<CpuVertexAllocator> fParallelTessellation;
+    bool                    fParallelTessellationIsLinear = false;
+    // Only set for AA draws that can be cached.
+    sk_sp<GrAATessellationCache> fAACache;
+    GrAATessellationCache::Key fAACacheKey;
+    sk_sp<const GrAATessellationCache::Tessellation> fAATessellation;
+    bool                    fHasAATessellation = false;
 
     typedef GrMeshDrawOp INHERITED;
 };
@@ -381,6 +540,14 @@ private:
 bool GrTessellatingPathRenderer::onDrawPath(const DrawPathArgs& args) {
     GR_AUDIT_TRAIL_AUTO_FRAME(args.fRenderTargetContext->auditTrail(),
                               "GrTessellatingPathRenderer::onDrawPath");
+    // Track the resource cache's budget, which the client may change at any time. DDL recording
+    // contexts have no resource cache. Their ops are executed by another context, possibly while
+    // this one is still recording on its own thread, so they don't use the AA cache.
+    GrAATessellationCache* aaCache = nullptr;
+    if (const GrResourceCache* resourceCache = args.fContext->contextPriv().getResourceCache()) {
+        fAACache->setMaxBytes(resourceCache->getMaxResourceBytes() / kAACacheBudgetDivisor);
+        aaCache = fAACache.get();
+    }
     SkIRect clipBoundsI;
     args.fClip->getConservativeBounds(args.fRenderTargetContext->width(),
                                       args.fRenderTargetContext->height(),
@@ -391,7 +558,8 @@ bool GrTessellatingPathRenderer::onDrawPath(const DrawPathArgs& args) {
                                                             *args.fViewMatrix,
                                                             clipBoundsI,
                                                             args.fAAType,
-                                                            args.fUserStencilSettings);
+                                                            args.fUserStencilSettings,
+                                                            aaCache);
     args.fRenderTargetContext->addDrawOp(*args.fClip, std::move(op));
     return true;
 }
@@ -10,6 +10,8 @@
 
 #include "GrPathRenderer.h"
 
+class GrAATessellationCache;
+
 /**
  *  Subclass that renders the path by converting to screen-space trapezoids plus
  *   extra 1-pixel geometry for AA.
@@ -17,6 +19,11 @@
 class SK_API GrTessellatingPathRenderer : public GrPathRenderer {
 public:
     GrTessellatingPathRenderer();
+    ~GrTessellatingPathRenderer() override;
+
+#if GR_TEST_UTILS
+    const GrAATessellationCache* aaTessellationCacheForTesting() const { return fAACache.get(); }
+#endif
 
 private:
     CanDrawPath onCanDrawPath(const CanDrawPathArgs&) const override;
@@ -27,6 +34,10 @@ private:
 
     bool onDrawPath(const DrawPathArgs&) override;
 
+    // Antialiased tessellations are made in device space. This caches them across draws that
+    // differ only by translation.
+    sk_sp<GrAATessellationCache> fAACache;
+
     typedef GrPathRenderer INHERITED;
 };
 
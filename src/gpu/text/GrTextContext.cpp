@@ -10,7 +10,6 @@
 #include "GrCaps.h"
 #include "GrContext.h"
 #include "GrContextPriv.h"
-#include "GrSDFMaskFilter.h"
 #include "GrTextBlobCache.h"
 #include "SkDistanceFieldGen.h"
 #include "SkDraw.h"
@@ -22,25 +21,10 @@
 #include "SkMakeUnique.h"
 #include "SkMaskFilterBase.h"
 #include "SkPaintPriv.h"
+#include "SkSDFMaskFilter.h"
 #include "SkTo.h"
 #include "ops/GrMeshDrawOp.h"
 
-// DF sizes and thresholds for usage of the small and medium sizes. For example, above
-// kSmallDFFontLimit we will use the medium size. The large size is used up until the size at
-// which we switch over to drawing as paths as controlled by Options.
-static const int kSmallDFFontSize = 32;
-static const int kSmallDFFontLimit = 32;
-static const int kMediumDFFontSize = 72;
-static const int kMediumDFFontLimit = 72;
-static const int kLargeDFFontSize = 162;
-
-static const int kDefaultMinDistanceFieldFontSize = 18;
-#ifdef SK_BUILD_FOR_ANDROID
-static const int kDefaultMaxDistanceFieldFontSize = 384;
-#else
-static const int kDefaultMaxDistanceFieldFontSize = 2 * kLargeDFFontSize;
-#endif
-
 GrTextContext::GrTextContext(const Options& options)
         : fDistanceAdjustTable(new GrDistanceFieldAdjustTable), fOptions(options) {
     SanitizeOptions(&fOptions);
@@ -192,7 +176,7 @@ void GrTextContext::InitDistanceFieldPaint(GrTextBlob* blob,
     skPaint->setHinting(SkPaint::kNormal_Hinting);
     skPaint->setSubpixelText(true);
 
-    skPaint->setMaskFilter(GrSDFMaskFilter::Make());
+    skPaint->setMaskFilter(SkSDFMaskFilter::Make());
 
     // We apply the fake-gamma by altering the distance in the shader, so we ignore the
     // passed-in scaler context flags. (It's only used when we fall-back to bitmap text).
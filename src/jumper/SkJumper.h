@@ -31,6 +31,22 @@ struct SkJumper_GatherCtx {
     float       height;
 };
 
+// Samples a signed distance field, then converts it to coverage as value * scale + bias.
+struct SkJumper_SDFCtx {
+    SkJumper_GatherCtx gather;
+    float              scale;
+    float              bias;
+};
+
+// Maps device coordinates through a row-major perspective matrix, then averages taps bilinear
+// samples spread evenly along the major axis of each pixel's footprint.
+struct SkJumper_AnisoCtx {
+    SkJumper_GatherCtx gather;
+    float              matrix[9];
+    int                taps;
+    float              invTaps;
+};
+
 // State shared by save_xy, accumulate, and bilinear_* / bicubic_*.
 struct SkJumper_SamplerCtx {
     float      x[SkJumper_kMaxStride];
@@ -61,6 +77,16 @@ struct SkJumper_CallbackCtx {
     float* read_from = rgba;
 };
 
+struct SkJumper_InterpreterCtx {
+    void (*fn)(SkJumper_InterpreterCtx* self, int dx, int dy,
+               int active_pixels/*<= SkJumper_kMaxStride*/);
+
+    // When called, fn() will have our active pixels available in rgba, stored planar:
+    // rgba[0*SkJumper_kMaxStride + i] is the red channel of pixel i, and so on.
+    // fn() updates them in place, and the pipeline reads them back when it returns.
+    float rgba[4*SkJumper_kMaxStride];
+};
+
 // This should line up with the memory layout of SkColorSpaceTransferFn.
 struct SkJumper_ParametricTransferFunction {
     float G, A,B,C,D,E,F;
@@ -1902,6 +1902,21 @@ STAGE(gradient, const SkJumper_GradientCtx* c) {
     gradient_lookup(c, idx, t, &r, &g, &b, &a);
 }
 
+// Linearly interpolates a table of RGBA float colors evenly spaced from t=0 to t=1.
+STAGE(gradient_lut, const SkJumper_GatherCtx* ctx) {
+    F x  = min(max(0, r), 1.0f) * (ctx->width - 1),
+      fx = fract(x);
+
+    const float* ptr;
+    U32 ix_l = ix_and_ptr(&ptr, ctx, x       , 0) * 4,
+        ix_r = ix_and_ptr(&ptr, ctx, x + 1.0f, 0) * 4;
+
+    r = lerp(gather(ptr, ix_l + 0), gather(ptr, ix_r + 0), fx);
+    g = lerp(gather(ptr, ix_l + 1), gather(ptr, ix_r + 1), fx);
+    b = lerp(gather(ptr, ix_l + 2), gather(ptr, ix_r + 2), fx);
+    a = lerp(gather(ptr, ix_l + 3), gather(ptr, ix_r + 3), fx);
+}
+
 STAGE(evenly_spaced_2_stop_gradient, const void* ctx) {
     // TODO: Rename Ctx SkJumper_EvenlySpaced2StopGradientCtx.
     struct Ctx { float f[4], b[4]; };
@@ -1950,6 +1965,11 @@ STAGE(xy_to_radius, Ctx::None) {
 
 STAGE(negate_x, Ctx::None) { r = -r; }
 
+STAGE(xy_to_2pt_conical_concentric, const SkJumper_2PtConicalCtx* ctx) {
+    F x = r, y = g, &t = r;
+    t = mad(sqrt_(x*x + y*y), ctx->fP0, ctx->fP1); // ctx->fP0 = scale, ctx->fP1 = bias
+}
+
 STAGE(xy_to_2pt_conical_strip, const SkJumper_2PtConicalCtx* ctx) {
     F x = r, y = g, &t = r;
     t = x + sqrt_(ctx->fP0 - y*y); // ctx->fP0 = r0 * r0
@@ -2120,6 +2140,18 @@ STAGE(callback, SkJumper_CallbackCtx* c) {
     load4(c->read_from,0, &r,&g,&b,&a);
 }
 
+STAGE(interpreter, SkJumper_InterpreterCtx* c) {
+    unaligned_store(c->rgba + 0*SkJumper_kMaxStride, r);
+    unaligned_store(c->rgba + 1*SkJumper_kMaxStride, g);
+    unaligned_store(c->rgba + 2*SkJumper_kMaxStride, b);
+    unaligned_store(c->rgba + 3*SkJumper_kMaxStride, a);
+    c->fn(c, (int)dx, (int)dy, tail ? tail : N);
+    r = unaligned_load<F>(c->rgba + 0*SkJumper_kMaxStride);
+    g = unaligned_load<F>(c->rgba + 1*SkJumper_kMaxStride);
+    b = unaligned_load<F>(c->rgba + 2*SkJumper_kMaxStride);
+    a = unaligned_load<F>(c->rgba + 3*SkJumper_kMaxStride);
+}
+
 STAGE(gauss_a_to_rgba, Ctx::None) {
     // x = 1 - x;
     // exp(-x * x * 4) - 0.018f;
@@ -2136,20 +2168,15 @@ STAGE(gauss_a_to_rgba, Ctx::None) {
     b = a;
 }
 
-// A specialized fused image shader for clamp-x, clamp-y, non-sRGB sampling.
-STAGE(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
-    // (cx,cy) are the center of our sample.
-    F cx = r,
-      cy = g;
-
+// Bilinearly samples a clamp-x, clamp-y 8888 image at (cx,cy), adding its color times weight
+// into {r,g,b,a}.
+SI void bilerp_clamp_8888_accumulate(const SkJumper_GatherCtx* ctx, F cx, F cy, F weight,
+                                     F* r, F* g, F* b, F* a) {
     // All sample points are at the same fractional offset (fx,fy).
     // They're the 4 corners of a logical 1x1 pixel surrounding (x,y) at (0.5,0.5) offsets.
     F fx = fract(cx + 0.5f),
       fy = fract(cy + 0.5f);
 
-    // We'll accumulate the color of all four samples into {r,g,b,a} directly.
-    r = g = b = a = 0;
-
     for (float dy = -0.5f; dy <= +0.5f; dy += 1.0f)
     for (float dx = -0.5f; dx <= +0.5f; dx += 1.0f) {
         // (x,y) are the coordinates of this sample point.
@@ -2169,13 +2196,78 @@ STAGE(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
         // or (1-fx) at negative x.  Same deal for y.
         F sx = (dx > 0) ? fx : 1.0f - fx,
           sy = (dy > 0) ? fy : 1.0f - fy,
-          area = sx * sy;
+          area = sx * sy * weight;
+
+        *r += sr * area;
+        *g += sg * area;
+        *b += sb * area;
+        *a += sa * area;
+    }
+}
+
+// A specialized fused image shader for clamp-x, clamp-y, non-sRGB sampling.
+STAGE(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
+    // (cx,cy) are the center of our sample.
+    F cx = r,
+      cy = g;
+
+    // We'll accumulate the color of all four samples into {r,g,b,a} directly.
+    r = g = b = a = 0;
+    bilerp_clamp_8888_accumulate(ctx, cx,cy, 1.0f, &r,&g,&b,&a);
+}
+
+// Like bilerp_clamp_8888, but averages several bilinear samples along the longer side of each
+// pixel's footprint in the image. This starts from device coordinates, since the footprint comes
+// from the derivatives of the matrix at each pixel.
+STAGE(aniso_clamp_8888, const SkJumper_AnisoCtx* ctx) {
+    const float* m = ctx->matrix;
+    F X = mad(r,m[0], mad(g,m[1], m[2])),
+      Y = mad(r,m[3], mad(g,m[4], m[5])),
+      W = mad(r,m[6], mad(g,m[7], m[8]));
+    F invW = 1.0f / W,
+      u = X * invW,
+      v = Y * invW;
+
+    // The footprint's sides are the derivatives of (u,v) along device x and y.
+    F dudx = (m[0] - u*m[6]) * invW,  dvdx = (m[3] - v*m[6]) * invW,
+      dudy = (m[1] - u*m[7]) * invW,  dvdy = (m[4] - v*m[7]) * invW;
+    auto major_is_x = dudx*dudx + dvdx*dvdx >= dudy*dudy + dvdy*dvdy;
+    F du = if_then_else(major_is_x, dudx, dudy) * ctx->invTaps,
+      dv = if_then_else(major_is_x, dvdx, dvdy) * ctx->invTaps;
+
+    // The taps are centered on (u,v), each covering an equal part of the major axis.
+    F cx = u - du * (0.5f * (ctx->taps - 1)),
+      cy = v - dv * (0.5f * (ctx->taps - 1));
+
+    r = g = b = a = 0;
+    for (int i = 0; i < ctx->taps; i++) {
+        bilerp_clamp_8888_accumulate(&ctx->gather, cx,cy, ctx->invTaps, &r,&g,&b,&a);
+        cx += du;
+        cy += dv;
+    }
+}
 
-        r += sr * area;
-        g += sg * area;
-        b += sb * area;
-        a += sa * area;
+// Bilinearly samples an 8-bit clamp/clamp signed distance field, like bilerp_clamp_8888 does
+// colors, and turns the distance into coverage in a.
+STAGE(bilerp_sdf, const SkJumper_SDFCtx* ctx) {
+    F cx = r,
+      cy = g;
+    F fx = fract(cx + 0.5f),
+      fy = fract(cy + 0.5f);
+
+    F distance = 0;
+    for (float dy = -0.5f; dy <= +0.5f; dy += 1.0f)
+    for (float dx = -0.5f; dx <= +0.5f; dx += 1.0f) {
+        const uint8_t* ptr;
+        U32 ix = ix_and_ptr(&ptr, &ctx->gather, cx + dx, cy + dy);
+
+        F sx = (dx > 0) ? fx : 1.0f - fx,
+          sy = (dy > 0) ? fy : 1.0f - fy;
+        distance = mad(from_byte(gather(ptr, ix)), sx * sy, distance);
     }
+
+    r = g = b = 0;
+    a = min(max(0, mad(distance, ctx->scale, ctx->bias)), 1.0f);
 }
 
 namespace lowp {
@@ -3142,6 +3234,25 @@ STAGE_GP(evenly_spaced_gradient, const SkJumper_GradientCtx* c) {
     gradient_lookup(c, idx, t, &r, &g, &b, &a);
 }
 
+STAGE_GP(gradient_lut, const SkJumper_GatherCtx* ctx) {
+    F t  = min(max(0, x), 1.0f) * (ctx->width - 1),
+      ft = fract(t);
+
+    const float* ptr;
+    U32 ix_l = ix_and_ptr(&ptr, ctx, t       , 0) * 4,
+        ix_r = ix_and_ptr(&ptr, ctx, t + 1.0f, 0) * 4;
+
+    auto lerp_channel = [&](int channel) {
+        F lo = gather<F>(ptr, ix_l + channel),
+          hi = gather<F>(ptr, ix_r + channel);
+        return round_F_to_U16(mad(ft, hi - lo, lo));
+    };
+    r = lerp_channel(0);
+    g = lerp_channel(1);
+    b = lerp_channel(2);
+    a = lerp_channel(3);
+}
+
 STAGE_GP(evenly_spaced_2_stop_gradient, const void* ctx) {
     // TODO: Rename Ctx SkJumper_EvenlySpaced2StopGradientCtx.
     struct Ctx { float f[4], b[4]; };
@@ -3181,6 +3292,52 @@ STAGE_GG(xy_to_radius, Ctx::None) {
     x = sqrt_(x*x + y*y);
 }
 
+STAGE_GG(negate_x, Ctx::None) { x = -x; }
+
+STAGE_GG(xy_to_2pt_conical_concentric, const SkJumper_2PtConicalCtx* ctx) {
+    x = mad(sqrt_(x*x + y*y), ctx->fP0, ctx->fP1);
+}
+STAGE_GG(xy_to_2pt_conical_strip, const SkJumper_2PtConicalCtx* ctx) {
+    x = x + sqrt_(ctx->fP0 - y*y);
+}
+STAGE_GG(xy_to_2pt_conical_focal_on_circle, Ctx::None) {
+    x = x + y*y / x;
+}
+STAGE_GG(xy_to_2pt_conical_well_behaved, const SkJumper_2PtConicalCtx* ctx) {
+    x = sqrt_(x*x + y*y) - x * ctx->fP0;
+}
+STAGE_GG(xy_to_2pt_conical_greater, const SkJumper_2PtConicalCtx* ctx) {
+    x = sqrt_(x*x - y*y) - x * ctx->fP0;
+}
+STAGE_GG(xy_to_2pt_conical_smaller, const SkJumper_2PtConicalCtx* ctx) {
+    x = -sqrt_(x*x - y*y) - x * ctx->fP0;
+}
+STAGE_GG(alter_2pt_conical_compensate_focal, const SkJumper_2PtConicalCtx* ctx) {
+    x = x + ctx->fP1;
+}
+STAGE_GG(alter_2pt_conical_unswap, Ctx::None) {
+    x = 1 - x;
+}
+
+// Like the decal masks, lowp stores 16-bit masks into fMask, read back by apply_vector_mask.
+STAGE_GG(mask_2pt_conical_nan, SkJumper_2PtConicalCtx* c) {
+    auto is_valid = (x == x);  // Not NaN.
+    x = if_then_else(is_valid, x, F(0));
+    unaligned_store(c->fMask, cond_to_mask_16(is_valid));
+}
+STAGE_GG(mask_2pt_conical_degenerates, SkJumper_2PtConicalCtx* c) {
+    auto is_valid = (x > 0);  // Also false for NaN.
+    x = if_then_else(is_valid, x, F(0));
+    unaligned_store(c->fMask, cond_to_mask_16(is_valid));
+}
+STAGE_PP(apply_vector_mask, const uint32_t* ctx) {
+    auto mask = unaligned_load<U16>(ctx);
+    r = r & mask;
+    g = g & mask;
+    b = b & mask;
+    a = a & mask;
+}
+
 // ~~~~~~ Compound stages ~~~~~~ //
 
 STAGE_PP(srcover_rgba_8888, const SkJumper_MemoryCtx* ctx) {
@@ -3210,7 +3367,7 @@ STAGE_PP(srcover_bgra_8888, const SkJumper_MemoryCtx* ctx) {
 using NotImplemented = void(*)(void);
 
 static NotImplemented
-        callback, load_rgba, store_rgba,
+        callback, interpreter, load_rgba, store_rgba,
         unbounded_uniform_color,
         unpremul, dither,
         from_srgb, from_srgb_dst, to_srgb,
@@ -3226,23 +3383,11 @@ static NotImplemented
         gauss_a_to_rgba,
         mirror_x, repeat_x,
         mirror_y, repeat_y,
-        negate_x,
-        bilerp_clamp_8888,
+        bilerp_clamp_8888, bilerp_sdf, aniso_clamp_8888,
         bilinear_nx, bilinear_ny, bilinear_px, bilinear_py,
         bicubic_n3x, bicubic_n1x, bicubic_p1x, bicubic_p3x,
         bicubic_n3y, bicubic_n1y, bicubic_p1y, bicubic_p3y,
-        save_xy, accumulate,
-        xy_to_2pt_conical_well_behaved,
-        xy_to_2pt_conical_strip,
-        xy_to_2pt_conical_focal_on_circle,
-        xy_to_2pt_conical_smaller,
-        xy_to_2pt_conical_greater,
-        xy_to_2pt_conical_compensate_focal,
-        alter_2pt_conical_compensate_focal,
-        alter_2pt_conical_unswap,
-        mask_2pt_conical_nan,
-        mask_2pt_conical_degenerates,
-        apply_vector_mask;
+        save_xy, accumulate;
 
 #endif//defined(JUMPER_IS_SCALAR) controlling whether we build lowp stages
 }  // namespace lowp
@@ -22,12 +22,17 @@
 #include "SkMutex.h"
 #include "SkOTUtils.h"
 #include "SkPath.h"
+#include "SkResourceCache.h"
 #include "SkScalerContext.h"
+#include "SkScopeExit.h"
 #include "SkStream.h"
 #include "SkString.h"
+#include "SkTDArray.h"
+#include "SkTLazy.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 
+#include <atomic>
 #include <memory>
 
 #include <ft2build.h>
@@ -232,6 +237,45 @@ SK_DECLARE_STATIC_MUTEX(gFTMutex);
 static FreeTypeLibrary* gFTLibrary;
 static SkFaceRec* gFaceRecHead;
 
+// FreeType only allows one thread at a time to use an FT_Library and the faces opened with it. A
+// scaler context borrows an FTLibraryRec for each call which uses its face and returns it when the
+// call is done, so the number of libraries follows the number of threads generating glyphs at
+// once rather than the number of strikes. A library keeps the faces and sizes it was last used
+// with, so a scaler context rarely has to open a face or set up a size again.
+struct FTLibraryRec {
+    struct SizeRec {
+        uint32_t fScalerContextID;
+        FT_Size  fSize;  // Owned by the face.
+    };
+    struct FaceRec {
+        std::unique_ptr<SkFaceRec> fFaceRec;
+        SkTDArray<SizeRec> fSizes;  // Least recently used first.
+
+        // Takes ownership of size, closing the least recently used size if there are too many.
+        void addSize(uint32_t scalerContextID, FT_Size size);
+        // Returns the scaler context's size, if there is one, and makes it the most recently used.
+        FT_Size findSize(uint32_t scalerContextID);
+    };
+
+    ~FTLibraryRec();
+
+    // Returns the index of the typeface's face in fFaces, or -1.
+    int findFace(SkFontID fontID) const;
+    // Returns the typeface's face, opening it if needed, and makes it the most recently used.
+    // Will return nullptr on failure.
+    FaceRec* face(const SkTypeface* typeface);
+
+    FreeTypeLibrary fLibrary;
+    SkTDArray<FaceRec*> fFaces;  // Least recently used first.
+};
+
+// Libraries which are not in use by a scaler context, least recently used first. Creating a
+// library loads all of the default modules, so a few idle ones are kept around.
+static SkTDArray<FTLibraryRec*> gFTLibraryPool;
+static constexpr int kMaxIdleFTLibraries = 4;
+static constexpr int kMaxFacesPerFTLibrary = 8;
+static constexpr int kMaxSizesPerFTFace = 8;
+
 // Private to ref_ft_library and unref_ft_library
 static int gFTCount;
 
@@ -259,6 +303,42 @@ static void unref_ft_library() {
         SkASSERT(nullptr != gFTLibrary);
         delete gFTLibrary;
         SkDEBUGCODE(gFTLibrary = nullptr;)
+        gFTLibraryPool.deleteAll();
+    }
+}
+
+// Returns a library for the exclusive use of the caller, preferring an idle one which already has
+// the typeface's face open. The caller must hold a ref on the shared library (so that the pool
+// isn't emptied) and return the library with release_ft_library.
+// Caller must lock gFTMutex before calling this function.
+static FTLibraryRec* acquire_ft_library(SkFontID fontID) {
+    gFTMutex.assertHeld();
+    SkASSERT(gFTCount > 0);
+
+    if (gFTLibraryPool.isEmpty()) {
+        return new FTLibraryRec;
+    }
+    int index = gFTLibraryPool.count() - 1;
+    for (int i = gFTLibraryPool.count() - 1; i >= 0; --i) {
+        if (gFTLibraryPool[i]->findFace(fontID) >= 0) {
+            index = i;
+            break;
+        }
+    }
+    FTLibraryRec* library = gFTLibraryPool[index];
+    gFTLibraryPool.remove(index);
+    return library;
+}
+
+// Caller must lock gFTMutex before calling this function.
+static void release_ft_library(FTLibraryRec* library) {
+    gFTMutex.assertHeld();
+    SkASSERT(gFTCount > 0);
+
+    *gFTLibraryPool.append() = library;
+    if (gFTLibraryPool.count() > kMaxIdleFTLibraries) {
+        delete gFTLibraryPool[0];
+        gFTLibraryPool.remove(0);
     }
 }
 
@@ -360,22 +440,12 @@ static void ft_face_setup_axes(SkFaceRec* rec, const SkFontData& data) {
     }
 }
 
+// Opens a new face for the typeface with the given library. The face is not added to the list of
+// shared faces. Memory backed font data is shared with the typeface rather than copied.
 // Will return nullptr on failure
-// Caller must lock gFTMutex before calling this function.
-static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
-    gFTMutex.assertHeld();
-
+// The caller must have exclusive use of the library.
+static std::unique_ptr<SkFaceRec> open_ft_face(FT_Library library, const SkTypeface* typeface) {
     const SkFontID fontID = typeface->uniqueID();
-    SkFaceRec* cachedRec = gFaceRecHead;
-    while (cachedRec) {
-        if (cachedRec->fFontID == fontID) {
-            SkASSERT(cachedRec->fFace);
-            cachedRec->fRefCnt += 1;
-            return cachedRec;
-        }
-        cachedRec = cachedRec->fNext;
-    }
-
     std::unique_ptr<SkFontData> data = typeface->makeFontData();
     if (nullptr == data || !data->hasStream()) {
         return nullptr;
@@ -397,7 +467,7 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
 
     {
         FT_Face rawFace;
-        FT_Error err = FT_Open_Face(gFTLibrary->library(), &args, data->getIndex(), &rawFace);
+        FT_Error err = FT_Open_Face(library, &args, data->getIndex(), &rawFace);
         if (err) {
             SK_TRACEFTR(err, "unable to open font '%x'", fontID);
             return nullptr;
@@ -417,15 +487,99 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
     if (!rec->fFace->charmap) {
         FT_Select_Charmap(rec->fFace.get(), FT_ENCODING_MS_SYMBOL);
     }
+    return rec;
+}
+
+FTLibraryRec::~FTLibraryRec() {
+    // Closing a face also closes its sizes.
+    fFaces.deleteAll();
+}
 
+int FTLibraryRec::findFace(SkFontID fontID) const {
+    for (int i = 0; i < fFaces.count(); ++i) {
+        if (fFaces[i]->fFaceRec->fFontID == fontID) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+FTLibraryRec::FaceRec* FTLibraryRec::face(const SkTypeface* typeface) {
+    int index = this->findFace(typeface->uniqueID());
+    if (index >= 0) {
+        FaceRec* face = fFaces[index];
+        fFaces.remove(index);
+        *fFaces.append() = face;
+        return face;
+    }
+
+    if (!fLibrary.library()) {
+        return nullptr;
+    }
+    std::unique_ptr<SkFaceRec> rec = open_ft_face(fLibrary.library(), typeface);
+    if (!rec) {
+        return nullptr;
+    }
+#ifdef FT_COLOR_H
+    FT_Palette_Select(rec->fFace.get(), 0, nullptr);
+#endif
+    if (fFaces.count() >= kMaxFacesPerFTLibrary) {
+        delete fFaces[0];
+        fFaces.remove(0);
+    }
+    FaceRec* face = new FaceRec;
+    face->fFaceRec = std::move(rec);
+    *fFaces.append() = face;
+    return face;
+}
+
+void FTLibraryRec::FaceRec::addSize(uint32_t scalerContextID, FT_Size size) {
+    if (fSizes.count() >= kMaxSizesPerFTFace) {
+        FT_Done_Size(fSizes[0].fSize);
+        fSizes.remove(0);
+    }
+    *fSizes.append() = { scalerContextID, size };
+}
+
+FT_Size FTLibraryRec::FaceRec::findSize(uint32_t scalerContextID) {
+    for (int i = 0; i < fSizes.count(); ++i) {
+        if (fSizes[i].fScalerContextID == scalerContextID) {
+            SizeRec size = fSizes[i];
+            fSizes.remove(i);
+            *fSizes.append() = size;
+            return size.fSize;
+        }
+    }
+    return nullptr;
+}
+
+// Will return nullptr on failure
+// Caller must lock gFTMutex before calling this function.
+static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
+    gFTMutex.assertHeld();
+
+    const SkFontID fontID = typeface->uniqueID();
+    SkFaceRec* cachedRec = gFaceRecHead;
+    while (cachedRec) {
+        if (cachedRec->fFontID == fontID) {
+            SkASSERT(cachedRec->fFace);
+            cachedRec->fRefCnt += 1;
+            return cachedRec;
+        }
+        cachedRec = cachedRec->fNext;
+    }
+
+    std::unique_ptr<SkFaceRec> rec = open_ft_face(gFTLibrary->library(), typeface);
+    if (!rec) {
+        return nullptr;
+    }
     rec->fNext = gFaceRecHead;
     gFaceRecHead = rec.get();
     return rec.release();
 }
 
 // Caller must lock gFTMutex before calling this function.
-// Marked extern because vc++ does not support internal linkage template parameters.
-extern /*static*/ void unref_ft_face(SkFaceRec* faceRec) {
+static void unref_ft_face(SkFaceRec* faceRec) {
     gFTMutex.assertHeld();
 
     SkFaceRec*  rec = gFaceRecHead;
@@ -486,7 +640,7 @@ public:
     ~SkScalerContext_FreeType() override;
 
     bool success() const {
-        return fFTSize != nullptr && fFace != nullptr;
+        return fSuccess;
     }
 
 protected:
@@ -500,11 +654,30 @@ protected:
     SkUnichar generateGlyphToChar(uint16_t glyph) override;
 
 private:
-    using UnrefFTFace = SkFunctionWrapper<void, SkFaceRec, unref_ft_face>;
-    std::unique_ptr<SkFaceRec, UnrefFTFace> fFaceRec;
+    // Borrows a library for one call which uses fFace, and activates this scaler context's size
+    // on the library's face for the typeface. The library is only used by the borrowing thread,
+    // so no lock is held while generating glyphs.
+    class AutoFTFace : SkNoncopyable {
+    public:
+        AutoFTFace(SkScalerContext_FreeType* context)
+            : fContext(context), fError(context->acquireFace()) {}
+        ~AutoFTFace() { fContext->releaseFace(); }
+
+        FT_Error error() const { return fError; }
+
+    private:
+        SkScalerContext_FreeType* fContext;
+        FT_Error fError;
+    };
+
+    // Identifies this scaler context's sizes in the libraries' faces.
+    const uint32_t fSizeID;
+    bool      fSuccess;
+
+    // Only set while an AutoFTFace exists.
+    FTLibraryRec* fFTLibrary;
+    FT_Face   fFace;  // Owned by fFTLibrary.
 
-    FT_Face   fFace;  // Borrowed face from gFaceRecHead.
-    FT_Size   fFTSize;  // The size on the fFace for this scaler.
     FT_Int    fStrikeIndex;
 
     /** The rest of the matrix after FreeType handles the size.
@@ -517,17 +690,22 @@ private:
     /** The actual size requested. */
     SkVector  fScale;
 
+    /** If fUnscaledPaths, maps the typeface's cached unscaled glyph paths to this size. */
+    SkMatrix  fUnscaledPathMatrix;
+    bool      fUnscaledPaths;
+
     uint32_t  fLoadGlyphFlags;
     bool      fDoLinearMetrics;
     bool      fLCDIsVert;
 
-    FT_Error setupSize();
+    FT_Error acquireFace();
+    void releaseFace();
+    // Creates and activates a new size on the face and sets it to this scaler context's scale.
+    FT_Error newSize(FT_Face face, FT_Size* size);
     void getBBoxForCurrentGlyph(const SkGlyph* glyph, FT_BBox* bbox,
                                 bool snapToPixelBoundary = false);
     bool getCBoxForLetter(char letter, FT_BBox* bbox);
-    // Caller must lock gFTMutex before calling this function.
     void updateGlyphIfLCD(SkGlyph* glyph);
-    // Caller must lock gFTMutex before calling this function.
     // update FreeType2 glyph slot with glyph emboldened
     void emboldenIfNeeded(FT_Face face, FT_GlyphSlot glyph, SkGlyphID gid);
     bool shouldSubpixelBitmap(const SkGlyph&, const SkMatrix&);
@@ -796,24 +974,36 @@ static FT_Int chooseBitmapStrike(FT_Face face, FT_F26Dot6 scaleY) {
     return chosenStrikeIndex;
 }
 
+static uint32_t next_scaler_context_size_id() {
+    static std::atomic<uint32_t> nextID{1};
+    return nextID.fetch_add(1, std::memory_order_relaxed);
+}
+
 SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
                                                    const SkScalerContextEffects& effects,
                                                    const SkDescriptor* desc)
     : SkScalerContext_FreeType_Base(std::move(typeface), effects, desc)
+    , fSizeID(next_scaler_context_size_id())
+    , fSuccess(false)
+    , fFTLibrary(nullptr)
     , fFace(nullptr)
-    , fFTSize(nullptr)
     , fStrikeIndex(-1)
+    , fUnscaledPaths(false)
 {
-    SkAutoMutexAcquire  ac(gFTMutex);
-    SkASSERT_RELEASE(ref_ft_library());
-
-    fFaceRec.reset(ref_ft_face(this->getTypeface()));
+    {
+        SkAutoMutexAcquire  ac(gFTMutex);
+        SkASSERT_RELEASE(ref_ft_library());
+        fFTLibrary = acquire_ft_library(this->getTypeface()->uniqueID());
+    }
+    SK_AT_SCOPE_EXIT(this->releaseFace());
 
     // load the font file
-    if (nullptr == fFaceRec) {
+    FTLibraryRec::FaceRec* faceRec = fFTLibrary->face(this->getTypeface());
+    if (nullptr == faceRec) {
         SkDEBUGF("Could not create FT_Face.\n");
         return;
     }
+    FT_Face face = faceRec->fFaceRec->fFace.get();
 
     fLCDIsVert = SkToBool(fRec.fFlags & SkScalerContext::kLCD_Vertical_Flag);
 
@@ -884,72 +1074,46 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
         fLoadGlyphFlags = loadFlags;
     }
 
-    using DoneFTSize = SkFunctionWrapper<FT_Error, skstd::remove_pointer_t<FT_Size>, FT_Done_Size>;
-    std::unique_ptr<skstd::remove_pointer_t<FT_Size>, DoneFTSize> ftSize([this]() -> FT_Size {
-        FT_Size size;
-        FT_Error err = FT_New_Size(fFaceRec->fFace.get(), &size);
-        if (err != 0) {
-            SK_TRACEFTR(err, "FT_New_Size(%s) failed.", fFaceRec->fFace->family_name);
-            return nullptr;
+    fRec.computeMatrices(SkScalerContextRec::kFull_PreMatrixScale, &fScale, &fMatrix22Scalar);
+
+    if (FT_IS_SCALABLE(face)) {
+        fStrikeIndex = -1;
+    } else if (FT_HAS_FIXED_SIZES(face)) {
+        fStrikeIndex = chooseBitmapStrike(face, SkScalarToFDot6(fScale.fY));
+        if (fStrikeIndex == -1) {
+            SkDEBUGF("No glyphs for font \"%s\" size %f.\n", face->family_name, fScale.fY);
+            return;
         }
-        return size;
-    }());
-    if (nullptr == ftSize) {
-        SkDEBUGF("Could not create FT_Size.\n");
+    } else {
+        SkDEBUGF("Unknown kind of font \"%s\" size %f.\n", face->family_name, fScale.fY);
         return;
     }
 
-    FT_Error err = FT_Activate_Size(ftSize.get());
-    if (err != 0) {
-        SK_TRACEFTR(err, "FT_Activate_Size(%s) failed.", fFaceRec->fFace->family_name);
+    FT_Size ftSize;
+    if (this->newSize(face, &ftSize) != 0) {
+        SkDEBUGF("Could not create FT_Size.\n");
         return;
     }
+    faceRec->addSize(fSizeID, ftSize);
 
-    fRec.computeMatrices(SkScalerContextRec::kFull_PreMatrixScale, &fScale, &fMatrix22Scalar);
-    FT_F26Dot6 scaleX = SkScalarToFDot6(fScale.fX);
-    FT_F26Dot6 scaleY = SkScalarToFDot6(fScale.fY);
-
-    if (FT_IS_SCALABLE(fFaceRec->fFace)) {
-        err = FT_Set_Char_Size(fFaceRec->fFace.get(), scaleX, scaleY, 72, 72);
-        if (err != 0) {
-            SK_TRACEFTR(err, "FT_Set_CharSize(%s, %f, %f) failed.",
-                        fFaceRec->fFace->family_name, fScale.fX, fScale.fY);
-            return;
-        }
-
+    if (FT_IS_SCALABLE(face)) {
 #ifndef SK_IGNORE_TINY_FREETYPE_SIZE_FIX
         // Adjust the matrix to reflect the actually chosen scale.
         // FreeType currently does not allow requesting sizes less than 1, this allow for scaling.
         // Don't do this at all sizes as that will interfere with hinting.
         if (fScale.fX < 1 || fScale.fY < 1) {
-            SkScalar upem = fFaceRec->fFace->units_per_EM;
-            FT_Size_Metrics& ftmetrics = fFaceRec->fFace->size->metrics;
+            SkScalar upem = face->units_per_EM;
+            FT_Size_Metrics& ftmetrics = face->size->metrics;
             SkScalar x_ppem = upem * SkFT_FixedToScalar(ftmetrics.x_scale) / 64.0f;
             SkScalar y_ppem = upem * SkFT_FixedToScalar(ftmetrics.y_scale) / 64.0f;
             fMatrix22Scalar.preScale(fScale.x() / x_ppem, fScale.y() / y_ppem);
         }
 #endif
-
-    } else if (FT_HAS_FIXED_SIZES(fFaceRec->fFace)) {
-        fStrikeIndex = chooseBitmapStrike(fFaceRec->fFace.get(), scaleY);
-        if (fStrikeIndex == -1) {
-            SkDEBUGF("No glyphs for font \"%s\" size %f.\n",
-                     fFaceRec->fFace->family_name, fScale.fY);
-            return;
-        }
-
-        err = FT_Select_Size(fFaceRec->fFace.get(), fStrikeIndex);
-        if (err != 0) {
-            SK_TRACEFTR(err, "FT_Select_Size(%s, %d) failed.",
-                        fFaceRec->fFace->family_name, fStrikeIndex);
-            fStrikeIndex = -1;
-            return;
-        }
-
+    } else {
         // Adjust the matrix to reflect the actually chosen scale.
         // It is likely that the ppem chosen was not the one requested, this allows for scaling.
-        fMatrix22Scalar.preScale(fScale.x() / fFaceRec->fFace->size->metrics.x_ppem,
-                                 fScale.y() / fFaceRec->fFace->size->metrics.y_ppem);
+        fMatrix22Scalar.preScale(fScale.x() / face->size->metrics.x_ppem,
+                                 fScale.y() / face->size->metrics.y_ppem);
 
         // FreeType does not provide linear metrics for bitmap fonts.
         linearMetrics = false;
@@ -961,9 +1125,6 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
         // However, in FreeType 2.5.1 color bitmap only fonts do not ignore this flag.
         // Force this flag off for bitmap only fonts.
         fLoadGlyphFlags &= ~FT_LOAD_NO_BITMAP;
-    } else {
-        SkDEBUGF("Unknown kind of font \"%s\" size %f.\n", fFaceRec->fFace->family_name, fScale.fY);
-        return;
     }
 
     fMatrix22.xx = SkScalarToFixed(fMatrix22Scalar.getScaleX());
@@ -971,51 +1132,121 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
     fMatrix22.yx = SkScalarToFixed(-fMatrix22Scalar.getSkewY());
     fMatrix22.yy = SkScalarToFixed(fMatrix22Scalar.getScaleY());
 
-#ifdef FT_COLOR_H
-    FT_Palette_Select(fFaceRec->fFace.get(), 0, nullptr);
-#endif
+    // Unhinted outlines of a scalable face only differ between sizes by the transform FreeType
+    // applies to them, so they are loaded in font units once for the typeface and transformed.
+    // FreeType hints tricky faces even when asked not to, so their outlines do depend on the size.
+    // If the resource cache can't hold the outlines there is nothing to share.
+    if (FT_IS_SCALABLE(face) && !FT_IS_TRICKY(face) && !FT_HAS_MULTIPLE_MASTERS(face) &&
+        SkToBool(fLoadGlyphFlags & FT_LOAD_NO_HINTING) && !this->isVertical() &&
+        !(fRec.fFlags & SkScalerContext::kEmbolden_Flag) &&
+        (SkResourceCache::GetTotalByteLimit() > 0 || SkResourceCache::GetDiscardableFactory()))
+    {
+        FT_Size_Metrics& ftmetrics = face->size->metrics;
+        fUnscaledPathMatrix.setScale(SkFT_FixedToScalar(ftmetrics.x_scale),
+                                     SkFT_FixedToScalar(ftmetrics.y_scale));
+        fUnscaledPathMatrix.postConcat(fMatrix22Scalar);
+        fUnscaledPaths = true;
+    }
 
-    fFTSize = ftSize.release();
-    fFace = fFaceRec->fFace.get();
     fDoLinearMetrics = linearMetrics;
+    fSuccess = true;
 }
 
 SkScalerContext_FreeType::~SkScalerContext_FreeType() {
+    // This scaler context's sizes are left in the libraries' faces until they are pushed out by
+    // newer ones, or the face or library is closed.
     SkAutoMutexAcquire  ac(gFTMutex);
+    unref_ft_library();
+}
 
-    if (fFTSize != nullptr) {
-        FT_Done_Size(fFTSize);
+FT_Error SkScalerContext_FreeType::newSize(FT_Face face, FT_Size* size) {
+    FT_Error err = FT_New_Size(face, size);
+    if (err != 0) {
+        SK_TRACEFTR(err, "FT_New_Size(%s) failed.", face->family_name);
+        return err;
     }
-
-    fFaceRec = nullptr;
-
-    unref_ft_library();
+    err = FT_Activate_Size(*size);
+    if (err != 0) {
+        SK_TRACEFTR(err, "FT_Activate_Size(%s) failed.", face->family_name);
+    } else if (fStrikeIndex == -1) {
+        err = FT_Set_Char_Size(face, SkScalarToFDot6(fScale.fX), SkScalarToFDot6(fScale.fY),
+                               72, 72);
+        if (err != 0) {
+            SK_TRACEFTR(err, "FT_Set_CharSize(%s, %f, %f) failed.",
+                        face->family_name, fScale.fX, fScale.fY);
+        }
+    } else {
+        err = FT_Select_Size(face, fStrikeIndex);
+        if (err != 0) {
+            SK_TRACEFTR(err, "FT_Select_Size(%s, %d) failed.", face->family_name, fStrikeIndex);
+        }
+    }
+    if (err != 0) {
+        FT_Done_Size(*size);
+        *size = nullptr;
+    }
+    return err;
 }
 
-/*  We call this before each use of the fFace, since we may be sharing
-    this face with other context (at different sizes).
+/*  We call this before each use of the fFace. Loading glyphs with other scaler contexts may have
+    left the library's face with a different size and transform.
 */
-FT_Error SkScalerContext_FreeType::setupSize() {
-    gFTMutex.assertHeld();
-    FT_Error err = FT_Activate_Size(fFTSize);
+FT_Error SkScalerContext_FreeType::acquireFace() {
+    SkASSERT(fSuccess && !fFTLibrary);
+    {
+        SkAutoMutexAcquire  ac(gFTMutex);
+        fFTLibrary = acquire_ft_library(this->getTypeface()->uniqueID());
+    }
+    FTLibraryRec::FaceRec* faceRec = fFTLibrary->face(this->getTypeface());
+    if (!faceRec) {
+        return FT_Err_Cannot_Open_Resource;
+    }
+    FT_Face face = faceRec->fFaceRec->fFace.get();
+    FT_Size size = faceRec->findSize(fSizeID);
+    if (!size) {
+        FT_Error err = this->newSize(face, &size);
+        if (err != 0) {
+            return err;
+        }
+        faceRec->addSize(fSizeID, size);
+    }
+    FT_Error err = FT_Activate_Size(size);
     if (err != 0) {
         return err;
     }
-    FT_Set_Transform(fFace, &fMatrix22, nullptr);
+    FT_Set_Transform(face, &fMatrix22, nullptr);
+    fFace = face;
     return 0;
 }
 
+void SkScalerContext_FreeType::releaseFace() {
+    fFace = nullptr;
+    SkAutoMutexAcquire  ac(gFTMutex);
+    release_ft_library(fFTLibrary);
+    fFTLibrary = nullptr;
+}
+
 unsigned SkScalerContext_FreeType::generateGlyphCount() {
+    AutoFTFace ftFace(this);
+    if (ftFace.error()) {
+        return 0;
+    }
     return fFace->num_glyphs;
 }
 
 uint16_t SkScalerContext_FreeType::generateCharToGlyph(SkUnichar uni) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    AutoFTFace ftFace(this);
+    if (ftFace.error()) {
+        return 0;
+    }
     return SkToU16(FT_Get_Char_Index( fFace, uni ));
 }
 
 SkUnichar SkScalerContext_FreeType::generateGlyphToChar(uint16_t glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    AutoFTFace ftFace(this);
+    if (ftFace.error()) {
+        return 0;
+    }
     // iterate through each cmap entry, looking for matching glyph indices
     FT_UInt glyphIndex;
     SkUnichar charCode = FT_Get_First_Char( fFace, &glyphIndex );
@@ -1038,9 +1269,8 @@ bool SkScalerContext_FreeType::generateAdvance(SkGlyph* glyph) {
         return false;
     }
 
-    SkAutoMutexAcquire  ac(gFTMutex);
-
-    if (this->setupSize()) {
+    AutoFTFace ftFace(this);
+    if (ftFace.error()) {
         glyph->zeroMetrics();
         return true;
     }
@@ -1117,11 +1347,11 @@ bool SkScalerContext_FreeType::getCBoxForLetter(char letter, FT_BBox* bbox) {
 void SkScalerContext_FreeType::updateGlyphIfLCD(SkGlyph* glyph) {
     if (glyph->fMaskFormat == SkMask::kLCD16_Format) {
         if (fLCDIsVert) {
-            glyph->fHeight += gFTLibrary->lcdExtra();
-            glyph->fTop -= gFTLibrary->lcdExtra() >> 1;
+            glyph->fHeight += fFTLibrary->fLibrary.lcdExtra();
+            glyph->fTop -= fFTLibrary->fLibrary.lcdExtra() >> 1;
         } else {
-            glyph->fWidth += gFTLibrary->lcdExtra();
-            glyph->fLeft -= gFTLibrary->lcdExtra() >> 1;
+            glyph->fWidth += fFTLibrary->fLibrary.lcdExtra();
+            glyph->fLeft -= fFTLibrary->fLibrary.lcdExtra() >> 1;
         }
     }
 }
@@ -1143,11 +1373,10 @@ bool SkScalerContext_FreeType::shouldSubpixelBitmap(const SkGlyph& glyph, const
 }
 
 void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
-
     glyph->fMaskFormat = fRec.fMaskFormat;
 
-    if (this->setupSize()) {
+    AutoFTFace ftFace(this);
+    if (ftFace.error()) {
         glyph->zeroMetrics();
         return;
     }
@@ -1297,13 +1526,26 @@ static void clear_glyph_image(const SkGlyph& glyph) {
 }
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
-
-    if (this->setupSize()) {
+    AutoFTFace ftFace(this);
+    if (ftFace.error()) {
         clear_glyph_image(glyph);
         return;
     }
 
+    // Scaled bitmap strike glyphs, like color emoji, are drawn from the cached strike image when
+    // possible. Such a glyph is always subpixel positioned, as in shouldSubpixelBitmap.
+    const bool scaledStrike = fStrikeIndex != -1 && !fMatrix22Scalar.isIdentity();
+    if (scaledStrike) {
+        SkMatrix bitmapMatrix = fMatrix22Scalar;
+        if (this->isSubpixel()) {
+            bitmapMatrix.postTranslate(SkFixedToScalar(glyph.getSubXFixed()),
+                                       SkFixedToScalar(glyph.getSubYFixed()));
+        }
+        if (this->generateCachedBitmapImage(fStrikeIndex, fLoadGlyphFlags, glyph, bitmapMatrix)) {
+            return;
+        }
+    }
+
     FT_Error err = FT_Load_Glyph(fFace, glyph.getGlyphID(), fLoadGlyphFlags);
     if (err != 0) {
         SK_TRACEFTR(err, "SkScalerContext_FreeType::generateImage: FT_Load_Glyph(glyph:%d "
@@ -1323,16 +1565,16 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
                                            SkFixedToScalar(glyph.getSubYFixed()));
         bitmapMatrix = &subpixelBitmapMatrix;
     }
-    generateGlyphImage(fFace, glyph, *bitmapMatrix);
+    generateGlyphImage(fFace, glyph, *bitmapMatrix, scaledStrike ? fStrikeIndex : -1,
+                       fLoadGlyphFlags);
 }
 
 
 bool SkScalerContext_FreeType::generatePath(SkGlyphID glyphID, SkPath* path) {
     SkASSERT(path);
 
-    SkAutoMutexAcquire  ac(gFTMutex);
-
-    if (this->setupSize()) {
+    AutoFTFace ftFace(this);
+    if (ftFace.error()) {
         path->reset();
         return false;
     }
@@ -1341,6 +1583,25 @@ bool SkScalerContext_FreeType::generatePath(SkGlyphID glyphID, SkPath* path) {
     flags |= FT_LOAD_NO_BITMAP; // ignore embedded bitmaps so we're sure to get the outline
     flags &= ~FT_LOAD_RENDER;   // don't scan convert (we just want the outline)
 
+    if (fUnscaledPaths) {
+        SkPath unscaledPath;
+        if (!this->findUnscaledGlyphPath(glyphID, &unscaledPath)) {
+            // FreeType applies the transform even to unscaled outlines.
+            FT_Set_Transform(fFace, nullptr, nullptr);
+            FT_Error err = FT_Load_Glyph(fFace, glyphID, flags | FT_LOAD_NO_SCALE);
+            FT_Set_Transform(fFace, &fMatrix22, nullptr);
+            if (err != 0 || fFace->glyph->format == FT_GLYPH_FORMAT_BITMAP ||
+                !generateGlyphPath(fFace, &unscaledPath))
+            {
+                path->reset();
+                return false;
+            }
+            this->addUnscaledGlyphPath(glyphID, unscaledPath);
+        }
+        unscaledPath.transform(fUnscaledPathMatrix, path);
+        return true;
+    }
+
     FT_Error err = FT_Load_Glyph(fFace, glyphID, flags);
     if (err != 0 || fFace->glyph->format == FT_GLYPH_FORMAT_BITMAP) {
         path->reset();
@@ -1370,9 +1631,8 @@ void SkScalerContext_FreeType::generateFontMetrics(SkPaint::FontMetrics* metrics
         return;
     }
 
-    SkAutoMutexAcquire ac(gFTMutex);
-
-    if (this->setupSize()) {
+    AutoFTFace ftFace(this);
+    if (ftFace.error()) {
         sk_bzero(metrics, sizeof(*metrics));
         return;
     }
@@ -1549,6 +1809,7 @@ void SkScalerContext_FreeType::emboldenIfNeeded(FT_Face face, FT_GlyphSlot glyph
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#include "SkUTF.h"
 #include "SkUtils.h"
 
 static SkUnichar next_utf8(const void** chars) {
@@ -1576,9 +1837,166 @@ static EncodingProc find_encoding_proc(SkTypeface::Encoding enc) {
     return gProcs[enc];
 }
 
+/**
+ *  Maps the Basic Multilingual Plane to glyph ids without going through FreeType (or its mutex).
+ *  The plane is split into pages of 256 characters, and only the pages with mapped characters are
+ *  stored. Every other page refers to page 0, which maps everything to glyph 0.
+ */
+class SkTypeface_FreeType::CharToGlyphTable {
+public:
+    static std::unique_ptr<CharToGlyphTable> Make(FT_Face face) {
+        struct Mapping {
+            uint16_t fUni;
+            uint16_t fGlyph;
+        };
+        SkTDArray<Mapping> mappings;
+        std::unique_ptr<CharToGlyphTable> table(new CharToGlyphTable);
+        sk_bzero(table->fPages, sizeof(table->fPages));
+        int pageCount = 1;
+
+        FT_UInt glyphIndex;
+        FT_ULong charCode = FT_Get_First_Char(face, &glyphIndex);
+        while (glyphIndex) {
+            if (charCode > 0xFFFF) {
+                break;  // Characters are returned in order.
+            }
+            mappings.push_back({SkToU16(charCode), SkToU16(glyphIndex)});
+            if (0 == table->fPages[charCode >> 8]) {
+                table->fPages[charCode >> 8] = SkToU16(pageCount++);
+            }
+            charCode = FT_Get_Next_Char(face, charCode, &glyphIndex);
+        }
+
+        table->fGlyphs.reset(pageCount << 8);
+        sk_bzero(table->fGlyphs.get(), (pageCount << 8) * sizeof(uint16_t));
+        for (const Mapping& mapping : mappings) {
+            table->fGlyphs[(table->fPages[mapping.fUni >> 8] << 8) | (mapping.fUni & 0xFF)] =
+                    mapping.fGlyph;
+        }
+        return table;
+    }
+
+    uint16_t lookup(SkUnichar uni) const {
+        SkASSERT(0 <= uni && uni <= 0xFFFF);
+        return fGlyphs[(fPages[uni >> 8] << 8) | (uni & 0xFF)];
+    }
+
+private:
+    CharToGlyphTable() = default;
+
+    uint16_t fPages[256];
+    SkAutoTMalloc<uint16_t> fGlyphs;
+};
+
+SkTypeface_FreeType::SkTypeface_FreeType(const SkFontStyle& style, bool isFixedPitch)
+    : INHERITED(style, isFixedPitch)
+{}
+
+SkTypeface_FreeType::~SkTypeface_FreeType() {
+    if (fAddedToResourceCache.load()) {
+        SkResourceCache::PostPurgeSharedID(ResourceCacheSharedID(this->uniqueID()));
+    }
+}
+
+uint64_t SkTypeface_FreeType::ResourceCacheSharedID(SkFontID uniqueID) {
+    uint64_t sharedID = SkSetFourByteTag('f', 't', 't', 'f');
+    return (sharedID << 32) | uniqueID;
+}
+
+// Building the table walks the whole cmap, which isn't worth it for a typeface which is only asked
+// about a few characters, like most of the candidates when looking for a fallback font.
+static constexpr int kCharToGlyphTableThreshold = 1024;
+
+const SkTypeface_FreeType::CharToGlyphTable*
+SkTypeface_FreeType::charToGlyphTable(int charCount) const {
+    if (fCharsMapped.load(std::memory_order_relaxed) < kCharToGlyphTableThreshold) {
+        charCount = SkTMin(charCount, kCharToGlyphTableThreshold);
+        if (fCharsMapped.fetch_add(charCount, std::memory_order_relaxed) + charCount <
+            kCharToGlyphTableThreshold)
+        {
+            return nullptr;
+        }
+    }
+    fCharToGlyphOnce([this] {
+        AutoFTAccess fta(this);
+        if (FT_Face face = fta.face()) {
+            fCharToGlyph = CharToGlyphTable::Make(face);
+        }
+    });
+    return fCharToGlyph.get();
+}
+
+// Decodes count characters into dst. Only the number of characters is known, not the length of
+// the text, but every character is at least one code unit. So while eight or more characters are
+// left the next eight code units can be decoded as a block, as long as they are valid UTF-8 or
+// UTF-16. Anything else is decoded a character at a time, as it always has been.
+static void decode_chars(const void** chars, SkTypeface::Encoding encoding,
+                         SkUnichar dst[], int count) {
+    constexpr int kBlock = 8;
+    EncodingProc next_uni_proc = find_encoding_proc(encoding);
+    int i = 0;
+    while (i < count) {
+        int decoded = 0;
+        if (count - i >= kBlock) {
+            if (SkTypeface::kUTF8_Encoding == encoding) {
+                const char* utf8 = static_cast<const char*>(*chars);
+                decoded = SkUTF::UTF8ToUTF32(&utf8, utf8 + kBlock, dst + i, kBlock);
+                *chars = utf8;
+            } else if (SkTypeface::kUTF16_Encoding == encoding) {
+                const uint16_t* utf16 = static_cast<const uint16_t*>(*chars);
+                decoded = SkUTF::UTF16ToUTF32(&utf16, utf16 + kBlock, dst + i, kBlock);
+                *chars = utf16;
+            }
+        }
+        if (decoded) {
+            i += decoded;
+        } else {
+            dst[i++] = next_uni_proc(chars);
+        }
+    }
+}
+
 int SkTypeface_FreeType::onCharsToGlyphs(const void* chars, Encoding encoding,
                                          uint16_t glyphs[], int glyphCount) const
 {
+    if (const CharToGlyphTable* table = this->charToGlyphTable(glyphCount)) {
+        // Only characters outside of the Basic Multilingual Plane need the face.
+        SkTLazy<AutoFTAccess> fta;
+
+        SkUnichar unichars[256];
+        int first = glyphCount;
+        for (int i = 0; i < glyphCount; i += SK_ARRAY_COUNT(unichars)) {
+            int count = SkTMin(glyphCount - i, (int)SK_ARRAY_COUNT(unichars));
+            const SkUnichar* uni = unichars;
+            if (kUTF32_Encoding == encoding) {
+                uni = static_cast<const SkUnichar*>(chars) + i;
+            } else {
+                decode_chars(&chars, encoding, unichars, count);
+            }
+            for (int j = 0; j < count; ++j) {
+                unsigned id;
+                if (static_cast<uint32_t>(uni[j]) <= 0xFFFF) {
+                    id = table->lookup(uni[j]);
+                } else {
+                    if (!fta.isValid()) {
+                        fta.init(this);
+                    }
+                    id = fta.get()->face() ? FT_Get_Char_Index(fta.get()->face(), uni[j]) : 0;
+                }
+                if (glyphs) {
+                    glyphs[i + j] = SkToU16(id);
+                }
+                if (0 == id && first == glyphCount) {
+                    first = i + j;
+                    if (!glyphs) {
+                        return first;
+                    }
+                }
+            }
+        }
+        return first;
+    }
+
     AutoFTAccess fta(this);
     FT_Face face = fta.face();
     if (!face) {
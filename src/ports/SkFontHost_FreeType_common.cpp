@@ -13,6 +13,7 @@
 #include "SkFDot6.h"
 #include "SkFontHost_FreeType_common.h"
 #include "SkPath.h"
+#include "SkResourceCache.h"
 #include "SkTo.h"
 
 #include <utility>
@@ -367,12 +368,221 @@ inline SkColorType SkColorType_for_SkMaskFormat(SkMask::Format format) {
     }
 }
 
+// Scales unscaledBitmap, whose top left is at origin in FreeType's y up space, into glyph.
+void scale_bitmap_image(const SkGlyph& glyph, const SkBitmap& unscaledBitmap, SkIPoint origin,
+                        const SkMatrix& bitmapTransform)
+{
+    SkMask::Format maskFormat = static_cast<SkMask::Format>(glyph.fMaskFormat);
+
+    // Wrap the glyph's mask in a bitmap, unless the glyph's mask is BW or LCD.
+    // BW requires an A8 target for resizing, which can then be down sampled.
+    // LCD should use a 4x A8 target, which will then be down sampled.
+    // For simplicity, LCD uses A8 and is replicated.
+    int bitmapRowBytes = 0;
+    if (SkMask::kBW_Format != maskFormat && SkMask::kLCD16_Format != maskFormat) {
+        bitmapRowBytes = glyph.rowBytes();
+    }
+    SkBitmap dstBitmap;
+    // TODO: mark this as sRGB when the blits will be sRGB.
+    dstBitmap.setInfo(SkImageInfo::Make(glyph.fWidth, glyph.fHeight,
+                                        SkColorType_for_SkMaskFormat(maskFormat),
+                                        kPremul_SkAlphaType),
+                      bitmapRowBytes);
+    if (SkMask::kBW_Format == maskFormat || SkMask::kLCD16_Format == maskFormat) {
+        dstBitmap.allocPixels();
+    } else {
+        dstBitmap.setPixels(glyph.fImage);
+    }
+
+    // Scale unscaledBitmap into dstBitmap.
+    SkCanvas canvas(dstBitmap);
+#ifdef SK_SHOW_TEXT_BLIT_COVERAGE
+    canvas.clear(0x33FF0000);
+#else
+    canvas.clear(SK_ColorTRANSPARENT);
+#endif
+    canvas.translate(-glyph.fLeft, -glyph.fTop);
+    canvas.concat(bitmapTransform);
+    canvas.translate(origin.fX, -origin.fY);
+
+    SkPaint paint;
+    // Using kMedium FilterQuality will cause mipmaps to be generated. Use
+    // kLow when the results will be roughly the same in order to avoid
+    // the mipmap generation cost.
+    // See skbug.com/6967
+    if (bitmapTransform.getMinScale() < 0.5) {
+        paint.setFilterQuality(kMedium_SkFilterQuality);
+    } else {
+        paint.setFilterQuality(kLow_SkFilterQuality);
+    }
+    canvas.drawBitmap(unscaledBitmap, 0, 0, &paint);
+
+    // If the destination is BW or LCD, convert from A8.
+    if (SkMask::kBW_Format == maskFormat) {
+        // Copy the A8 dstBitmap into the A1 glyph.fImage.
+        SkMask dstMask;
+        glyph.toMask(&dstMask);
+        packA8ToA1(dstMask, dstBitmap.getAddr8(0, 0), dstBitmap.rowBytes());
+    } else if (SkMask::kLCD16_Format == maskFormat) {
+        // Copy the A8 dstBitmap into the LCD16 glyph.fImage.
+        uint8_t* src = dstBitmap.getAddr8(0, 0);
+        uint16_t* dst = reinterpret_cast<uint16_t*>(glyph.fImage);
+        for (int y = dstBitmap.height(); y --> 0;) {
+            for (int x = 0; x < dstBitmap.width(); ++x) {
+                dst[x] = grayToRGB16(src[x]);
+            }
+            dst = (uint16_t*)((char*)dst + glyph.rowBytes());
+            src += dstBitmap.rowBytes();
+        }
+    }
+}
+
+// We used to always do this pre-USE_COLOR_LUMINANCE, but with colorlum,
+// it is optional
+void apply_pre_blend(const SkGlyph& glyph, const SkMaskGamma::PreBlend& preBlend) {
+#if defined(SK_GAMMA_APPLY_TO_A8)
+    if (SkMask::kA8_Format == glyph.fMaskFormat && preBlend.isApplicable()) {
+        uint8_t* SK_RESTRICT dst = (uint8_t*)glyph.fImage;
+        unsigned rowBytes = glyph.rowBytes();
+
+        for (int y = glyph.fHeight - 1; y >= 0; --y) {
+            for (int x = glyph.fWidth - 1; x >= 0; --x) {
+                dst[x] = preBlend.fG[dst[x]];
+            }
+            dst += rowBytes;
+        }
+    }
+#endif
+}
+
+static unsigned gBitmapStrikeGlyphKeyNamespaceLabel;
+
+// Identifies the unscaled image of a glyph from one of a typeface's embedded bitmap strikes.
+struct BitmapStrikeGlyphKey : public SkResourceCache::Key {
+    BitmapStrikeGlyphKey(uint32_t fontID, int strikeIndex, uint32_t loadFlags, SkGlyphID glyphID,
+                         bool embolden)
+        : fFontID(fontID)
+        , fStrikeIndex(strikeIndex)
+        , fLoadFlags(loadFlags)
+        , fGlyph(glyphID | (embolden ? 1u << 16 : 0))
+    {
+        this->init(&gBitmapStrikeGlyphKeyNamespaceLabel,
+                   SkTypeface_FreeType::ResourceCacheSharedID(fontID),
+                   sizeof(fFontID) + sizeof(fStrikeIndex) + sizeof(fLoadFlags) + sizeof(fGlyph));
+    }
+
+    uint32_t fFontID;
+    int32_t  fStrikeIndex;
+    uint32_t fLoadFlags;
+    uint32_t fGlyph;
+};
+
+struct BitmapStrikeGlyph {
+    SkBitmap fBitmap;
+    SkIPoint fOrigin;  // The top left of fBitmap in FreeType's y up space.
+};
+
+// Decoding a color glyph (a PNG for CBDT and sbix) and copying it out of FreeType is done once per
+// strike glyph instead of once per requested size. The cached bitmap also keeps its generation
+// ID, so the mipmaps built to downscale it are found in the SkMipMapCache for every other size.
+struct BitmapStrikeGlyphRec : public SkResourceCache::Rec {
+    BitmapStrikeGlyphRec(const BitmapStrikeGlyphKey& key, const SkBitmap& bitmap, SkIPoint origin)
+        : fKey(key)
+        , fValue{bitmap, origin}
+    {}
+
+    BitmapStrikeGlyphKey fKey;
+    BitmapStrikeGlyph    fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fBitmap.computeByteSize(); }
+    const char* getCategory() const override { return "bitmap-strike-glyph"; }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const BitmapStrikeGlyphRec& rec = static_cast<const BitmapStrikeGlyphRec&>(baseRec);
+        *static_cast<BitmapStrikeGlyph*>(contextData) = rec.fValue;
+        return true;
+    }
+};
+
+static unsigned gUnscaledGlyphPathKeyNamespaceLabel;
+
+struct UnscaledGlyphPathKey : public SkResourceCache::Key {
+    UnscaledGlyphPathKey(uint32_t fontID, SkGlyphID glyphID)
+        : fFontID(fontID)
+        , fGlyphID(glyphID)
+    {
+        this->init(&gUnscaledGlyphPathKeyNamespaceLabel,
+                   SkTypeface_FreeType::ResourceCacheSharedID(fontID),
+                   sizeof(fFontID) + sizeof(fGlyphID));
+    }
+
+    uint32_t fFontID;
+    uint32_t fGlyphID;
+};
+
+// Loading and decomposing an outline is done once per typeface glyph instead of once per strike.
+// The cached path's points are shared by every copy until they are transformed.
+struct UnscaledGlyphPathRec : public SkResourceCache::Rec {
+    UnscaledGlyphPathRec(const UnscaledGlyphPathKey& key, const SkPath& path)
+        : fKey(key)
+        , fPath(path)
+    {}
+
+    UnscaledGlyphPathKey fKey;
+    SkPath               fPath;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fPath.countPoints() * sizeof(SkPoint) + fPath.countVerbs();
+    }
+    const char* getCategory() const override { return "glyph-path"; }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const UnscaledGlyphPathRec& rec = static_cast<const UnscaledGlyphPathRec&>(baseRec);
+        *static_cast<SkPath*>(contextData) = rec.fPath;
+        return true;
+    }
+};
+
 }  // namespace
 
+void SkScalerContext_FreeType_Base::markAddedToResourceCache() {
+    static_cast<SkTypeface_FreeType*>(this->getTypeface())->fAddedToResourceCache.store(true);
+}
+
+bool SkScalerContext_FreeType_Base::findUnscaledGlyphPath(SkGlyphID glyphID, SkPath* path) const {
+    return SkResourceCache::Find(UnscaledGlyphPathKey(fRec.fFontID, glyphID),
+                                 UnscaledGlyphPathRec::Finder, path);
+}
+
+void SkScalerContext_FreeType_Base::addUnscaledGlyphPath(SkGlyphID glyphID, const SkPath& path) {
+    this->markAddedToResourceCache();
+    SkResourceCache::Add(new UnscaledGlyphPathRec(UnscaledGlyphPathKey(fRec.fFontID, glyphID),
+                                                  path));
+}
+
+bool SkScalerContext_FreeType_Base::generateCachedBitmapImage(int strikeIndex, uint32_t loadFlags,
+                                                              const SkGlyph& glyph,
+                                                              const SkMatrix& bitmapTransform)
+{
+    BitmapStrikeGlyphKey key(fRec.fFontID, strikeIndex, loadFlags, glyph.getGlyphID(),
+                             SkToBool(fRec.fFlags & SkScalerContext::kEmbolden_Flag));
+    BitmapStrikeGlyph found;
+    if (!SkResourceCache::Find(key, BitmapStrikeGlyphRec::Finder, &found)) {
+        return false;
+    }
+    scale_bitmap_image(glyph, found.fBitmap, found.fOrigin, bitmapTransform);
+    apply_pre_blend(glyph, fPreBlend);
+    return true;
+}
+
 void SkScalerContext_FreeType_Base::generateGlyphImage(
     FT_Face face,
     const SkGlyph& glyph,
-    const SkMatrix& bitmapTransform)
+    const SkMatrix& bitmapTransform,
+    int strikeIndex,
+    uint32_t loadFlags)
 {
     const bool doBGR = SkToBool(fRec.fFlags & SkScalerContext::kLCD_BGROrder_Flag);
     const bool doVert = SkToBool(fRec.fFlags & SkScalerContext::kLCD_Vertical_Flag);
@@ -602,68 +812,17 @@ void SkScalerContext_FreeType_Base::generateGlyphImage(
             unscaledBitmapAlias.fFormat = SkMaskFormat_for_SkColorType(unscaledBitmap.colorType());
             copyFTBitmap(face->glyph->bitmap, unscaledBitmapAlias);
 
-            // Wrap the glyph's mask in a bitmap, unless the glyph's mask is BW or LCD.
-            // BW requires an A8 target for resizing, which can then be down sampled.
-            // LCD should use a 4x A8 target, which will then be down sampled.
-            // For simplicity, LCD uses A8 and is replicated.
-            int bitmapRowBytes = 0;
-            if (SkMask::kBW_Format != maskFormat && SkMask::kLCD16_Format != maskFormat) {
-                bitmapRowBytes = glyph.rowBytes();
-            }
-            SkBitmap dstBitmap;
-            // TODO: mark this as sRGB when the blits will be sRGB.
-            dstBitmap.setInfo(SkImageInfo::Make(glyph.fWidth, glyph.fHeight,
-                                                SkColorType_for_SkMaskFormat(maskFormat),
-                                                kPremul_SkAlphaType),
-                              bitmapRowBytes);
-            if (SkMask::kBW_Format == maskFormat || SkMask::kLCD16_Format == maskFormat) {
-                dstBitmap.allocPixels();
-            } else {
-                dstBitmap.setPixels(glyph.fImage);
-            }
-
-            // Scale unscaledBitmap into dstBitmap.
-            SkCanvas canvas(dstBitmap);
-#ifdef SK_SHOW_TEXT_BLIT_COVERAGE
-            canvas.clear(0x33FF0000);
-#else
-            canvas.clear(SK_ColorTRANSPARENT);
-#endif
-            canvas.translate(-glyph.fLeft, -glyph.fTop);
-            canvas.concat(bitmapTransform);
-            canvas.translate(face->glyph->bitmap_left, -face->glyph->bitmap_top);
-
-            SkPaint paint;
-            // Using kMedium FilterQuality will cause mipmaps to be generated. Use
-            // kLow when the results will be roughly the same in order to avoid
-            // the mipmap generation cost.
-            // See skbug.com/6967
-            if (bitmapTransform.getMinScale() < 0.5) {
-                paint.setFilterQuality(kMedium_SkFilterQuality);
-            } else {
-                paint.setFilterQuality(kLow_SkFilterQuality);
-            }
-            canvas.drawBitmap(unscaledBitmap, 0, 0, &paint);
-
-            // If the destination is BW or LCD, convert from A8.
-            if (SkMask::kBW_Format == maskFormat) {
-                // Copy the A8 dstBitmap into the A1 glyph.fImage.
-                SkMask dstMask;
-                glyph.toMask(&dstMask);
-                packA8ToA1(dstMask, dstBitmap.getAddr8(0, 0), dstBitmap.rowBytes());
-            } else if (SkMask::kLCD16_Format == maskFormat) {
-                // Copy the A8 dstBitmap into the LCD16 glyph.fImage.
-                uint8_t* src = dstBitmap.getAddr8(0, 0);
-                uint16_t* dst = reinterpret_cast<uint16_t*>(glyph.fImage);
-                for (int y = dstBitmap.height(); y --> 0;) {
-                    for (int x = 0; x < dstBitmap.width(); ++x) {
-                        dst[x] = grayToRGB16(src[x]);
-                    }
-                    dst = (uint16_t*)((char*)dst + glyph.rowBytes());
-                    src += dstBitmap.rowBytes();
-                }
+            SkIPoint origin = {face->glyph->bitmap_left, face->glyph->bitmap_top};
+            if (strikeIndex >= 0) {
+                unscaledBitmap.setImmutable();
+                this->markAddedToResourceCache();
+                SkResourceCache::Add(new BitmapStrikeGlyphRec(
+                        BitmapStrikeGlyphKey(fRec.fFontID, strikeIndex, loadFlags,
+                                             glyph.getGlyphID(),
+                                             SkToBool(fRec.fFlags & SkScalerContext::kEmbolden_Flag)),
+                        unscaledBitmap, origin));
             }
-
+            scale_bitmap_image(glyph, unscaledBitmap, origin, bitmapTransform);
         } break;
 
         default:
@@ -672,21 +831,7 @@ void SkScalerContext_FreeType_Base::generateGlyphImage(
             return;
     }
 
-// We used to always do this pre-USE_COLOR_LUMINANCE, but with colorlum,
-// it is optional
-#if defined(SK_GAMMA_APPLY_TO_A8)
-    if (SkMask::kA8_Format == glyph.fMaskFormat && fPreBlend.isApplicable()) {
-        uint8_t* SK_RESTRICT dst = (uint8_t*)glyph.fImage;
-        unsigned rowBytes = glyph.rowBytes();
-
-        for (int y = glyph.fHeight - 1; y >= 0; --y) {
-            for (int x = glyph.fWidth - 1; x >= 0; --x) {
-                dst[x] = fPreBlend.fG[dst[x]];
-            }
-            dst += rowBytes;
-        }
-    }
-#endif
+    apply_pre_blend(glyph, fPreBlend);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -11,12 +11,16 @@
 
 #include "SkGlyph.h"
 #include "SkMutex.h"
+#include "SkOnce.h"
 #include "SkScalerContext.h"
 #include "SkTypeface.h"
 #include "SkTypes.h"
 
 #include "SkFontMgr.h"
 
+#include <atomic>
+#include <memory>
+
 // These are forward declared to avoid pimpl but also hide the FreeType implementation.
 typedef struct FT_LibraryRec_* FT_Library;
 typedef struct FT_FaceRec_* FT_Face;
@@ -45,10 +49,28 @@ protected:
         : INHERITED(std::move(typeface), effects, desc)
     {}
 
-    void generateGlyphImage(FT_Face face, const SkGlyph& glyph, const SkMatrix& bitmapTransform);
+    /** If strikeIndex is not -1 the face's glyph was loaded with loadFlags from that embedded
+     *  bitmap strike, and a scaled bitmap glyph's unscaled image is cached for
+     *  generateCachedBitmapImage.
+     */
+    void generateGlyphImage(FT_Face face, const SkGlyph& glyph, const SkMatrix& bitmapTransform,
+                            int strikeIndex = -1, uint32_t loadFlags = 0);
+    /** Scales the cached unscaled image of a bitmap strike glyph into glyph, without loading it.
+     *  Returns false if the image is not cached.
+     */
+    bool generateCachedBitmapImage(int strikeIndex, uint32_t loadFlags, const SkGlyph& glyph,
+                                   const SkMatrix& bitmapTransform);
     bool generateGlyphPath(FT_Face face, SkPath* path);
     bool generateFacePath(FT_Face face, SkGlyphID glyphID, SkPath* path);
+
+    /** The typeface's outlines in font units, divided by 64 like generateGlyphPath's 26.6
+     *  coordinates, are cached for every scaler context which only needs to transform them.
+     */
+    bool findUnscaledGlyphPath(SkGlyphID glyphID, SkPath* path) const;
+    void addUnscaledGlyphPath(SkGlyphID glyphID, const SkPath& path);
 private:
+    void markAddedToResourceCache();
+
     typedef SkScalerContext INHERITED;
 };
 
@@ -85,10 +107,14 @@ public:
         mutable SkMutex fLibraryMutex;
     };
 
+    /** Groups the SkResourceCache entries made by a typeface's scaler contexts, which are
+     *  purged with the typeface.
+     */
+    static uint64_t ResourceCacheSharedID(SkFontID uniqueID);
+
 protected:
-    SkTypeface_FreeType(const SkFontStyle& style, bool isFixedPitch)
-        : INHERITED(style, isFixedPitch)
-    {}
+    SkTypeface_FreeType(const SkFontStyle& style, bool isFixedPitch);
+    ~SkTypeface_FreeType() override;
 
     std::unique_ptr<SkFontData> cloneFontData(const SkFontArguments&) const;
     virtual SkScalerContext* onCreateScalerContext(const SkScalerContextEffects&,
@@ -115,6 +141,19 @@ protected:
                           size_t length, void* data) const override;
 
 private:
+    friend class SkScalerContext_FreeType_Base;
+
+    class CharToGlyphTable;
+    const CharToGlyphTable* charToGlyphTable(int charCount) const;
+
+    // Built from the cmap once enough characters have been mapped with this typeface.
+    mutable std::atomic<int> fCharsMapped{0};
+    mutable SkOnce fCharToGlyphOnce;
+    mutable std::unique_ptr<CharToGlyphTable> fCharToGlyph;
+
+    // Set once a scaler context has put any of the typeface's glyphs in the SkResourceCache.
+    mutable std::atomic<bool> fAddedToResourceCache{false};
+
     typedef SkTypeface INHERITED;
 };
 
@@ -7,6 +7,7 @@
 
 #include "SkFontArguments.h"
 #include "SkFontDescriptor.h"
+#include "SkFontFileCache.h"
 #include "SkFontHost_FreeType_common.h"
 #include "SkFontMgr.h"
 #include "SkFontMgr_custom.h"
@@ -94,7 +95,7 @@ SkTypeface_File::SkTypeface_File(const SkFontStyle& style, bool isFixedPitch, bo
 
 SkStreamAsset* SkTypeface_File::onOpenStream(int* ttcIndex) const {
     *ttcIndex = this->getIndex();
-    return SkStream::MakeFromFile(fPath.c_str()).release();
+    return SkFontFileCache::OpenStream(fPath.c_str()).release();
 }
 
 sk_sp<SkTypeface> SkTypeface_File::onMakeClone(const SkFontArguments& args) const {
@@ -10,18 +10,251 @@
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkStream.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+#include "SkTaskGroup.h"
+
+#include <stdio.h>
+
+namespace {
+
+struct ScannedFace {
+    SkString    fName;
+    SkFontStyle fStyle;
+    bool        fIsFixedPitch = false;
+    bool        fValid = false;  // False if FreeType could not read this face.
+};
+
+// The result of scanning a font file. Files which are not fonts have no faces.
+struct ScannedFile {
+    SkString                 fPath;
+    size_t                   fSize = 0;
+    int64_t                  fModTime = 0;
+    bool                     fScanned = false;  // True once fFaces reflects the file's contents.
+    SkTArray<ScannedFace>    fFaces;
+};
+
+// The scan cache is a list of ScannedFiles. A cached file is only reused if its size and
+// modification time are unchanged.
+static constexpr uint32_t kScanCacheMagic = SkSetFourByteTag('s', 'k', 'f', 's');
+static constexpr uint32_t kScanCacheVersion = 1;
+
+// Each scan task uses its own Scanner, so this is also the number of FT_Libraries in use.
+static constexpr int kMaxScanTasks = 8;
+
+}  // namespace
+
+static bool SK_WARN_UNUSED_RESULT read_string(SkStreamAsset* stream, SkString* string) {
+    size_t length;
+    if (!stream->readPackedUInt(&length) || length > stream->getLength()) { return false; }
+    string->resize(length);
+    return length == 0 || stream->read(string->writable_str(), length) == length;
+}
+
+static bool write_string(SkWStream* stream, const SkString& string) {
+    return stream->writePackedUInt(string.size()) && stream->write(string.c_str(), string.size());
+}
+
+static bool SK_WARN_UNUSED_RESULT read_scanned_file(SkStreamAsset* stream, ScannedFile* file) {
+    size_t size, faceCount;
+    uint32_t modTimeLo, modTimeHi;
+    if (!read_string(stream, &file->fPath) ||
+        !stream->readPackedUInt(&size) ||
+        !stream->readU32(&modTimeLo) ||
+        !stream->readU32(&modTimeHi) ||
+        !stream->readPackedUInt(&faceCount) ||
+        faceCount > stream->getLength())
+    {
+        return false;
+    }
+    file->fSize = size;
+    file->fModTime = static_cast<int64_t>((static_cast<uint64_t>(modTimeHi) << 32) | modTimeLo);
+    for (size_t i = 0; i < faceCount; ++i) {
+        ScannedFace& face = file->fFaces.push_back();
+        size_t styleBits;
+        if (!read_string(stream, &face.fName) ||
+            !stream->readPackedUInt(&styleBits) ||
+            !stream->readBool(&face.fIsFixedPitch) ||
+            !stream->readBool(&face.fValid))
+        {
+            return false;
+        }
+        face.fStyle = SkFontStyle((styleBits >> 16) & 0xFFFF,
+                                  (styleBits >> 8 ) & 0xFF,
+                                  static_cast<SkFontStyle::Slant>(styleBits & 0xFF));
+    }
+    file->fScanned = true;
+    return true;
+}
+
+static bool write_scanned_file(SkWStream* stream, const ScannedFile& file) {
+    uint64_t modTime = static_cast<uint64_t>(file.fModTime);
+    if (!write_string(stream, file.fPath) ||
+        !stream->writePackedUInt(file.fSize) ||
+        !stream->write32(static_cast<uint32_t>(modTime)) ||
+        !stream->write32(static_cast<uint32_t>(modTime >> 32)) ||
+        !stream->writePackedUInt(file.fFaces.count()))
+    {
+        return false;
+    }
+    for (const ScannedFace& face : file.fFaces) {
+        size_t styleBits = (face.fStyle.weight() << 16) | (face.fStyle.width() << 8) |
+                           face.fStyle.slant();
+        if (!write_string(stream, face.fName) ||
+            !stream->writePackedUInt(styleBits) ||
+            !stream->writeBool(face.fIsFixedPitch) ||
+            !stream->writeBool(face.fValid))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the number of files read. A cache which can't be read is treated as empty.
+static int read_scan_cache(const char* path, SkTHashMap<SkString, ScannedFile>* cache) {
+    std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(path);
+    if (!stream) {
+        return 0;
+    }
+    uint32_t magic, version;
+    size_t count;
+    if (!stream->readU32(&magic) || magic != kScanCacheMagic ||
+        !stream->readU32(&version) || version != kScanCacheVersion ||
+        !stream->readPackedUInt(&count))
+    {
+        return 0;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        ScannedFile file;
+        if (!read_scanned_file(stream.get(), &file)) {
+            SkDebugf("---- font scan cache <%s> is corrupt\n", path);
+            cache->reset();
+            return 0;
+        }
+        SkString filePath = file.fPath;
+        cache->set(std::move(filePath), std::move(file));
+    }
+    return cache->count();
+}
+
+// Writes to a temporary file first so that a partially written cache is never read.
+static void write_scan_cache(const char* path, const SkTArray<ScannedFile>& files) {
+    SkString tempPath = SkStringPrintf("%s.tmp", path);
+    {
+        SkFILEWStream stream(tempPath.c_str());
+        if (!stream.isValid()) {
+            return;
+        }
+        int count = 0;
+        for (const ScannedFile& file : files) {
+            count += file.fScanned;
+        }
+        bool success = stream.write32(kScanCacheMagic) &&
+                       stream.write32(kScanCacheVersion) &&
+                       stream.writePackedUInt(count);
+        for (int i = 0; success && i < files.count(); ++i) {
+            if (files[i].fScanned) {
+                success = write_scanned_file(&stream, files[i]);
+            }
+        }
+        if (!success) {
+            SkDebugf("---- failed to write font scan cache <%s>\n", tempPath.c_str());
+            return;
+        }
+        stream.fsync();
+    }
+    if (0 != rename(tempPath.c_str(), path)) {
+        SkDebugf("---- failed to write font scan cache <%s>\n", path);
+        remove(tempPath.c_str());
+    }
+}
+
+static void scan_file(const SkTypeface_FreeType::Scanner& scanner, ScannedFile* file) {
+    const char* filename = file->fPath.c_str();
+    std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(filename);
+    if (!stream) {
+        SkDebugf("---- failed to open <%s>\n", filename);
+        return;
+    }
+    file->fScanned = true;
+
+    int numFaces;
+    if (!scanner.recognizedFont(stream.get(), &numFaces)) {
+        SkDebugf("---- failed to open <%s> as a font\n", filename);
+        return;
+    }
+
+    for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
+        ScannedFace& face = file->fFaces.push_back();
+        face.fValid = scanner.scanFont(stream.get(), faceIndex, &face.fName, &face.fStyle,
+                                       &face.fIsFixedPitch, nullptr);
+        if (!face.fValid) {
+            SkDebugf("---- failed to open <%s> <%d> as a font\n", filename, faceIndex);
+        }
+    }
+}
 
 class DirectorySystemFontLoader : public SkFontMgr_Custom::SystemFontLoader {
 public:
-    DirectorySystemFontLoader(const char* dir) : fBaseDirectory(dir) { }
+    DirectorySystemFontLoader(const char* dir, const char* scanCachePath)
+        : fBaseDirectory(dir), fScanCachePath(scanCachePath) { }
 
     void loadSystemFonts(const SkTypeface_FreeType::Scanner& scanner,
                          SkFontMgr_Custom::Families* families) const override
     {
-        load_directory_fonts(scanner, fBaseDirectory, ".ttf", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".ttc", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".otf", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".pfb", families);
+        SkTArray<ScannedFile> files;
+        find_directory_fonts(fBaseDirectory, ".ttf", &files);
+        find_directory_fonts(fBaseDirectory, ".ttc", &files);
+        find_directory_fonts(fBaseDirectory, ".otf", &files);
+        find_directory_fonts(fBaseDirectory, ".pfb", &files);
+
+        SkTHashMap<SkString, ScannedFile> cache;
+        int cachedCount = 0;
+        if (!fScanCachePath.isEmpty()) {
+            cachedCount = read_scan_cache(fScanCachePath.c_str(), &cache);
+        }
+
+        SkTArray<ScannedFile*> misses;
+        int hits = 0;
+        for (ScannedFile& file : files) {
+            ScannedFile* cached = cache.find(file.fPath);
+            if (cached && cached->fSize == file.fSize && cached->fModTime == file.fModTime) {
+                file.fFaces = std::move(cached->fFaces);
+                file.fScanned = true;
+                ++hits;
+            } else {
+                misses.push_back(&file);
+            }
+        }
+
+        scan_files(scanner, misses);
+
+        // Files which could not be opened are left out of the cache, so they don't change it.
+        bool scannedMiss = false;
+        for (const ScannedFile* file : misses) {
+            scannedMiss |= file->fScanned;
+        }
+        if (!fScanCachePath.isEmpty() && (scannedMiss || hits != cachedCount)) {
+            write_scan_cache(fScanCachePath.c_str(), files);
+        }
+
+        for (const ScannedFile& file : files) {
+            for (int faceIndex = 0; faceIndex < file.fFaces.count(); ++faceIndex) {
+                const ScannedFace& face = file.fFaces[faceIndex];
+                if (!face.fValid) {
+                    continue;
+                }
+                SkFontStyleSet_Custom* addTo = find_family(*families, face.fName.c_str());
+                if (nullptr == addTo) {
+                    addTo = new SkFontStyleSet_Custom(face.fName);
+                    families->push_back().reset(addTo);
+                }
+                addTo->appendTypeface(sk_make_sp<SkTypeface_File>(face.fStyle, face.fIsFixedPitch,
+                                                                  true, face.fName,
+                                                                  file.fPath.c_str(), faceIndex));
+            }
+        }
 
         if (families->empty()) {
             SkFontStyleSet_Custom* family = new SkFontStyleSet_Custom(SkString());
@@ -42,48 +275,26 @@ private:
         return nullptr;
     }
 
-    static void load_directory_fonts(const SkTypeface_FreeType::Scanner& scanner,
-                                     const SkString& directory, const char* suffix,
-                                     SkFontMgr_Custom::Families* families)
+    static void find_directory_fonts(const SkString& directory, const char* suffix,
+                                     SkTArray<ScannedFile>* files)
     {
         SkOSFile::Iter iter(directory.c_str(), suffix);
         SkString name;
 
         while (iter.next(&name, false)) {
-            SkString filename(SkOSPath::Join(directory.c_str(), name.c_str()));
-            std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(filename.c_str());
-            if (!stream) {
-                SkDebugf("---- failed to open <%s>\n", filename.c_str());
-                continue;
-            }
-
-            int numFaces;
-            if (!scanner.recognizedFont(stream.get(), &numFaces)) {
-                SkDebugf("---- failed to open <%s> as a font\n", filename.c_str());
+            // A file which can't be statted can't be checked against the cache. It would be
+            // rescanned on every startup, and is almost certainly unreadable anyway, so skip it.
+            SkString path = SkOSPath::Join(directory.c_str(), name.c_str());
+            size_t size;
+            int64_t modTime;
+            if (!sk_stat(path.c_str(), &size, &modTime)) {
+                SkDebugf("---- failed to stat <%s>\n", path.c_str());
                 continue;
             }
-
-            for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
-                bool isFixedPitch;
-                SkString realname;
-                SkFontStyle style = SkFontStyle(); // avoid uninitialized warning
-                if (!scanner.scanFont(stream.get(), faceIndex,
-                                      &realname, &style, &isFixedPitch, nullptr))
-                {
-                    SkDebugf("---- failed to open <%s> <%d> as a font\n",
-                             filename.c_str(), faceIndex);
-                    continue;
-                }
-
-                SkFontStyleSet_Custom* addTo = find_family(*families, realname.c_str());
-                if (nullptr == addTo) {
-                    addTo = new SkFontStyleSet_Custom(realname);
-                    families->push_back().reset(addTo);
-                }
-                addTo->appendTypeface(sk_make_sp<SkTypeface_File>(style, isFixedPitch, true,
-                                                                  realname, filename.c_str(),
-                                                                  faceIndex));
-            }
+            ScannedFile& file = files->push_back();
+            file.fPath = std::move(path);
+            file.fSize = size;
+            file.fModTime = modTime;
         }
 
         SkOSFile::Iter dirIter(directory.c_str());
@@ -92,13 +303,41 @@ private:
                 continue;
             }
             SkString dirname(SkOSPath::Join(directory.c_str(), name.c_str()));
-            load_directory_fonts(scanner, dirname, suffix, families);
+            find_directory_fonts(dirname, suffix, files);
+        }
+    }
+
+    // Scanning opens every face with FreeType, which is slow, so the files are split between
+    // tasks when there is an executor to run them. The Scanner locks its library, so each task
+    // has its own. Without an executor the tasks would run one after another, so the files are
+    // scanned serially with the caller's Scanner instead.
+    static void scan_files(const SkTypeface_FreeType::Scanner& scanner,
+                           const SkTArray<ScannedFile*>& files)
+    {
+        int taskCount = SkTMin(files.count(), kMaxScanTasks);
+        if (taskCount <= 1 || !SkTaskGroup::HasDefaultExecutor()) {
+            for (ScannedFile* file : files) {
+                scan_file(scanner, file);
+            }
+            return;
         }
+        SkTaskGroup().batch(taskCount, [&](int task) {
+            SkTypeface_FreeType::Scanner taskScanner;
+            for (int i = task; i < files.count(); i += taskCount) {
+                scan_file(taskScanner, files[i]);
+            }
+        });
     }
 
     SkString fBaseDirectory;
+    SkString fScanCachePath;
 };
 
 SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir) {
-    return sk_make_sp<SkFontMgr_Custom>(DirectorySystemFontLoader(dir));
+    return SkFontMgr_New_Custom_Directory(dir, nullptr);
+}
+
+SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir,
+                                                       const char* scanCachePath) {
+    return sk_make_sp<SkFontMgr_Custom>(DirectorySystemFontLoader(dir, scanCachePath));
 }
@@ -12,6 +12,11 @@
 #    define SK_FONT_FILE_PREFIX "/usr/share/fonts/"
 #endif
 
+// Where to keep the results of scanning the font directory. By default there is no cache.
+#ifndef SK_FONT_SCAN_CACHE_PATH
+#    define SK_FONT_SCAN_CACHE_PATH nullptr
+#endif
+
 sk_sp<SkFontMgr> SkFontMgr::Factory() {
-    return SkFontMgr_New_Custom_Directory(SK_FONT_FILE_PREFIX);
+    return SkFontMgr_New_Custom_Directory(SK_FONT_FILE_PREFIX, SK_FONT_SCAN_CACHE_PATH);
 }
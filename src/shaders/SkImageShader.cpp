@@ -276,8 +276,15 @@ bool SkImageShader::onAppendStages(const StageRec& rec) const {
     }
     auto quality = rec.fPaint.getFilterQuality();
 
+    // Anisotropic sampling is only implemented by the fused 8888 clamp/clamp stage.
+    bool allowAnisotropic = (fImage->colorType() == kRGBA_8888_SkColorType ||
+                             fImage->colorType() == kBGRA_8888_SkColorType)
+                         && fTileModeX == SkShader::kClamp_TileMode
+                         && fTileModeY == SkShader::kClamp_TileMode;
+
     SkBitmapProvider provider(fImage.get());
-    const auto* state = SkBitmapController::RequestBitmap(provider, matrix, quality, alloc);
+    const auto* state = SkBitmapController::RequestBitmap(provider, matrix, quality, alloc,
+                                                          allowAnisotropic);
     if (!state) {
         return false;
     }
@@ -286,6 +293,9 @@ bool SkImageShader::onAppendStages(const StageRec& rec) const {
     matrix  = state->invMatrix();
     quality = state->quality();
     auto info = pm.info();
+    const int anisotropicTaps = (info.colorType() == kRGBA_8888_SkColorType ||
+                                 info.colorType() == kBGRA_8888_SkColorType)
+                              ? state->anisotropicTaps() : 0;
 
     // When the matrix is just an integer translate, bilerp == nearest neighbor.
     if (quality == kLow_SkFilterQuality &&
@@ -314,7 +324,10 @@ bool SkImageShader::onAppendStages(const StageRec& rec) const {
     };
     auto misc = alloc->make<MiscCtx>();
     swizzle_rb(Sk4f_fromL32(rec.fPaint.getColor())).store(misc->paint_color.vec());  // sRGBA floats
-    p->append_matrix(alloc, matrix);
+    // The anisotropic stage maps through the matrix itself, to measure each pixel's footprint.
+    if (!anisotropicTaps) {
+        p->append_matrix(alloc, matrix);
+    }
 
     auto gather = alloc->make<SkJumper_GatherCtx>();
     gather->pixels = pm.addr();
@@ -414,8 +427,22 @@ bool SkImageShader::onAppendStages(const StageRec& rec) const {
         return true;
     };
 
-    // We've got a fast path for 8888 bilinear clamp/clamp sampling.
     auto ct = info.colorType();
+    if (anisotropicTaps) {
+        auto aniso = alloc->make<SkJumper_AnisoCtx>();
+        aniso->gather  = *gather;
+        matrix.get9(aniso->matrix);
+        aniso->taps    = anisotropicTaps;
+        aniso->invTaps = 1.0f / anisotropicTaps;
+
+        p->append(SkRasterPipeline::aniso_clamp_8888, aniso);
+        if (ct == kBGRA_8888_SkColorType) {
+            p->append(SkRasterPipeline::swap_rb);
+        }
+        return append_misc();
+    }
+
+    // We've got a fast path for 8888 bilinear clamp/clamp sampling.
     if (true
         && (ct == kRGBA_8888_SkColorType || ct == kBGRA_8888_SkColorType)
         && quality == kLow_SkFilterQuality
@@ -230,6 +230,25 @@ static void add_stop_color(SkJumper_GradientCtx* ctx, size_t stop, SkPM4f Fs, Sk
     (ctx->bs[3])[stop] = Bs.a();
 }
 
+// Gradients with at least this many stops at arbitrary positions are baked into a table for raster
+// pipelines, which costs the same to sample no matter how many stops there are. Below this the
+// gradient stage's search is as fast as the table. Evenly spaced stops don't need one, since the
+// evenly_spaced_gradient stage finds their stop directly.
+static constexpr int kMinRasterPipelineLUTStops = 64;
+static constexpr int kRasterPipelineLUTSize = 1024;
+
+// The table blurs a hard stop over the distance between two entries, and in clamp mode t beyond a
+// hard stop at 0 or 1 takes the color on the far side, which the table doesn't hold. Gradients
+// with any hard stop keep using the gradient stage.
+static bool has_hard_stop(const SkScalar pos[], const SkColor4f colors[], int count) {
+    for (int i = 1; i < count; ++i) {
+        if (pos[i - 1] == pos[i] && colors[i - 1] != colors[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static void add_const_color(SkJumper_GradientCtx* ctx, size_t stop, SkPM4f color) {
     add_stop_color(ctx, stop, SkPM4f::FromPremulRGBA(0,0,0,0), color);
 }
@@ -334,6 +353,18 @@ bool SkGradientShaderBase::onAppendStages(const StageRec& rec) const {
         f_and_b[1] = c_l;
 
         p->append(SkRasterPipeline::evenly_spaced_2_stop_gradient, f_and_b);
+    } else if (fOrigPos && fColorCount >= kMinRasterPipelineLUTStops &&
+               !has_hard_stop(fOrigPos, fOrigColors4f, fColorCount)) {
+        // The table is clamped as it is sampled, so it handles unclamped t like the gradient stage.
+        auto* lut = alloc->make<SkBitmap>();
+        this->getRasterPipelineLUT(xformedColors.fColors, lut);
+
+        auto* ctx = alloc->make<SkJumper_GatherCtx>();
+        ctx->pixels = lut->getPixels();
+        ctx->stride = lut->width();
+        ctx->width  = lut->width();
+        ctx->height = 1;
+        p->append(SkRasterPipeline::gradient_lut, ctx);
     } else {
         auto* ctx = alloc->make<SkJumper_GradientCtx>();
 
@@ -547,17 +578,10 @@ void SkGradientShaderBase::initLinearBitmap(const SkColor4f* colors, SkBitmap* b
     SkASSERT(prevIndex == kGradientTextureSize - 1);
 }
 
-SK_DECLARE_STATIC_MUTEX(gGradientCacheMutex);
-/*
- *  Because our caller might rebuild the same (logically the same) gradient
- *  over and over, we'd like to return exactly the same "bitmap" if possible,
- *  allowing the client to utilize a cache of our bitmap (e.g. with a GPU).
- *  To do that, we maintain a private cache of built-bitmaps, based on our
- *  colors and positions.
- */
-void SkGradientShaderBase::getGradientTableBitmap(const SkColor4f* colors, SkBitmap* bitmap,
-                                                  SkColorType colorType) const {
-    // build our key: [numColors + colors[] + {positions[]} + flags + colorType ]
+// Builds the key for a gradient's cached tables:
+// [numColors + colors[] + {positions[]} + flags + tableType]
+int SkGradientShaderBase::makeTableKey(const SkColor4f* colors, int32_t tableType,
+                                       SkAutoSTMalloc<64, int32_t>* storage) const {
     static_assert(sizeof(SkColor4f) % sizeof(int32_t) == 0, "");
     const int colorsAsIntCount = fColorCount * sizeof(SkColor4f) / sizeof(int32_t);
     int count = 1 + colorsAsIntCount + 1 + 1;
@@ -565,8 +589,7 @@ void SkGradientShaderBase::getGradientTableBitmap(const SkColor4f* colors, SkBit
         count += fColorCount - 1;
     }
 
-    SkAutoSTMalloc<64, int32_t> storage(count);
-    int32_t* buffer = storage.get();
+    int32_t* buffer = storage->reset(count);
 
     *buffer++ = fColorCount;
     memcpy(buffer, colors, fColorCount * sizeof(SkColor4f));
@@ -577,8 +600,23 @@ void SkGradientShaderBase::getGradientTableBitmap(const SkColor4f* colors, SkBit
         }
     }
     *buffer++ = fGradFlags;
-    *buffer++ = static_cast<int32_t>(colorType);
-    SkASSERT(buffer - storage.get() == count);
+    *buffer++ = tableType;
+    SkASSERT(buffer - storage->get() == count);
+    return count;
+}
+
+SK_DECLARE_STATIC_MUTEX(gGradientCacheMutex);
+/*
+ *  Because our caller might rebuild the same (logically the same) gradient
+ *  over and over, we'd like to return exactly the same "bitmap" if possible,
+ *  allowing the client to utilize a cache of our bitmap (e.g. with a GPU).
+ *  To do that, we maintain a private cache of built-bitmaps, based on our
+ *  colors and positions.
+ */
+void SkGradientShaderBase::getGradientTableBitmap(const SkColor4f* colors, SkBitmap* bitmap,
+                                                  SkColorType colorType) const {
+    SkAutoSTMalloc<64, int32_t> storage;
+    int count = this->makeTableKey(colors, static_cast<int32_t>(colorType), &storage);
 
     ///////////////////////////////////
 
@@ -602,6 +640,60 @@ void SkGradientShaderBase::getGradientTableBitmap(const SkColor4f* colors, SkBit
     }
 }
 
+// Evaluates the gradient at each of the table's entries, with the same stop semantics as the
+// gradient stage: at a hard stop, t takes the color after it.
+void SkGradientShaderBase::initRasterPipelineLUT(const SkColor4f* colors, SkBitmap* bitmap) const {
+    const bool premulGrad = fGradFlags & SkGradientShader::kInterpolateColorsInPremul_Flag;
+    auto prepareColor = [premulGrad, colors](int i) {
+        Sk4f c = Sk4f::Load(colors[i].vec());
+        return premulGrad ? c * Sk4f(c[3], c[3], c[3], 1.0f) : c;
+    };
+
+    float* lut = static_cast<float*>(bitmap->getPixels());
+    int stop = 0;
+    for (int i = 0; i < kRasterPipelineLUTSize; i++) {
+        const float t = i / (kRasterPipelineLUTSize - 1.0f);
+        while (stop + 2 < fColorCount && t >= this->getPos(stop + 1)) {
+            stop++;
+        }
+        const float t_l = this->getPos(stop),
+                    t_r = this->getPos(stop + 1);
+        const float w = t_r > t_l ? SkTPin((t - t_l) / (t_r - t_l), 0.0f, 1.0f) : 1.0f;
+        const Sk4f c_l = prepareColor(stop),
+                   c_r = prepareColor(stop + 1);
+        (c_l + (c_r - c_l) * w).store(lut + 4*i);
+    }
+}
+
+// Tables for raster pipelines hold the stage's output colors as floats: premul if the gradient
+// interpolates in premul, otherwise unpremul.
+void SkGradientShaderBase::getRasterPipelineLUT(const SkColor4f* colors, SkBitmap* bitmap) const {
+    SkAutoSTMalloc<64, int32_t> storage;
+    int count = this->makeTableKey(colors, static_cast<int32_t>(kRGBA_F32_SkColorType),
+                                   &storage);
+
+    static SkGradientBitmapCache* gLUTCache;
+    // Each cache entry costs 16K of RAM.
+    static const int MAX_NUM_CACHED_GRADIENT_LUTS = 32;
+    SkAutoMutexAcquire ama(gGradientCacheMutex);
+
+    if (nullptr == gLUTCache) {
+        gLUTCache = new SkGradientBitmapCache(MAX_NUM_CACHED_GRADIENT_LUTS);
+    }
+    size_t size = count * sizeof(int32_t);
+
+    if (!gLUTCache->find(storage.get(), size, bitmap)) {
+        const bool premulGrad = fGradFlags & SkGradientShader::kInterpolateColorsInPremul_Flag;
+        SkImageInfo info = SkImageInfo::Make(kRasterPipelineLUTSize, 1, kRGBA_F32_SkColorType,
+                                             premulGrad ? kPremul_SkAlphaType
+                                                        : kUnpremul_SkAlphaType);
+        bitmap->allocPixels(info);
+        this->initRasterPipelineLUT(colors, bitmap);
+        bitmap->setImmutable();
+        gLUTCache->add(storage.get(), size, *bitmap);
+    }
+}
+
 void SkGradientShaderBase::commonAsAGradient(GradientInfo* info) const {
     if (info) {
         if (info->fColorCount >= fColorCount) {
@@ -80,6 +80,13 @@ protected:
 
     void initLinearBitmap(const SkColor4f* colors, SkBitmap* bitmap, SkColorType colorType) const;
 
+    // Finds or bakes a table of the gradient's colors, evenly spaced from t=0 to t=1, which is
+    // sampled by the gradient_lut stage.
+    void getRasterPipelineLUT(const SkColor4f* colors, SkBitmap*) const;
+    void initRasterPipelineLUT(const SkColor4f* colors, SkBitmap*) const;
+    int makeTableKey(const SkColor4f* colors, int32_t tableType,
+                     SkAutoSTMalloc<64, int32_t>* storage) const;
+
     bool onAppendStages(const StageRec&) const override;
 
     virtual void appendGradientStages(SkArenaAlloc* alloc, SkRasterPipeline* tPipeline,
@@ -207,14 +207,12 @@ void SkTwoPointConicalGradient::appendGradientStages(SkArenaAlloc* alloc, SkRast
     const auto dRadius = fRadius2 - fRadius1;
 
     if (fType == Type::kRadial) {
-        p->append(SkRasterPipeline::xy_to_radius);
-
         // Tiny twist: radial computes a t for [0, r2], but we want a t for [r1, r2].
-        auto scale =  SkTMax(fRadius1, fRadius2) / dRadius;
-        auto bias  = -fRadius1 / dRadius;
-
-        p->append_matrix(alloc, SkMatrix::Concat(SkMatrix::MakeTrans(bias, 0),
-                                                 SkMatrix::MakeScale(scale, 1)));
+        // xy_to_2pt_conical_concentric applies that scale and bias along with the radius.
+        auto* ctx = alloc->make<SkJumper_2PtConicalCtx>();
+        ctx->fP0 =  SkTMax(fRadius1, fRadius2) / dRadius;
+        ctx->fP1 = -fRadius1 / dRadius;
+        p->append(SkRasterPipeline::xy_to_2pt_conical_concentric, ctx);
         return;
     }
 
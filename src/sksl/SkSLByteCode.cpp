@@ -0,0 +1,247 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_STANDALONE
+
+#include "SkSLByteCode.h"
+#include "SkSLUtil.h"
+
+#include "SkArenaAlloc.h"
+#include "SkNx.h"
+#include "SkRasterPipeline.h"
+#include "../jumper/SkJumper.h"
+
+#include <cmath>
+#include <climits>
+
+namespace SkSL {
+
+typedef SkNx<ByteCode::kVecWidth, float>   VF;
+typedef SkNx<ByteCode::kVecWidth, int32_t> VI;
+
+static uint16_t read16(const uint8_t* ip) {
+    uint16_t result;
+    memcpy(&result, ip, sizeof(result));
+    return result;
+}
+
+static uint32_t read32(const uint8_t* ip) {
+    uint32_t result;
+    memcpy(&result, ip, sizeof(result));
+    return result;
+}
+
+template <typename Fn>
+static void per_lane_f(int32_t* dst, const int32_t* src, Fn fn) {
+    float lanes[ByteCode::kVecWidth];
+    memcpy(lanes, src, sizeof(lanes));
+    for (int i = 0; i < ByteCode::kVecWidth; ++i) {
+        lanes[i] = fn(lanes[i]);
+    }
+    memcpy(dst, lanes, sizeof(lanes));
+}
+
+void ByteCode::Run(const Function& f, int count, float args[], float outReturn[],
+                   int32_t registers[]) {
+    SkASSERT(count > 0 && count <= kVecWidth);
+    const size_t kRegisterSize = kVecWidth * sizeof(int32_t);
+
+    #define REG(index) (registers + (index) * kVecWidth)
+
+    for (int i = 0; i < kVecWidth; ++i) {
+        REG(kMaskRegister)[i] = i < count ? ~0 : 0;
+    }
+    memcpy(REG(1), args, f.fParameterCount * kRegisterSize);
+
+    const uint8_t* code = f.fCode.data();
+    const uint8_t* ip = code;
+
+    #define READ16() (ip += 2, read16(ip - 2))
+    #define READ32() (ip += 4, read32(ip - 4))
+
+    #define UNARY_F(expr) {                                        \
+        int dst = READ16();                                        \
+        VF x = VF::Load(REG(READ16()));                            \
+        (expr).store(REG(dst));                                    \
+        break;                                                     \
+    }
+    #define UNARY_I(expr) {                                        \
+        int dst = READ16();                                        \
+        VI x = VI::Load(REG(READ16()));                            \
+        (expr).store(REG(dst));                                    \
+        break;                                                     \
+    }
+    #define BINARY_F(expr) {                                       \
+        int dst = READ16();                                        \
+        VF x = VF::Load(REG(READ16()));                            \
+        VF y = VF::Load(REG(READ16()));                            \
+        (expr).store(REG(dst));                                    \
+        break;                                                     \
+    }
+    #define BINARY_I(expr) {                                       \
+        int dst = READ16();                                        \
+        VI x = VI::Load(REG(READ16()));                            \
+        VI y = VI::Load(REG(READ16()));                            \
+        (expr).store(REG(dst));                                    \
+        break;                                                     \
+    }
+    #define PER_LANE_F(fn) {                                       \
+        int dst = READ16();                                        \
+        per_lane_f(REG(dst), REG(READ16()), fn);                   \
+        break;                                                     \
+    }
+
+    for (;;) {
+        Instruction inst = (Instruction) *ip++;
+        switch (inst) {
+            case Instruction::kAddF:         BINARY_F(x + y)
+            case Instruction::kAddI:         BINARY_I(x + y)
+            case Instruction::kSubtractF:    BINARY_F(x - y)
+            case Instruction::kSubtractI:    BINARY_I(x - y)
+            case Instruction::kMultiplyF:    BINARY_F(x * y)
+            case Instruction::kMultiplyI:    BINARY_I(x * y)
+            case Instruction::kDivideF:      BINARY_F(x / y)
+            case Instruction::kMinF:         BINARY_F(VF::Min(x, y))
+            case Instruction::kMaxF:         BINARY_F(VF::Max(x, y))
+            case Instruction::kAnd:          BINARY_I(x & y)
+            case Instruction::kOr:           BINARY_I(x | y)
+            case Instruction::kXor:          BINARY_I(x ^ y)
+            case Instruction::kCompareEQF:   BINARY_F(x == y)
+            case Instruction::kCompareEQI:   BINARY_I(x == y)
+            case Instruction::kCompareNEQF:  BINARY_F(x != y)
+            case Instruction::kCompareNEQI:  BINARY_I((x == y) ^ VI(~0))
+            case Instruction::kCompareLTF:   BINARY_F(x < y)
+            case Instruction::kCompareLTI:   BINARY_I(x < y)
+            case Instruction::kCompareLTEQF: BINARY_F(x <= y)
+            case Instruction::kCompareLTEQI: BINARY_I((x > y) ^ VI(~0))
+            case Instruction::kCompareGTF:   BINARY_F(x > y)
+            case Instruction::kCompareGTI:   BINARY_I(x > y)
+            case Instruction::kCompareGTEQF: BINARY_F(x >= y)
+            case Instruction::kCompareGTEQI: BINARY_I((x < y) ^ VI(~0))
+            case Instruction::kNegateF:      UNARY_F(-x)
+            case Instruction::kNegateI:      UNARY_I(VI(0) - x)
+            case Instruction::kNot:          UNARY_I(x ^ VI(~0))
+            case Instruction::kAbsF:         UNARY_F(x.abs())
+            case Instruction::kSqrt:         UNARY_F(x.sqrt())
+            case Instruction::kConvertFtoI:  UNARY_F(SkNx_cast<int32_t>(x))
+            case Instruction::kConvertItoF:  UNARY_I(SkNx_cast<float>(x))
+            case Instruction::kSin:          PER_LANE_F([](float x) { return sinf(x); })
+            case Instruction::kCos:          PER_LANE_F([](float x) { return cosf(x); })
+            case Instruction::kTan:          PER_LANE_F([](float x) { return tanf(x); })
+            case Instruction::kDivideI:
+            case Instruction::kRemainderI: {
+                // There's no vector integer division; do it a lane at a time. Dead lanes may hold
+                // anything, so division by zero (and the one overflowing case) must not trap.
+                int32_t* dst = REG(READ16());
+                const int32_t* x = REG(READ16());
+                const int32_t* y = REG(READ16());
+                for (int i = 0; i < kVecWidth; ++i) {
+                    if (y[i] == 0 || (x[i] == INT_MIN && y[i] == -1)) {
+                        dst[i] = 0;
+                    } else {
+                        dst[i] = Instruction::kDivideI == inst ? x[i] / y[i] : x[i] % y[i];
+                    }
+                }
+                break;
+            }
+            case Instruction::kCopy: {
+                int dst = READ16();
+                memcpy(REG(dst), REG(READ16()), kRegisterSize);
+                break;
+            }
+            case Instruction::kSelect: {
+                int dst = READ16();
+                VI test = VI::Load(REG(READ16()));
+                VI ifTrue = VI::Load(REG(READ16()));
+                VI ifFalse = VI::Load(REG(READ16()));
+                test.thenElse(ifTrue, ifFalse).store(REG(dst));
+                break;
+            }
+            case Instruction::kLoadConstant: {
+                int dst = READ16();
+                VI((int32_t) READ32()).store(REG(dst));
+                break;
+            }
+            case Instruction::kBranch:
+                ip = code + read16(ip);
+                break;
+            case Instruction::kBranchIfAllFalse: {
+                const int32_t* src = REG(READ16());
+                int target = READ16();
+                bool any = false;
+                for (int i = 0; i < kVecWidth; ++i) {
+                    any |= src[i] != 0;
+                }
+                if (!any) {
+                    ip = code + target;
+                }
+                break;
+            }
+            case Instruction::kReturn:
+                memcpy(args, REG(1), f.fParameterCount * kRegisterSize);
+                if (outReturn) {
+                    memcpy(outReturn, REG(1 + f.fParameterCount), f.fReturnCount * kRegisterSize);
+                }
+                return;
+            default:
+                ABORT("unsupported instruction %d\n", (int) inst);
+        }
+    }
+
+    #undef REG
+    #undef READ16
+    #undef READ32
+    #undef UNARY_F
+    #undef UNARY_I
+    #undef BINARY_F
+    #undef BINARY_I
+    #undef PER_LANE_F
+}
+
+struct InterpreterCtx : public SkJumper_InterpreterCtx {
+    const ByteCode::Function* fFunction;
+    int32_t* fRegisters;
+};
+
+static void run_interpreter(SkJumper_InterpreterCtx* raw, int dx, int dy, int activePixels) {
+    static_assert(SkJumper_kMaxStride % ByteCode::kVecWidth == 0, "");
+    InterpreterCtx& ctx = (InterpreterCtx&) *raw;
+    const int W = ByteCode::kVecWidth;
+    // Parameters are (int x, int y, inout float4 color): six registers.
+    float args[6 * W];
+    for (int start = 0; start < activePixels; start += W) {
+        int count = SkTMin(W, activePixels - start);
+        int32_t xy[2 * W];
+        for (int i = 0; i < W; ++i) {
+            xy[i] = dx + start + i;
+            xy[W + i] = dy;
+        }
+        memcpy(args, xy, sizeof(xy));
+        for (int c = 0; c < 4; ++c) {
+            memcpy(&args[(2 + c) * W], &ctx.rgba[c * SkJumper_kMaxStride + start],
+                   W * sizeof(float));
+        }
+        ByteCode::Run(*ctx.fFunction, count, args, nullptr, ctx.fRegisters);
+        for (int c = 0; c < 4; ++c) {
+            memcpy(&ctx.rgba[c * SkJumper_kMaxStride + start], &args[(2 + c) * W],
+                   count * sizeof(float));
+        }
+    }
+}
+
+void ByteCode::AppendStage(const Function& f, SkRasterPipeline* pipeline, SkArenaAlloc* alloc) {
+    SkASSERT(6 == f.fParameterCount && 0 == f.fReturnCount);
+    InterpreterCtx* ctx = alloc->make<InterpreterCtx>();
+    ctx->fn = run_interpreter;
+    ctx->fFunction = &f;
+    ctx->fRegisters = alloc->makeArrayDefault<int32_t>(f.fRegisterCount * kVecWidth);
+    pipeline->append(SkRasterPipeline::interpreter, ctx);
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_BYTECODE
+#define SKSL_BYTECODE
+
+#include "SkSLString.h"
+
+#include <memory>
+#include <vector>
+
+class SkArenaAlloc;
+class SkRasterPipeline;
+
+namespace SkSL {
+
+/**
+ * A compact, register-based encoding of an SkSL program, produced by ByteCodeGenerator and
+ * executed by ByteCode::Run.
+ *
+ * Every register holds kVecWidth lanes, one per pixel, and every instruction operates on all lanes
+ * at once. Control flow which depends on per-pixel values is handled by masking rather than by
+ * branching: register 0 always holds the execution mask (all bits set for live lanes, zero for
+ * dead ones), and every store to a variable is a select against it. Branches are only taken when
+ * the mask proves that no lane needs the code being skipped.
+ */
+struct ByteCode {
+    static constexpr int kVecWidth = 16;
+
+    // Register 0 is reserved for the execution mask.
+    static constexpr int kMaskRegister = 0;
+
+    /**
+     * Instructions are one byte, followed by their operands. Register and branch target operands
+     * are 16 bits; constants are 32 bits. Unless otherwise noted, the operands are (dst, src) for
+     * unary instructions and (dst, left, right) for binary ones. Booleans are represented as
+     * integer lane masks: ~0 for true, 0 for false.
+     */
+    enum class Instruction : uint8_t {
+        kAddF,
+        kAddI,
+        kSubtractF,
+        kSubtractI,
+        kMultiplyF,
+        kMultiplyI,
+        kDivideF,
+        kDivideI,
+        kRemainderI,
+        kMinF,
+        kMaxF,
+        kAnd,
+        kOr,
+        kXor,
+        kCompareEQF,
+        kCompareEQI,
+        kCompareNEQF,
+        kCompareNEQI,
+        kCompareLTF,
+        kCompareLTI,
+        kCompareLTEQF,
+        kCompareLTEQI,
+        kCompareGTF,
+        kCompareGTI,
+        kCompareGTEQF,
+        kCompareGTEQI,
+        kNegateF,
+        kNegateI,
+        kNot,
+        kAbsF,
+        kSqrt,
+        kSin,
+        kCos,
+        kTan,
+        kConvertFtoI,
+        kConvertItoF,
+        kCopy,
+        // (dst, test, ifTrue, ifFalse)
+        kSelect,
+        // (dst, 32-bit value) splats the value across all lanes
+        kLoadConstant,
+        // (target)
+        kBranch,
+        // (src, target) branches if no lane of src is set
+        kBranchIfAllFalse,
+        // no operands
+        kReturn
+    };
+
+    struct Function {
+        String fName;
+
+        // Number of registers holding parameters. These follow the mask register, in declaration
+        // order, one register per component. Out and inout parameters are written back in place.
+        int fParameterCount = 0;
+
+        // Number of registers holding the return value. These immediately follow the parameters.
+        int fReturnCount = 0;
+
+        // Total number of registers (including the mask) the function needs.
+        int fRegisterCount = 0;
+
+        std::vector<uint8_t> fCode;
+    };
+
+    const Function* getFunction(const char* name) const {
+        for (const auto& f : fFunctions) {
+            if (f->fName == name) {
+                return f.get();
+            }
+        }
+        return nullptr;
+    }
+
+#ifndef SKSL_STANDALONE
+    /**
+     * Runs the function over count (<= kVecWidth) lanes. args holds fParameterCount registers'
+     * worth of lane values laid out component-major (args[i * kVecWidth + lane]); out and inout
+     * parameters are written back to it. If outReturn is non-null, the fReturnCount return value
+     * registers are copied to it in the same layout. registers must point to at least
+     * fRegisterCount * kVecWidth 32-bit values of scratch space.
+     */
+    static void Run(const Function& f, int count, float args[], float outReturn[],
+                    int32_t registers[]);
+
+    /**
+     * Appends a stage running the function to the pipeline. The function must have the signature
+     * void <name>(int x, int y, inout half4 color). The ByteCode must outlive the pipeline.
+     */
+    static void AppendStage(const Function& f, SkRasterPipeline* pipeline, SkArenaAlloc* alloc);
+#endif
+
+    std::vector<std::unique_ptr<Function>> fFunctions;
+};
+
+} // namespace
+
+#endif
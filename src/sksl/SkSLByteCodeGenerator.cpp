@@ -0,0 +1,941 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSLByteCodeGenerator.h"
+
+#include <algorithm>
+
+#include "SkSLCompiler.h"
+#include "ir/SkSLBoolLiteral.h"
+#include "ir/SkSLFloatLiteral.h"
+#include "ir/SkSLIntLiteral.h"
+
+namespace SkSL {
+
+typedef ByteCode::Instruction Inst;
+
+bool ByteCodeGenerator::generateCode() {
+    for (const auto& e : fProgram) {
+        if (ProgramElement::kFunction_Kind == e.fKind) {
+            std::unique_ptr<ByteCode::Function> f =
+                                            this->writeFunction((const FunctionDefinition&) e);
+            if (!f) {
+                return false;
+            }
+            fOutput->fFunctions.push_back(std::move(f));
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<ByteCode::Function> ByteCodeGenerator::writeFunction(const FunctionDefinition& f) {
+    std::unique_ptr<ByteCode::Function> result(new ByteCode::Function());
+    result->fName = f.fDeclaration.fName;
+    fCode = &result->fCode;
+    fVariables.clear();
+    fNextRegister = fMaxRegister = ByteCode::kMaskRegister + 1;
+    for (const Variable* p : f.fDeclaration.fParameters) {
+        int count;
+        if (!this->slotCount(p->fType, p->fOffset, &count)) {
+            return nullptr;
+        }
+        fVariables[p] = this->nextRegisters(count);
+        result->fParameterCount += count;
+    }
+    if (!this->slotCount(f.fDeclaration.fReturnType, f.fOffset, &result->fReturnCount)) {
+        return nullptr;
+    }
+    Registers returnRegisters = this->nextRegisters(result->fReturnCount);
+    fInlining.insert(&f.fDeclaration);
+    bool success = this->writeBody(f, &returnRegisters);
+    fInlining.erase(&f.fDeclaration);
+    if (!success) {
+        return nullptr;
+    }
+    this->writeInstruction(Inst::kReturn);
+    if (fMaxRegister > UINT16_MAX || fCode->size() > UINT16_MAX) {
+        fErrors.error(f.fOffset, "function '" + f.fDeclaration.fName + "' is too large");
+        return nullptr;
+    }
+    result->fRegisterCount = fMaxRegister;
+    fCode = nullptr;
+    return result;
+}
+
+bool ByteCodeGenerator::slotCount(const Type& type, int offset, int* outCount) {
+    if (type == *fContext.fVoid_Type) {
+        *outCount = 0;
+        return true;
+    }
+    switch (type.kind()) {
+        case Type::kScalar_Kind:
+            *outCount = 1;
+            return true;
+        case Type::kVector_Kind:
+            *outCount = type.columns();
+            return true;
+        default:
+            fErrors.error(offset, "unsupported type '" + type.description() + "'");
+            return false;
+    }
+}
+
+bool ByteCodeGenerator::numberKind(const Type& type, int offset, NumberKind* outKind) {
+    const Type& component = Type::kVector_Kind == type.kind() ? type.componentType() : type;
+    if (component.isFloat()) {
+        *outKind = NumberKind::kFloat;
+    } else if (component.isSigned()) {
+        *outKind = NumberKind::kInt;
+    } else if (component == *fContext.fBool_Type) {
+        *outKind = NumberKind::kBool;
+    } else {
+        fErrors.error(offset, "unsupported type '" + type.description() + "'");
+        return false;
+    }
+    return true;
+}
+
+int ByteCodeGenerator::nextRegister() {
+    int result = fNextRegister++;
+    fMaxRegister = std::max(fMaxRegister, fNextRegister);
+    return result;
+}
+
+ByteCodeGenerator::Registers ByteCodeGenerator::nextRegisters(int count) {
+    Registers result;
+    for (int i = 0; i < count; ++i) {
+        result.push_back(this->nextRegister());
+    }
+    return result;
+}
+
+void ByteCodeGenerator::write8(uint8_t b) {
+    fCode->push_back(b);
+}
+
+void ByteCodeGenerator::write16(uint16_t b) {
+    fCode->push_back(b >> 0);
+    fCode->push_back(b >> 8);
+}
+
+void ByteCodeGenerator::write32(uint32_t b) {
+    fCode->push_back(b >>  0);
+    fCode->push_back(b >>  8);
+    fCode->push_back(b >> 16);
+    fCode->push_back(b >> 24);
+}
+
+void ByteCodeGenerator::writeInstruction(Inst inst) {
+    this->write8((uint8_t) inst);
+}
+
+void ByteCodeGenerator::writeUnary(Inst inst, int dst, int src) {
+    this->writeInstruction(inst);
+    this->write16(dst);
+    this->write16(src);
+}
+
+void ByteCodeGenerator::writeBinary(Inst inst, int dst, int left, int right) {
+    this->writeInstruction(inst);
+    this->write16(dst);
+    this->write16(left);
+    this->write16(right);
+}
+
+void ByteCodeGenerator::writeSelect(int dst, int test, int ifTrue, int ifFalse) {
+    this->writeInstruction(Inst::kSelect);
+    this->write16(dst);
+    this->write16(test);
+    this->write16(ifTrue);
+    this->write16(ifFalse);
+}
+
+size_t ByteCodeGenerator::writeBranch(Inst inst, int src) {
+    this->writeInstruction(inst);
+    if (Inst::kBranchIfAllFalse == inst) {
+        this->write16(src);
+    }
+    size_t result = fCode->size();
+    this->write16(0);
+    return result;
+}
+
+void ByteCodeGenerator::patchBranch(size_t location, size_t target) {
+    (*fCode)[location + 0] = (uint8_t) (target >> 0);
+    (*fCode)[location + 1] = (uint8_t) (target >> 8);
+}
+
+void ByteCodeGenerator::writeMaskedStore(const Registers& dst, const Registers& src) {
+    SkASSERT(dst.size() == src.size());
+    for (size_t i = 0; i < dst.size(); ++i) {
+        if (dst[i] != src[i]) {
+            this->writeSelect(dst[i], ByteCode::kMaskRegister, src[i], dst[i]);
+        }
+    }
+}
+
+ByteCodeGenerator::Registers ByteCodeGenerator::broadcast(const Registers& regs, int count) {
+    if (1 == regs.size()) {
+        return Registers(count, regs[0]);
+    }
+    SkASSERT((int) regs.size() == count);
+    return regs;
+}
+
+static uint32_t float_bits(float f) {
+    uint32_t result;
+    memcpy(&result, &f, sizeof(result));
+    return result;
+}
+
+ByteCodeGenerator::Registers ByteCodeGenerator::convert(const Registers& regs, NumberKind from,
+                                                        NumberKind to) {
+    if (from == to) {
+        return regs;
+    }
+    Registers result = this->nextRegisters(regs.size());
+    int zero = -1, one = -1;
+    if (NumberKind::kBool == from || NumberKind::kBool == to) {
+        zero = this->nextRegister();
+        this->writeInstruction(Inst::kLoadConstant);
+        this->write16(zero);
+        this->write32(0);
+        if (NumberKind::kBool == from) {
+            one = this->nextRegister();
+            this->writeInstruction(Inst::kLoadConstant);
+            this->write16(one);
+            this->write32(NumberKind::kFloat == to ? float_bits(1) : 1);
+        }
+    }
+    for (size_t i = 0; i < regs.size(); ++i) {
+        if (NumberKind::kBool == from) {
+            this->writeSelect(result[i], regs[i], one, zero);
+        } else if (NumberKind::kBool == to) {
+            this->writeBinary(NumberKind::kFloat == from ? Inst::kCompareNEQF : Inst::kCompareNEQI,
+                              result[i], regs[i], zero);
+        } else {
+            this->writeUnary(NumberKind::kFloat == from ? Inst::kConvertFtoI : Inst::kConvertItoF,
+                             result[i], regs[i]);
+        }
+    }
+    return result;
+}
+
+bool ByteCodeGenerator::writeLValue(const Expression& e, Registers* outRegisters) {
+    switch (e.fKind) {
+        case Expression::kVariableReference_Kind:
+            return this->writeExpression(e, outRegisters);
+        case Expression::kSwizzle_Kind: {
+            const Swizzle& s = (const Swizzle&) e;
+            Registers base;
+            if (!this->writeLValue(*s.fBase, &base)) {
+                return false;
+            }
+            outRegisters->clear();
+            for (int c : s.fComponents) {
+                outRegisters->push_back(base[c]);
+            }
+            return true;
+        }
+        default:
+            fErrors.error(e.fOffset, "unsupported lvalue '" + e.description() + "'");
+            return false;
+    }
+}
+
+bool ByteCodeGenerator::writeExpression(const Expression& e, Registers* outRegisters) {
+    switch (e.fKind) {
+        case Expression::kBinary_Kind:
+            return this->writeBinaryExpression((const BinaryExpression&) e, outRegisters);
+        case Expression::kBoolLiteral_Kind: {
+            int reg = this->nextRegister();
+            this->writeInstruction(Inst::kLoadConstant);
+            this->write16(reg);
+            this->write32(((const BoolLiteral&) e).fValue ? ~0 : 0);
+            *outRegisters = { reg };
+            return true;
+        }
+        case Expression::kConstructor_Kind:
+            return this->writeConstructor((const Constructor&) e, outRegisters);
+        case Expression::kFloatLiteral_Kind: {
+            int reg = this->nextRegister();
+            this->writeInstruction(Inst::kLoadConstant);
+            this->write16(reg);
+            this->write32(float_bits(((const FloatLiteral&) e).fValue));
+            *outRegisters = { reg };
+            return true;
+        }
+        case Expression::kFunctionCall_Kind:
+            return this->writeFunctionCall((const FunctionCall&) e, outRegisters);
+        case Expression::kIntLiteral_Kind: {
+            int reg = this->nextRegister();
+            this->writeInstruction(Inst::kLoadConstant);
+            this->write16(reg);
+            this->write32((uint32_t) ((const IntLiteral&) e).fValue);
+            *outRegisters = { reg };
+            return true;
+        }
+        case Expression::kPrefix_Kind:
+            return this->writePrefixExpression((const PrefixExpression&) e, outRegisters);
+        case Expression::kPostfix_Kind:
+            return this->writePostfixExpression((const PostfixExpression&) e, outRegisters);
+        case Expression::kSwizzle_Kind: {
+            const Swizzle& s = (const Swizzle&) e;
+            Registers base;
+            if (!this->writeExpression(*s.fBase, &base)) {
+                return false;
+            }
+            outRegisters->clear();
+            for (int c : s.fComponents) {
+                outRegisters->push_back(base[c]);
+            }
+            return true;
+        }
+        case Expression::kTernary_Kind:
+            return this->writeTernaryExpression((const TernaryExpression&) e, outRegisters);
+        case Expression::kVariableReference_Kind: {
+            const Variable& var = ((const VariableReference&) e).fVariable;
+            auto found = fVariables.find(&var);
+            if (found == fVariables.end()) {
+                fErrors.error(e.fOffset, "unsupported variable '" + var.fName + "'");
+                return false;
+            }
+            *outRegisters = found->second;
+            return true;
+        }
+        default:
+            fErrors.error(e.fOffset, "unsupported expression '" + e.description() + "'");
+            return false;
+    }
+}
+
+static Inst pick(bool isFloat, Inst f, Inst i) {
+    return isFloat ? f : i;
+}
+
+bool ByteCodeGenerator::writeBinaryExpression(const BinaryExpression& b, Registers* outRegisters) {
+    Token::Kind op = b.fOperator;
+    NumberKind kind;
+    int leftCount, rightCount;
+    if (!this->numberKind(b.fLeft->fType, b.fOffset, &kind) ||
+        !this->slotCount(b.fLeft->fType, b.fOffset, &leftCount) ||
+        !this->slotCount(b.fRight->fType, b.fOffset, &rightCount)) {
+        return false;
+    }
+    int count = std::max(leftCount, rightCount);
+    if (Token::EQ == op) {
+        Registers left, right;
+        if (!this->writeLValue(*b.fLeft, &left) || !this->writeExpression(*b.fRight, &right)) {
+            return false;
+        }
+        right = this->broadcast(right, count);
+        // Stores happen one component at a time, so e.g. 'v.xy = v.yx' needs a copy of the right
+        // hand side before we start overwriting it.
+        for (size_t i = 0; i < right.size(); ++i) {
+            if (std::find(left.begin(), left.end(), right[i]) != left.end() && left[i] != right[i]) {
+                Registers copy = this->nextRegisters(right.size());
+                for (size_t j = 0; j < right.size(); ++j) {
+                    this->writeUnary(Inst::kCopy, copy[j], right[j]);
+                }
+                right = copy;
+                break;
+            }
+        }
+        this->writeMaskedStore(left, right);
+        *outRegisters = left;
+        return true;
+    }
+    if (Token::LOGICALAND == op || Token::LOGICALOR == op) {
+        // Only lanes which need the right hand side get to see its side effects.
+        Registers left, right;
+        if (!this->writeExpression(*b.fLeft, &left)) {
+            return false;
+        }
+        int savedMask = this->nextRegister();
+        this->writeUnary(Inst::kCopy, savedMask, ByteCode::kMaskRegister);
+        if (Token::LOGICALAND == op) {
+            this->writeBinary(Inst::kAnd, ByteCode::kMaskRegister, savedMask, left[0]);
+        } else {
+            int notLeft = this->nextRegister();
+            this->writeUnary(Inst::kNot, notLeft, left[0]);
+            this->writeBinary(Inst::kAnd, ByteCode::kMaskRegister, savedMask, notLeft);
+        }
+        if (!this->writeExpression(*b.fRight, &right)) {
+            return false;
+        }
+        this->writeUnary(Inst::kCopy, ByteCode::kMaskRegister, savedMask);
+        int result = this->nextRegister();
+        this->writeBinary(Token::LOGICALAND == op ? Inst::kAnd : Inst::kOr, result, left[0],
+                          right[0]);
+        *outRegisters = { result };
+        return true;
+    }
+
+    bool isAssignment = Compiler::IsAssignment(op);
+    Registers left, right;
+    if (isAssignment ? !this->writeLValue(*b.fLeft, &left)
+                     : !this->writeExpression(*b.fLeft, &left)) {
+        return false;
+    }
+    if (!isAssignment && b.fRight->hasSideEffects()) {
+        // the right hand side might modify the variables we're reading from
+        Registers copy = this->nextRegisters(left.size());
+        for (size_t i = 0; i < left.size(); ++i) {
+            this->writeUnary(Inst::kCopy, copy[i], left[i]);
+        }
+        left = copy;
+    }
+    if (!this->writeExpression(*b.fRight, &right)) {
+        return false;
+    }
+    Registers l = this->broadcast(left, count);
+    Registers r = this->broadcast(right, count);
+    bool isFloat = NumberKind::kFloat == kind;
+    Inst inst;
+    switch (op) {
+        case Token::PLUS:
+        case Token::PLUSEQ:
+            inst = pick(isFloat, Inst::kAddF, Inst::kAddI);
+            break;
+        case Token::MINUS:
+        case Token::MINUSEQ:
+            inst = pick(isFloat, Inst::kSubtractF, Inst::kSubtractI);
+            break;
+        case Token::STAR:
+        case Token::STAREQ:
+            inst = pick(isFloat, Inst::kMultiplyF, Inst::kMultiplyI);
+            break;
+        case Token::SLASH:
+        case Token::SLASHEQ:
+            inst = pick(isFloat, Inst::kDivideF, Inst::kDivideI);
+            break;
+        case Token::PERCENT:
+        case Token::PERCENTEQ:
+            if (isFloat) {
+                fErrors.error(b.fOffset, "unsupported operator '%'");
+                return false;
+            }
+            inst = Inst::kRemainderI;
+            break;
+        case Token::BITWISEAND:
+        case Token::BITWISEANDEQ:
+            inst = Inst::kAnd;
+            break;
+        case Token::BITWISEOR:
+        case Token::BITWISEOREQ:
+            inst = Inst::kOr;
+            break;
+        case Token::BITWISEXOR:
+        case Token::BITWISEXOREQ:
+        case Token::LOGICALXOR:
+            inst = Inst::kXor;
+            break;
+        case Token::LT:
+            inst = pick(isFloat, Inst::kCompareLTF, Inst::kCompareLTI);
+            break;
+        case Token::LTEQ:
+            inst = pick(isFloat, Inst::kCompareLTEQF, Inst::kCompareLTEQI);
+            break;
+        case Token::GT:
+            inst = pick(isFloat, Inst::kCompareGTF, Inst::kCompareGTI);
+            break;
+        case Token::GTEQ:
+            inst = pick(isFloat, Inst::kCompareGTEQF, Inst::kCompareGTEQI);
+            break;
+        case Token::EQEQ:
+        case Token::NEQ: {
+            // Compare component-wise, then reduce to a single boolean.
+            bool eq = Token::EQEQ == op;
+            inst = eq ? pick(isFloat, Inst::kCompareEQF, Inst::kCompareEQI)
+                      : pick(isFloat, Inst::kCompareNEQF, Inst::kCompareNEQI);
+            int result = this->nextRegister();
+            this->writeBinary(inst, result, l[0], r[0]);
+            for (int i = 1; i < count; ++i) {
+                int component = this->nextRegister();
+                this->writeBinary(inst, component, l[i], r[i]);
+                this->writeBinary(eq ? Inst::kAnd : Inst::kOr, result, result, component);
+            }
+            *outRegisters = { result };
+            return true;
+        }
+        default:
+            fErrors.error(b.fOffset, String("unsupported operator '") +
+                                     Compiler::OperatorName(op) + "'");
+            return false;
+    }
+    Registers result = this->nextRegisters(count);
+    for (int i = 0; i < count; ++i) {
+        this->writeBinary(inst, result[i], l[i], r[i]);
+    }
+    if (isAssignment) {
+        this->writeMaskedStore(left, result);
+        result = left;
+    }
+    *outRegisters = result;
+    return true;
+}
+
+bool ByteCodeGenerator::writeConstructor(const Constructor& c, Registers* outRegisters) {
+    NumberKind kind;
+    int count;
+    if (!this->numberKind(c.fType, c.fOffset, &kind) ||
+        !this->slotCount(c.fType, c.fOffset, &count)) {
+        return false;
+    }
+    Registers result;
+    for (const auto& arg : c.fArguments) {
+        NumberKind argKind;
+        Registers argRegisters;
+        if (!this->numberKind(arg->fType, arg->fOffset, &argKind) ||
+            !this->writeExpression(*arg, &argRegisters)) {
+            return false;
+        }
+        argRegisters = this->convert(argRegisters, argKind, kind);
+        result.insert(result.end(), argRegisters.begin(), argRegisters.end());
+    }
+    if ((int) result.size() != count) {
+        if (1 != result.size()) {
+            fErrors.error(c.fOffset, "unsupported constructor '" + c.description() + "'");
+            return false;
+        }
+        result = this->broadcast(result, count);
+    }
+    *outRegisters = result;
+    return true;
+}
+
+bool ByteCodeGenerator::writeFunctionCall(const FunctionCall& c, Registers* outRegisters) {
+    if (c.fFunction.fBuiltin) {
+        return this->writeIntrinsicCall(c, outRegisters);
+    }
+    const FunctionDefinition* definition = nullptr;
+    for (const auto& e : fProgram) {
+        if (ProgramElement::kFunction_Kind == e.fKind &&
+            &((const FunctionDefinition&) e).fDeclaration == &c.fFunction) {
+            definition = &(const FunctionDefinition&) e;
+            break;
+        }
+    }
+    if (!definition) {
+        fErrors.error(c.fOffset, "function '" + c.fFunction.fName + "' is not defined");
+        return false;
+    }
+    if (fInlining.find(&c.fFunction) != fInlining.end()) {
+        fErrors.error(c.fOffset, "unsupported recursive call to '" + c.fFunction.fName + "'");
+        return false;
+    }
+    // Calls are inlined: each parameter gets fresh registers, initialized from the arguments, and
+    // out parameters are stored back to their arguments after the body runs.
+    std::vector<Registers> outArguments;
+    for (size_t i = 0; i < c.fArguments.size(); ++i) {
+        const Variable* param = c.fFunction.fParameters[i];
+        const Expression& arg = *c.fArguments[i];
+        int count;
+        if (!this->slotCount(param->fType, arg.fOffset, &count)) {
+            return false;
+        }
+        Registers value;
+        if (param->fModifiers.fFlags & Modifiers::kOut_Flag) {
+            if (!this->writeLValue(arg, &value)) {
+                return false;
+            }
+            outArguments.push_back(value);
+        } else if (!this->writeExpression(arg, &value)) {
+            return false;
+        }
+        Registers registers = this->nextRegisters(count);
+        if ((param->fModifiers.fFlags & Modifiers::kIn_Flag) ||
+            !(param->fModifiers.fFlags & Modifiers::kOut_Flag)) {
+            value = this->broadcast(value, count);
+            for (int j = 0; j < count; ++j) {
+                this->writeUnary(Inst::kCopy, registers[j], value[j]);
+            }
+        }
+        fVariables[param] = registers;
+    }
+    int returnCount;
+    if (!this->slotCount(c.fFunction.fReturnType, c.fOffset, &returnCount)) {
+        return false;
+    }
+    Registers returnRegisters = this->nextRegisters(returnCount);
+    fInlining.insert(&c.fFunction);
+    bool success = this->writeBody(*definition, &returnRegisters);
+    fInlining.erase(&c.fFunction);
+    if (!success) {
+        return false;
+    }
+    auto outArgument = outArguments.begin();
+    for (const Variable* param : c.fFunction.fParameters) {
+        if (param->fModifiers.fFlags & Modifiers::kOut_Flag) {
+            this->writeMaskedStore(*outArgument++, fVariables[param]);
+        }
+    }
+    *outRegisters = returnRegisters;
+    return true;
+}
+
+bool ByteCodeGenerator::writeIntrinsicCall(const FunctionCall& c, Registers* outRegisters) {
+    const String& name = c.fFunction.fName;
+    NumberKind kind;
+    int count;
+    if (!this->numberKind(c.fType, c.fOffset, &kind) ||
+        !this->slotCount(c.fType, c.fOffset, &count)) {
+        return false;
+    }
+    std::vector<Registers> args;
+    for (const auto& arg : c.fArguments) {
+        Registers registers;
+        if (!this->writeExpression(*arg, &registers)) {
+            return false;
+        }
+        args.push_back(this->broadcast(registers, count));
+    }
+    Registers result = this->nextRegisters(count);
+    if (NumberKind::kFloat == kind && 1 == args.size()) {
+        Inst inst;
+        if ("abs" == name) {
+            inst = Inst::kAbsF;
+        } else if ("sqrt" == name) {
+            inst = Inst::kSqrt;
+        } else if ("sin" == name) {
+            inst = Inst::kSin;
+        } else if ("cos" == name) {
+            inst = Inst::kCos;
+        } else if ("tan" == name) {
+            inst = Inst::kTan;
+        } else {
+            inst = Inst::kReturn;
+        }
+        if (Inst::kReturn != inst) {
+            for (int i = 0; i < count; ++i) {
+                this->writeUnary(inst, result[i], args[0][i]);
+            }
+            *outRegisters = result;
+            return true;
+        }
+    }
+    if (NumberKind::kFloat == kind && 3 == args.size() && "clamp" == name) {
+        for (int i = 0; i < count; ++i) {
+            this->writeBinary(Inst::kMaxF, result[i], args[0][i], args[1][i]);
+            this->writeBinary(Inst::kMinF, result[i], result[i], args[2][i]);
+        }
+        *outRegisters = result;
+        return true;
+    }
+    fErrors.error(c.fOffset, "unsupported intrinsic '" + c.fFunction.description() + "'");
+    return false;
+}
+
+bool ByteCodeGenerator::writePrefixExpression(const PrefixExpression& p,
+                                              Registers* outRegisters) {
+    NumberKind kind;
+    if (!this->numberKind(p.fType, p.fOffset, &kind)) {
+        return false;
+    }
+    bool isFloat = NumberKind::kFloat == kind;
+    Registers operand;
+    switch (p.fOperator) {
+        case Token::PLUSPLUS:
+        case Token::MINUSMINUS: {
+            if (!this->writeLValue(*p.fOperand, &operand)) {
+                return false;
+            }
+            int one = this->nextRegister();
+            this->writeInstruction(Inst::kLoadConstant);
+            this->write16(one);
+            this->write32(isFloat ? float_bits(1) : 1);
+            Registers result = this->nextRegisters(operand.size());
+            Inst inst = Token::PLUSPLUS == p.fOperator
+                                          ? pick(isFloat, Inst::kAddF, Inst::kAddI)
+                                          : pick(isFloat, Inst::kSubtractF, Inst::kSubtractI);
+            for (size_t i = 0; i < operand.size(); ++i) {
+                this->writeBinary(inst, result[i], operand[i], one);
+            }
+            this->writeMaskedStore(operand, result);
+            *outRegisters = operand;
+            return true;
+        }
+        case Token::MINUS:
+        case Token::LOGICALNOT:
+        case Token::BITWISENOT: {
+            if (!this->writeExpression(*p.fOperand, &operand)) {
+                return false;
+            }
+            Inst inst = Token::MINUS == p.fOperator
+                                            ? pick(isFloat, Inst::kNegateF, Inst::kNegateI)
+                                            : Inst::kNot;
+            Registers result = this->nextRegisters(operand.size());
+            for (size_t i = 0; i < operand.size(); ++i) {
+                this->writeUnary(inst, result[i], operand[i]);
+            }
+            *outRegisters = result;
+            return true;
+        }
+        default:
+            fErrors.error(p.fOffset, String("unsupported operator '") +
+                                     Compiler::OperatorName(p.fOperator) + "'");
+            return false;
+    }
+}
+
+bool ByteCodeGenerator::writePostfixExpression(const PostfixExpression& p,
+                                               Registers* outRegisters) {
+    NumberKind kind;
+    Registers operand;
+    if (!this->numberKind(p.fType, p.fOffset, &kind) ||
+        !this->writeLValue(*p.fOperand, &operand)) {
+        return false;
+    }
+    bool isFloat = NumberKind::kFloat == kind;
+    Registers old = this->nextRegisters(operand.size());
+    for (size_t i = 0; i < operand.size(); ++i) {
+        this->writeUnary(Inst::kCopy, old[i], operand[i]);
+    }
+    int one = this->nextRegister();
+    this->writeInstruction(Inst::kLoadConstant);
+    this->write16(one);
+    this->write32(isFloat ? float_bits(1) : 1);
+    Registers result = this->nextRegisters(operand.size());
+    Inst inst = Token::PLUSPLUS == p.fOperator
+                                          ? pick(isFloat, Inst::kAddF, Inst::kAddI)
+                                          : pick(isFloat, Inst::kSubtractF, Inst::kSubtractI);
+    for (size_t i = 0; i < operand.size(); ++i) {
+        this->writeBinary(inst, result[i], operand[i], one);
+    }
+    this->writeMaskedStore(operand, result);
+    *outRegisters = old;
+    return true;
+}
+
+bool ByteCodeGenerator::writeTernaryExpression(const TernaryExpression& t,
+                                               Registers* outRegisters) {
+    Registers test, ifTrue, ifFalse;
+    if (!this->writeExpression(*t.fTest, &test)) {
+        return false;
+    }
+    // Both sides are evaluated, each with only its own lanes live, and the results selected.
+    int savedMask = this->nextRegister();
+    this->writeUnary(Inst::kCopy, savedMask, ByteCode::kMaskRegister);
+    int falseMask = this->nextRegister();
+    this->writeBinary(Inst::kAnd, ByteCode::kMaskRegister, savedMask, test[0]);
+    this->writeBinary(Inst::kXor, falseMask, savedMask, ByteCode::kMaskRegister);
+    if (!this->writeExpression(*t.fIfTrue, &ifTrue)) {
+        return false;
+    }
+    Registers result = this->nextRegisters(ifTrue.size());
+    for (size_t i = 0; i < ifTrue.size(); ++i) {
+        this->writeUnary(Inst::kCopy, result[i], ifTrue[i]);
+    }
+    this->writeUnary(Inst::kCopy, ByteCode::kMaskRegister, falseMask);
+    if (!this->writeExpression(*t.fIfFalse, &ifFalse)) {
+        return false;
+    }
+    this->writeUnary(Inst::kCopy, ByteCode::kMaskRegister, savedMask);
+    for (size_t i = 0; i < result.size(); ++i) {
+        this->writeSelect(result[i], falseMask, ifFalse[i], result[i]);
+    }
+    *outRegisters = result;
+    return true;
+}
+
+bool ByteCodeGenerator::writeStatement(const Statement& s) {
+    int start = fNextRegister;
+    bool result;
+    switch (s.fKind) {
+        case Statement::kBlock_Kind:
+            result = this->writeBlock((const Block&) s);
+            break;
+        case Statement::kExpression_Kind: {
+            Registers unused;
+            result = this->writeExpression(*((const ExpressionStatement&) s).fExpression, &unused);
+            break;
+        }
+        case Statement::kVarDeclarations_Kind:
+            // the variables stay live until the end of the enclosing block
+            return this->writeVarDeclarations(*((const VarDeclarationsStatement&) s).fDeclaration);
+        case Statement::kIf_Kind:
+            result = this->writeIfStatement((const IfStatement&) s);
+            break;
+        case Statement::kFor_Kind: {
+            const ForStatement& f = (const ForStatement&) s;
+            result = this->writeLoop(f.fInitializer.get(), f.fTest.get(), f.fNext.get(),
+                                     *f.fStatement, true);
+            break;
+        }
+        case Statement::kWhile_Kind: {
+            const WhileStatement& w = (const WhileStatement&) s;
+            result = this->writeLoop(nullptr, w.fTest.get(), nullptr, *w.fStatement, true);
+            break;
+        }
+        case Statement::kDo_Kind: {
+            const DoStatement& d = (const DoStatement&) s;
+            result = this->writeLoop(nullptr, d.fTest.get(), nullptr, *d.fStatement, false);
+            break;
+        }
+        case Statement::kNop_Kind:
+            result = true;
+            break;
+        default:
+            fErrors.error(s.fOffset, "unsupported statement '" + s.description() + "'");
+            return false;
+    }
+    fNextRegister = start;
+    return result;
+}
+
+bool ByteCodeGenerator::writeBlock(const Block& b) {
+    int start = fNextRegister;
+    for (const auto& s : b.fStatements) {
+        if (!this->writeStatement(*s)) {
+            return false;
+        }
+    }
+    fNextRegister = start;
+    return true;
+}
+
+bool ByteCodeGenerator::writeVarDeclarations(const VarDeclarations& decls) {
+    for (const auto& raw : decls.fVars) {
+        const VarDeclaration& decl = (const VarDeclaration&) *raw;
+        int count;
+        if (!this->slotCount(decl.fVar->fType, decl.fOffset, &count)) {
+            return false;
+        }
+        if (decl.fSizes.size()) {
+            fErrors.error(decl.fOffset, "unsupported array '" + decl.description() + "'");
+            return false;
+        }
+        Registers registers = this->nextRegisters(count);
+        fVariables[decl.fVar] = registers;
+        if (decl.fValue) {
+            int start = fNextRegister;
+            Registers value;
+            if (!this->writeExpression(*decl.fValue, &value)) {
+                return false;
+            }
+            // The variable is only visible in this scope, so there's no need to preserve the
+            // contents of dead lanes.
+            value = this->broadcast(value, count);
+            for (int i = 0; i < count; ++i) {
+                this->writeUnary(Inst::kCopy, registers[i], value[i]);
+            }
+            fNextRegister = start;
+        }
+    }
+    return true;
+}
+
+bool ByteCodeGenerator::writeIfStatement(const IfStatement& i) {
+    Registers test;
+    if (!this->writeExpression(*i.fTest, &test)) {
+        return false;
+    }
+    int savedMask = this->nextRegister();
+    this->writeUnary(Inst::kCopy, savedMask, ByteCode::kMaskRegister);
+    int falseMask = this->nextRegister();
+    this->writeBinary(Inst::kAnd, ByteCode::kMaskRegister, savedMask, test[0]);
+    this->writeBinary(Inst::kXor, falseMask, savedMask, ByteCode::kMaskRegister);
+    size_t skipTrue = this->writeBranch(Inst::kBranchIfAllFalse, ByteCode::kMaskRegister);
+    if (!this->writeStatement(*i.fIfTrue)) {
+        return false;
+    }
+    this->patchBranch(skipTrue, fCode->size());
+    if (i.fIfFalse) {
+        this->writeUnary(Inst::kCopy, ByteCode::kMaskRegister, falseMask);
+        size_t skipFalse = this->writeBranch(Inst::kBranchIfAllFalse, ByteCode::kMaskRegister);
+        if (!this->writeStatement(*i.fIfFalse)) {
+            return false;
+        }
+        this->patchBranch(skipFalse, fCode->size());
+    }
+    this->writeUnary(Inst::kCopy, ByteCode::kMaskRegister, savedMask);
+    return true;
+}
+
+bool ByteCodeGenerator::writeLoop(const Statement* initializer, const Expression* test,
+                                  const Expression* next, const Statement& body, bool testFirst) {
+    if (!test) {
+        // without break, there would be no way out
+        fErrors.error(body.fOffset, "unsupported loop without a test");
+        return false;
+    }
+    if (initializer && !this->writeStatement(*initializer)) {
+        return false;
+    }
+    // Lanes drop out of the mask as their test fails; we keep going until none are left.
+    int savedMask = this->nextRegister();
+    this->writeUnary(Inst::kCopy, savedMask, ByteCode::kMaskRegister);
+    size_t loopStart = fCode->size();
+    auto writeTest = [&]() {
+        int start = fNextRegister;
+        Registers t;
+        if (!this->writeExpression(*test, &t)) {
+            return false;
+        }
+        this->writeBinary(Inst::kAnd, ByteCode::kMaskRegister, ByteCode::kMaskRegister, t[0]);
+        fNextRegister = start;
+        return true;
+    };
+    size_t exit = 0;
+    if (testFirst) {
+        if (!writeTest()) {
+            return false;
+        }
+        exit = this->writeBranch(Inst::kBranchIfAllFalse, ByteCode::kMaskRegister);
+    }
+    if (!this->writeStatement(body)) {
+        return false;
+    }
+    if (next) {
+        int start = fNextRegister;
+        Registers unused;
+        if (!this->writeExpression(*next, &unused)) {
+            return false;
+        }
+        fNextRegister = start;
+    }
+    if (!testFirst) {
+        if (!writeTest()) {
+            return false;
+        }
+        exit = this->writeBranch(Inst::kBranchIfAllFalse, ByteCode::kMaskRegister);
+    }
+    this->patchBranch(this->writeBranch(Inst::kBranch), loopStart);
+    this->patchBranch(exit, fCode->size());
+    this->writeUnary(Inst::kCopy, ByteCode::kMaskRegister, savedMask);
+    return true;
+}
+
+bool ByteCodeGenerator::writeBody(const FunctionDefinition& f, Registers* outReturn) {
+    const Block& body = (const Block&) *f.fBody;
+    int start = fNextRegister;
+    for (size_t i = 0; i < body.fStatements.size(); ++i) {
+        const Statement& s = *body.fStatements[i];
+        if (Statement::kReturn_Kind != s.fKind) {
+            if (!this->writeStatement(s)) {
+                return false;
+            }
+            continue;
+        }
+        if (i != body.fStatements.size() - 1) {
+            fErrors.error(s.fOffset, "unsupported early return");
+            return false;
+        }
+        const ReturnStatement& r = (const ReturnStatement&) s;
+        if (r.fExpression) {
+            Registers value;
+            if (!this->writeExpression(*r.fExpression, &value)) {
+                return false;
+            }
+            this->writeMaskedStore(*outReturn, this->broadcast(value, outReturn->size()));
+        }
+    }
+    fNextRegister = start;
+    return true;
+}
+
+}
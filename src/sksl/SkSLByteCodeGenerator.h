@@ -0,0 +1,153 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_BYTECODEGENERATOR
+#define SKSL_BYTECODEGENERATOR
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "SkSLByteCode.h"
+#include "SkSLCodeGenerator.h"
+#include "SkSLContext.h"
+#include "ir/SkSLBinaryExpression.h"
+#include "ir/SkSLBlock.h"
+#include "ir/SkSLConstructor.h"
+#include "ir/SkSLDoStatement.h"
+#include "ir/SkSLExpressionStatement.h"
+#include "ir/SkSLForStatement.h"
+#include "ir/SkSLFunctionCall.h"
+#include "ir/SkSLFunctionDefinition.h"
+#include "ir/SkSLIfStatement.h"
+#include "ir/SkSLPostfixExpression.h"
+#include "ir/SkSLPrefixExpression.h"
+#include "ir/SkSLReturnStatement.h"
+#include "ir/SkSLSwizzle.h"
+#include "ir/SkSLTernaryExpression.h"
+#include "ir/SkSLVarDeclarationsStatement.h"
+#include "ir/SkSLVariableReference.h"
+#include "ir/SkSLWhileStatement.h"
+
+namespace SkSL {
+
+/**
+ * Converts a Program into ByteCode. Each function definition becomes a ByteCode::Function, with
+ * calls to other user functions inlined. Only scalar and vector types of float, int and bool are
+ * supported; programs using anything else (matrices, arrays, globals, break / continue, early
+ * returns, ...) are rejected with an error, and the caller should fall back to another backend.
+ */
+class ByteCodeGenerator : public CodeGenerator {
+public:
+    ByteCodeGenerator(const Context* context, const Program* program, ErrorReporter* errors,
+                      ByteCode* output)
+    : INHERITED(program, errors, nullptr)
+    , fContext(*context)
+    , fOutput(output) {}
+
+    bool generateCode() override;
+
+private:
+    // The registers holding each component of a value, in order.
+    typedef std::vector<int> Registers;
+
+    enum class NumberKind {
+        kFloat,
+        kInt,
+        kBool,
+    };
+
+    std::unique_ptr<ByteCode::Function> writeFunction(const FunctionDefinition& f);
+
+    bool slotCount(const Type& type, int offset, int* outCount);
+
+    bool numberKind(const Type& type, int offset, NumberKind* outKind);
+
+    int nextRegister();
+
+    Registers nextRegisters(int count);
+
+    void write8(uint8_t b);
+
+    void write16(uint16_t b);
+
+    void write32(uint32_t b);
+
+    void writeInstruction(ByteCode::Instruction inst);
+
+    void writeUnary(ByteCode::Instruction inst, int dst, int src);
+
+    void writeBinary(ByteCode::Instruction inst, int dst, int left, int right);
+
+    void writeSelect(int dst, int test, int ifTrue, int ifFalse);
+
+    // Emits a branch with a placeholder target, returning the location to pass to patchBranch.
+    size_t writeBranch(ByteCode::Instruction inst, int src = -1);
+
+    void patchBranch(size_t location, size_t target);
+
+    // Copies src to dst in every lane live under the current execution mask.
+    void writeMaskedStore(const Registers& dst, const Registers& src);
+
+    // Returns the registers of a value as a vector of the given width, splatting scalars.
+    Registers broadcast(const Registers& regs, int count);
+
+    Registers convert(const Registers& regs, NumberKind from, NumberKind to);
+
+    bool writeLValue(const Expression& e, Registers* outRegisters);
+
+    bool writeExpression(const Expression& e, Registers* outRegisters);
+
+    bool writeBinaryExpression(const BinaryExpression& b, Registers* outRegisters);
+
+    bool writeConstructor(const Constructor& c, Registers* outRegisters);
+
+    bool writeFunctionCall(const FunctionCall& c, Registers* outRegisters);
+
+    bool writeIntrinsicCall(const FunctionCall& c, Registers* outRegisters);
+
+    bool writePrefixExpression(const PrefixExpression& p, Registers* outRegisters);
+
+    bool writePostfixExpression(const PostfixExpression& p, Registers* outRegisters);
+
+    bool writeTernaryExpression(const TernaryExpression& t, Registers* outRegisters);
+
+    bool writeStatement(const Statement& s);
+
+    bool writeBlock(const Block& b);
+
+    bool writeVarDeclarations(const VarDeclarations& decls);
+
+    bool writeIfStatement(const IfStatement& i);
+
+    // Handles for, while and do loops, all of which are represented by an optional initializer,
+    // test, and next expression around a body.
+    bool writeLoop(const Statement* initializer, const Expression* test, const Expression* next,
+                   const Statement& body, bool testFirst);
+
+    bool writeBody(const FunctionDefinition& f, Registers* outReturn);
+
+    const Context& fContext;
+
+    ByteCode* fOutput;
+
+    std::vector<uint8_t>* fCode = nullptr;
+
+    std::unordered_map<const Variable*, Registers> fVariables;
+
+    // Functions currently being inlined, used to reject recursion.
+    std::unordered_set<const FunctionDeclaration*> fInlining;
+
+    int fNextRegister = 0;
+
+    int fMaxRegister = 0;
+
+    typedef CodeGenerator INHERITED;
+};
+
+}
+
+#endif
@@ -6,7 +6,7 @@
  */
 
 #include "SkSLCompiler.h"
-
+#include "SkSLByteCodeGenerator.h"
 #include "SkSLCFGGenerator.h"
 #include "SkSLCPPCodeGenerator.h"
 #include "SkSLGLSLCodeGenerator.h"
@@ -27,6 +27,10 @@
 #include "ir/SkSLUnresolvedFunction.h"
 #include "ir/SkSLVarDeclarations.h"
 
+#ifndef SKSL_STANDALONE
+#include "SkOnce.h"
+#endif
+
 #ifdef SK_ENABLE_SPIRV_VALIDATION
 #include "spirv-tools/libspirv.hpp"
 #endif
@@ -62,150 +66,209 @@ static const char* SKSL_PIPELINE_STAGE_INCLUDE =
 
 namespace SkSL {
 
+namespace {
+
+/**
+ * Reports errors in the built-in declarations shared by every Compiler. These are never expected.
+ */
+class BuiltinErrorReporter : public ErrorReporter {
+public:
+    void error(int offset, String msg) override {
+        ABORT("error in built-in SkSL declarations: %s\n", msg.c_str());
+    }
+
+    int errorCount() override {
+        return 0;
+    }
+};
+
+} // namespace
+
+/**
+ * The built-in types, and the functions declared in sksl.inc, are the same for every Compiler.
+ * Converting sksl.inc is by far the most expensive part of creating a Compiler, so it is done once
+ * per process and the results are shared by every Compiler. Looking up a symbol never modifies
+ * these tables, so they may safely be used by Compilers on several threads at once.
+ */
+struct Compiler::Builtins {
+    std::shared_ptr<Context> fContext;
+    std::shared_ptr<SymbolTable> fTypes;
+    std::shared_ptr<SymbolTable> fSymbols;
+};
+
+const Compiler::Builtins& Compiler::GetBuiltins() {
+    static BuiltinErrorReporter* errors;
+    static Builtins* builtins;
+#ifdef SKSL_STANDALONE
+    if (!builtins) {
+#else
+    static SkOnce once;
+    once([] {
+#endif
+        errors = new BuiltinErrorReporter();
+        builtins = new Builtins();
+        builtins->fContext.reset(new Context());
+        builtins->fTypes.reset(new SymbolTable(errors));
+        builtins->fSymbols.reset(new SymbolTable(builtins->fTypes, errors));
+        const Context* context = builtins->fContext.get();
+        SymbolTable* types = builtins->fTypes.get();
+        #define ADD_TYPE(t) types->addWithoutOwnership(context->f ## t ## _Type->fName, \
+                                                       context->f ## t ## _Type.get())
+        ADD_TYPE(Void);
+        ADD_TYPE(Float);
+        ADD_TYPE(Float2);
+        ADD_TYPE(Float3);
+        ADD_TYPE(Float4);
+        ADD_TYPE(Half);
+        ADD_TYPE(Half2);
+        ADD_TYPE(Half3);
+        ADD_TYPE(Half4);
+        ADD_TYPE(Double);
+        ADD_TYPE(Double2);
+        ADD_TYPE(Double3);
+        ADD_TYPE(Double4);
+        ADD_TYPE(Int);
+        ADD_TYPE(Int2);
+        ADD_TYPE(Int3);
+        ADD_TYPE(Int4);
+        ADD_TYPE(UInt);
+        ADD_TYPE(UInt2);
+        ADD_TYPE(UInt3);
+        ADD_TYPE(UInt4);
+        ADD_TYPE(Short);
+        ADD_TYPE(Short2);
+        ADD_TYPE(Short3);
+        ADD_TYPE(Short4);
+        ADD_TYPE(UShort);
+        ADD_TYPE(UShort2);
+        ADD_TYPE(UShort3);
+        ADD_TYPE(UShort4);
+        ADD_TYPE(Byte);
+        ADD_TYPE(Byte2);
+        ADD_TYPE(Byte3);
+        ADD_TYPE(Byte4);
+        ADD_TYPE(UByte);
+        ADD_TYPE(UByte2);
+        ADD_TYPE(UByte3);
+        ADD_TYPE(UByte4);
+        ADD_TYPE(Bool);
+        ADD_TYPE(Bool2);
+        ADD_TYPE(Bool3);
+        ADD_TYPE(Bool4);
+        ADD_TYPE(Float2x2);
+        ADD_TYPE(Float2x3);
+        ADD_TYPE(Float2x4);
+        ADD_TYPE(Float3x2);
+        ADD_TYPE(Float3x3);
+        ADD_TYPE(Float3x4);
+        ADD_TYPE(Float4x2);
+        ADD_TYPE(Float4x3);
+        ADD_TYPE(Float4x4);
+        ADD_TYPE(Half2x2);
+        ADD_TYPE(Half2x3);
+        ADD_TYPE(Half2x4);
+        ADD_TYPE(Half3x2);
+        ADD_TYPE(Half3x3);
+        ADD_TYPE(Half3x4);
+        ADD_TYPE(Half4x2);
+        ADD_TYPE(Half4x3);
+        ADD_TYPE(Half4x4);
+        ADD_TYPE(Double2x2);
+        ADD_TYPE(Double2x3);
+        ADD_TYPE(Double2x4);
+        ADD_TYPE(Double3x2);
+        ADD_TYPE(Double3x3);
+        ADD_TYPE(Double3x4);
+        ADD_TYPE(Double4x2);
+        ADD_TYPE(Double4x3);
+        ADD_TYPE(Double4x4);
+        ADD_TYPE(GenType);
+        ADD_TYPE(GenHType);
+        ADD_TYPE(GenDType);
+        ADD_TYPE(GenIType);
+        ADD_TYPE(GenUType);
+        ADD_TYPE(GenBType);
+        ADD_TYPE(Mat);
+        ADD_TYPE(Vec);
+        ADD_TYPE(GVec);
+        ADD_TYPE(GVec2);
+        ADD_TYPE(GVec3);
+        ADD_TYPE(GVec4);
+        ADD_TYPE(HVec);
+        ADD_TYPE(DVec);
+        ADD_TYPE(IVec);
+        ADD_TYPE(UVec);
+        ADD_TYPE(SVec);
+        ADD_TYPE(USVec);
+        ADD_TYPE(ByteVec);
+        ADD_TYPE(UByteVec);
+        ADD_TYPE(BVec);
+
+        ADD_TYPE(Sampler1D);
+        ADD_TYPE(Sampler2D);
+        ADD_TYPE(Sampler3D);
+        ADD_TYPE(SamplerExternalOES);
+        ADD_TYPE(SamplerCube);
+        ADD_TYPE(Sampler2DRect);
+        ADD_TYPE(Sampler1DArray);
+        ADD_TYPE(Sampler2DArray);
+        ADD_TYPE(SamplerCubeArray);
+        ADD_TYPE(SamplerBuffer);
+        ADD_TYPE(Sampler2DMS);
+        ADD_TYPE(Sampler2DMSArray);
+
+        ADD_TYPE(ISampler2D);
+
+        ADD_TYPE(Image2D);
+        ADD_TYPE(IImage2D);
+
+        ADD_TYPE(SubpassInput);
+        ADD_TYPE(SubpassInputMS);
+
+        ADD_TYPE(GSampler1D);
+        ADD_TYPE(GSampler2D);
+        ADD_TYPE(GSampler3D);
+        ADD_TYPE(GSamplerCube);
+        ADD_TYPE(GSampler2DRect);
+        ADD_TYPE(GSampler1DArray);
+        ADD_TYPE(GSampler2DArray);
+        ADD_TYPE(GSamplerCubeArray);
+        ADD_TYPE(GSamplerBuffer);
+        ADD_TYPE(GSampler2DMS);
+        ADD_TYPE(GSampler2DMSArray);
+
+        ADD_TYPE(Sampler1DShadow);
+        ADD_TYPE(Sampler2DShadow);
+        ADD_TYPE(SamplerCubeShadow);
+        ADD_TYPE(Sampler2DRectShadow);
+        ADD_TYPE(Sampler1DArrayShadow);
+        ADD_TYPE(Sampler2DArrayShadow);
+        ADD_TYPE(SamplerCubeArrayShadow);
+        ADD_TYPE(GSampler2DArrayShadow);
+        ADD_TYPE(GSamplerCubeArrayShadow);
+        ADD_TYPE(FragmentProcessor);
+        ADD_TYPE(SkRasterPipeline);
+        #undef ADD_TYPE
+
+        IRGenerator irGenerator(context, builtins->fSymbols, *errors);
+        irGenerator.fTypeTable = builtins->fTypes;
+        std::vector<std::unique_ptr<ProgramElement>> ignored;
+        irGenerator.convertProgram(Program::kFragment_Kind, SKSL_INCLUDE, strlen(SKSL_INCLUDE),
+                                   &ignored);
+        builtins->fSymbols->markAllFunctionsBuiltin();
+    }
+#ifndef SKSL_STANDALONE
+    );
+#endif
+    return *builtins;
+}
+
 Compiler::Compiler(Flags flags)
 : fFlags(flags)
-, fContext(new Context())
+, fContext(GetBuiltins().fContext)
 , fErrorCount(0) {
-    auto types = std::shared_ptr<SymbolTable>(new SymbolTable(this));
-    auto symbols = std::shared_ptr<SymbolTable>(new SymbolTable(types, this));
+    auto symbols = std::shared_ptr<SymbolTable>(new SymbolTable(GetBuiltins().fSymbols, this));
     fIRGenerator = new IRGenerator(fContext.get(), symbols, *this);
-    fTypes = types;
-    #define ADD_TYPE(t) types->addWithoutOwnership(fContext->f ## t ## _Type->fName, \
-                                                   fContext->f ## t ## _Type.get())
-    ADD_TYPE(Void);
-    ADD_TYPE(Float);
-    ADD_TYPE(Float2);
-    ADD_TYPE(Float3);
-    ADD_TYPE(Float4);
-    ADD_TYPE(Half);
-    ADD_TYPE(Half2);
-    ADD_TYPE(Half3);
-    ADD_TYPE(Half4);
-    ADD_TYPE(Double);
-    ADD_TYPE(Double2);
-    ADD_TYPE(Double3);
-    ADD_TYPE(Double4);
-    ADD_TYPE(Int);
-    ADD_TYPE(Int2);
-    ADD_TYPE(Int3);
-    ADD_TYPE(Int4);
-    ADD_TYPE(UInt);
-    ADD_TYPE(UInt2);
-    ADD_TYPE(UInt3);
-    ADD_TYPE(UInt4);
-    ADD_TYPE(Short);
-    ADD_TYPE(Short2);
-    ADD_TYPE(Short3);
-    ADD_TYPE(Short4);
-    ADD_TYPE(UShort);
-    ADD_TYPE(UShort2);
-    ADD_TYPE(UShort3);
-    ADD_TYPE(UShort4);
-    ADD_TYPE(Byte);
-    ADD_TYPE(Byte2);
-    ADD_TYPE(Byte3);
-    ADD_TYPE(Byte4);
-    ADD_TYPE(UByte);
-    ADD_TYPE(UByte2);
-    ADD_TYPE(UByte3);
-    ADD_TYPE(UByte4);
-    ADD_TYPE(Bool);
-    ADD_TYPE(Bool2);
-    ADD_TYPE(Bool3);
-    ADD_TYPE(Bool4);
-    ADD_TYPE(Float2x2);
-    ADD_TYPE(Float2x3);
-    ADD_TYPE(Float2x4);
-    ADD_TYPE(Float3x2);
-    ADD_TYPE(Float3x3);
-    ADD_TYPE(Float3x4);
-    ADD_TYPE(Float4x2);
-    ADD_TYPE(Float4x3);
-    ADD_TYPE(Float4x4);
-    ADD_TYPE(Half2x2);
-    ADD_TYPE(Half2x3);
-    ADD_TYPE(Half2x4);
-    ADD_TYPE(Half3x2);
-    ADD_TYPE(Half3x3);
-    ADD_TYPE(Half3x4);
-    ADD_TYPE(Half4x2);
-    ADD_TYPE(Half4x3);
-    ADD_TYPE(Half4x4);
-    ADD_TYPE(Double2x2);
-    ADD_TYPE(Double2x3);
-    ADD_TYPE(Double2x4);
-    ADD_TYPE(Double3x2);
-    ADD_TYPE(Double3x3);
-    ADD_TYPE(Double3x4);
-    ADD_TYPE(Double4x2);
-    ADD_TYPE(Double4x3);
-    ADD_TYPE(Double4x4);
-    ADD_TYPE(GenType);
-    ADD_TYPE(GenHType);
-    ADD_TYPE(GenDType);
-    ADD_TYPE(GenIType);
-    ADD_TYPE(GenUType);
-    ADD_TYPE(GenBType);
-    ADD_TYPE(Mat);
-    ADD_TYPE(Vec);
-    ADD_TYPE(GVec);
-    ADD_TYPE(GVec2);
-    ADD_TYPE(GVec3);
-    ADD_TYPE(GVec4);
-    ADD_TYPE(HVec);
-    ADD_TYPE(DVec);
-    ADD_TYPE(IVec);
-    ADD_TYPE(UVec);
-    ADD_TYPE(SVec);
-    ADD_TYPE(USVec);
-    ADD_TYPE(ByteVec);
-    ADD_TYPE(UByteVec);
-    ADD_TYPE(BVec);
-
-    ADD_TYPE(Sampler1D);
-    ADD_TYPE(Sampler2D);
-    ADD_TYPE(Sampler3D);
-    ADD_TYPE(SamplerExternalOES);
-    ADD_TYPE(SamplerCube);
-    ADD_TYPE(Sampler2DRect);
-    ADD_TYPE(Sampler1DArray);
-    ADD_TYPE(Sampler2DArray);
-    ADD_TYPE(SamplerCubeArray);
-    ADD_TYPE(SamplerBuffer);
-    ADD_TYPE(Sampler2DMS);
-    ADD_TYPE(Sampler2DMSArray);
-
-    ADD_TYPE(ISampler2D);
-
-    ADD_TYPE(Image2D);
-    ADD_TYPE(IImage2D);
-
-    ADD_TYPE(SubpassInput);
-    ADD_TYPE(SubpassInputMS);
-
-    ADD_TYPE(GSampler1D);
-    ADD_TYPE(GSampler2D);
-    ADD_TYPE(GSampler3D);
-    ADD_TYPE(GSamplerCube);
-    ADD_TYPE(GSampler2DRect);
-    ADD_TYPE(GSampler1DArray);
-    ADD_TYPE(GSampler2DArray);
-    ADD_TYPE(GSamplerCubeArray);
-    ADD_TYPE(GSamplerBuffer);
-    ADD_TYPE(GSampler2DMS);
-    ADD_TYPE(GSampler2DMSArray);
-
-    ADD_TYPE(Sampler1DShadow);
-    ADD_TYPE(Sampler2DShadow);
-    ADD_TYPE(SamplerCubeShadow);
-    ADD_TYPE(Sampler2DRectShadow);
-    ADD_TYPE(Sampler1DArrayShadow);
-    ADD_TYPE(Sampler2DArrayShadow);
-    ADD_TYPE(SamplerCubeArrayShadow);
-    ADD_TYPE(GSampler2DArrayShadow);
-    ADD_TYPE(GSamplerCubeArrayShadow);
-    ADD_TYPE(FragmentProcessor);
-    ADD_TYPE(SkRasterPipeline);
 
     StringFragment skCapsName("sk_Caps");
     Variable* skCaps = new Variable(-1, Modifiers(), skCapsName,
@@ -216,34 +279,6 @@ Compiler::Compiler(Flags flags)
     Variable* skArgs = new Variable(-1, Modifiers(), skArgsName,
                                     *fContext->fSkArgs_Type, Variable::kGlobal_Storage);
     fIRGenerator->fSymbolTable->add(skArgsName, std::unique_ptr<Symbol>(skArgs));
-
-    std::vector<std::unique_ptr<ProgramElement>> ignored;
-    fIRGenerator->convertProgram(Program::kFragment_Kind, SKSL_INCLUDE, strlen(SKSL_INCLUDE),
-                                 *fTypes, &ignored);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    if (fErrorCount) {
-        printf("Unexpected errors: %s\n", fErrorText.c_str());
-    }
-    SkASSERT(!fErrorCount);
-
-    Program::Settings settings;
-    fIRGenerator->start(&settings, nullptr);
-    fIRGenerator->convertProgram(Program::kFragment_Kind, SKSL_VERT_INCLUDE,
-                                 strlen(SKSL_VERT_INCLUDE), *fTypes, &fVertexInclude);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    fVertexSymbolTable = fIRGenerator->fSymbolTable;
-
-    fIRGenerator->start(&settings, nullptr);
-    fIRGenerator->convertProgram(Program::kVertex_Kind, SKSL_FRAG_INCLUDE,
-                                 strlen(SKSL_FRAG_INCLUDE), *fTypes, &fFragmentInclude);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    fFragmentSymbolTable = fIRGenerator->fSymbolTable;
-
-    fIRGenerator->start(&settings, nullptr);
-    fIRGenerator->convertProgram(Program::kGeometry_Kind, SKSL_GEOM_INCLUDE,
-                                 strlen(SKSL_GEOM_INCLUDE), *fTypes, &fGeometryInclude);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    fGeometrySymbolTable = fIRGenerator->fSymbolTable;
 }
 
 Compiler::~Compiler() {
@@ -1231,51 +1266,51 @@ void Compiler::scanCFG(FunctionDefinition& f) {
     }
 }
 
+Compiler::Include& Compiler::include(Program::Kind kind) {
+    std::unique_ptr<Include>& include = fIncludes[kind];
+    if (!include) {
+        const char* text;
+        switch (kind) {
+            case Program::kVertex_Kind:            text = SKSL_VERT_INCLUDE;           break;
+            case Program::kFragment_Kind:          text = SKSL_FRAG_INCLUDE;           break;
+            case Program::kGeometry_Kind:          text = SKSL_GEOM_INCLUDE;           break;
+            case Program::kFragmentProcessor_Kind: text = SKSL_FP_INCLUDE;             break;
+            case Program::kPipelineStage_Kind:     text = SKSL_PIPELINE_STAGE_INCLUDE; break;
+        }
+        include.reset(new Include());
+        Program::Settings settings;
+        fIRGenerator->fSymbolTable = fIRGenerator->fRootSymbolTable;
+        fIRGenerator->start(&settings, nullptr);
+        fIRGenerator->convertProgram(kind, text, strlen(text), &include->fElements);
+        fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
+        for (auto& element : include->fElements) {
+            if (element->fKind == ProgramElement::kEnum_Kind) {
+                ((Enum&) *element).fBuiltin = true;
+            }
+        }
+        include->fSymbols = fIRGenerator->fSymbolTable;
+        if (fErrorCount) {
+            printf("Unexpected errors: %s\n", fErrorText.c_str());
+        }
+        SkASSERT(!fErrorCount);
+    }
+    return *include;
+}
+
 std::unique_ptr<Program> Compiler::convertProgram(Program::Kind kind, String text,
                                                   const Program::Settings& settings) {
     fErrorText = "";
     fErrorCount = 0;
-    std::vector<std::unique_ptr<ProgramElement>>* inherited;
+    // Each program gets its own symbol tables, so that the types and functions it declares do not
+    // leak into the next program compiled with this Compiler.
+    Include& include = this->include(kind);
+    std::vector<std::unique_ptr<ProgramElement>>* inherited = &include.fElements;
     std::vector<std::unique_ptr<ProgramElement>> elements;
-    switch (kind) {
-        case Program::kVertex_Kind:
-            inherited = &fVertexInclude;
-            fIRGenerator->fSymbolTable = fVertexSymbolTable;
-            fIRGenerator->start(&settings, inherited);
-            break;
-        case Program::kFragment_Kind:
-            inherited = &fFragmentInclude;
-            fIRGenerator->fSymbolTable = fFragmentSymbolTable;
-            fIRGenerator->start(&settings, inherited);
-            break;
-        case Program::kGeometry_Kind:
-            inherited = &fGeometryInclude;
-            fIRGenerator->fSymbolTable = fGeometrySymbolTable;
-            fIRGenerator->start(&settings, inherited);
-            break;
-        case Program::kFragmentProcessor_Kind:
-            inherited = nullptr;
-            fIRGenerator->start(&settings, nullptr);
-            fIRGenerator->convertProgram(kind, SKSL_FP_INCLUDE, strlen(SKSL_FP_INCLUDE), *fTypes,
-                                         &elements);
-            fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-            break;
-        case Program::kPipelineStage_Kind:
-            inherited = nullptr;
-            fIRGenerator->start(&settings, nullptr);
-            fIRGenerator->convertProgram(kind, SKSL_PIPELINE_STAGE_INCLUDE,
-                                         strlen(SKSL_PIPELINE_STAGE_INCLUDE), *fTypes, &elements);
-            fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-            break;
-    }
-    for (auto& element : elements) {
-        if (element->fKind == ProgramElement::kEnum_Kind) {
-            ((Enum&) *element).fBuiltin = true;
-        }
-    }
+    fIRGenerator->fSymbolTable = include.fSymbols;
+    fIRGenerator->start(&settings, inherited);
     std::unique_ptr<String> textPtr(new String(std::move(text)));
     fSource = textPtr.get();
-    fIRGenerator->convertProgram(kind, textPtr->c_str(), textPtr->size(), *fTypes, &elements);
+    fIRGenerator->convertProgram(kind, textPtr->c_str(), textPtr->size(), &elements);
     auto result = std::unique_ptr<Program>(new Program(kind,
                                                        std::move(textPtr),
                                                        settings,
@@ -1447,6 +1482,21 @@ bool Compiler::toPipelineStage(const Program& program, String* out,
     return result;
 }
 
+std::unique_ptr<ByteCode> Compiler::toByteCode(Program& program) {
+    if (!this->optimize(program)) {
+        return nullptr;
+    }
+    fSource = program.fSource.get();
+    std::unique_ptr<ByteCode> result(new ByteCode());
+    ByteCodeGenerator cg(fContext.get(), &program, this, result.get());
+    bool success = cg.generateCode();
+    fSource = nullptr;
+    if (!success) {
+        return nullptr;
+    }
+    return result;
+}
+
 const char* Compiler::OperatorName(Token::Kind kind) {
     switch (kind) {
         case Token::PLUS:         return "+";
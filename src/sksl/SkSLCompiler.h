@@ -40,6 +40,7 @@
 
 namespace SkSL {
 
+struct ByteCode;
 class IRGenerator;
 
 /**
@@ -114,6 +115,12 @@ public:
     bool toPipelineStage(const Program& program, String* out,
                          std::vector<FormatArg>* outFormatArgs);
 
+    /**
+     * Compiles the program's functions to ByteCode, for execution on the CPU. Returns null (and
+     * reports errors) if the program uses features the ByteCode does not support.
+     */
+    std::unique_ptr<ByteCode> toByteCode(Program& program);
+
     void error(int offset, String msg) override;
 
     String errorText();
@@ -168,14 +175,30 @@ private:
 
     Position position(int offset);
 
-    std::vector<std::unique_ptr<ProgramElement>> fVertexInclude;
-    std::shared_ptr<SymbolTable> fVertexSymbolTable;
-    std::vector<std::unique_ptr<ProgramElement>> fFragmentInclude;
-    std::shared_ptr<SymbolTable> fFragmentSymbolTable;
-    std::vector<std::unique_ptr<ProgramElement>> fGeometryInclude;
-    std::shared_ptr<SymbolTable> fGeometrySymbolTable;
+    struct Builtins;
+
+    /**
+     * Returns the built-in types and functions shared by every Compiler.
+     */
+    static const Builtins& GetBuiltins();
+
+    /**
+     * The built-in declarations specific to one kind of program (sksl_frag.inc, sksl_fp.inc, ...).
+     */
+    struct Include {
+        std::vector<std::unique_ptr<ProgramElement>> fElements;
+        std::shared_ptr<SymbolTable> fSymbols;
+    };
+
+    /**
+     * Returns the built-in declarations for the given kind of program, converting them the first
+     * time a program of that kind is compiled.
+     */
+    Include& include(Program::Kind kind);
+
+    // indexed by Program::Kind
+    std::unique_ptr<Include> fIncludes[Program::kPipelineStage_Kind + 1];
 
-    std::shared_ptr<SymbolTable> fTypes;
     IRGenerator* fIRGenerator;
     int fFlags;
 
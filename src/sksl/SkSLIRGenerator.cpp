@@ -155,11 +155,14 @@ void IRGenerator::start(const Program::Settings* settings,
                                        Program::Settings::Value(true)));
     }
     this->pushSymbolTable();
+    fTypeTable = fSymbolTable;
+    this->pushSymbolTable();
     fInvocations = -1;
     fInputs.reset();
     fSkPerVertex = nullptr;
     fRTAdjust = nullptr;
     fRTAdjustInterfaceBlock = nullptr;
+    fInherited = inherited;
     if (inherited) {
         for (const auto& e : *inherited) {
             if (e->fKind == ProgramElement::kInterfaceBlock_Kind) {
@@ -751,6 +754,11 @@ void IRGenerator::convertFunction(const ASTFunction& f) {
                         fErrors.error(f.fOffset, "duplicate definition of " +
                                                  other->description());
                     }
+                    if (other->fBuiltin && f.fBody) {
+                        // built-in declarations are shared with other programs and Compilers, so
+                        // a definition of one gets a declaration of its own
+                        decl = nullptr;
+                    }
                     break;
                 }
             }
@@ -1998,12 +2006,18 @@ std::unique_ptr<Expression> IRGenerator::getArg(int offset, String name) const {
 std::unique_ptr<Expression> IRGenerator::convertTypeField(int offset, const Type& type,
                                                           StringFragment field) {
     std::unique_ptr<Expression> result;
-    for (const auto& e : *fProgramElements) {
-        if (e->fKind == ProgramElement::kEnum_Kind && type.name() == ((Enum&) *e).fTypeName) {
-            std::shared_ptr<SymbolTable> old = fSymbolTable;
-            fSymbolTable = ((Enum&) *e).fSymbols;
-            result = convertIdentifier(ASTIdentifier(offset, field));
-            fSymbolTable = old;
+    // built-in enums, such as those of sksl_enums.inc, live in the inherited elements
+    for (const auto* elements : { fInherited, fProgramElements }) {
+        if (!elements) {
+            continue;
+        }
+        for (const auto& e : *elements) {
+            if (e->fKind == ProgramElement::kEnum_Kind && type.name() == ((Enum&) *e).fTypeName) {
+                std::shared_ptr<SymbolTable> old = fSymbolTable;
+                fSymbolTable = ((Enum&) *e).fSymbols;
+                result = convertIdentifier(ASTIdentifier(offset, field));
+                fSymbolTable = old;
+            }
         }
     }
     if (!result) {
@@ -2251,11 +2265,10 @@ void IRGenerator::setRefKind(const Expression& expr, VariableReference::RefKind
 void IRGenerator::convertProgram(Program::Kind kind,
                                  const char* text,
                                  size_t length,
-                                 SymbolTable& types,
                                  std::vector<std::unique_ptr<ProgramElement>>* out) {
     fKind = kind;
     fProgramElements = out;
-    Parser parser(text, length, types, fErrors);
+    Parser parser(text, length, *fTypeTable, fErrors);
     std::vector<std::unique_ptr<ASTDeclaration>> parsed = parser.file();
     if (fErrors.errorCount()) {
         return;
@@ -63,10 +63,13 @@ public:
     IRGenerator(const Context* context, std::shared_ptr<SymbolTable> root,
                 ErrorReporter& errorReporter);
 
+    /**
+     * Converts the program's declarations into IR, appending them to result. Struct and enum types
+     * which the program declares are added to the table created for them by start().
+     */
     void convertProgram(Program::Kind kind,
                         const char* text,
                         size_t length,
-                        SymbolTable& types,
                         std::vector<std::unique_ptr<ProgramElement>>* result);
 
     /**
@@ -87,8 +90,8 @@ public:
 
 private:
     /**
-     * Prepare to compile a program. Resets state, pushes a new symbol table, and installs the
-     * settings.
+     * Prepare to compile a program. Resets state, pushes new tables for the program's types and
+     * symbols, and installs the settings.
      */
     void start(const Program::Settings* settings,
                std::vector<std::unique_ptr<ProgramElement>>* inherited);
@@ -176,6 +179,8 @@ private:
     std::unordered_map<String, Program::Settings::Value> fCapsMap;
     std::shared_ptr<SymbolTable> fRootSymbolTable;
     std::shared_ptr<SymbolTable> fSymbolTable;
+    // holds the types declared by the current program; the parent of its outermost symbol table
+    std::shared_ptr<SymbolTable> fTypeTable;
     // holds extra temp variable declarations needed for the current function
     std::vector<std::unique_ptr<Statement>> fExtraVars;
     int fLoopLevel;
@@ -185,6 +190,8 @@ private:
     ErrorReporter& fErrors;
     int fInvocations;
     std::vector<std::unique_ptr<ProgramElement>>* fProgramElements;
+    // the built-in elements the current program inherits, or null
+    std::vector<std::unique_ptr<ProgramElement>>* fInherited = nullptr;
     const Variable* fSkPerVertex = nullptr;
     Variable* fRTAdjust;
     Variable* fRTAdjustInterfaceBlock;
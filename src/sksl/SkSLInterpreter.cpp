@@ -56,6 +56,7 @@ void Interpreter::run(const FunctionDefinition& f) {
     while (fCurrentIndex.size()) {
         this->runStatement();
     }
+    fVars.pop_back();
 }
 
 void Interpreter::push(Value value) {
@@ -232,15 +233,16 @@ static void do_callback(SkJumper_CallbackCtx* raw, int activePixels) {
 }
 
 void Interpreter::appendStage(const AppendStage& a) {
+    // fArguments[0] is the pipeline itself; the stage's own arguments follow it.
     switch (a.fStage) {
         case SkRasterPipeline::matrix_4x5: {
-            SkASSERT(a.fArguments.size() == 1);
-            StackIndex transpose = evaluate(*a.fArguments[0]).fInt;
+            SkASSERT(a.fArguments.size() == 2);
+            StackIndex transpose = evaluate(*a.fArguments[1]).fInt;
             fPipeline.append(SkRasterPipeline::matrix_4x5, &fStack[transpose]);
             break;
         }
         case SkRasterPipeline::callback: {
-            SkASSERT(a.fArguments.size() == 1);
+            SkASSERT(a.fArguments.size() == 2);
             CallbackCtx* ctx = new CallbackCtx();
             ctx->fInterpreter = this;
             ctx->fn = do_callback;
@@ -248,7 +250,7 @@ void Interpreter::appendStage(const AppendStage& a) {
                 if (ProgramElement::kFunction_Kind == e.fKind) {
                     const FunctionDefinition& f = (const FunctionDefinition&) e;
                     if (&f.fDeclaration ==
-                                      ((const FunctionReference&) *a.fArguments[0]).fFunctions[0]) {
+                                      ((const FunctionReference&) *a.fArguments[1]).fFunctions[0]) {
                         ctx->fFunction = &f;
                     }
                 }
@@ -239,7 +239,8 @@ void Parser::error(int offset, String msg) {
 }
 
 bool Parser::isType(StringFragment name) {
-    return nullptr != fTypes[name];
+    const Symbol* symbol = fTypes[name];
+    return symbol && symbol->fKind == Symbol::kType_Kind;
 }
 
 /* DIRECTIVE(#version) INT_LITERAL ("es" | "compatibility")? |
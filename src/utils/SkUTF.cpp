@@ -4,6 +4,7 @@
 #include "SkUTF.h"
 
 #include <climits>
+#include <cstring>
 
 static constexpr inline int32_t left_shift(int32_t value, int32_t shift) {
     return (int32_t) ((uint32_t) value << shift);
@@ -206,6 +207,75 @@ SkUnichar SkUTF::NextUTF32(const int32_t** ptr, const int32_t* end) {
     return value;
 }
 
+// The blocks of eight below are only read when at least eight more codepoints are wanted. Every
+// codepoint takes at least one code unit, so a caller which knows how many codepoints it has, but
+// not exactly where they end, can't have the block read past them.
+static constexpr int kBlock = 8;
+
+int SkUTF::UTF8ToUTF32(const char** ptr, const char* end, SkUnichar dst[], int count) {
+    if (!ptr || !*ptr || !end) {
+        return 0;
+    }
+    const char* p = *ptr;
+    int n = 0;
+    while (n < count && p < end) {
+        if (count - n >= kBlock && end - p >= kBlock && (uint8_t)*p < 0x80) {
+            uint64_t block;
+            memcpy(&block, p, sizeof(block));
+            if (0 == (block & 0x8080808080808080ull)) {
+                for (int i = 0; i < kBlock; ++i) {
+                    dst[n + i] = (uint8_t)p[i];
+                }
+                n += kBlock;
+                p += kBlock;
+                continue;
+            }
+        }
+        const char* next = p;
+        SkUnichar c = NextUTF8(&next, end);
+        if (c < 0) {
+            break;
+        }
+        dst[n++] = c;
+        p = next;
+    }
+    *ptr = p;
+    return n;
+}
+
+int SkUTF::UTF16ToUTF32(const uint16_t** ptr, const uint16_t* end, SkUnichar dst[], int count) {
+    if (!ptr || !*ptr || !end || !is_align2(intptr_t(*ptr))) {
+        return 0;
+    }
+    const uint16_t* p = *ptr;
+    int n = 0;
+    while (n < count && p < end) {
+        if (count - n >= kBlock && end - p >= kBlock) {
+            bool hasSurrogate = false;
+            for (int i = 0; i < kBlock; ++i) {
+                hasSurrogate |= (p[i] & 0xF800) == 0xD800;
+            }
+            if (!hasSurrogate) {
+                for (int i = 0; i < kBlock; ++i) {
+                    dst[n + i] = p[i];
+                }
+                n += kBlock;
+                p += kBlock;
+                continue;
+            }
+        }
+        const uint16_t* next = p;
+        SkUnichar c = NextUTF16(&next, end);
+        if (c < 0) {
+            break;
+        }
+        dst[n++] = c;
+        p = next;
+    }
+    *ptr = p;
+    return n;
+}
+
 size_t SkUTF::ToUTF8(SkUnichar uni, char utf8[SkUTF::kMaxBytesInUTF8Sequence]) {
     if ((uint32_t)uni > 0x10FFFF) {
         return 0;
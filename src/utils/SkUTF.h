@@ -47,6 +47,22 @@ SkUnichar NextUTF16(const uint16_t** ptr, const uint16_t* end);
 */
 SkUnichar NextUTF32(const int32_t** ptr, const int32_t* end);
 
+/** Given a sequence of UTF-8 bytes, decode at most `count` unicode codepoints
+    into `dst`.  The pointer will be incremented to point past the last decoded
+    codepoint.  Return the number of codepoints decoded, which is less than
+    `count` only if end is reached or invalid UTF-8 is encountered; in the
+    latter case *ptr is left pointing at the invalid sequence.  Runs of ASCII
+    are decoded eight bytes at a time, so this is much faster than NextUTF8()
+    for mostly Latin text.
+*/
+int UTF8ToUTF32(const char** ptr, const char* end, SkUnichar dst[], int count);
+
+/** Given a sequence of aligned UTF-16 characters in machine-endian form,
+    decode at most `count` unicode codepoints into `dst`, as UTF8ToUTF32() does.
+    Runs without surrogates are decoded eight code units at a time.
+*/
+int UTF16ToUTF32(const uint16_t** ptr, const uint16_t* end, SkUnichar dst[], int count);
+
 constexpr unsigned kMaxBytesInUTF8Sequence = 4;
 
 /** Convert the unicode codepoint into UTF-8.  If `utf8` is non-null, place the
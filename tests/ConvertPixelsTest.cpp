@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAutoPixmapStorage.h"
+#include "SkColorSpace.h"
+#include "SkConvertPixels.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+// Converting a batch of pixmaps must match converting each of them on its own.
+DEF_TEST(ConvertPixmaps, r) {
+    auto srgb = SkColorSpace::MakeSRGB(),
+         p3   = SkColorSpace::MakeRGB(SkColorSpace::kSRGB_RenderTargetGamma,
+                                      SkColorSpace::kDCIP3_D65_Gamut),
+         lin  = srgb->makeLinearGamma();
+
+    const struct {
+        SkColorType         srcCT, dstCT;
+        SkAlphaType         srcAT, dstAT;
+        sk_sp<SkColorSpace> srcCS, dstCS;
+    } formats[] = {
+        { kRGBA_8888_SkColorType, kRGBA_8888_SkColorType, kPremul_SkAlphaType,
+          kPremul_SkAlphaType, srgb, p3 },
+        { kRGBA_8888_SkColorType, kRGBA_8888_SkColorType, kPremul_SkAlphaType,
+          kPremul_SkAlphaType, srgb, srgb },  // The memcpy() fast path.
+        { kBGRA_8888_SkColorType, kRGBA_F16_SkColorType, kUnpremul_SkAlphaType,
+          kPremul_SkAlphaType, p3, lin },
+        { kRGBA_8888_SkColorType, kRGB_565_SkColorType, kOpaque_SkAlphaType,
+          kOpaque_SkAlphaType, srgb, p3 },
+    };
+
+    // Runs of pixmaps with the same formats, then with formats changing from one to the next.
+    const int kCount = 24;
+    int formatIndices[kCount];
+    for (int i = 0; i < kCount; i++) {
+        formatIndices[i] = i < kCount/2 ? i / 3 % SK_ARRAY_COUNT(formats)
+                                        : i % SK_ARRAY_COUNT(formats);
+    }
+
+    SkRandom rand;
+    SkAutoPixmapStorage src[kCount], dst[kCount], expected[kCount];
+    for (int i = 0; i < kCount; i++) {
+        const auto& format = formats[formatIndices[i]];
+        int w = 1 + rand.nextULessThan(20),
+            h = 1 + rand.nextULessThan(20);
+        src[i].alloc(SkImageInfo::Make(w, h, format.srcCT, format.srcAT, format.srcCS));
+        dst[i].alloc(SkImageInfo::Make(w, h, format.dstCT, format.dstAT, format.dstCS));
+        expected[i].alloc(dst[i].info());
+
+        for (int y = 0; y < h; y++) {
+            uint32_t* row = src[i].writable_addr32(0, y);
+            for (int x = 0; x < w; x++) {
+                SkColor c = rand.nextU();
+                if (format.srcAT == kOpaque_SkAlphaType) {
+                    c = SkColorSetA(c, 0xFF);
+                }
+                // Both 8888 color types keep alpha in the top byte, so this is premul for either.
+                row[x] = format.srcAT == kPremul_SkAlphaType ? SkPreMultiplyColor(c) : c;
+            }
+        }
+        SkConvertPixels(expected[i].info(), expected[i].writable_addr(), expected[i].rowBytes(),
+                        src[i].info(), src[i].addr(), src[i].rowBytes());
+    }
+
+    SkPixmap srcPixmaps[kCount], dstPixmaps[kCount];
+    for (int i = 0; i < kCount; i++) {
+        srcPixmaps[i] = src[i];
+        dstPixmaps[i] = dst[i];
+    }
+    SkConvertPixmaps(dstPixmaps, srcPixmaps, kCount);
+
+    for (int i = 0; i < kCount; i++) {
+        bool matches = true;
+        for (int y = 0; y < dst[i].height(); y++) {
+            matches &= 0 == memcmp(dst[i].addr(0, y), expected[i].addr(0, y),
+                                   dst[i].info().minRowBytes());
+        }
+        REPORTER_ASSERT(r, matches, "pixmap %d", i);
+    }
+}
@@ -8,6 +8,7 @@
 #include "SkAlphaThresholdFilter.h"
 #include "SkImage.h"
 #include "SkRegion.h"
+#include "SkSDFMaskFilter.h"
 #include "Test.h"
 
 static void test_flattenable(skiatest::Reporter* r,
@@ -38,4 +39,9 @@ DEF_TEST(FlattenableFactoryToName, r) {
     bm.eraseColor(SK_ColorCYAN);
     sk_sp<SkImage> image(SkImage::MakeFromBitmap(bm));
     test_flattenable(r, image->makeShader().get(), "SkImage::newShader()");
+
+    // The SDF mask filter keeps the serialized name it had as GrSDFMaskFilterImpl.
+    sk_sp<SkMaskFilter> sdf(SkSDFMaskFilter::Make());
+    test_flattenable(r, sdf.get(), "SkSDFMaskFilter::Make()");
+    REPORTER_ASSERT(r, !strcmp(sdf->getTypeName(), "GrSDFMaskFilterImpl"));
 }
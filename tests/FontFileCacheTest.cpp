@@ -0,0 +1,56 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkData.h"
+#include "SkFontFileCache.h"
+#include "SkOSPath.h"
+#include "SkStream.h"
+#include "Test.h"
+
+static bool write_file(skiatest::Reporter* reporter, const SkString& path, const char text[]) {
+    SkFILEWStream writer(path.c_str());
+    if (!writer.isValid()) {
+        ERRORF(reporter, "Failed to create tmp file %s\n", path.c_str());
+        return false;
+    }
+    return writer.write(text, strlen(text));
+}
+
+DEF_TEST(FontFileCache, reporter) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+    SkString path = SkOSPath::Join(tmpDir.c_str(), "font_file_cache_test");
+    if (!write_file(reporter, path, "abcdefghijklmnopqrstuvwxyz")) {
+        return;
+    }
+
+    // Every user of the file shares the same contents.
+    sk_sp<SkData> data = SkFontFileCache::Find(path.c_str());
+    REPORTER_ASSERT(reporter, data && data->size() == 26);
+    if (!data) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, SkFontFileCache::Find(path.c_str()) == data);
+    std::unique_ptr<SkStreamAsset> stream = SkFontFileCache::OpenStream(path.c_str());
+    REPORTER_ASSERT(reporter, stream && stream->getMemoryBase() == data->data());
+    REPORTER_ASSERT(reporter, SkFontFileCache::GetMappedBytes() + SkFontFileCache::GetHeapBytes()
+                              >= data->size());
+
+    // A changed file is read again, without affecting the existing users.
+    if (!write_file(reporter, path, "0123456789")) {
+        return;
+    }
+    sk_sp<SkData> changed = SkFontFileCache::Find(path.c_str());
+    REPORTER_ASSERT(reporter, changed && changed->size() == 10 && changed != data);
+    REPORTER_ASSERT(reporter, data->size() == 26 && stream->getLength() == 26);
+    REPORTER_ASSERT(reporter, changed && !memcmp(changed->data(), "0123456789", 10));
+
+    REPORTER_ASSERT(reporter, !SkFontFileCache::Find(
+            SkOSPath::Join(tmpDir.c_str(), "font_file_cache_test_missing").c_str()));
+}
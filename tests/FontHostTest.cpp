@@ -7,12 +7,20 @@
 
 #include "Resources.h"
 #include "SkAutoMalloc.h"
+#include "SkCanvas.h"
 #include "SkEndian.h"
 #include "SkFontStream.h"
+#include "SkGlyphCache.h"
+#include "SkGraphics.h"
+#include "SkImage.h"
 #include "SkOSFile.h"
 #include "SkPaint.h"
 #include "SkStream.h"
+#include "SkStrikeCache.h"
+#include "SkSurface.h"
+#include "SkTDArray.h"
 #include "SkTypeface.h"
+#include "SkUTF.h"
 #include "Test.h"
 
 //#define DUMP_TABLES
@@ -112,6 +120,64 @@ static void test_charsToGlyphs(skiatest::Reporter* reporter, const sk_sp<SkTypef
     }
 }
 
+// Once a typeface has mapped enough characters it maps them through a table built from its cmap.
+// The table must map every character the same as asking the typeface one batch at a time.
+DEF_TEST(FontHost_CharsToGlyphsTable, reporter) {
+    // colr.ttf maps U+0020, U+2662 and U+1F600. The others are unmapped, in and out of the BMP.
+    const SkUnichar kChars[] = { 0x20, 0x2662, 0x1F600, 'a', 0x1F601, 0xE9, 0x10FFFF, 0xFFFF };
+    const int kCount = 3000;
+    const int kBatch = 500;  // Few enough to be mapped without the table.
+
+    SkTDArray<SkUnichar> utf32;
+    SkTDArray<char> utf8;
+    SkTDArray<uint16_t> utf16;
+    for (int i = 0; i < kCount; ++i) {
+        SkUnichar uni = kChars[(i + i / 7) % SK_ARRAY_COUNT(kChars)];
+        utf32.push_back(uni);
+        SkUTF::ToUTF8(uni, utf8.append(SkToInt(SkUTF::ToUTF8(uni))));
+        SkUTF::ToUTF16(uni, utf16.append(SkToInt(SkUTF::ToUTF16(uni))));
+    }
+
+    SkGlyphID expected[kCount];
+    for (int i = 0; i < kCount; i += kBatch) {
+        sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/colr.ttf");
+        if (!typeface) {
+            return;
+        }
+        typeface->charsToGlyphs(utf32.begin() + i, SkTypeface::kUTF32_Encoding, expected + i,
+                                kBatch);
+    }
+    REPORTER_ASSERT(reporter, expected[2] != 0 && expected[3] == 0);
+    int expectedFirst = 3;
+
+    const struct {
+        const void*          fChars;
+        SkTypeface::Encoding fEncoding;
+    } texts[] = {
+        { utf8.begin(), SkTypeface::kUTF8_Encoding },
+        { utf16.begin(), SkTypeface::kUTF16_Encoding },
+        { utf32.begin(), SkTypeface::kUTF32_Encoding },
+    };
+    for (const auto& text : texts) {
+        sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/colr.ttf");
+        SkGlyphID glyphs[kCount];
+        REPORTER_ASSERT(reporter, expectedFirst ==
+                                  typeface->charsToGlyphs(text.fChars, text.fEncoding, glyphs,
+                                                          kCount));
+        REPORTER_ASSERT(reporter, !memcmp(glyphs, expected, sizeof(expected)));
+        REPORTER_ASSERT(reporter, expectedFirst ==
+                                  typeface->charsToGlyphs(text.fChars, text.fEncoding, nullptr,
+                                                          kCount));
+
+        // Short runs use the table too, once it has been built.
+        const SkUnichar shortRun[] = { 0x1F600, 0x1F601 };
+        REPORTER_ASSERT(reporter, 1 == typeface->charsToGlyphs(shortRun,
+                                                               SkTypeface::kUTF32_Encoding,
+                                                               glyphs, 2));
+        REPORTER_ASSERT(reporter, glyphs[0] == expected[2] && glyphs[1] == 0);
+    }
+}
+
 static void test_fontstream(skiatest::Reporter* reporter, SkStream* stream, int ttcIndex) {
     int n = SkFontStream::GetTableTags(stream, ttcIndex, nullptr);
     SkAutoTArray<SkFontTableTag> array(n);
@@ -314,4 +380,160 @@ DEF_TEST(FontHost, reporter) {
     test_symbolfont(reporter);
 }
 
+static sk_sp<SkImage> draw_scaled_emoji(const sk_sp<SkTypeface>& typeface, SkScalar textSize) {
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(64, 64);
+    SkPaint paint;
+    paint.setTypeface(typeface);
+    paint.setTextSize(textSize);
+    paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    const SkGlyphID glyph = 3;  // U+1F600
+    surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+    surface->getCanvas()->drawText(&glyph, sizeof(glyph), 4, 48, paint);
+    return surface->makeImageSnapshot();
+}
+
+// Scaled bitmap strike glyphs are drawn from a cached copy of the strike's image once it has
+// been loaded. That copy must draw the same as the glyph loaded from the font.
+DEF_TEST(FontHost_ScaledBitmapStrike, reporter) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/cbdt.ttf");
+    if (!typeface) {
+        return;
+    }
+    for (SkScalar textSize : { 10.0f, 25.0f, 40.0f }) {
+        SkGraphics::PurgeAllCaches();
+        sk_sp<SkImage> loaded = draw_scaled_emoji(typeface, textSize);
+        SkGraphics::PurgeFontCache();
+        sk_sp<SkImage> cached = draw_scaled_emoji(typeface, textSize);
+
+        SkPixmap loadedPixels, cachedPixels;
+        if (!loaded->peekPixels(&loadedPixels) || !cached->peekPixels(&cachedPixels)) {
+            ERRORF(reporter, "Could not read the glyph images.");
+            return;
+        }
+        bool drawn = false;
+        for (int y = 0; y < loadedPixels.height(); ++y) {
+            for (int x = 0; x < loadedPixels.width(); ++x) {
+                drawn |= *loadedPixels.addr32(x, y) != 0;
+            }
+            REPORTER_ASSERT(reporter, !memcmp(loadedPixels.addr32(0, y), cachedPixels.addr32(0, y),
+                                              loadedPixels.width() * sizeof(uint32_t)));
+        }
+        REPORTER_ASSERT(reporter, drawn);
+    }
+}
+
+// A bitmap strike glyph drawn at its strike's size is the same at every subpixel position, so the
+// positions share one image.
+DEF_TEST(FontHost_SharedSubpixelImages, reporter) {
+    SkPaint paint;
+    paint.setTypeface(MakeResourceAsTypeface("fonts/cbdt.ttf"));
+    if (!paint.getTypeface()) {
+        return;
+    }
+    paint.setTextSize(64);
+    paint.setSubpixelText(true);
+    paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(paint);
+    if (!cache->isSubpixel()) {
+        return;
+    }
+
+    const SkGlyphID glyphID = 3;  // U+1F600
+    const SkGlyph& first = cache->getGlyphIDMetrics(glyphID, 0, 0);
+    const void* firstImage = cache->findImage(first);
+    size_t sharedBefore = cache->getSharedImageMemory();
+    for (SkFixed x : { SK_Fixed1 / 4, SK_Fixed1 / 2, SK_Fixed1 * 3 / 4 }) {
+        const SkGlyph& glyph = cache->getGlyphIDMetrics(glyphID, x, 0);
+        const void* image = cache->findImage(glyph);
+        if (!firstImage || !image) {
+            continue;
+        }
+        bool same = glyph.fWidth == first.fWidth && glyph.fHeight == first.fHeight &&
+                    glyph.fLeft == first.fLeft && glyph.fTop == first.fTop &&
+                    glyph.fMaskFormat == first.fMaskFormat &&
+                    !memcmp(image, firstImage, first.computeImageSize());
+        REPORTER_ASSERT(reporter, same == (image == firstImage));
+        if (same) {
+            REPORTER_ASSERT(reporter,
+                            cache->getSharedImageMemory() - sharedBefore >= first.computeImageSize());
+            sharedBefore = cache->getSharedImageMemory();
+        }
+    }
+
+    // The strike's memory accounting includes the scratch image the positions are compared in.
+    cache = SkStrikeCache::ExclusiveStrikePtr();
+    SkStrikeCache::ValidateGlyphCacheDataSize();
+}
+
+static SkPath unhinted_glyph_path(const sk_sp<SkTypeface>& typeface, SkScalar textSize,
+                                  bool vertical = false) {
+    SkPaint paint;
+    paint.setTypeface(typeface);
+    paint.setTextSize(textSize);
+    paint.setTextSkewX(-SK_Scalar1 / 4);
+    paint.setHinting(SkPaint::kNo_Hinting);
+    paint.setVerticalText(vertical);
+    paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(paint);
+    const SkGlyphID glyph = 3;  // U+2613
+    const SkPath* path = cache->findPath(cache->getGlyphIDMetrics(glyph));
+    return path ? *path : SkPath();
+}
+
+static SkPoint average_point(const SkPath& path) {
+    SkPoint sum = { 0, 0 };
+    for (int i = 0; i < path.countPoints(); ++i) {
+        sum += path.getPoint(i);
+    }
+    return sum * (1.0f / SkTMax(path.countPoints(), 1));
+}
+
+// Vertical strikes don't share unhinted outlines, so FreeType scales them itself. Their outlines
+// are only offset to the vertical origin, which this moves them back from.
+static SkPath freetype_scaled_glyph_path(const sk_sp<SkTypeface>& typeface, SkScalar textSize,
+                                         const SkPath& horizontal) {
+    SkPath path = unhinted_glyph_path(typeface, textSize, true);
+    path.offset(average_point(horizontal).fX - average_point(path).fX,
+                average_point(horizontal).fY - average_point(path).fY);
+    return path;
+}
+
+// FreeType rounds the outlines it scales to 1/64 of a pixel.
+static bool nearly_equal(const SkPath& a, const SkPath& b) {
+    if (a.countVerbs() != b.countVerbs() || a.countPoints() != b.countPoints()) {
+        return false;
+    }
+    for (int i = 0; i < a.countPoints(); ++i) {
+        if (SkPoint::Distance(a.getPoint(i), b.getPoint(i)) > 1.0f / 32) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Unhinted glyph paths may be shared between sizes. Each size must get the outline FreeType would
+// have scaled for it, whichever size asked for the glyph first.
+DEF_TEST(FontHost_UnhintedGlyphPaths, reporter) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Em.ttf");
+    if (!typeface) {
+        return;
+    }
+    for (bool smallFirst : {true, false}) {
+        SkGraphics::PurgeAllCaches();
+        SkPath small, large;
+        if (smallFirst) {
+            small = unhinted_glyph_path(typeface, 20);
+            large = unhinted_glyph_path(typeface, 40);
+        } else {
+            large = unhinted_glyph_path(typeface, 40);
+            small = unhinted_glyph_path(typeface, 20);
+        }
+        REPORTER_ASSERT(reporter, !small.isEmpty());
+        REPORTER_ASSERT(reporter,
+                        nearly_equal(small, freetype_scaled_glyph_path(typeface, 20, small)));
+        REPORTER_ASSERT(reporter,
+                        nearly_equal(large, freetype_scaled_glyph_path(typeface, 40, large)));
+    }
+}
+
 // need tests for SkStrSearch
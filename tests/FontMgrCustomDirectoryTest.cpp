@@ -0,0 +1,278 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkData.h"
+#include "SkFontMgr.h"
+#include "SkFontMgr_directory.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkStream.h"
+#include "SkTSort.h"
+#include "Test.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <utime.h>
+
+static const char* kFonts[] = {
+    "Em.ttf", "Funkster.ttf", "HangingS.ttf", "ReallyBigA.ttf", "SpiderSymbol.ttf", "test.ttc",
+};
+
+static bool write_data(const SkString& path, const SkData& data) {
+    SkFILEWStream stream(path.c_str());
+    return stream.isValid() && stream.write(data.data(), data.size());
+}
+
+static bool copy_font(const SkString& dir, const char* font) {
+    sk_sp<SkData> data = GetResourceAsData(SkStringPrintf("fonts/%s", font).c_str());
+    return data && write_data(SkOSPath::Join(dir.c_str(), font), *data);
+}
+
+// Makes an empty directory in the tmp dir, or returns an empty string.
+static SkString make_dir(const char* name, const char* const fonts[], int fontCount) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return SkString();
+    }
+    SkString dir = SkOSPath::Join(tmpDir.c_str(), name);
+    if (!sk_mkdir(dir.c_str())) {
+        return SkString();
+    }
+    SkOSFile::Iter iter(dir.c_str());
+    SkString file;
+    while (iter.next(&file)) {
+        remove(SkOSPath::Join(dir.c_str(), file.c_str()).c_str());
+    }
+    for (int i = 0; i < fontCount; ++i) {
+        if (!copy_font(dir, fonts[i])) {
+            return SkString();
+        }
+    }
+    return dir;
+}
+
+static void sort(SkTArray<SkString>* strings) {
+    SkTQSort(strings->begin(), strings->end() - 1, [](const SkString& a, const SkString& b) {
+        return strcmp(a.c_str(), b.c_str()) < 0;
+    });
+}
+
+// Appends one entry per typeface: "family weight width slant".
+static void append_faces(SkFontMgr* mgr, SkTArray<SkString>* faces) {
+    for (int i = 0; i < mgr->countFamilies(); ++i) {
+        SkString family;
+        mgr->getFamilyName(i, &family);
+        sk_sp<SkFontStyleSet> set(mgr->createStyleSet(i));
+        for (int j = 0; j < set->count(); ++j) {
+            SkFontStyle style;
+            set->getStyle(j, &style, nullptr);
+            faces->push_back(SkStringPrintf("%s %d %d %d", family.c_str(), style.weight(),
+                                            style.width(), style.slant()));
+        }
+    }
+}
+
+// True if the font manager has exactly the expected faces, in any order.
+static bool has_faces(SkFontMgr* mgr, const SkTArray<SkString>& expected) {
+    SkTArray<SkString> faces;
+    append_faces(mgr, &faces);
+    sort(&faces);
+    SkTArray<SkString> sorted(expected.begin(), expected.count());
+    sort(&sorted);
+    return faces == sorted;
+}
+
+static bool has_family(SkFontMgr* mgr, const SkString& name) {
+    sk_sp<SkFontStyleSet> set(mgr->matchFamily(name.c_str()));
+    return set && set->count() > 0;
+}
+
+// The family name the directory font manager gives the font's first face.
+static SkString family_name(const char* font) {
+    SkString name;
+    SkString dir = make_dir("font_scan_family_name", &font, 1);
+    if (!dir.isEmpty()) {
+        SkFontMgr_New_Custom_Directory(dir.c_str())->getFamilyName(0, &name);
+    }
+    return name;
+}
+
+// Renames a family in the scan cache so the test can tell whether a face came from the cache.
+// The name keeps its length, so its length prefix and the rest of the cache stay valid.
+static SkString rename_cached_family(const SkString& cachePath, const SkString& name) {
+    sk_sp<SkData> data = SkData::MakeFromFileName(cachePath.c_str());
+    if (!data || name.isEmpty() || name.size() > 127) {
+        return SkString();
+    }
+    SkString renamed(name);
+    renamed.writable_str()[0] = name[0] == 'X' ? 'Y' : 'X';
+    sk_sp<SkData> patched = SkData::MakeWithCopy(data->data(), data->size());
+    char* bytes = static_cast<char*>(patched->writable_data());
+    int count = 0;
+    for (size_t i = 0; i + 1 + name.size() <= patched->size(); ++i) {
+        if (bytes[i] == (char)name.size() && !memcmp(bytes + i + 1, name.c_str(), name.size())) {
+            memcpy(bytes + i + 1, renamed.c_str(), name.size());
+            ++count;
+        }
+    }
+    return count && write_data(cachePath, *patched) ? renamed : SkString();
+}
+
+DEF_TEST(FontMgrCustomDirectory_ScanCache, reporter) {
+    SkString dir = make_dir("font_scan_cache_fonts", kFonts, SK_ARRAY_COUNT(kFonts));
+    if (dir.isEmpty()) {
+        return;
+    }
+    SkString cachePath = SkOSPath::Join(skiatest::GetTmpDir().c_str(), "font_scan_cache");
+    remove(cachePath.c_str());
+    SkTArray<SkString> expected;
+    append_faces(SkFontMgr_New_Custom_Directory(dir.c_str()).get(), &expected);
+    REPORTER_ASSERT(reporter, !expected.empty());
+
+    // The first scan writes the cache and matches an uncached scan.
+    sk_sp<SkFontMgr> mgr = SkFontMgr_New_Custom_Directory(dir.c_str(), cachePath.c_str());
+    REPORTER_ASSERT(reporter, sk_exists(cachePath.c_str()));
+    REPORTER_ASSERT(reporter, has_faces(mgr.get(), expected));
+
+    // The next scan reads the faces of unchanged files from the cache.
+    SkString fontPath = SkOSPath::Join(dir.c_str(), "Funkster.ttf");
+    SkString name = family_name("Funkster.ttf");
+    SkString renamed = rename_cached_family(cachePath, name);
+    REPORTER_ASSERT(reporter, !renamed.isEmpty());
+    mgr = SkFontMgr_New_Custom_Directory(dir.c_str(), cachePath.c_str());
+    REPORTER_ASSERT(reporter, has_family(mgr.get(), renamed));
+    REPORTER_ASSERT(reporter, !has_family(mgr.get(), name));
+
+    // A file with a new modification time is scanned again.
+    size_t size;
+    int64_t modTime;
+    REPORTER_ASSERT(reporter, sk_stat(fontPath.c_str(), &size, &modTime));
+    utimbuf times = {static_cast<time_t>(modTime - 10), static_cast<time_t>(modTime - 10)};
+    REPORTER_ASSERT(reporter, 0 == utime(fontPath.c_str(), &times));
+    mgr = SkFontMgr_New_Custom_Directory(dir.c_str(), cachePath.c_str());
+    REPORTER_ASSERT(reporter, has_family(mgr.get(), name));
+    REPORTER_ASSERT(reporter, !has_family(mgr.get(), renamed));
+    REPORTER_ASSERT(reporter, has_faces(mgr.get(), expected));
+
+    // So is a file with a new size. FreeType ignores the data appended to the font.
+    REPORTER_ASSERT(reporter, !rename_cached_family(cachePath, name).isEmpty());
+    sk_sp<SkData> font = SkData::MakeFromFileName(fontPath.c_str());
+    REPORTER_ASSERT(reporter, font);
+    if (font) {
+        sk_sp<SkData> longer = SkData::MakeUninitialized(font->size() + 4);
+        memset(longer->writable_data(), 0, longer->size());
+        memcpy(longer->writable_data(), font->data(), font->size());
+        font.reset();
+        REPORTER_ASSERT(reporter, write_data(fontPath, *longer));
+    }
+    mgr = SkFontMgr_New_Custom_Directory(dir.c_str(), cachePath.c_str());
+    REPORTER_ASSERT(reporter, has_family(mgr.get(), name));
+    REPORTER_ASSERT(reporter, has_faces(mgr.get(), expected));
+
+    // A removed file's faces are gone and the other files still come from the cache.
+    SkString otherName = family_name("Em.ttf");
+    SkString otherRenamed = rename_cached_family(cachePath, otherName);
+    REPORTER_ASSERT(reporter, !otherRenamed.isEmpty());
+    REPORTER_ASSERT(reporter, 0 == remove(fontPath.c_str()));
+    mgr = SkFontMgr_New_Custom_Directory(dir.c_str(), cachePath.c_str());
+    REPORTER_ASSERT(reporter, !has_family(mgr.get(), name));
+    REPORTER_ASSERT(reporter, has_family(mgr.get(), otherRenamed));
+
+    // An added file is scanned, and the other files still come from the cache.
+    REPORTER_ASSERT(reporter, copy_font(dir, "Funkster.ttf"));
+    mgr = SkFontMgr_New_Custom_Directory(dir.c_str(), cachePath.c_str());
+    REPORTER_ASSERT(reporter, has_family(mgr.get(), name));
+    REPORTER_ASSERT(reporter, has_family(mgr.get(), otherRenamed));
+}
+
+DEF_TEST(FontMgrCustomDirectory_CorruptScanCache, reporter) {
+    SkString dir = make_dir("font_scan_cache_corrupt_fonts", kFonts, SK_ARRAY_COUNT(kFonts));
+    if (dir.isEmpty()) {
+        return;
+    }
+    SkString cachePath = SkOSPath::Join(skiatest::GetTmpDir().c_str(), "font_scan_cache_corrupt");
+    remove(cachePath.c_str());
+    SkTArray<SkString> expected;
+    append_faces(SkFontMgr_New_Custom_Directory(dir.c_str()).get(), &expected);
+    SkFontMgr_New_Custom_Directory(dir.c_str(), cachePath.c_str());
+    // The file is overwritten below, so copy it rather than keeping it mapped.
+    sk_sp<SkData> cache = SkData::MakeFromFileName(cachePath.c_str());
+    REPORTER_ASSERT(reporter, cache && cache->size() > 8);
+    if (!cache || cache->size() <= 8) {
+        return;
+    }
+    cache = SkData::MakeWithCopy(cache->data(), cache->size());
+
+    // Truncated and garbled caches are ignored, and replaced with a good one.
+    sk_sp<SkData> truncated = SkData::MakeSubset(cache.get(), 0, cache->size() / 2);
+    sk_sp<SkData> garbled = SkData::MakeWithCopy(cache->data(), cache->size());
+    memset(garbled->writable_data(), 0xFF, garbled->size());
+    sk_sp<SkData> badLengths = SkData::MakeWithCopy(cache->data(), cache->size());
+    memset(static_cast<char*>(badLengths->writable_data()) + 8, 0xFF, badLengths->size() - 8);
+    for (const sk_sp<SkData>& corrupt : {truncated, garbled, badLengths}) {
+        REPORTER_ASSERT(reporter, write_data(cachePath, *corrupt));
+        sk_sp<SkFontMgr> mgr = SkFontMgr_New_Custom_Directory(dir.c_str(), cachePath.c_str());
+        REPORTER_ASSERT(reporter, has_faces(mgr.get(), expected));
+        sk_sp<SkData> rewritten = SkData::MakeFromFileName(cachePath.c_str());
+        REPORTER_ASSERT(reporter, rewritten && rewritten->equals(cache.get()));
+    }
+}
+
+DEF_TEST(FontMgrCustomDirectory_UnstattableFile, reporter) {
+    SkString dir = make_dir("font_scan_unstattable_fonts", kFonts, SK_ARRAY_COUNT(kFonts));
+    if (dir.isEmpty()) {
+        return;
+    }
+    SkString cachePath = SkOSPath::Join(skiatest::GetTmpDir().c_str(),
+                                        "font_scan_cache_unstattable");
+    remove(cachePath.c_str());
+    SkTArray<SkString> expected;
+    append_faces(SkFontMgr_New_Custom_Directory(dir.c_str()).get(), &expected);
+
+    // A dangling link can't be statted. It is skipped rather than rescanned on every startup.
+    SkString linkPath = SkOSPath::Join(dir.c_str(), "Missing.ttf");
+    SkString targetPath = SkOSPath::Join(dir.c_str(), "Missing.ttf.target");
+    REPORTER_ASSERT(reporter, 0 == symlink(targetPath.c_str(), linkPath.c_str()));
+    sk_sp<SkFontMgr> mgr = SkFontMgr_New_Custom_Directory(dir.c_str(), cachePath.c_str());
+    REPORTER_ASSERT(reporter, has_faces(mgr.get(), expected));
+
+    // Nothing changed, so the next startup leaves the cache alone.
+    size_t size;
+    int64_t modTime;
+    REPORTER_ASSERT(reporter, sk_stat(cachePath.c_str(), &size, &modTime));
+    utimbuf times = {static_cast<time_t>(modTime - 10), static_cast<time_t>(modTime - 10)};
+    REPORTER_ASSERT(reporter, 0 == utime(cachePath.c_str(), &times));
+    mgr = SkFontMgr_New_Custom_Directory(dir.c_str(), cachePath.c_str());
+    REPORTER_ASSERT(reporter, has_faces(mgr.get(), expected));
+    int64_t newModTime;
+    REPORTER_ASSERT(reporter, sk_stat(cachePath.c_str(), &size, &newModTime));
+    REPORTER_ASSERT(reporter, newModTime == modTime - 10);
+    remove(linkPath.c_str());
+}
+
+DEF_TEST(FontMgrCustomDirectory_ParallelScan, reporter) {
+    // With a default executor, directories with several files are scanned by several tasks. Ones
+    // with a single file are scanned serially, so scanning each file on its own gives the
+    // expected faces.
+    SkString dir = make_dir("font_scan_parallel_fonts", kFonts, SK_ARRAY_COUNT(kFonts));
+    if (dir.isEmpty()) {
+        return;
+    }
+    SkTArray<SkString> expected;
+    for (const char* font : kFonts) {
+        SkString name = SkStringPrintf("font_scan_serial_%s", font);
+        SkString singleDir = make_dir(name.c_str(), &font, 1);
+        if (singleDir.isEmpty()) {
+            return;
+        }
+        sk_sp<SkFontMgr> mgr = SkFontMgr_New_Custom_Directory(singleDir.c_str());
+        append_faces(mgr.get(), &expected);
+    }
+    sk_sp<SkFontMgr> mgr = SkFontMgr_New_Custom_Directory(dir.c_str());
+    REPORTER_ASSERT(reporter, has_faces(mgr.get(), expected));
+}
@@ -7,6 +7,8 @@
 
 #include "SkFont.h"
 #include "SkPaint.h"
+#include "SkPaintPriv.h"
+#include "SkTemplates.h"
 #include "SkTypeface.h"
 #include "Test.h"
 
@@ -37,6 +39,8 @@ static void test_cachedfont(skiatest::Reporter* reporter, const SkPaint& paint)
     REPORTER_ASSERT(reporter, font->isEmbolden() == paint.isFakeBoldText());
 
     REPORTER_ASSERT(reporter, font->isUseNonLinearMetrics() == is_use_nonlinear_metrics(paint));
+    REPORTER_ASSERT(reporter, font->isSubpixel() == paint.isSubpixelText());
+    REPORTER_ASSERT(reporter, font->isLinearMetrics() == paint.isLinearText());
     REPORTER_ASSERT(reporter, font->isEnableAutoHints() == is_enable_auto_hints(paint));
     REPORTER_ASSERT(reporter, font->isEnableByteCodeHints() == is_enable_bytecode_hints(paint));
 }
@@ -116,4 +120,68 @@ DEF_TEST(FontObj, reporter) {
     test_cachedfont(reporter);
 }
 
+// Compares against measuring the utf8 text, which looks each glyph up in the cache as it goes
+// rather than through SkPaintPriv::GetGlyphWidths.
+static void check_text_widths(skiatest::Reporter* reporter, const SkPaint& paint,
+                              const char text[], int count,
+                              const SkScalar widths[], const SkRect bounds[]) {
+    SkPaint textPaint(paint);
+    textPaint.setTextEncoding(SkPaint::kUTF8_TextEncoding);
+    SkAutoTArray<SkScalar> textWidths(count);
+    SkAutoTArray<SkRect> textBounds(count);
+    REPORTER_ASSERT(reporter, count == textPaint.getTextWidths(text, count, textWidths.get(),
+                                                               textBounds.get()));
+    for (int i = 0; i < count; ++i) {
+        REPORTER_ASSERT(reporter, widths[i] == textWidths[i]);
+        REPORTER_ASSERT(reporter, bounds[i] == textBounds[i]);
+    }
+
+    // Without bounds only the advances are looked up.
+    REPORTER_ASSERT(reporter, count == textPaint.getTextWidths(text, count, textWidths.get()));
+    REPORTER_ASSERT(reporter, !memcmp(widths, textWidths.get(), count * sizeof(SkScalar)));
+}
+
+DEF_TEST(FontObj_GetWidths, reporter) {
+    const char txt[] = "long.text.with.lots.of.dots.";
+    const int count = SkToInt(strlen(txt));
+    SkGlyphID glyphs[SK_ARRAY_COUNT(txt)];
+    SkScalar widths[SK_ARRAY_COUNT(txt)], widthsOnly[SK_ARRAY_COUNT(txt)];
+    SkRect bounds[SK_ARRAY_COUNT(txt)];
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    REPORTER_ASSERT(reporter, count == paint.textToGlyphs(txt, count, glyphs));
+
+    // Linear text and vertical text take different paths through the glyph cache.
+    for (bool linear : {false, true}) {
+        for (bool vertical : {false, true}) {
+            paint.setLinearText(linear);
+            paint.setVerticalText(vertical);
+            SkPaintPriv::GetGlyphWidths(paint, glyphs, count, widths, bounds);
+            check_text_widths(reporter, paint, txt, count, widths, bounds);
+
+            SkPaintPriv::GetGlyphWidths(paint, glyphs, count, widthsOnly, nullptr);
+            REPORTER_ASSERT(reporter, !memcmp(widths, widthsOnly, count * sizeof(SkScalar)));
+        }
+    }
+
+    // A font measures the same as the paint it was made from, at every hinting level.
+    paint.setVerticalText(false);
+    paint.setTextSize(17);
+    paint.setTypeface(SkTypeface::MakeDefault());
+    for (SkPaint::Hinting hinting : {SkPaint::kNo_Hinting, SkPaint::kSlight_Hinting,
+                                     SkPaint::kNormal_Hinting, SkPaint::kFull_Hinting}) {
+        for (bool linear : {false, true}) {
+            for (bool subpixel : {false, true}) {
+                paint.setHinting(hinting);
+                paint.setLinearText(linear);
+                paint.setSubpixelText(subpixel);
+                sk_sp<SkFont> font(SkFont::Testing_CreateFromPaint(paint));
+                font->getWidths(glyphs, count, widths, bounds);
+                check_text_widths(reporter, paint, txt, count, widths, bounds);
+            }
+        }
+    }
+}
+
 // need tests for SkStrSearch
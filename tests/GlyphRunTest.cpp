@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "SkTextBlob.h"
+#include "SkTextBlobPriv.h"
 
 #include "Test.h"
 
@@ -106,3 +107,45 @@ DEF_TEST(GlyphRunBlob, reporter) {
         runIndex += 1;
     }
 }
+
+DEF_TEST(GlyphRunBlobResolvedRuns, reporter) {
+    constexpr uint16_t count = 5;
+
+    SkPaint font;
+    font.setTypeface(SkTypeface::MakeFromName("monospace", SkFontStyle()));
+    font.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    font.setTextSize(12);
+
+    // A default positioned run between two positioned runs.
+    SkTextBlobBuilder blobBuilder;
+    const auto& before = blobBuilder.allocRunPosH(font, count, 0);
+    const auto& advanced = blobBuilder.allocRun(font, count, 0, 20);
+    const auto& after = blobBuilder.allocRunPosH(font, count, 40);
+    for (int i = 0; i < count; i++) {
+        before.glyphs[i] = advanced.glyphs[i] = after.glyphs[i] = static_cast<SkGlyphID>(i + 3);
+        before.pos[i] = after.pos[i] = SkIntToScalar(i);
+    }
+    auto blob = blobBuilder.make();
+
+    SkGlyphRunBuilder runBuilder;
+    runBuilder.drawTextBlob(font, *blob, SkPoint::Make(0, 0));
+    std::vector<SkPoint> firstPositions;
+    for (auto& run : runBuilder.useGlyphRunList()) {
+        firstPositions.insert(firstPositions.end(), run.positions().begin(),
+                              run.positions().end());
+    }
+    REPORTER_ASSERT(reporter, SkTextBlobPriv::GetResolvedRuns(*blob) != nullptr);
+
+    // Later draws, with any builder, use the resolved runs.
+    SkGlyphRunBuilder otherBuilder;
+    SkPaint paint(font);
+    paint.setStyle(SkPaint::kStroke_Style);
+    otherBuilder.drawTextBlob(paint, *blob, SkPoint::Make(0, 0));
+    std::vector<SkPoint> laterPositions;
+    for (auto& run : otherBuilder.useGlyphRunList()) {
+        REPORTER_ASSERT(reporter, run.runSize() == count);
+        laterPositions.insert(laterPositions.end(), run.positions().begin(),
+                              run.positions().end());
+    }
+    REPORTER_ASSERT(reporter, firstPositions == laterPositions);
+}
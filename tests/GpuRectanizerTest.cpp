@@ -7,6 +7,7 @@
 
 #include "GrRectanizer_pow2.h"
 #include "GrRectanizer_skyline.h"
+#include "GrRectanizer_wastemap.h"
 #include "SkRandom.h"
 #include "SkSize.h"
 #include "SkTDArray.h"
@@ -49,6 +50,13 @@ static void test_skyline(skiatest::Reporter* reporter, const SkTDArray<SkISize>&
     test_rectanizer_inserts(reporter, &skylineRectanizer, rects);
 }
 
+static void test_wastemap(skiatest::Reporter* reporter, const SkTDArray<SkISize>& rects) {
+    GrRectanizerWasteMap wasteMapRectanizer(kWidth, kHeight);
+
+    test_rectanizer_basic(reporter, &wasteMapRectanizer);
+    test_rectanizer_inserts(reporter, &wasteMapRectanizer, rects);
+}
+
 static void test_pow2(skiatest::Reporter* reporter, const SkTDArray<SkISize>& rects) {
     GrRectanizerPow2 pow2Rectanizer(kWidth, kHeight);
 
@@ -66,5 +74,66 @@ DEF_GPUTEST(GpuRectanizer, reporter, factory) {
     }
 
     test_skyline(reporter, rects);
+    test_wastemap(reporter, rects);
     test_pow2(reporter, rects);
 }
+
+// Fills a rectanizer with small rects, checking that they are in bounds and don't overlap, and
+// returns how full it got.
+static float fill_with_small_rects(skiatest::Reporter* reporter, GrRectanizer* rectanizer) {
+    static const int kSize = 256;
+    SkASSERT(kSize == rectanizer->width() && kSize == rectanizer->height());
+    SkAutoTMalloc<bool> used(kSize * kSize);
+    sk_bzero(used.get(), kSize * kSize * sizeof(bool));
+
+    SkRandom rand;
+    // Keep going past the first failure; later, smaller rects may still fit.
+    for (int failures = 0; failures < 20;) {
+        int w = rand.nextRangeU(4, 32);
+        int h = rand.nextRangeU(4, 32);
+        SkIPoint16 loc;
+        if (!rectanizer->addRect(w, h, &loc)) {
+            ++failures;
+            continue;
+        }
+        REPORTER_ASSERT(reporter, loc.fX >= 0 && loc.fX + w <= kSize);
+        REPORTER_ASSERT(reporter, loc.fY >= 0 && loc.fY + h <= kSize);
+        for (int y = SkTMax<int>(loc.fY, 0); y < SkTMin(loc.fY + h, kSize); ++y) {
+            for (int x = SkTMax<int>(loc.fX, 0); x < SkTMin(loc.fX + w, kSize); ++x) {
+                REPORTER_ASSERT(reporter, !used[y * kSize + x]);
+                used[y * kSize + x] = true;
+            }
+        }
+    }
+    return rectanizer->percentFull();
+}
+
+DEF_GPUTEST(GpuRectanizer_WasteMap, reporter, factory) {
+    GrRectanizerSkyline skylineRectanizer(256, 256);
+    GrRectanizerWasteMap wasteMapRectanizer(256, 256);
+
+    float skylineFull = fill_with_small_rects(reporter, &skylineRectanizer);
+    float wasteMapFull = fill_with_small_rects(reporter, &wasteMapRectanizer);
+    // Reusing the space below the skyline packs at least as tightly.
+    REPORTER_ASSERT(reporter, wasteMapFull >= skylineFull);
+
+    // A reset rectanizer packs the same way again.
+    wasteMapRectanizer.reset();
+    REPORTER_ASSERT(reporter, wasteMapFull == fill_with_small_rects(reporter, &wasteMapRectanizer));
+}
+
+DEF_GPUTEST(GpuRectanizer_WasteMapFullHeight, reporter, factory) {
+    // Rects as tall as a power of two sized rectanizer are taller than any free rect can be.
+    GrRectanizerWasteMap rectanizer(256, 256);
+    SkIPoint16 loc;
+    REPORTER_ASSERT(reporter, rectanizer.addRect(10, 20, &loc));
+    REPORTER_ASSERT(reporter, rectanizer.addRect(246, 5, &loc));
+    REPORTER_ASSERT(reporter, rectanizer.addRect(256, 10, &loc));
+    REPORTER_ASSERT(reporter, !rectanizer.addRect(4, 256, &loc));
+
+    rectanizer.reset();
+    REPORTER_ASSERT(reporter, rectanizer.addRect(4, 256, &loc));
+    REPORTER_ASSERT(reporter, loc.fX == 0 && loc.fY == 0);
+    REPORTER_ASSERT(reporter, rectanizer.addRect(252, 256, &loc));
+    REPORTER_ASSERT(reporter, !rectanizer.addRect(1, 256, &loc));
+}
@@ -0,0 +1,261 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrClip.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrDefaultGeoProcFactory.h"
+#include "GrPathUtils.h"
+#include "GrRenderTargetContext.h"
+#include "GrShape.h"
+#include "GrStyle.h"
+#include "SkMatrix.h"
+#include "SkPath.h"
+#include "effects/GrPorterDuffXferProcessor.h"
+#include "ops/GrAATessellationCache.h"
+#include "ops/GrTessellatingPathRenderer.h"
+
+static SkPath make_concave_path() {
+    SkPath path;
+    path.moveTo(100, 0);
+    path.lineTo(200, 200);
+    path.lineTo(100, 150);
+    path.lineTo(0, 200);
+    path.close();
+    return path;
+}
+
+static GrShape make_shape(const SkPath& path) {
+    return GrShape(path, GrStyle(SkStrokeRec::kFill_InitStyle));
+}
+
+static sk_sp<GrAATessellationCache::Tessellation> tessellate(const SkPath& path,
+                                                             const SkMatrix& matrix) {
+    SkPath devPath;
+    path.transform(matrix, &devPath);
+    return GrAATessellationCache::Tessellation::Make(devPath, GrPathUtils::kDefaultTolerance);
+}
+
+DEF_TEST(GrAATessellationCache_Key, reporter) {
+    SkPath path = make_concave_path();
+    GrShape shape = make_shape(path);
+    GrAATessellationCache::Key a, b;
+
+    // Translations that differ by whole quarter pixels, up to float error, share a key.
+    SkMatrix m = SkMatrix::MakeTrans(10.3f, -7.6f);
+    REPORTER_ASSERT(reporter, a.set(shape, m));
+    m.postTranslate(31.25f, 2);
+    REPORTER_ASSERT(reporter, b.set(shape, m));
+    REPORTER_ASSERT(reporter, a == b);
+    REPORTER_ASSERT(reporter, GrAATessellationCache::Key::Hash()(a) ==
+                              GrAATessellationCache::Key::Hash()(b));
+    REPORTER_ASSERT(reporter, b.translate().fX - a.translate().fX == 31.25f);
+    REPORTER_ASSERT(reporter, b.translate().fY - a.translate().fY == 2);
+
+    // A different subpixel offset, scale, or path is a different key.
+    m.postTranslate(0.1f, 0);
+    REPORTER_ASSERT(reporter, b.set(shape, m));
+    REPORTER_ASSERT(reporter, !(a == b));
+    REPORTER_ASSERT(reporter, b.set(shape, SkMatrix::MakeScale(2)));
+    REPORTER_ASSERT(reporter, !(a == b));
+    SkPath other = path;
+    other.lineTo(50, 50);
+    REPORTER_ASSERT(reporter, b.set(make_shape(other), SkMatrix::MakeTrans(10.3f, -7.6f)));
+    REPORTER_ASSERT(reporter, !(a == b));
+
+    // Inverse fills depend on the clip, perspective can't be split into a translation, and
+    // volatile paths have no key.
+    SkPath inverse = path;
+    inverse.toggleInverseFillType();
+    REPORTER_ASSERT(reporter, !b.set(make_shape(inverse), SkMatrix::I()));
+    SkMatrix persp = SkMatrix::I();
+    persp.setPerspX(0.001f);
+    REPORTER_ASSERT(reporter, !b.set(shape, persp));
+    SkPath volatilePath = path;
+    volatilePath.setIsVolatile(true);
+    REPORTER_ASSERT(reporter, !b.set(make_shape(volatilePath), SkMatrix::I()));
+}
+
+DEF_TEST(GrAATessellationCache_TranslateInvariance, reporter) {
+    SkPath path = make_concave_path();
+    GrShape shape = make_shape(path);
+    GrAATessellationCache::Key key;
+    // Subpixel offsets at the key's resolution so that the translated matrices are exact.
+    static constexpr SkScalar kTx = 19 / 64.f, kTy = 38 / 64.f;
+    REPORTER_ASSERT(reporter, key.set(shape, SkMatrix::MakeTrans(kTx, kTy)));
+    sk_sp<GrAATessellationCache::Tessellation> cached =
+            tessellate(path, key.tessellationMatrix());
+    REPORTER_ASSERT(reporter, cached);
+
+    for (SkScalar dx : {0.f, 1.f, 17.25f, -300.5f}) {
+        SkMatrix m = SkMatrix::MakeTrans(kTx + dx, kTy - 2 * dx);
+        REPORTER_ASSERT(reporter, key.set(shape, m));
+        sk_sp<GrAATessellationCache::Tessellation> direct = tessellate(path, m);
+        REPORTER_ASSERT(reporter, direct && direct->count() == cached->count());
+        if (!direct || direct->count() != cached->count()) {
+            continue;
+        }
+        SkAutoTMalloc<GrDefaultGeoProcFactory::PositionColorCoverageAttr> verts(cached->count());
+        GrAATessellationCache::WriteVertices(*cached, key.translate(), 0xFFFFFFFF, false,
+                                             verts.get());
+        for (int i = 0; i < cached->count(); ++i) {
+            SkVector diff = verts[i].fPosition - direct->vertices()[i].fPosition;
+            REPORTER_ASSERT(reporter, diff.length() < 1e-3f);
+            REPORTER_ASSERT(reporter, verts[i].fCoverage == direct->vertices()[i].fCoverage);
+        }
+    }
+}
+
+DEF_TEST(GrAATessellationCache_LRU, reporter) {
+    SkPath path = make_concave_path();
+    GrAATessellationCache::Key keys[3];
+    sk_sp<GrAATessellationCache::Tessellation> tessellations[3];
+    for (int i = 0; i < 3; ++i) {
+        REPORTER_ASSERT(reporter, keys[i].set(make_shape(path), SkMatrix::MakeScale(i + 1)));
+        tessellations[i] = tessellate(path, keys[i].tessellationMatrix());
+    }
+    // Only the two newest tessellations fit in the budget.
+    GrAATessellationCache cache(tessellations[1]->bytes() + tessellations[2]->bytes());
+    for (int i = 0; i < 3; ++i) {
+        REPORTER_ASSERT(reporter, !cache.find(keys[i]));
+        cache.add(keys[i], tessellations[i]);
+    }
+    REPORTER_ASSERT(reporter, cache.missCount() == 3 && cache.hitCount() == 0);
+    // The oldest entry was purged.
+    REPORTER_ASSERT(reporter, !cache.find(keys[0]));
+    REPORTER_ASSERT(reporter, cache.find(keys[1]));
+    REPORTER_ASSERT(reporter, cache.find(keys[2]));
+    REPORTER_ASSERT(reporter, cache.missCount() == 4 && cache.hitCount() == 2);
+    REPORTER_ASSERT(reporter, cache.bytes() == cache.maxBytes());
+
+    // Replacing an entry doesn't count it twice.
+    cache.add(keys[2], tessellate(path, keys[2].tessellationMatrix()));
+    REPORTER_ASSERT(reporter, cache.bytes() == cache.maxBytes());
+    REPORTER_ASSERT(reporter, cache.find(keys[1]));
+
+    // Shrinking the budget purges the least recently used entries.
+    cache.setMaxBytes(tessellations[1]->bytes());
+    REPORTER_ASSERT(reporter, cache.find(keys[1]));
+    REPORTER_ASSERT(reporter, !cache.find(keys[2]));
+    REPORTER_ASSERT(reporter, cache.bytes() == tessellations[1]->bytes());
+
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, !cache.find(keys[1]));
+    REPORTER_ASSERT(reporter, !cache.bytes());
+}
+
+static void draw_aa_path(GrContext* ctx, GrRenderTargetContext* rtc, GrPathRenderer* pr,
+                         const SkPath& path, const SkMatrix& matrix) {
+    GrPaint paint;
+    paint.setXPFactory(GrPorterDuffXPFactory::Get(SkBlendMode::kSrcOver));
+    GrNoClip noClip;
+    SkIRect clipConservativeBounds = SkIRect::MakeWH(rtc->width(), rtc->height());
+    GrShape shape = make_shape(path);
+    GrPathRenderer::DrawPathArgs args{ctx,
+                                      std::move(paint),
+                                      &GrUserStencilSettings::kUnused,
+                                      rtc,
+                                      &noClip,
+                                      &clipConservativeBounds,
+                                      &matrix,
+                                      &shape,
+                                      GrAAType::kCoverage,
+                                      false};
+    pr->drawPath(args);
+}
+
+DEF_GPUTEST(GrAATessellationCache_PathRenderer, reporter, /* options */) {
+    sk_sp<GrContext> ctx = GrContext::MakeMock(nullptr);
+    sk_sp<GrRenderTargetContext> rtc(ctx->contextPriv().makeDeferredRenderTargetContext(
+            SkBackingFit::kApprox, 800, 800, kRGBA_8888_GrPixelConfig, nullptr, 1, GrMipMapped::kNo,
+            kTopLeft_GrSurfaceOrigin));
+    if (!rtc) {
+        return;
+    }
+    sk_sp<GrTessellatingPathRenderer> pr(new GrTessellatingPathRenderer());
+    const GrAATessellationCache* cache = pr->aaTessellationCacheForTesting();
+    SkPath path = make_concave_path();
+
+    // Scrolling the path over a few frames only tessellates it once.
+    for (int i = 0; i < 4; ++i) {
+        draw_aa_path(ctx.get(), rtc.get(), pr.get(), path, SkMatrix::MakeTrans(10, 10 + 25 * i));
+        ctx->flush();
+    }
+    REPORTER_ASSERT(reporter, cache->missCount() == 1);
+    REPORTER_ASSERT(reporter, cache->hitCount() == 3);
+
+    // A new scale misses.
+    draw_aa_path(ctx.get(), rtc.get(), pr.get(), path, SkMatrix::MakeScale(1.5f));
+    ctx->flush();
+    REPORTER_ASSERT(reporter, cache->missCount() == 2);
+    REPORTER_ASSERT(reporter, cache->hitCount() == 3);
+}
+
+DEF_GPUTEST(GrAATessellationCache_Budget, reporter, /* options */) {
+    sk_sp<GrContext> ctx = GrContext::MakeMock(nullptr);
+    sk_sp<GrRenderTargetContext> rtc(ctx->contextPriv().makeDeferredRenderTargetContext(
+            SkBackingFit::kApprox, 800, 800, kRGBA_8888_GrPixelConfig, nullptr, 1, GrMipMapped::kNo,
+            kTopLeft_GrSurfaceOrigin));
+    if (!rtc) {
+        return;
+    }
+    sk_sp<GrTessellatingPathRenderer> pr(new GrTessellatingPathRenderer());
+    sk_sp<const GrAATessellationCache> cache = sk_ref_sp(pr->aaTessellationCacheForTesting());
+    SkPath path = make_concave_path();
+
+    // The cache's budget follows the resource cache's.
+    int maxResources;
+    ctx->getResourceCacheLimits(&maxResources, nullptr);
+    ctx->setResourceCacheLimits(maxResources, 1 << 20);
+    draw_aa_path(ctx.get(), rtc.get(), pr.get(), path, SkMatrix::I());
+    ctx->flush();
+    REPORTER_ASSERT(reporter, cache->maxBytes() == (1 << 20) / 16);
+    REPORTER_ASSERT(reporter, cache->bytes() > 0);
+
+    // A budget too small for the tessellation doesn't keep it.
+    ctx->setResourceCacheLimits(maxResources, 16);
+    draw_aa_path(ctx.get(), rtc.get(), pr.get(), path, SkMatrix::I());
+    ctx->flush();
+    REPORTER_ASSERT(reporter, !cache->bytes());
+    ctx->setResourceCacheLimits(maxResources, 1 << 20);
+    draw_aa_path(ctx.get(), rtc.get(), pr.get(), path, SkMatrix::I());
+    ctx->flush();
+    REPORTER_ASSERT(reporter, cache->bytes() > 0);
+
+    // GrContext::freeGpuResources() releases the path renderers, which purges the cache even if it
+    // is still referenced.
+    pr.reset();
+    REPORTER_ASSERT(reporter, !cache->bytes());
+}
+
+DEF_GPUTEST(GrAATessellationCache_DDL, reporter, /* options */) {
+    sk_sp<GrContext> ctx = GrContext::MakeMock(nullptr);
+    sk_sp<GrContext> ddlCtx = GrContextPriv::MakeDDL(ctx->threadSafeProxy());
+    if (!ddlCtx) {
+        return;
+    }
+    sk_sp<GrRenderTargetContext> rtc(ddlCtx->contextPriv().makeDeferredRenderTargetContext(
+            SkBackingFit::kApprox, 800, 800, kRGBA_8888_GrPixelConfig, nullptr, 1, GrMipMapped::kNo,
+            kTopLeft_GrSurfaceOrigin));
+    if (!rtc) {
+        return;
+    }
+    sk_sp<GrTessellatingPathRenderer> pr(new GrTessellatingPathRenderer());
+    const GrAATessellationCache* cache = pr->aaTessellationCacheForTesting();
+
+    // Ops recorded for a DDL are executed by another context, on another thread, so they don't
+    // hold the cache.
+    draw_aa_path(ddlCtx.get(), rtc.get(), pr.get(), make_concave_path(), SkMatrix::I());
+    REPORTER_ASSERT(reporter, cache->unique());
+    REPORTER_ASSERT(reporter, cache->maxBytes() == GrAATessellationCache::kDefaultMaxBytes);
+}
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkExecutor.h"
+#include "SkSLCompiler.h"
+#include "SkSLUtil.h"
+#include "SkTaskGroup.h"
+#include "gl/builders/GrGLShaderPrecompiler.h"
+
+#include <deque>
+
+using Precompiler = GrGLShaderPrecompiler;
+
+static const char* kVertexSkSL = "in float2 pos; void main() { sk_Position = float4(pos, 0, 1); }";
+
+static SkSL::String fragment_sksl(int i) {
+    SkSL::String sksl;
+    sksl.appendf("uniform half4 color; void main() { sk_FragColor = color * %d.0; }", i + 1);
+    return sksl;
+}
+
+static sk_sp<SkData> encode(const SkSL::String& fragment, bool flipY = false) {
+    SkSL::Program::Settings settings;
+    settings.fFlipY = flipY;
+    SkSL::String sksl[Precompiler::kShaderTypeCount];
+    sksl[Precompiler::kVertex_ShaderType] = SkSL::String(kVertexSkSL);
+    sksl[Precompiler::kFragment_ShaderType] = fragment;
+    return Precompiler::Encode(settings, sksl);
+}
+
+static sk_sp<SkData> make_key(int i) {
+    return SkData::MakeWithCopy(&i, sizeof(i));
+}
+
+static SkSL::String to_glsl(const GrShaderCaps* caps, SkSL::Program::Kind kind,
+                            const SkSL::String& sksl) {
+    SkSL::Compiler compiler;
+    SkSL::Program::Settings settings;
+    settings.fCaps = caps;
+    std::unique_ptr<SkSL::Program> program = compiler.convertProgram(kind, sksl, settings);
+    SkSL::String glsl;
+    if (!program || !compiler.toGLSL(*program, &glsl)) {
+        return SkSL::String();
+    }
+    return glsl;
+}
+
+DEF_TEST(GrGLShaderPrecompilerEncoding, r) {
+    SkSL::String fragment = fragment_sksl(0);
+    Precompiler::Entry entry;
+    REPORTER_ASSERT(r, Precompiler::Decode(*encode(fragment, true), &entry));
+    REPORTER_ASSERT(r, entry.fSettings.fFlipY);
+    REPORTER_ASSERT(r, !entry.fSettings.fSharpenTextures);
+    REPORTER_ASSERT(r, entry.fSkSL[Precompiler::kVertex_ShaderType] == kVertexSkSL);
+    REPORTER_ASSERT(r, entry.fSkSL[Precompiler::kGeometry_ShaderType].empty());
+    REPORTER_ASSERT(r, entry.fSkSL[Precompiler::kFragment_ShaderType] == fragment);
+    REPORTER_ASSERT(r, entry.fSettings.fReplaceSettings);
+    REPORTER_ASSERT(r, entry.fSettings.fArgs.empty());
+
+    // Every setting which affects the generated GLSL survives the round trip.
+    SkSL::Program::Settings settings;
+    settings.fReplaceSettings = false;
+    settings.fArgs.insert(std::make_pair(SkSL::String("enabled"), true));
+    settings.fArgs.insert(std::make_pair(SkSL::String("count"), -3));
+    SkSL::String sksl[Precompiler::kShaderTypeCount];
+    sksl[Precompiler::kVertex_ShaderType] = SkSL::String(kVertexSkSL);
+    sksl[Precompiler::kFragment_ShaderType] = fragment;
+    REPORTER_ASSERT(r, Precompiler::Decode(*Precompiler::Encode(settings, sksl), &entry));
+    REPORTER_ASSERT(r, !entry.fSettings.fReplaceSettings);
+    REPORTER_ASSERT(r, 2 == entry.fSettings.fArgs.size());
+    auto enabled = entry.fSettings.fArgs.find(SkSL::String("enabled"));
+    REPORTER_ASSERT(r, enabled != entry.fSettings.fArgs.end() &&
+                       SkSL::Program::Settings::Value::kBool_Kind == enabled->second.fKind &&
+                       1 == enabled->second.fValue);
+    auto count = entry.fSettings.fArgs.find(SkSL::String("count"));
+    REPORTER_ASSERT(r, count != entry.fSettings.fArgs.end() &&
+                       SkSL::Program::Settings::Value::kInt_Kind == count->second.fKind &&
+                       -3 == count->second.fValue);
+
+    // Truncated or foreign data (e.g. a program binary) must be rejected.
+    sk_sp<SkData> data = encode(fragment);
+    for (size_t size : { (size_t) 0, (size_t) 4, data->size() / 2, data->size() - 4 }) {
+        REPORTER_ASSERT(r, !Precompiler::Decode(*SkData::MakeWithCopy(data->data(), size),
+                                                &entry));
+    }
+    uint8_t garbage[64];
+    memset(garbage, 0xAB, sizeof(garbage));
+    REPORTER_ASSERT(r, !Precompiler::Decode(*SkData::MakeWithCopy(garbage, sizeof(garbage)),
+                                            &entry));
+}
+
+DEF_TEST(GrGLShaderPrecompilerCompile, r) {
+    sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+    sk_sp<Precompiler> precompiler(new Precompiler(caps));
+    SkSL::String fragment = fragment_sksl(0);
+    REPORTER_ASSERT(r, precompiler->add(*make_key(0), *encode(fragment)));
+    REPORTER_ASSERT(r, !precompiler->add(*make_key(0), *encode(fragment)));
+    REPORTER_ASSERT(r, precompiler->add(*make_key(1), *encode(SkSL::String("not sksl"))));
+    REPORTER_ASSERT(r, !precompiler->add(*make_key(2), *SkData::MakeEmpty()));
+    REPORTER_ASSERT(r, 2 == precompiler->count());
+    precompiler->compile(nullptr);
+
+    int key = 0;
+    const Precompiler::Entry* entry = precompiler->find(&key, sizeof(key));
+    REPORTER_ASSERT(r, entry);
+    if (entry) {
+        REPORTER_ASSERT(r, entry->fGLSL[Precompiler::kVertex_ShaderType] ==
+                           to_glsl(caps.get(), SkSL::Program::kVertex_Kind,
+                                   SkSL::String(kVertexSkSL)));
+        REPORTER_ASSERT(r, entry->fGLSL[Precompiler::kGeometry_ShaderType].empty());
+        REPORTER_ASSERT(r, entry->fGLSL[Precompiler::kFragment_ShaderType] ==
+                           to_glsl(caps.get(), SkSL::Program::kFragment_Kind, fragment));
+    }
+    // Entries which fail to compile are left for the program builder to report.
+    key = 1;
+    REPORTER_ASSERT(r, !precompiler->find(&key, sizeof(key)));
+    key = 2;
+    REPORTER_ASSERT(r, !precompiler->find(&key, sizeof(key)));
+}
+
+DEF_TEST(GrGLShaderPrecompilerThreaded, r) {
+    static const int kProgramCount = 50;
+    sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkTaskGroup taskGroup(*executor);
+    sk_sp<Precompiler> precompiler(new Precompiler(caps));
+    for (int i = 0; i < kProgramCount; ++i) {
+        REPORTER_ASSERT(r, precompiler->add(*make_key(i), *encode(fragment_sksl(i))));
+    }
+    precompiler->compile(&taskGroup);
+
+    for (int i = 0; i < kProgramCount; ++i) {
+        const Precompiler::Entry* entry = precompiler->find(&i, sizeof(i));
+        REPORTER_ASSERT(r, entry);
+        if (entry) {
+            REPORTER_ASSERT(r, entry->fGLSL[Precompiler::kFragment_ShaderType] ==
+                               to_glsl(caps.get(), SkSL::Program::kFragment_Kind,
+                                       fragment_sksl(i)));
+        }
+    }
+    taskGroup.wait();
+}
+
+namespace {
+// Holds tasks until they are borrowed, so the test controls when the compile tasks run.
+class DeferredExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override { fWork.push_back(std::move(work)); }
+    void borrow() override {
+        if (!fWork.empty()) {
+            std::function<void(void)> work = std::move(fWork.front());
+            fWork.pop_front();
+            work();
+        }
+    }
+
+private:
+    std::deque<std::function<void(void)>> fWork;
+};
+}
+
+DEF_TEST(GrGLShaderPrecompilerFindBeforeTask, r) {
+    sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+    DeferredExecutor executor;
+    SkTaskGroup taskGroup(executor);
+    sk_sp<Precompiler> precompiler(new Precompiler(caps));
+    for (int i = 0; i < 2; ++i) {
+        REPORTER_ASSERT(r, precompiler->add(*make_key(i), *encode(fragment_sksl(i))));
+    }
+    precompiler->compile(&taskGroup);
+
+    // No task has run yet, so find() compiles the entry itself instead of waiting.
+    int key = 1;
+    const Precompiler::Entry* entry = precompiler->find(&key, sizeof(key));
+    REPORTER_ASSERT(r, entry);
+    if (entry) {
+        REPORTER_ASSERT(r, entry->fGLSL[Precompiler::kFragment_ShaderType] ==
+                           to_glsl(caps.get(), SkSL::Program::kFragment_Kind, fragment_sksl(1)));
+    }
+
+    // The task skips the entry find() claimed and compiles the other.
+    taskGroup.wait();
+    for (int i = 0; i < 2; ++i) {
+        entry = precompiler->find(&i, sizeof(i));
+        REPORTER_ASSERT(r, entry);
+        if (entry) {
+            REPORTER_ASSERT(r, entry->fGLSL[Precompiler::kFragment_ShaderType] ==
+                               to_glsl(caps.get(), SkSL::Program::kFragment_Kind,
+                                       fragment_sksl(i)));
+        }
+    }
+}
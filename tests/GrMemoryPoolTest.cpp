@@ -10,6 +10,7 @@
 #include "SkRandom.h"
 #include "SkTArray.h"
 #include "SkTDArray.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 
 // A is the top of an inheritance tree of classes that overload op new and
@@ -318,3 +319,94 @@ DEF_TEST(GrMemoryPoolAPI, reporter) {
         REPORTER_ASSERT(reporter, pool.size() == hugeBlockSize + kMinAllocSize);
     }
 }
+
+DEF_TEST(GrMemoryPoolBlockCache, reporter) {
+    constexpr size_t kBlockSize = GrMemoryPool::kSmallestMinAllocSize * 4;
+    constexpr int kMaxBlocksPerShard = 4;
+    GrMemoryPoolBlockCache cache(kBlockSize, kMaxBlocksPerShard);
+    GrMemoryPoolBlockCache::Stats stats;
+
+    // The first pool has to malloc all of its blocks.
+    {
+        GrMemoryPool pool(kBlockSize, kBlockSize, &cache);
+        AutoPoolReleaser r(pool);
+        for (int i = 0; i < 3; ++i) {
+            size_t origPoolSize = pool.size();
+            while (pool.size() == origPoolSize) {
+                r.add(pool.allocate(31));
+            }
+        }
+        cache.getStats(&stats);
+        REPORTER_ASSERT(reporter, stats.fAllocatedBlocks == 4);
+        REPORTER_ASSERT(reporter, stats.fRecycledBlocks == 0);
+    }
+    cache.getStats(&stats);
+    REPORTER_ASSERT(reporter, stats.fCachedBlocks == 4);
+    REPORTER_ASSERT(reporter, stats.fFreedBlocks == 0);
+
+    // A second pool on the same thread reuses them.
+    {
+        GrMemoryPool pool(kBlockSize, kBlockSize, &cache);
+        AutoPoolReleaser r(pool);
+        size_t origPoolSize = pool.size();
+        while (pool.size() == origPoolSize) {
+            r.add(pool.allocate(31));
+        }
+        cache.getStats(&stats);
+        REPORTER_ASSERT(reporter, stats.fAllocatedBlocks == 4);
+        REPORTER_ASSERT(reporter, stats.fRecycledBlocks == 2);
+    }
+
+    // Blocks of other sizes aren't cached.
+    {
+        GrMemoryPool pool(kBlockSize, kBlockSize, &cache);
+        AutoPoolReleaser r(pool);
+        r.add(pool.allocate(kBlockSize * 2));
+    }
+    cache.getStats(&stats);
+    REPORTER_ASSERT(reporter, stats.fAllocatedBlocks == 5);
+    REPORTER_ASSERT(reporter, stats.fFreedBlocks == 1);
+
+    cache.purge();
+    void* block = cache.acquire(kBlockSize);
+    cache.getStats(&stats);
+    REPORTER_ASSERT(reporter, stats.fAllocatedBlocks == 6);
+    cache.recycle(block, kBlockSize);
+}
+
+// Simulates DDL recorders on many threads creating, filling, and destroying their op pools.
+DEF_TEST(GrMemoryPoolBlockCacheThreaded, reporter) {
+    constexpr size_t kBlockSize = GrMemoryPool::kSmallestMinAllocSize * 4;
+    GrMemoryPoolBlockCache cache(kBlockSize, 8);
+    std::atomic<int> failures{0};
+    SkTaskGroup().batch(16, [&](int threadIndex) {
+        SkRandom random(threadIndex);
+        for (int p = 0; p < 20; ++p) {
+            GrMemoryPool pool(kBlockSize, kBlockSize, &cache);
+            SkTDArray<int*> allocs;
+            for (int i = 0; i < 500; ++i) {
+                int count = random.nextRangeU(1, 64);
+                int* alloc = static_cast<int*>(pool.allocate(count * sizeof(int) + sizeof(int)));
+                alloc[0] = count;
+                for (int j = 1; j <= count; ++j) {
+                    alloc[j] = threadIndex + j;
+                }
+                *allocs.append() = alloc;
+            }
+            for (int* alloc : allocs) {
+                for (int j = 1; j <= alloc[0]; ++j) {
+                    if (alloc[j] != threadIndex + j) {
+                        failures.fetch_add(1);
+                        break;
+                    }
+                }
+                pool.release(alloc);
+            }
+        }
+    });
+    REPORTER_ASSERT(reporter, !failures.load());
+    GrMemoryPoolBlockCache::Stats stats;
+    cache.getStats(&stats);
+    REPORTER_ASSERT(reporter, stats.fRecycledBlocks + stats.fAllocatedBlocks ==
+                              stats.fCachedBlocks + stats.fFreedBlocks);
+}
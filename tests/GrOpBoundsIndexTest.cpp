@@ -0,0 +1,79 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "GrOpBoundsIndex.h"
+#include "GrRect.h"
+#include "SkRandom.h"
+#include "SkTArray.h"
+
+static SkRect random_rect(SkRandom* random, SkScalar width, SkScalar height) {
+    // Allow rects that extend past the edges of the target, and some that are very thin.
+    SkScalar l = random->nextRangeScalar(-0.25f * width, 1.25f * width);
+    SkScalar t = random->nextRangeScalar(-0.25f * height, 1.25f * height);
+    SkScalar w = random->nextBool() ? random->nextRangeScalar(0, 0.5f * width)
+                                    : random->nextRangeScalar(0, 2);
+    SkScalar h = random->nextBool() ? random->nextRangeScalar(0, 0.5f * height)
+                                    : random->nextRangeScalar(0, 2);
+    return SkRect::MakeXYWH(l, t, w, h);
+}
+
+static int brute_force_last_overlap(const SkTArray<SkRect>& bounds, const SkTArray<bool>& inserted,
+                                    const SkRect& rect, int minIndex) {
+    for (int i = bounds.count() - 1; i >= SkTMax(minIndex, 0); --i) {
+        if (inserted[i] && GrRectsOverlap(bounds[i], rect)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Compares the index against a linear search while inserting, growing, and querying random rects.
+DEF_TEST(GrOpBoundsIndex, reporter) {
+    static constexpr int kWidth = 300;
+    static constexpr int kHeight = 170;
+    SkRandom random;
+    for (int iter = 0; iter < 10; ++iter) {
+        GrOpBoundsIndex index(kWidth, kHeight);
+        SkTArray<SkRect> bounds;
+        SkTArray<bool> inserted;
+        for (int i = 0; i < 500; ++i) {
+            SkRect rect = random_rect(&random, kWidth, kHeight);
+            int minIndex = bounds.count() - static_cast<int>(random.nextRangeU(1, 100));
+            int expected = brute_force_last_overlap(bounds, inserted, rect, minIndex);
+            REPORTER_ASSERT(reporter, index.findLastOverlap(rect, minIndex) == expected);
+
+            // Like an op list: some new entries are not indexed (chained ops) and some existing
+            // entries grow (merged ops).
+            bounds.push_back(rect);
+            inserted.push_back(random.nextULessThan(4) != 0);
+            if (inserted.back()) {
+                index.insert(bounds.count() - 1, rect);
+            }
+            if (random.nextBool()) {
+                int grow = random.nextULessThan(bounds.count());
+                if (inserted[grow]) {
+                    bounds[grow].join(random_rect(&random, kWidth, kHeight));
+                    index.insert(grow, bounds[grow]);
+                }
+            }
+        }
+        index.reset();
+        REPORTER_ASSERT(reporter, index.findLastOverlap(SkRect::MakeWH(kWidth, kHeight), 0) == -1);
+    }
+
+    // Infinite bounds overlap everything that isn't empty, NaN bounds overlap nothing.
+    GrOpBoundsIndex index(kWidth, kHeight);
+    index.insert(0, SkRect::MakeLTRB(10, 10, 20, 20));
+    index.insert(1, SkRect::MakeLTRB(-SK_ScalarInfinity, -SK_ScalarInfinity,
+                                     SK_ScalarInfinity, SK_ScalarInfinity));
+    index.insert(2, SkRect::MakeLTRB(SK_ScalarNaN, 0, 10, 10));
+    REPORTER_ASSERT(reporter, index.findLastOverlap(SkRect::MakeLTRB(5000, 5000, 5001, 5001), 0)
+                              == 1);
+    REPORTER_ASSERT(reporter, index.findLastOverlap(SkRect::MakeLTRB(15, 15, 16, 16), 2) == -1);
+    REPORTER_ASSERT(reporter, index.findLastOverlap(SkRect::MakeLTRB(15, 15, 16, 16), 0) == 1);
+}
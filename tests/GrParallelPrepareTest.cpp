@@ -0,0 +1,134 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTypes.h"
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrContextOptions.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+#include <atomic>
+
+namespace {
+// Forwards to a thread pool, counting the tasks so the test knows ops were prepared off-thread.
+class CountingExecutor final : public SkExecutor {
+public:
+    CountingExecutor() : fThreads(SkExecutor::MakeFIFOThreadPool(4)) {}
+
+    void add(std::function<void(void)> work) override {
+        ++fTaskCount;
+        fThreads->add(std::move(work));
+    }
+    void borrow() override { fThreads->borrow(); }
+
+    int taskCount() const { return fTaskCount; }
+
+private:
+    std::unique_ptr<SkExecutor> fThreads;
+    std::atomic<int>            fTaskCount{0};
+};
+}
+
+static constexpr int kSize = 256;
+
+static SkPath make_star(SkScalar x, SkScalar y, SkScalar radius) {
+    SkPath path;
+    path.moveTo(x, y - radius);
+    for (int i = 1; i < 5; ++i) {
+        SkScalar angle = i * 4 * SK_ScalarPI / 5;
+        path.lineTo(x + radius * SkScalarSin(angle), y - radius * SkScalarCos(angle));
+    }
+    path.close();
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    return path;
+}
+
+static SkPath make_convex(SkScalar x, SkScalar y, SkScalar radius) {
+    SkPath path;
+    path.moveTo(x - radius, y);
+    path.quadTo(x - radius, y - radius, x, y - radius);
+    path.quadTo(x + radius, y - radius, x + radius, y);
+    path.lineTo(x, y + radius);
+    path.close();
+    return path;
+}
+
+// Draws enough tessellated and AA-linearized paths that several ops prepare in parallel.
+static bool draw(GrContext* context, SkBitmap* bitmap) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        return false;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint;
+    for (int i = 0; i < 16; ++i) {
+        SkScalar x = 16 + 32 * (i % 8);
+        SkScalar y = 16 + 32 * (i / 8);
+        paint.setColor(0xFF000000 | (i * 0x0F0D0B));
+        paint.setAntiAlias(i & 1);
+        paint.setStyle(SkPaint::kFill_Style);
+        canvas->drawPath(make_star(x, y, 14 + (i & 3)), paint);
+
+        paint.setAntiAlias(true);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(1 + (i & 3));
+        canvas->drawPath(make_convex(x, y + 64, 10 + (i & 3)), paint);
+    }
+    bitmap->allocPixels(info);
+    return surface->readPixels(*bitmap, 0, 0);
+}
+
+DEF_GPUTEST(GrParallelPrepare_MatchesSerial, reporter, options) {
+    GrContextOptions serialOptions(options);
+    serialOptions.fGpuPathRenderers = GpuPathRenderers::kTessellating |
+                                      GpuPathRenderers::kAALinearizing;
+    serialOptions.fExecutor = nullptr;
+    CountingExecutor executor;
+    GrContextOptions parallelOptions(serialOptions);
+    parallelOptions.fExecutor = &executor;
+
+    for (int typeInt = 0; typeInt < sk_gpu_test::GrContextFactory::kContextTypeCnt; ++typeInt) {
+        auto contextType = (sk_gpu_test::GrContextFactory::ContextType) typeInt;
+        if (!sk_gpu_test::GrContextFactory::IsRenderingContext(contextType)) {
+            continue;
+        }
+        sk_gpu_test::GrContextFactory serialFactory(serialOptions);
+        sk_gpu_test::GrContextFactory parallelFactory(parallelOptions);
+        GrContext* serialContext = serialFactory.get(contextType);
+        GrContext* parallelContext = parallelFactory.get(contextType);
+        if (!serialContext || !parallelContext) {
+            continue;
+        }
+        skiatest::ReporterContext ctx(
+                reporter, SkString(sk_gpu_test::GrContextFactory::ContextTypeName(contextType)));
+
+        SkBitmap serial, parallel;
+        int taskCount = executor.taskCount();
+        if (!draw(serialContext, &serial) || !draw(parallelContext, &parallel)) {
+            continue;
+        }
+        REPORTER_ASSERT(reporter, executor.taskCount() > taskCount);
+
+        // The ops generate the same vertices either way, so the results match exactly.
+        int mismatches = 0;
+        for (int y = 0; y < kSize; ++y) {
+            if (memcmp(serial.getAddr32(0, y), parallel.getAddr32(0, y), kSize * 4)) {
+                ++mismatches;
+            }
+        }
+        REPORTER_ASSERT(reporter, !mismatches, "%d rows differ", mismatches);
+    }
+}
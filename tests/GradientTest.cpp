@@ -12,6 +12,7 @@
 #include "SkShader.h"
 #include "SkSurface.h"
 #include "SkTemplates.h"
+#include "SkTDArray.h"
 #include "SkTLazy.h"
 #include "Test.h"
 
@@ -538,6 +539,94 @@ static void test_sweep_fuzzer(skiatest::Reporter*) {
     }
 }
 
+static void draw_clamped_conical(const SkColor colors[], const SkScalar pos[], int count,
+                                 SkBitmap* bitmap) {
+    // The circles are centered on x = 128 with radii 32 and 96, so t is below 0 near the center
+    // and above 1 at either end. Unlike linear gradients, these aren't drawn in bursts.
+    const SkPoint center = { 128, 0.5f };
+    SkImageInfo info = SkImageInfo::Make(256, 1, kN32_SkColorType, kPremul_SkAlphaType,
+                                         SkColorSpace::MakeSRGB());
+    sk_sp<SkSurface> surface = SkSurface::MakeRaster(info);
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeTwoPointConical(center, 32, center, 96, colors, pos,
+                                                          count, SkShader::kClamp_TileMode));
+    surface->getCanvas()->drawPaint(paint);
+    bitmap->allocPixels(info);
+    surface->readPixels(*bitmap, 0, 0);
+}
+
+static bool nearly_equal(SkPMColor a, SkPMColor b, int tolerance) {
+    for (int shift : { 0, 8, 16, 24 }) {
+        if (SkTAbs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Raster pipelines sample gradients with many stops from a table. With stops added to make
+// enough of them, they must draw like the same gradient through the gradient stage, including t
+// beyond 0 and 1, which clamp mode doesn't clamp for stops which aren't evenly spaced.
+static void test_many_stops_match_few(skiatest::Reporter* reporter) {
+    SkTDArray<SkColor> colors;
+    SkTDArray<SkScalar> pos;
+    for (int i = 0; i <= 12; ++i) {
+        colors.push_back(SkColorSetRGB(i * 20, 255 - i * 20, (i & 1) * 255));
+        pos.push_back(i / 12.0f);
+    }
+    // Repeating the stop at 0.5 doesn't change the gradient.
+    SkTDArray<SkColor> moreColors(colors);
+    SkTDArray<SkScalar> morePos(pos);
+    const int half = 6;
+    while (moreColors.count() < 64) {
+        *moreColors.insert(half) = colors[half];
+        *morePos.insert(half) = pos[half];
+    }
+
+    SkBitmap few, many;
+    draw_clamped_conical(colors.begin(), pos.begin(), colors.count(), &few);
+    draw_clamped_conical(moreColors.begin(), morePos.begin(), moreColors.count(), &many);
+    for (int x = 0; x < few.width(); ++x) {
+        // The table's entries are interpolated, which is close but not exact.
+        REPORTER_ASSERT(reporter, nearly_equal(*few.getAddr32(x, 0), *many.getAddr32(x, 0), 2),
+                        "x = %d: %08x != %08x", x, *few.getAddr32(x, 0), *many.getAddr32(x, 0));
+    }
+}
+
+// A table entry on either side of a hard stop would blend across it. Pixels this close to one must
+// still take the exact color on their side.
+static void test_many_stops_interior_hard_stop(skiatest::Reporter* reporter) {
+    constexpr int kWidth = 4096;
+    constexpr int kHalf = 32;
+    SkColor colors[2 * kHalf];
+    SkScalar pos[2 * kHalf];
+    for (int i = 0; i < kHalf; ++i) {
+        colors[i] = SK_ColorRED;
+        pos[i] = i / (2 * kHalf - 2.0f);
+        colors[kHalf + i] = SK_ColorBLUE;
+        pos[kHalf + i] = (kHalf - 1 + i) / (2 * kHalf - 2.0f);
+    }
+    SkImageInfo info = SkImageInfo::Make(kWidth, 1, kN32_SkColorType, kPremul_SkAlphaType,
+                                         SkColorSpace::MakeSRGB());
+    sk_sp<SkSurface> surface = SkSurface::MakeRaster(info);
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeRadial({ 0, 0.5f }, kWidth, colors, pos, 2 * kHalf,
+                                                 SkShader::kClamp_TileMode));
+    surface->getCanvas()->drawPaint(paint);
+    SkBitmap bitmap;
+    bitmap.allocPixels(info);
+    surface->readPixels(bitmap, 0, 0);
+    REPORTER_ASSERT(reporter, *bitmap.getAddr32(kWidth / 2 - 1, 0) ==
+                              SkPreMultiplyColor(SK_ColorRED));
+    REPORTER_ASSERT(reporter, *bitmap.getAddr32(kWidth / 2, 0) ==
+                              SkPreMultiplyColor(SK_ColorBLUE));
+}
+
+DEF_TEST(Gradient_ManyStops, reporter) {
+    test_many_stops_match_few(reporter);
+    test_many_stops_interior_hard_stop(reporter);
+}
+
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestGradientOptimization(reporter);
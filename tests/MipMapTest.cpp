@@ -106,6 +106,43 @@ DEF_TEST(MipMap_DirectLevelAccess, reporter) {
     test_mipmap_generation(1000, 1000, 9, reporter);
 }
 
+// Large levels are built in bands of rows, which must match filtering the whole level at once.
+DEF_TEST(MipMap_LargeLevels, reporter) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeA8(1024, 1023));
+    SkRandom rand;
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            *bm.getAddr8(x, y) = SkToU8(rand.nextU() >> 24);
+        }
+    }
+    sk_sp<SkMipMap> mm(SkMipMap::Build(bm, nullptr));
+    REPORTER_ASSERT(reporter, mm);
+    if (!mm) {
+        return;
+    }
+
+    SkMipMap::Level level;
+    REPORTER_ASSERT(reporter, mm->getLevel(0, &level));
+    const SkPixmap& pm = level.fPixmap;
+    REPORTER_ASSERT(reporter, pm.width() == 512 && pm.height() == 511);
+
+    // The source height is odd, so each pixel is a 2x3 triangle filter of the source.
+    int mismatches = 0;
+    for (int y = 0; y < pm.height(); ++y) {
+        for (int x = 0; x < pm.width(); ++x) {
+            unsigned sum = 0;
+            for (int dx = 0; dx < 2; ++dx) {
+                sum += *bm.getAddr8(2*x + dx, 2*y + 0) +
+                       *bm.getAddr8(2*x + dx, 2*y + 1) * 2 +
+                       *bm.getAddr8(2*x + dx, 2*y + 2);
+            }
+            mismatches += *pm.addr8(x, y) != (sum >> 3);
+        }
+    }
+    REPORTER_ASSERT(reporter, 0 == mismatches);
+}
+
 struct LevelCountScenario {
     int fWidth;
     int fHeight;
@@ -822,6 +822,48 @@ static void test_remove_scratch_key(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, 0 == cache->getResourceCount());
 }
 
+static void test_scratch_reuse_order(skiatest::Reporter* reporter) {
+    Mock mock(5, 30000);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+    GrGpu* gpu = context->contextPriv().getGpu();
+
+    TestResource* a = TestResource::CreateScratch(gpu, SkBudgeted::kYes,
+                                                  TestResource::kB_SimulatedProperty);
+    TestResource* b = TestResource::CreateScratch(gpu, SkBudgeted::kYes,
+                                                  TestResource::kB_SimulatedProperty);
+    TestResource* c = TestResource::CreateScratch(gpu, SkBudgeted::kYes,
+                                                  TestResource::kB_SimulatedProperty);
+    GrScratchKey scratchKey;
+    TestResource::ComputeScratchKey(TestResource::kB_SimulatedProperty, &scratchKey);
+
+    // Scratch lookups return the most recently freed resources first.
+    b->unref();
+    c->unref();
+    a->unref();
+    GrGpuResource* find;
+    find = cache->findAndRefScratchResource(scratchKey, TestResource::kDefaultSize, 0);
+    REPORTER_ASSERT(reporter, find == a);
+    find = cache->findAndRefScratchResource(scratchKey, TestResource::kDefaultSize, 0);
+    REPORTER_ASSERT(reporter, find == c);
+
+    // A resource that is freed again becomes the preferred one.
+    a->unref();
+    find = cache->findAndRefScratchResource(scratchKey, TestResource::kDefaultSize, 0);
+    REPORTER_ASSERT(reporter, find == a);
+    find = cache->findAndRefScratchResource(scratchKey, TestResource::kDefaultSize, 0);
+    REPORTER_ASSERT(reporter, find == b);
+    REPORTER_ASSERT(reporter, !cache->findAndRefScratchResource(scratchKey,
+                                                                TestResource::kDefaultSize, 0));
+    SkDEBUGCODE(REPORTER_ASSERT(reporter, 3 == cache->countScratchEntriesForKey(scratchKey));)
+
+    a->unref();
+    b->unref();
+    c->unref();
+    cache->purgeAllUnlocked();
+    REPORTER_ASSERT(reporter, 0 == TestResource::NumAlive());
+}
+
 static void test_scratch_key_consistency(skiatest::Reporter* reporter) {
     Mock mock(5, 30000);
     GrContext* context = mock.context();
@@ -1349,6 +1391,75 @@ static void test_time_purge(skiatest::Reporter* reporter) {
     }
 }
 
+// Checks that time based and scratch only purges follow the order in which resources became
+// purgeable, including resources that lose their unique key while purgeable.
+static void test_purge_age_order(skiatest::Reporter* reporter) {
+    Mock mock(1000, 1000000);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+    GrGpu* gpu = context->contextPriv().getGpu();
+
+    auto nowish = []() {
+        // Sleep so that the time point is distinct from when any resource became purgeable.
+        std::this_thread::sleep_for(GrStdSteadyClock::duration(5));
+        auto result = GrStdSteadyClock::now();
+        std::this_thread::sleep_for(GrStdSteadyClock::duration(5));
+        return result;
+    };
+
+    GrUniqueKey key1, key2;
+    make_unique_key<0>(&key1, 1);
+    make_unique_key<0>(&key2, 2);
+
+    // Interleave scratch and uniquely keyed resources, all of which have scratch keys.
+    TestResource* unique1 = TestResource::CreateScratch(gpu, SkBudgeted::kYes,
+                                                        TestResource::kA_SimulatedProperty);
+    unique1->resourcePriv().setUniqueKey(key1);
+    TestResource* scratch1 = TestResource::CreateScratch(gpu, SkBudgeted::kYes,
+                                                         TestResource::kA_SimulatedProperty);
+    TestResource* unique2 = TestResource::CreateScratch(gpu, SkBudgeted::kYes,
+                                                        TestResource::kA_SimulatedProperty);
+    unique2->resourcePriv().setUniqueKey(key2);
+    TestResource* scratch2 = TestResource::CreateScratch(gpu, SkBudgeted::kYes,
+                                                         TestResource::kA_SimulatedProperty);
+
+    GrStdSteadyClock::time_point times[4];
+    unique1->unref();
+    times[0] = nowish();
+    scratch1->unref();
+    times[1] = nowish();
+    unique2->unref();
+    times[2] = nowish();
+    scratch2->unref();
+    times[3] = nowish();
+    REPORTER_ASSERT(reporter, 4 == cache->getResourceCount());
+
+    cache->purgeResourcesNotUsedSince(times[0]);
+    REPORTER_ASSERT(reporter, 3 == cache->getResourceCount());
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(key1));
+
+    // Give key2 to a new resource. unique2 becomes a purgeable scratch resource but keeps its age.
+    TestResource* unique3 = new TestResource(gpu);
+    unique3->resourcePriv().setUniqueKey(key2);
+    REPORTER_ASSERT(reporter, !unique2->getUniqueKey().isValid());
+    REPORTER_ASSERT(reporter, 4 == cache->getResourceCount());
+
+    // The oldest scratch resource goes first.
+    context->purgeUnlockedResources(TestResource::kDefaultSize, true);
+    REPORTER_ASSERT(reporter, 3 == cache->getResourceCount());
+    cache->purgeResourcesNotUsedSince(times[2]);
+    REPORTER_ASSERT(reporter, 2 == cache->getResourceCount());
+    cache->purgeResourcesNotUsedSince(times[3]);
+    REPORTER_ASSERT(reporter, 1 == cache->getResourceCount());
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key2));
+
+    unique3->unref();
+    cache->purgeUnlockedResources(true);
+    REPORTER_ASSERT(reporter, 1 == cache->getResourceCount());
+    cache->purgeResourcesNotUsedSince(nowish());
+    REPORTER_ASSERT(reporter, 0 == cache->getResourceCount());
+}
+
 static void test_partial_purge(skiatest::Reporter* reporter) {
     Mock mock(6, 100);
     GrContext* context = mock.context();
@@ -1647,12 +1758,14 @@ DEF_GPUTEST(ResourceCacheMisc, reporter, /* options */) {
     test_duplicate_unique_key(reporter);
     test_duplicate_scratch_key(reporter);
     test_remove_scratch_key(reporter);
+    test_scratch_reuse_order(reporter);
     test_scratch_key_consistency(reporter);
     test_purge_invalidated(reporter);
     test_cache_chained_purge(reporter);
     test_timestamp_wrap(reporter);
     test_flush(reporter);
     test_time_purge(reporter);
+    test_purge_age_order(reporter);
     test_partial_purge(reporter);
     test_large_resource_count(reporter);
     test_custom_data(reporter);
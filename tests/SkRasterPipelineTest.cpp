@@ -7,6 +7,7 @@
 
 #include "../src/jumper/SkJumper.h"
 #include "SkHalf.h"
+#include "SkMatrix.h"
 #include "SkRasterPipeline.h"
 #include "SkTo.h"
 #include "Test.h"
@@ -201,3 +202,214 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipeline_bilerp_sdf, r) {
+    const uint8_t field[] = { 0, 64, 128, 192, 255 };
+    uint8_t coverage[5];
+
+    SkJumper_SDFCtx sdf;
+    sdf.gather = { field, 5, 5.0f, 1.0f };
+    SkJumper_MemoryCtx store_ctx = { coverage, 5 };
+
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::seed_shader);
+    p.append(SkRasterPipeline::bilerp_sdf, &sdf);
+    p.append(SkRasterPipeline::store_a8, &store_ctx);
+
+    // Sampling at the texel centers gives the field's values, scaled and biased.
+    sdf.scale = 1.0f;
+    sdf.bias = 0.0f;
+    p.run(0,0,5,1);
+    for (int i = 0; i < 5; ++i) {
+        REPORTER_ASSERT(r, SkTAbs(coverage[i] - field[i]) <= 1);
+    }
+
+    // Coverage is clamped to [0,1].
+    sdf.scale = 2.0f;
+    sdf.bias = -0.5f;
+    p.run(0,0,5,1);
+    REPORTER_ASSERT(r, coverage[0] == 0);
+    REPORTER_ASSERT(r, SkTAbs(coverage[2] - 128) <= 1);
+    REPORTER_ASSERT(r, coverage[4] == 255);
+}
+
+DEF_TEST(SkRasterPipeline_aniso_clamp_8888, r) {
+    // Alternating black and white columns above, and solid red below.
+    const int kW = 64, kH = 8;
+    uint32_t image[kW * kH];
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < kW; ++x) {
+            image[y*kW + x] = y < kH/2 ? ((x & 1) ? 0xffffffff : 0xff000000) : 0xff0000ff;
+        }
+    }
+    uint32_t colors[8 * kH];
+
+    // Draw the image 8x narrower, with a tap for each column of the footprint.
+    SkJumper_AnisoCtx aniso;
+    aniso.gather = { image, kW, (float)kW, (float)kH };
+    SkMatrix::MakeScale(8, 1).get9(aniso.matrix);
+    aniso.taps = 8;
+    aniso.invTaps = 1.0f / 8;
+    SkJumper_MemoryCtx store_ctx = { colors, 8 };
+
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::seed_shader);
+    p.append(SkRasterPipeline::aniso_clamp_8888, &aniso);
+    p.append(SkRasterPipeline::store_8888, &store_ctx);
+    p.run(0,0,8,kH);
+
+    // The columns average to gray, without blurring into the rows below.
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            uint32_t c = colors[y*8 + x];
+            if (y < kH/2) {
+                REPORTER_ASSERT(r, SkTAbs((int)(c & 0xff) - 0x80) <= 1 && (c >> 24) == 0xff);
+            } else {
+                REPORTER_ASSERT(r, c == 0xff0000ff);
+            }
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_gradient_lut, r) {
+    // Red to green to blue, evenly spaced from t=0 to t=1.
+    const float lut[] = {
+        1,0,0,1,  0,1,0,1,  0,0,1,1,
+    };
+    SkJumper_GatherCtx gather = { lut, 3, 3.0f, 1.0f };
+
+    // x = 0.5, 1.5, ... 5.5 maps to t = 0, 0.25, ... 1.25, which is clamped to 1.
+    const float matrix[] = { 0.25f,0, 0,0, -0.125f,0 };
+
+    float highp[4 * 6];
+    uint32_t lowp[6];
+    SkJumper_MemoryCtx highp_ctx = { highp, 0 },
+                        lowp_ctx = { lowp,  0 };
+
+    for (bool isLowp : {false, true}) {
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::seed_shader);
+        p.append(SkRasterPipeline::matrix_2x3, matrix);
+        p.append(SkRasterPipeline::gradient_lut, &gather);
+        p.append(isLowp ? SkRasterPipeline::store_8888 : SkRasterPipeline::store_f32,
+                 isLowp ? &lowp_ctx : &highp_ctx);
+        p.run(0,0,6,1);
+    }
+
+    const float expected[][4] = {
+        {1,0,0,1}, {0.5f,0.5f,0,1}, {0,1,0,1},
+        {0,0.5f,0.5f,1}, {0,0,1,1}, {0,0,1,1},
+    };
+    for (int i = 0; i < 6; i++) {
+        for (int c = 0; c < 4; c++) {
+            REPORTER_ASSERT(r, SkTAbs(highp[4*i + c] - expected[i][c]) < 1e-5f);
+            int byte = (lowp[i] >> (8*c)) & 0xff;
+            REPORTER_ASSERT(r, SkTAbs(byte - expected[i][c] * 255) <= 1);
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_sweep_and_concentric, r) {
+    // Each pixel's t is drawn as a black to white gradient, so we can check it in highp and lowp.
+    struct { float f[4], b[4]; } black_to_white = { {1,1,1,0}, {0,0,0,1} };
+
+    // Center the 16x16 grid of pixels on the origin, so we see every quadrant.
+    const float trans[] = { -8, -8 };
+
+    SkJumper_2PtConicalCtx concentric;
+    concentric.fP0 = 1/16.0f;
+    concentric.fP1 = 0.125f;
+
+    for (bool isSweep : {true, false}) {
+        float highp[4 * 256];
+        uint32_t lowp[256];
+        SkJumper_MemoryCtx highp_ctx = { highp, 16 },
+                            lowp_ctx = { lowp,  16 };
+
+        for (bool isLowp : {false, true}) {
+            SkRasterPipeline_<256> p;
+            p.append(SkRasterPipeline::seed_shader);
+            p.append(SkRasterPipeline::matrix_translate, trans);
+            if (isSweep) {
+                p.append(SkRasterPipeline::xy_to_unit_angle);
+            } else {
+                p.append(SkRasterPipeline::xy_to_2pt_conical_concentric, &concentric);
+            }
+            p.append(SkRasterPipeline::evenly_spaced_2_stop_gradient, &black_to_white);
+            p.append(isLowp ? SkRasterPipeline::store_8888 : SkRasterPipeline::store_f32,
+                     isLowp ? &lowp_ctx : &highp_ctx);
+            p.run(0,0,16,16);
+        }
+
+        for (int i = 0; i < 256; i++) {
+            float x = (i % 16) + 0.5f - 8,
+                  y = (i / 16) + 0.5f - 8;
+            float expected;
+            if (isSweep) {
+                expected = atan2f(y, x) / (2 * SK_ScalarPI);
+                expected += expected < 0 ? 1 : 0;
+            } else {
+                expected = sqrtf(x*x + y*y) * concentric.fP0 + concentric.fP1;
+            }
+            REPORTER_ASSERT(r, SkTAbs(highp[4*i] - expected) < 1e-4f);
+            REPORTER_ASSERT(r, SkTAbs(int(lowp[i] & 0xff) - expected * 255) <= 1);
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_2pt_conical_masks, r) {
+    // As above, t is drawn as black to white, but pixels where t is NaN or degenerate are masked
+    // to transparent.  The strip case produces NaNs, and the greater case produces both.
+    struct { float f[4], b[4]; } black_to_white = { {1,1,1,0}, {0,0,0,1} };
+
+    // x runs over [0,0.5) and y over [-0.5,0.5), so each case has valid and masked pixels.
+    const float scale_trans[] = { 1/32.0f, 1/16.0f, 0, -0.5f };
+
+    for (bool isStrip : {true, false}) {
+        SkJumper_2PtConicalCtx ctx;
+        ctx.fP0 = isStrip ? 0.0625f : 0.5f;
+        ctx.fP1 = 0;
+
+        float highp[4 * 256];
+        uint32_t lowp[256];
+        SkJumper_MemoryCtx highp_ctx = { highp, 16 },
+                            lowp_ctx = { lowp,  16 };
+
+        for (bool isLowp : {false, true}) {
+            SkRasterPipeline_<256> p;
+            p.append(SkRasterPipeline::seed_shader);
+            p.append(SkRasterPipeline::matrix_scale_translate, scale_trans);
+            if (isStrip) {
+                p.append(SkRasterPipeline::xy_to_2pt_conical_strip, &ctx);
+                p.append(SkRasterPipeline::mask_2pt_conical_nan, &ctx);
+            } else {
+                p.append(SkRasterPipeline::xy_to_2pt_conical_greater, &ctx);
+                p.append(SkRasterPipeline::mask_2pt_conical_degenerates, &ctx);
+            }
+            p.append(SkRasterPipeline::evenly_spaced_2_stop_gradient, &black_to_white);
+            p.append(SkRasterPipeline::apply_vector_mask, &ctx.fMask);
+            p.append(isLowp ? SkRasterPipeline::store_8888 : SkRasterPipeline::store_f32,
+                     isLowp ? &lowp_ctx : &highp_ctx);
+            p.run(0,0,16,16);
+        }
+
+        int masked = 0;
+        for (int i = 0; i < 256; i++) {
+            float x = ((i % 16) + 0.5f) / 32,
+                  y = ((i / 16) + 0.5f) / 16 - 0.5f;
+            float t = isStrip ? x + sqrtf(ctx.fP0 - y*y)
+                              : sqrtf(x*x - y*y) - x * ctx.fP0;
+            bool valid = isStrip ? !SkScalarIsNaN(t) : t > 0;
+            masked += valid ? 0 : 1;
+
+            float expected[4] = { t, t, t, 1 };
+            for (int c = 0; c < 4; c++) {
+                float e = valid ? expected[c] : 0;
+                REPORTER_ASSERT(r, SkTAbs(highp[4*i + c] - e) < 1e-4f);
+                int byte = (lowp[i] >> (8*c)) & 0xff;
+                REPORTER_ASSERT(r, SkTAbs(byte - e * 255) <= 1);
+            }
+        }
+        REPORTER_ASSERT(r, masked > 0 && masked < 256);
+    }
+}
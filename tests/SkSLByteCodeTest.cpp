@@ -0,0 +1,199 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSLByteCode.h"
+#include "SkSLCompiler.h"
+
+#include "Test.h"
+
+static const int W = SkSL::ByteCode::kVecWidth;
+
+// Runs 'void main(int x, int y, inout half4 color)' over the first count lanes, with x set to the
+// lane index, y to 7, and every lane's color starting as in. out receives all W lanes, so callers
+// can check that lanes past count were left alone. Returns false if compilation fails.
+static bool run(skiatest::Reporter* r, const char* src, const float in[4], float out[][4],
+                int count = W) {
+    SkSL::Compiler compiler;
+    SkSL::Program::Settings settings;
+    std::unique_ptr<SkSL::Program> program = compiler.convertProgram(
+                                                             SkSL::Program::kPipelineStage_Kind,
+                                                             SkSL::String(src), settings);
+    if (!program) {
+        ERRORF(r, "%s", compiler.errorText().c_str());
+        return false;
+    }
+    std::unique_ptr<SkSL::ByteCode> byteCode = compiler.toByteCode(*program);
+    if (!byteCode) {
+        ERRORF(r, "%s", compiler.errorText().c_str());
+        return false;
+    }
+    const SkSL::ByteCode::Function* main = byteCode->getFunction("main");
+    REPORTER_ASSERT(r, main && 6 == main->fParameterCount);
+    if (!main || 6 != main->fParameterCount) {
+        return false;
+    }
+    float args[6 * W];
+    for (int i = 0; i < W; ++i) {
+        int32_t x = i, y = 7;
+        memcpy(&args[0 * W + i], &x, sizeof(x));
+        memcpy(&args[1 * W + i], &y, sizeof(y));
+        for (int c = 0; c < 4; ++c) {
+            args[(2 + c) * W + i] = in[c];
+        }
+    }
+    std::vector<int32_t> registers(main->fRegisterCount * W);
+    SkSL::ByteCode::Run(*main, count, args, nullptr, registers.data());
+    for (int i = 0; i < W; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            out[i][c] = args[(2 + c) * W + i];
+        }
+    }
+    return true;
+}
+
+static void test(skiatest::Reporter* r, const char* src, float inR, float inG, float inB,
+                 float inA, float expectedR, float expectedG, float expectedB, float expectedA) {
+    const float in[4] = { inR, inG, inB, inA };
+    const float expected[4] = { expectedR, expectedG, expectedB, expectedA };
+    float out[W][4];
+    if (!run(r, src, in, out)) {
+        return;
+    }
+    for (int i = 0; i < W; ++i) {
+        if (memcmp(out[i], expected, sizeof(expected))) {
+            ERRORF(r, "%s\nlane %d: expected (%g, %g, %g, %g), but got (%g, %g, %g, %g)", src, i,
+                   expected[0], expected[1], expected[2], expected[3],
+                   out[i][0], out[i][1], out[i][2], out[i][3]);
+            return;
+        }
+    }
+}
+
+DEF_TEST(SkSLByteCodeArithmetic, r) {
+    test(r, "void main(int x, int y, inout half4 color) { color = color * 2 + 1; }",
+         0, 1, 2, 3, 1, 3, 5, 7);
+    test(r, "void main(int x, int y, inout half4 color) { color.r = color.g - color.b / 4; }",
+         0, 5, 2, 3, 4.5, 5, 2, 3);
+    test(r, "void main(int x, int y, inout half4 color) { color = -color; }",
+         1, -2, 3, -4, -1, 2, -3, 4);
+    test(r, "void main(int x, int y, inout half4 color) {"
+            "    int i = int(color.r) * 7 / 2 % 5; color.r = float(i); color.g = float(y + 1);"
+            "}",
+         3, 0, 0, 0, 0, 8, 0, 0);
+    test(r, "void main(int x, int y, inout half4 color) { color += half4(1, 2, 3, 4); }",
+         1, 1, 1, 1, 2, 3, 4, 5);
+}
+
+DEF_TEST(SkSLByteCodeSwizzle, r) {
+    test(r, "void main(int x, int y, inout half4 color) { color.rb = color.br; }",
+         1, 2, 3, 4, 3, 2, 1, 4);
+    test(r, "void main(int x, int y, inout half4 color) { color = color.aaar; }",
+         1, 2, 3, 4, 4, 4, 4, 1);
+    test(r, "void main(int x, int y, inout half4 color) {"
+            "    half2 v = color.gr; color = half4(v, v.yx);"
+            "}",
+         1, 2, 3, 4, 2, 1, 1, 2);
+}
+
+DEF_TEST(SkSLByteCodeIntrinsics, r) {
+    test(r, "void main(int x, int y, inout half4 color) {"
+            "    color = half4(abs(color.r), sqrt(color.g), clamp(color.b, 0, 1), cos(color.a));"
+            "}",
+         -2, 16, 1.5, 0, 2, 4, 1, 1);
+}
+
+DEF_TEST(SkSLByteCodeFunctions, r) {
+    test(r, "float half_of(float v) { return v / 2; }"
+            "void swap(inout half a, inout half b) { half t = a; a = b; b = t; }"
+            "void main(int x, int y, inout half4 color) {"
+            "    swap(color.r, color.g); color.b = half_of(color.b);"
+            "}",
+         1, 2, 3, 4, 2, 1, 1.5, 4);
+}
+
+DEF_TEST(SkSLByteCodeControlFlow, r) {
+    const float in[4] = { 0, 0, 0, 0 };
+    float out[W][4];
+    // Every lane takes its own path through the if, the ternary and the loop.
+    if (run(r, "void main(int x, int y, inout half4 color) {"
+               "    if (x < 3) {"
+               "        color.r = 1;"
+               "    } else if (x == 5) {"
+               "        color.r = 2;"
+               "    } else {"
+               "        color.r = 3;"
+               "    }"
+               "    color.g = x > 10 && x != 12 ? 1 : 0;"
+               "    for (int i = 0; i < x; ++i) {"
+               "        color.b += 1;"
+               "    }"
+               "    int j = x;"
+               "    while (j > 4) {"
+               "        j -= 4;"
+               "    }"
+               "    color.a = float(j);"
+               "}", in, out)) {
+        for (int i = 0; i < W; ++i) {
+            float expectedR = i < 3 ? 1 : (i == 5 ? 2 : 3);
+            float expectedG = i > 10 && i != 12 ? 1 : 0;
+            float expectedA = i > 4 ? (float) ((i - 1) % 4 + 1) : (float) i;
+            REPORTER_ASSERT(r, out[i][0] == expectedR, "lane %d: %g", i, out[i][0]);
+            REPORTER_ASSERT(r, out[i][1] == expectedG, "lane %d: %g", i, out[i][1]);
+            REPORTER_ASSERT(r, out[i][2] == (float) i, "lane %d: %g", i, out[i][2]);
+            REPORTER_ASSERT(r, out[i][3] == expectedA, "lane %d: %g", i, out[i][3]);
+        }
+    }
+}
+
+DEF_TEST(SkSLByteCodePartialLanes, r) {
+    const float in[4] = { 1, 2, 3, 4 };
+    const char* src = "void main(int x, int y, inout half4 color) {"
+                      "    color.r = float(x);"
+                      "    if (x > 1) {"
+                      "        color.g = 0;"
+                      "    }"
+                      "    for (int i = 0; i < x; ++i) {"
+                      "        color.b += 1;"
+                      "    }"
+                      "    color.a = color.a * 2;"
+                      "}";
+    for (int count : { 1, 3, W - 1 }) {
+        float out[W][4];
+        if (!run(r, src, in, out, count)) {
+            return;
+        }
+        for (int i = 0; i < count; ++i) {
+            const float expected[4] = { (float) i, i > 1 ? 0.0f : 2.0f, 3.0f + i, 8 };
+            REPORTER_ASSERT(r, !memcmp(out[i], expected, sizeof(expected)),
+                            "count %d, lane %d: (%g, %g, %g, %g)", count, i,
+                            out[i][0], out[i][1], out[i][2], out[i][3]);
+        }
+        // Inactive lanes must come back exactly as they went in.
+        for (int i = count; i < W; ++i) {
+            REPORTER_ASSERT(r, !memcmp(out[i], in, sizeof(in)),
+                            "count %d, inactive lane %d: (%g, %g, %g, %g)", count, i,
+                            out[i][0], out[i][1], out[i][2], out[i][3]);
+        }
+    }
+}
+
+DEF_TEST(SkSLByteCodeUnsupported, r) {
+    const char* src = "void main(int x, int y, inout half4 color) {"
+                      "    float2x2 m = float2x2(color);"
+                      "    color.rg = m * color.ba;"
+                      "}";
+    SkSL::Compiler compiler;
+    SkSL::Program::Settings settings;
+    std::unique_ptr<SkSL::Program> program = compiler.convertProgram(
+                                                             SkSL::Program::kPipelineStage_Kind,
+                                                             SkSL::String(src), settings);
+    REPORTER_ASSERT(r, program);
+    if (program) {
+        REPORTER_ASSERT(r, !compiler.toByteCode(*program));
+        REPORTER_ASSERT(r, compiler.errorCount() > 0);
+    }
+}
@@ -545,3 +545,30 @@ DEF_TEST(SkSLFPNestedChildProcessors, r) {
             "this->registerChildProcessor(src.childProcessor(1).clone());"
          });
 }
+
+DEF_TEST(SkSLFPCompilerReuse, r) {
+    // The built-in enums of the .fp include must not clash with themselves when one Compiler
+    // converts several processors.
+    const char* src = "layout(key) in GrClipEdgeType edgeType;"
+                      "void main() {"
+                      "    if (edgeType == GrClipEdgeType::kFillAA) {"
+                      "        sk_OutColor = sk_InColor;"
+                      "    }"
+                      "}";
+    SkSL::Compiler compiler;
+    sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+    SkSL::Program::Settings settings;
+    settings.fCaps = caps.get();
+    for (int i = 0; i < 3; ++i) {
+        std::unique_ptr<SkSL::Program> program = compiler.convertProgram(
+                                                             SkSL::Program::kFragmentProcessor_Kind,
+                                                             SkSL::String(src),
+                                                             settings);
+        if (!program) {
+            SkDebugf("Unexpected error compiling %s\n%s", src, compiler.errorText().c_str());
+        }
+        REPORTER_ASSERT(r, program);
+        SkSL::StringStream output;
+        REPORTER_ASSERT(r, program && compiler.toCPP(*program, "Test", output));
+    }
+}
@@ -2147,3 +2147,40 @@ DEF_TEST(SkSLWorkaroundRemovePowWithConstantExponent, r) {
          SkSL::Program::kFragment_Kind
          );
 }
+
+DEF_TEST(SkSLCompilerReuse, r) {
+    // A Compiler is reused for many programs; what one program declares must not be visible to
+    // the next.
+    const char* src = "struct S { float x; };"
+                      "float twice(float x) { return x * 2; }"
+                      "void main() { S s; s.x = twice(sqrt(sk_FragCoord.x)); "
+                      "              sk_FragColor = half4(half(s.x)); }";
+    SkSL::Compiler compiler;
+    sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+    SkSL::Program::Settings settings;
+    settings.fCaps = caps.get();
+    SkSL::String first;
+    for (int i = 0; i < 3; ++i) {
+        std::unique_ptr<SkSL::Program> program = compiler.convertProgram(
+                                                                     SkSL::Program::kFragment_Kind,
+                                                                     SkSL::String(src),
+                                                                     settings);
+        if (!program) {
+            SkDebugf("Unexpected error compiling %s\n%s", src, compiler.errorText().c_str());
+        }
+        REPORTER_ASSERT(r, program);
+        SkSL::String output;
+        REPORTER_ASSERT(r, program && compiler.toGLSL(*program, &output));
+        if (!i) {
+            first = output;
+        }
+        REPORTER_ASSERT(r, output == first);
+    }
+    // Symbols declared by one kind of program are not visible to the others.
+    REPORTER_ASSERT(r, !compiler.convertProgram(SkSL::Program::kVertex_Kind,
+                                                SkSL::String("void main() { "
+                                                             "sk_FragColor = half4(1); }"),
+                                                settings));
+    REPORTER_ASSERT(r, !compiler.convertProgram(SkSL::Program::kFragment_Kind,
+                                                SkSL::String("void main() { S s; }"), settings));
+}
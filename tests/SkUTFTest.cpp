@@ -140,3 +140,58 @@ DEF_TEST(SkUTF_NextUTF8_ToUTF8, r) {
 #undef LEADING_THREE_BYTE
 #undef LEADING_FOUR_BYTE
 #undef INVALID_BYTE
+
+DEF_TEST(SkUTF_ToUTF32, r) {
+    // Long enough runs of ASCII and of the BMP to take the block paths, with multi-byte and
+    // surrogate pair characters at every offset around them.
+    static const SkUnichar gUni[] = {
+        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 0xE9, 'k', 'l', 0x4E2D, 0x6587,
+        'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 0x1F600, 'v', 0x4E00, 0x4E01, 0x4E02,
+        0x4E03, 0x4E04, 0x4E05, 0x4E06, 0x4E07, 0x4E08, 'w', 'x', 'y', 'z', 0x10330,
+    };
+    constexpr int kCount = SK_ARRAY_COUNT(gUni);
+    char utf8[kCount * SkUTF::kMaxBytesInUTF8Sequence];
+    uint16_t utf16[kCount * 2];
+    size_t utf8Length = 0, utf16Length = 0;
+    for (SkUnichar uni : gUni) {
+        utf8Length += SkUTF::ToUTF8(uni, utf8 + utf8Length);
+        utf16Length += SkUTF::ToUTF16(uni, utf16 + utf16Length);
+    }
+
+    for (int start = 0; start < kCount; ++start) {
+        for (int count = 0; count <= kCount - start; ++count) {
+            const char* utf8Start = utf8;
+            const uint16_t* utf16Start = utf16;
+            for (int i = 0; i < start; ++i) {
+                SkUTF::NextUTF8(&utf8Start, utf8 + utf8Length);
+                SkUTF::NextUTF16(&utf16Start, utf16 + utf16Length);
+            }
+            SkUnichar dst[kCount];
+            const char* p8 = utf8Start;
+            REPORTER_ASSERT(r, count == SkUTF::UTF8ToUTF32(&p8, utf8 + utf8Length, dst, count));
+            REPORTER_ASSERT(r, !memcmp(dst, gUni + start, count * sizeof(SkUnichar)));
+            const uint16_t* p16 = utf16Start;
+            REPORTER_ASSERT(r, count == SkUTF::UTF16ToUTF32(&p16, utf16 + utf16Length,
+                                                           dst, count));
+            REPORTER_ASSERT(r, !memcmp(dst, gUni + start, count * sizeof(SkUnichar)));
+            for (int i = 0; i < count; ++i) {
+                SkUTF::NextUTF8(&utf8Start, utf8 + utf8Length);
+                SkUTF::NextUTF16(&utf16Start, utf16 + utf16Length);
+            }
+            REPORTER_ASSERT(r, p8 == utf8Start);
+            REPORTER_ASSERT(r, p16 == utf16Start);
+        }
+    }
+
+    // Decoding stops at invalid sequences, leaving the pointer at them.
+    const char invalid8[] = "abcdefghijk\xFCxyz";
+    const char* p8 = invalid8;
+    SkUnichar dst[16];
+    REPORTER_ASSERT(r, 11 == SkUTF::UTF8ToUTF32(&p8, invalid8 + strlen(invalid8), dst, 16));
+    REPORTER_ASSERT(r, p8 == invalid8 + 11);
+    const uint16_t invalid16[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 0xDC00, 'x' };
+    const uint16_t* p16 = invalid16;
+    REPORTER_ASSERT(r, 9 == SkUTF::UTF16ToUTF32(&p16, invalid16 + SK_ARRAY_COUNT(invalid16),
+                                                dst, 16));
+    REPORTER_ASSERT(r, p16 == invalid16 + 9);
+}
@@ -8,6 +8,8 @@
 #include "DDLTileHelper.h"
 
 #include "DDLPromiseImageHelper.h"
+#include "GrContextPriv.h"
+#include "GrMemoryPool.h"
 #include "SkCanvas.h"
 #include "SkDeferredDisplayListRecorder.h"
 #include "SkImage_Gpu.h"
@@ -15,6 +17,7 @@
 #include "SkSurface.h"
 #include "SkSurfaceCharacterization.h"
 #include "SkTaskGroup.h"
+#include "SkTime.h"
 
 DDLTileHelper::TileData::TileData(sk_sp<SkSurface> s, const SkIRect& clip)
         : fSurface(std::move(s))
@@ -37,6 +40,7 @@ void DDLTileHelper::TileData::createDDL() {
     SkASSERT(fReconstitutedPicture);
     SkASSERT(!fDisplayList);
 
+    double start = SkTime::GetMSecs();
     SkDeferredDisplayListRecorder recorder(fCharacterization);
 
     // DDL TODO: the DDLRecorder's GrContext isn't initialized until getCanvas is called.
@@ -62,7 +66,9 @@ void DDLTileHelper::TileData::createDDL() {
     // but, more generally, clients will use arbitrary draw calls.
     subCanvas->drawPicture(fReconstitutedPicture);
 
+    fOpMemory = subCanvas->getGrContext()->contextPriv().opMemoryPool()->size();
     fDisplayList = recorder.detach();
+    fRecordMs = SkTime::GetMSecs() - start;
 }
 
 void DDLTileHelper::TileData::draw() {
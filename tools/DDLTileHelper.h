@@ -47,6 +47,12 @@ public:
 
         void reset();
 
+        // The wall time spent in the last createDDL().
+        double recordMs() const { return fRecordMs; }
+
+        // The op memory held by the last recorded DDL.
+        size_t opMemory() const { return fOpMemory; }
+
     private:
         sk_sp<SkSurface>                       fSurface;
         SkSurfaceCharacterization              fCharacterization;
@@ -55,6 +61,8 @@ public:
         SkTArray<sk_sp<SkImage>>               fPromiseImages; // All the promise images in the
                                                                // reconstituted picture
         std::unique_ptr<SkDeferredDisplayList> fDisplayList;
+        double                                 fRecordMs = 0;
+        size_t                                 fOpMemory = 0;
     };
 
     DDLTileHelper(SkCanvas* canvas, const SkIRect& viewport, int numDivisions);
@@ -69,6 +77,9 @@ public:
 
     void resetAllTiles();
 
+    int numTiles() const { return fTiles.count(); }
+    const TileData& tile(int i) const { return fTiles[i]; }
+
 private:
     int                fNumDivisions; // number of tiles along a side
     SkTArray<TileData> fTiles;
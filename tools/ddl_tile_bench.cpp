@@ -0,0 +1,170 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "DDLPromiseImageHelper.h"
+#include "DDLTileHelper.h"
+#include "GrContext.h"
+#include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkDeferredDisplayList.h"
+#include "SkExecutor.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkPicture.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTime.h"
+
+// Measures parallel DDL recording throughput with the mock GPU backend. Each SKP is split into
+// tiles, every tile's SkDeferredDisplayList is recorded on an SkTaskGroup thread, and the DDLs are
+// then replayed into the mock context. This is repeated for each thread count to show how
+// recording scales, along with the per tile record time and the op memory held by each DDL.
+// Unlike skpbench --ddl this doesn't need a GPU (or fence syncs) so it runs on any machine.
+
+DEFINE_string2(skps, s, "", "An skp or a directory of skps to record.");
+DEFINE_int32(tiles, 4, "Number of tiles along each edge of an skp.");
+DEFINE_string(threads, "0 1 2 4 8",
+              "Thread counts to record with. 0 records every tile on the main thread.");
+DEFINE_int32(loops, 10, "Number of times to record and replay each skp per thread count.");
+
+struct Timings {
+    double fRecordMs = 0;     // wall time to record all of the tiles
+    double fReplayMs = 0;     // wall time to replay all of the DDLs and flush
+    double fTileMs = 0;       // sum of the per tile record times
+    double fMaxTileMs = 0;
+    size_t fOpMemory = 0;     // sum of the per DDL op memory
+    int    fTiles = 0;
+};
+
+static void record_and_replay(GrContext* context, DDLTileHelper* tiles, Timings* timings) {
+    double start = SkTime::GetMSecs();
+    tiles->createDDLsInParallel();
+    double recorded = SkTime::GetMSecs();
+    tiles->drawAllTilesAndFlush(context, true);
+    double replayed = SkTime::GetMSecs();
+    if (timings) {
+        timings->fRecordMs += recorded - start;
+        timings->fReplayMs += replayed - recorded;
+        for (int i = 0; i < tiles->numTiles(); ++i) {
+            const DDLTileHelper::TileData& tile = tiles->tile(i);
+            timings->fTileMs += tile.recordMs();
+            timings->fMaxTileMs = SkTMax(timings->fMaxTileMs, tile.recordMs());
+            timings->fOpMemory += tile.opMemory();
+            ++timings->fTiles;
+        }
+    }
+    tiles->resetAllTiles();
+}
+
+static bool bench(GrContext* context, const SkString& path, const SkTArray<int>& threadCounts) {
+    std::unique_ptr<SkStream> stream = SkStream::MakeFromFile(path.c_str());
+    sk_sp<SkPicture> picture = stream ? SkPicture::MakeFromStream(stream.get()) : nullptr;
+    if (!picture) {
+        SkDebugf("Could not read %s.\n", path.c_str());
+        return false;
+    }
+    SkIRect bounds = picture->cullRect().roundOut();
+    int maxSize = context->maxRenderTargetSize();
+    SkImageInfo info = SkImageInfo::MakeN32Premul(SkTMin(SkTMax(bounds.width(), 1), maxSize),
+                                                  SkTMin(SkTMax(bounds.height(), 1), maxSize));
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        SkDebugf("Could not create a surface for %s.\n", path.c_str());
+        return false;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->translate(-bounds.fLeft, -bounds.fTop);
+
+    DDLPromiseImageHelper promiseImageHelper;
+    sk_sp<SkData> compressedPictureData = promiseImageHelper.deflateSKP(picture.get());
+    if (!compressedPictureData) {
+        SkDebugf("Could not convert %s for DDL recording.\n", path.c_str());
+        return false;
+    }
+    promiseImageHelper.uploadAllToGPU(context);
+
+    DDLTileHelper tiles(canvas, info.bounds(), FLAGS_tiles);
+    tiles.createSKPPerTile(compressedPictureData.get(), promiseImageHelper);
+
+    SkString name = SkOSPath::Basename(path.c_str());
+    double serialRecordMs = 0;
+    for (int threads : threadCounts) {
+        std::unique_ptr<SkExecutor> executor;
+        if (threads > 0) {
+            executor = SkExecutor::MakeFIFOThreadPool(threads);
+        }
+        SkExecutor::SetDefault(executor.get());
+
+        record_and_replay(context, &tiles, nullptr);  // warm up
+        Timings timings;
+        for (int i = 0; i < FLAGS_loops; ++i) {
+            record_and_replay(context, &tiles, &timings);
+        }
+        SkExecutor::SetDefault(nullptr);
+
+        double recordMs = timings.fRecordMs / FLAGS_loops;
+        if (!serialRecordMs) {
+            serialRecordMs = recordMs;
+        }
+        SkDebugf("%-32s %7d %10.3f %7.2fx %10.3f %10.3f %10.3f %10.1f\n",
+                 name.c_str(), threads, recordMs, recordMs ? serialRecordMs / recordMs : 0.0,
+                 timings.fReplayMs / FLAGS_loops, timings.fTileMs / timings.fTiles,
+                 timings.fMaxTileMs, timings.fOpMemory / 1024.0 / timings.fTiles);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Benchmarks parallel DDL recording of skps with the mock backend.\n"
+                                 "Usage: ddl_tile_bench -s <skp or dir of skps> [--tiles N] "
+                                 "[--threads \"0 1 2 4 8\"] [--loops N]\n");
+    SkCommandLineFlags::Parse(argc, argv);
+    if (FLAGS_skps.count() != 1 || FLAGS_tiles <= 0 || FLAGS_loops <= 0) {
+        SkCommandLineFlags::PrintUsage();
+        return 1;
+    }
+
+    SkTArray<int> threadCounts;
+    for (int i = 0; i < FLAGS_threads.count(); ++i) {
+        SkTArray<SkString> counts;
+        SkStrSplit(FLAGS_threads[i], " ", &counts);
+        for (const SkString& count : counts) {
+            threadCounts.push_back(SkTMax(atoi(count.c_str()), 0));
+        }
+    }
+    if (threadCounts.empty()) {
+        SkCommandLineFlags::PrintUsage();
+        return 1;
+    }
+
+    sk_sp<GrContext> context = GrContext::MakeMock(nullptr);
+    if (!context) {
+        SkDebugf("Could not create a mock context.\n");
+        return 1;
+    }
+
+    SkTArray<SkString> paths;
+    const char* input = FLAGS_skps[0];
+    if (sk_isdir(input)) {
+        SkOSFile::Iter iter(input, "skp");
+        for (SkString file; iter.next(&file); ) {
+            paths.push_back(SkOSPath::Join(input, file.c_str()));
+        }
+    } else {
+        paths.push_back(SkString(input));
+    }
+
+    SkDebugf("%-32s %7s %10s %8s %10s %10s %10s %10s\n", "", "threads", "record_ms", "speedup",
+             "replay_ms", "tile_ms", "max_tile", "KB/DDL");
+    int failures = 0;
+    for (const SkString& path : paths) {
+        if (!bench(context.get(), path, threadCounts)) {
+            ++failures;
+        }
+    }
+    return failures ? 2 : 0;
+}
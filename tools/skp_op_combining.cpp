@@ -0,0 +1,136 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrAuditTrail.h"
+#include "GrContext.h"
+#include "GrContextOptions.h"
+#include "GrContextPriv.h"
+#include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkPicture.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTHash.h"
+
+// Draws SKPs with the mock GPU backend and reports, per op type, how many ops were recorded and
+// how many were left after GrRenderTargetOpList combined them. Useful for evaluating changes to
+// op combining (e.g. --lookback/--lookahead) against a corpus of SKPs without a real GPU.
+
+DEFINE_string2(skps, s, "", "An skp or a directory of skps to report on.");
+DEFINE_int32(lookback, -1, "Max ops to look back when combining. Negative uses the default.");
+DEFINE_int32(lookahead, -1, "Max ops to look ahead when combining. Negative uses the default.");
+DEFINE_bool2(verbose, v, false, "Print the per op type counts for each skp.");
+
+struct Totals {
+    int fRecorded = 0;
+    int fCombined = 0;
+};
+
+static void print_counts(const char* name, int recorded, int combined) {
+    SkDebugf("%-40s %8d %8d %7.1f%%\n", name, recorded, combined,
+             recorded ? 100.0 * (recorded - combined) / recorded : 0.0);
+}
+
+static bool report(GrContext* context, const SkString& path,
+                   SkTHashMap<SkString, Totals>* opTotals, Totals* totals) {
+    std::unique_ptr<SkStream> stream = SkStream::MakeFromFile(path.c_str());
+    sk_sp<SkPicture> picture = stream ? SkPicture::MakeFromStream(stream.get()) : nullptr;
+    if (!picture) {
+        SkDebugf("Could not read %s.\n", path.c_str());
+        return false;
+    }
+    SkIRect bounds = picture->cullRect().roundOut();
+    int maxSize = context->maxRenderTargetSize();
+    SkImageInfo info = SkImageInfo::MakeN32Premul(SkTMin(SkTMax(bounds.width(), 1), maxSize),
+                                                  SkTMin(SkTMax(bounds.height(), 1), maxSize));
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        SkDebugf("Could not create a surface for %s.\n", path.c_str());
+        return false;
+    }
+
+    GrAuditTrail* auditTrail = context->contextPriv().getAuditTrail();
+    SkTArray<GrAuditTrail::OpCount> counts;
+    {
+        GrAuditTrail::AutoManageOpList autoManage(auditTrail);
+        surface->getCanvas()->translate(-bounds.fLeft, -bounds.fTop);
+        surface->getCanvas()->drawPicture(picture);
+        surface->flush();
+        auditTrail->getOpCounts(&counts);
+    }
+
+    Totals skpTotals;
+    for (const GrAuditTrail::OpCount& count : counts) {
+        skpTotals.fRecorded += count.fRecorded;
+        skpTotals.fCombined += count.fCombined;
+        Totals* opTotal = opTotals->find(count.fName);
+        if (!opTotal) {
+            opTotal = opTotals->set(count.fName, Totals());
+        }
+        opTotal->fRecorded += count.fRecorded;
+        opTotal->fCombined += count.fCombined;
+        if (FLAGS_verbose) {
+            print_counts(SkStringPrintf("  %s", count.fName.c_str()).c_str(),
+                         count.fRecorded, count.fCombined);
+        }
+    }
+    print_counts(SkOSPath::Basename(path.c_str()).c_str(),
+                 skpTotals.fRecorded, skpTotals.fCombined);
+    totals->fRecorded += skpTotals.fRecorded;
+    totals->fCombined += skpTotals.fCombined;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Reports GPU op combining for skps drawn with the mock backend.\n"
+                                 "Usage: skp_op_combining -s <skp or dir of skps> "
+                                 "[--lookback N] [--lookahead N] [-v]\n");
+    SkCommandLineFlags::Parse(argc, argv);
+    if (FLAGS_skps.count() != 1) {
+        SkCommandLineFlags::PrintUsage();
+        return 1;
+    }
+
+    GrContextOptions options;
+    options.fMaxOpCombineLookback = FLAGS_lookback;
+    options.fMaxOpCombineLookahead = FLAGS_lookahead;
+    sk_sp<GrContext> context = GrContext::MakeMock(nullptr, options);
+    if (!context) {
+        SkDebugf("Could not create a mock context.\n");
+        return 1;
+    }
+
+    SkTArray<SkString> paths;
+    const char* input = FLAGS_skps[0];
+    if (sk_isdir(input)) {
+        SkOSFile::Iter iter(input, "skp");
+        for (SkString file; iter.next(&file); ) {
+            paths.push_back(SkOSPath::Join(input, file.c_str()));
+        }
+    } else {
+        paths.push_back(SkString(input));
+    }
+
+    SkDebugf("%-40s %8s %8s %8s\n", "", "recorded", "combined", "removed");
+    SkTHashMap<SkString, Totals> opTotals;
+    Totals totals;
+    int failures = 0;
+    for (const SkString& path : paths) {
+        if (!report(context.get(), path, &opTotals, &totals)) {
+            ++failures;
+        }
+    }
+
+    SkDebugf("\n");
+    opTotals.foreach([](const SkString& name, Totals* total) {
+        print_counts(name.c_str(), total->fRecorded, total->fCombined);
+    });
+    print_counts("total", totals.fRecorded, totals.fCombined);
+    return failures ? 2 : 0;
+}